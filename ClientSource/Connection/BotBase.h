@@ -7,6 +7,7 @@
 #ifndef PokemonAutomation_AbstractBotBase_H
 #define PokemonAutomation_AbstractBotBase_H
 
+#include <stdint.h>
 #include "Common/Cpp/CancellableScope.h"
 
 namespace PokemonAutomation{
@@ -32,6 +33,10 @@ public:
     virtual Logger& logger() = 0;
     virtual State state() const = 0;
 
+    //  The protocol version the device reported the last time it was asked.
+    //  Zero if it hasn't been asked.
+    virtual uint32_t device_protocol_version() const{ return 0; }
+
     //  Waits for all pending requests to finish.
     virtual void wait_for_all_requests(const Cancellable* cancelled = nullptr) = 0;
 
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/PanicDump.h"
+#include "Common/Cpp/LatencyTracer.h"
 #include "Common/Cpp/Concurrency/SpinPause.h"
 #include "Common/Microcontroller/MessageProtocol.h"
 #include "Common/Microcontroller/DeviceRoutines.h"
@@ -42,6 +43,8 @@ PABotBase::PABotBase(
     , m_send_seq(1)
     , m_retransmit_delay(retransmit_delay)
     , m_last_ack(current_time())
+    , m_device_protocol_version(0)
+    , m_trace_scope(LatencyTracer::instance().new_scope())
     , m_state(State::RUNNING)
     , m_error(false)
     , m_retransmit_thread(run_with_catch, "PABotBase::retransmit_thread()", [this]{ retransmit_thread(); })
@@ -297,6 +300,7 @@ void PABotBase::process_ack_request(BotBaseMessage message){
 
         state = iter->second.state;
         if (state == AckState::NOT_ACKED){
+            LatencyTracer::instance().async_end(PA_TRACE_COMMAND, "Request", m_trace_scope, full_seqnum);
             if (iter->second.silent_remove){
                 m_pending_requests.erase(iter);
             }else{
@@ -354,6 +358,7 @@ void PABotBase::process_ack_command(BotBaseMessage message){
     switch (iter->second.state){
     case AckState::NOT_ACKED:
 //        std::cout << "acked: " << full_seqnum << std::endl;
+        LatencyTracer::instance().async_instant(PA_TRACE_COMMAND, "Command", m_trace_scope, full_seqnum);
         iter->second.state = AckState::ACKED;
         iter->second.ack = std::move(message);
         return;
@@ -409,6 +414,7 @@ void PABotBase::process_command_finished(BotBaseMessage message){
     switch (iter->second.state){
     case AckState::NOT_ACKED:
     case AckState::ACKED:
+        LatencyTracer::instance().async_end(PA_TRACE_COMMAND, "Command", m_trace_scope, full_seqnum);
         iter->second.state = AckState::FINISHED;
         iter->second.ack = std::move(message);
         if (iter->second.silent_remove){
@@ -575,6 +581,8 @@ uint64_t PABotBase::try_issue_request(
     handle.request = std::move(message);
     handle.first_sent = current_time();
 
+    LatencyTracer::instance().async_begin(PA_TRACE_COMMAND, "Request", m_trace_scope, seqnum, handle.first_sent);
+
     send_message(handle.request, false);
 
     return seqnum;
@@ -645,6 +653,8 @@ uint64_t PABotBase::try_issue_command(
     handle.request = std::move(message);
     handle.first_sent = current_time();
 
+    LatencyTracer::instance().async_begin(PA_TRACE_COMMAND, "Command", m_trace_scope, seqnum, handle.first_sent);
+
     send_message(handle.request, false);
 
     return seqnum;
@@ -769,8 +779,21 @@ BotBaseMessage PABotBase::issue_request_and_wait(
         throw InternalProgramError(&m_logger, PA_CURRENT_FUNCTION, "This function only supports requests.");
     }
 
+    BotBaseMessage query = request.message();
     uint64_t seqnum = issue_request(cancelled, request, false);
-    return wait_for_request(seqnum);
+    BotBaseMessage response = wait_for_request(seqnum);
+
+    //  Remember what the device said so that commands can check for features
+    //  without asking again.
+    if (query.type == PABB_MSG_REQUEST_PROTOCOL_VERSION &&
+        response.type == PABB_MSG_ACK_REQUEST_I32 &&
+        response.body.size() == sizeof(pabb_MsgAckRequestI32)
+    ){
+        const pabb_MsgAckRequestI32* params = (const pabb_MsgAckRequestI32*)response.body.c_str();
+        m_device_protocol_version.store(params->data, std::memory_order_release);
+    }
+
+    return response;
 }
 BotBaseMessage PABotBase::wait_for_request(uint64_t seqnum){
     m_sanitizer.check_usage();
@@ -68,6 +68,9 @@ public:
     virtual State state() const override{
         return m_state.load(std::memory_order_acquire);
     }
+    virtual uint32_t device_protocol_version() const override{
+        return m_device_protocol_version.load(std::memory_order_acquire);
+    }
 
 public:
     //  Basic Requests
@@ -173,6 +176,10 @@ private:
     uint64_t m_send_seq;
     std::chrono::milliseconds m_retransmit_delay;
     std::atomic<std::chrono::time_point<std::chrono::system_clock>> m_last_ack;
+    std::atomic<uint32_t> m_device_protocol_version;
+
+    //  Keeps the seqnums of different connections apart in the latency trace.
+    const uint32_t m_trace_scope;
 
     std::map<uint64_t, PendingRequest> m_pending_requests;
     std::map<uint64_t, PendingCommand> m_pending_commands;
@@ -4,6 +4,7 @@
  * 
  */
 
+#include <string.h>
 #include "Common/CRC32.h"
 #include "Common/Microcontroller/MessageProtocol.h"
 #include "ClientSource/Libraries/Logging.h"
@@ -84,47 +85,50 @@ void PABotBaseConnection::send_message(const BotBaseMessage& message, bool is_re
 
 void PABotBaseConnection::on_recv(const void* data, size_t bytes){
     //  Push into receive buffer.
-    for (size_t c = 0; c < bytes; c++){
-        m_recv_buffer.emplace_back(((const char*)data)[c]);
+    if (m_recv_head > 0 && m_recv_head * 2 >= m_recv_buffer.size()){
+        m_recv_buffer.erase(m_recv_buffer.begin(), m_recv_buffer.begin() + m_recv_head);
+        m_recv_head = 0;
     }
+    m_recv_buffer.insert(m_recv_buffer.end(), (const char*)data, (const char*)data + bytes);
 
-    while (!m_recv_buffer.empty()){
-        uint8_t length = ~m_recv_buffer[0];
+    while (m_recv_head < m_recv_buffer.size()){
+        const char* message = m_recv_buffer.data() + m_recv_head;
+        size_t available = m_recv_buffer.size() - m_recv_head;
+        uint8_t length = ~message[0];
 
-        if (m_recv_buffer[0] == 0){
+        if (message[0] == 0){
             m_sniffer->log("Skipping zero byte.");
-            m_recv_buffer.pop_front();
+            m_recv_head++;
             continue;
         }
 
         //  Message is too short.
         if (length < PABB_PROTOCOL_OVERHEAD){
             m_sniffer->log("Message is too short: bytes = " + std::to_string(length));
-            m_recv_buffer.pop_front();
+            m_recv_head++;
             continue;
         }
 
         //  Message is too long.
         if (length > PABB_MAX_PACKET_SIZE){
             m_sniffer->log("Message is too long: bytes = " + std::to_string(length));
-            m_recv_buffer.pop_front();
+            m_recv_head++;
             continue;
         }
 
         //  Message is incomplete.
-        if (length > m_recv_buffer.size()){
+        if (length > available){
             return;
         }
 
-        std::string message(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
-
         //  Verify checksum
         {
             //  Calculate checksum.
-            uint32_t checksumA = pabb_crc32(0xffffffff, &message[0], length - sizeof(uint32_t));
+            uint32_t checksumA = pabb_crc32(0xffffffff, message, length - sizeof(uint32_t));
 
             //  Read the checksum from the message.
-            uint32_t checksumE = ((uint32_t*)(&message[0] + length))[-1];
+            uint32_t checksumE;
+            memcpy(&checksumE, message + length - sizeof(uint32_t), sizeof(uint32_t));
 
             //  Compare
 //            std::cout << checksumA << " / " << checksumE << std::endl;
@@ -132,16 +136,19 @@ void PABotBaseConnection::on_recv(const void* data, size_t bytes){
                 m_sniffer->log("Invalid Checksum: bytes = " + std::to_string(length));
 //                std::cout << checksumA << " / " << checksumE << std::endl;
 //                log(message_to_string(message[1], &message[2], length - PABB_PROTOCOL_OVERHEAD));
-                m_recv_buffer.pop_front();
+                m_recv_head++;
                 continue;
             }
         }
-        m_recv_buffer.erase(m_recv_buffer.begin(), m_recv_buffer.begin() + length);
 
-        BotBaseMessage msg(message[1], std::string(&message[2], length - PABB_PROTOCOL_OVERHEAD));
+        BotBaseMessage msg(message[1], std::string(message + 2, length - PABB_PROTOCOL_OVERHEAD));
+        m_recv_head += length;
         m_sniffer->on_recv(msg);
         on_recv_message(std::move(msg));
     }
+
+    m_recv_buffer.clear();
+    m_recv_head = 0;
 }
 
 
@@ -16,7 +16,7 @@
 
 #include <memory>
 #include <string>
-#include <deque>
+#include <vector>
 #include "Common/Compiler.h"
 #include "Common/Microcontroller/MessageProtocol.h"
 #include "BotBase.h"
@@ -49,7 +49,12 @@ private:
 
 private:
     std::unique_ptr<StreamConnection> m_connection;
-    std::deque<char> m_recv_buffer;
+
+    //  Received bytes that are not yet framed start at "m_recv_head".
+    //  Messages are parsed in place. The consumed front is only moved out
+    //  once it is at least half of the buffer.
+    std::vector<char> m_recv_buffer;
+    size_t m_recv_head = 0;
 
 protected:
     Logger& m_logger;
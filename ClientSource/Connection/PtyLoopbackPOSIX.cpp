@@ -0,0 +1,122 @@
+/*  Pseudo-Terminal Loopback for POSIX
+ * 
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ * 
+ */
+
+#ifndef _WIN32
+
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PanicDump.h"
+#include "PtyLoopbackPOSIX.h"
+
+namespace PokemonAutomation{
+
+
+PtyLoopback::PtyLoopback(bool echo)
+    : m_echo(echo)
+    , m_stopping(false)
+{
+    m_master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_master == -1){
+        int error = errno;
+        throw ConnectionException(nullptr, "posix_openpt() failed. Error = " + std::to_string(error));
+    }
+    const char* name = nullptr;
+    if (grantpt(m_master) == 0 && unlockpt(m_master) == 0){
+        name = ptsname(m_master);
+    }
+    if (name == nullptr){
+        int error = errno;
+        close(m_master);
+        throw ConnectionException(nullptr, "Unable to open pseudo-terminal. Error = " + std::to_string(error));
+    }
+    m_device_name = name;
+
+    //  Raw mode on our side as well. Otherwise the line discipline will
+    //  translate and echo bytes.
+    struct termios options;
+    if (tcgetattr(m_master, &options) == 0){
+        cfmakeraw(&options);
+        tcsetattr(m_master, TCSANOW, &options);
+    }
+    fcntl(m_master, F_SETFL, fcntl(m_master, F_GETFL) | O_NONBLOCK);
+
+    if (m_echo){
+        m_echo_thread = std::thread(run_with_catch, "PtyLoopback::echo_loop()", [this]{ echo_loop(); });
+    }
+}
+PtyLoopback::~PtyLoopback(){
+    if (m_echo){
+        m_stopping.store(true, std::memory_order_release);
+        m_echo_thread.join();
+    }
+    close(m_master);
+}
+void PtyLoopback::echo_loop(){
+    char buffer[4096];
+    while (!m_stopping.load(std::memory_order_acquire)){
+        struct pollfd fd = {};
+        fd.fd = m_master;
+        fd.events = POLLIN;
+        if (poll(&fd, 1, 100) <= 0){
+            continue;
+        }
+        if (!(fd.revents & POLLIN)){
+            //  Hangup. The connection isn't open (yet or anymore).
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        ssize_t bytes = read(m_master, buffer, sizeof(buffer));
+        if (bytes <= 0){
+            continue;
+        }
+        try{
+            send(buffer, bytes);
+        }catch (ConnectionException&){
+            //  Closed while echoing. Drop the rest.
+        }
+    }
+}
+
+void PtyLoopback::send(const void* data, size_t bytes){
+    const char* ptr = (const char*)data;
+    while (bytes > 0){
+        ssize_t written = write(m_master, ptr, bytes);
+        if (written > 0){
+            ptr += written;
+            bytes -= written;
+            continue;
+        }
+        if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+            int error = errno;
+            throw ConnectionException(nullptr, "Pseudo-terminal write failed. Error = " + std::to_string(error));
+        }
+        struct pollfd fd = {};
+        fd.fd = m_master;
+        fd.events = POLLOUT;
+        poll(&fd, 1, 100);
+    }
+}
+size_t PtyLoopback::recv(void* data, size_t bytes, std::chrono::milliseconds timeout){
+    struct pollfd fd = {};
+    fd.fd = m_master;
+    fd.events = POLLIN;
+    if (poll(&fd, 1, (int)timeout.count()) <= 0){
+        return 0;
+    }
+    ssize_t actual = read(m_master, data, bytes);
+    return actual > 0 ? actual : 0;
+}
+
+
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+/*  Pseudo-Terminal Loopback for POSIX
+ * 
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ * 
+ *      A pseudo-terminal pair that stands in for a serial device. Open a
+ *  SerialConnection on "device_name()" and play the role of the device with
+ *  send() and recv(). In echo mode everything the connection sends is
+ *  immediately sent back to it.
+ * 
+ *  Intended for tests and benchmarks of the connection stack.
+ * 
+ */
+
+#ifndef PokemonAutomation_PtyLoopbackPOSIX_H
+#define PokemonAutomation_PtyLoopbackPOSIX_H
+
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <thread>
+
+namespace PokemonAutomation{
+
+
+class PtyLoopback{
+public:
+    PtyLoopback(bool echo = false);
+    ~PtyLoopback();
+
+    PtyLoopback(const PtyLoopback&) = delete;
+    void operator=(const PtyLoopback&) = delete;
+
+    //  Path of the terminal to open as the serial port.
+    const std::string& device_name() const{ return m_device_name; }
+
+    //  Send bytes to the connection.
+    void send(const void* data, size_t bytes);
+
+    //  Receive up to "bytes" from the connection. Not usable in echo mode.
+    //  Returns the number of bytes read. Returns 0 on timeout.
+    size_t recv(void* data, size_t bytes, std::chrono::milliseconds timeout);
+
+
+private:
+    //  Echo runs on its own thread. send() may wait for the connection to
+    //  drain and must not do that on the shared reactor thread.
+    void echo_loop();
+
+private:
+    int m_master;
+    bool m_echo;
+    std::string m_device_name;
+    std::atomic<bool> m_stopping;
+    std::thread m_echo_thread;
+};
+
+
+}
+
+#endif
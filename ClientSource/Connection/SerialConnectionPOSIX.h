@@ -9,14 +9,15 @@
 
 #include <string>
 #include <atomic>
-#include <thread>
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <termios.h>
 #include <unistd.h>
 #include "Common/Cpp/Exceptions.h"
-#include "Common/Cpp/PanicDump.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "StreamInterface.h"
+#include "SerialReactorPOSIX.h"
 
 namespace PokemonAutomation{
 
@@ -100,6 +101,12 @@ public:
         options.c_lflag &= ~ECHOE;
 #endif
 
+        //  Without this, a port left at VMIN = 0 by a previous user makes
+        //  read() return 0 once the input is drained. That looks like a hangup
+        //  to the reactor.
+        options.c_cc[VMIN] = 1;
+        options.c_cc[VTIME] = 0;
+
         if (tcsetattr(m_fd, TCSANOW, &options) == -1){
             int error = errno;
             throw ConnectionException(nullptr, "tcsetattr() failed. Error = " + std::to_string(error));
@@ -118,9 +125,9 @@ public:
             throw ConnectionException(nullptr, "Unable to set output baud rate.");
         }
 
-        //  Start receiver thread.
+        //  Receiving is done by the shared reactor thread.
         try{
-            m_listener = std::thread(run_with_catch, "SerialConnection::SerialConnection()", [this]{ recv_loop(); });
+            SerialReactor::instance().add(m_fd, [this](const void* data, size_t bytes){ on_recv(data, bytes); });
         }catch (...){
             close(m_fd);
             throw;
@@ -135,33 +142,38 @@ public:
 
     virtual void stop() final{
         m_exit.store(true, std::memory_order_release);
+        SerialReactor::instance().remove(m_fd);
         close(m_fd);
-        m_listener.join();
     }
 
 private:
     virtual void send(const void* data, size_t bytes){
         SpinLockGuard lg(m_send_lock, "SerialConnection::send()");
-        bytes = write(m_fd, data, bytes);
-    }
 
-    void recv_loop(){
-        char buffer[32];
-        while (!m_exit.load(std::memory_order_acquire)){
-            int actual = read(m_fd, buffer, sizeof(buffer));
-            if (actual > 0){
-                on_recv(buffer, actual);
+        //  The port is non-blocking. Wait for room instead of dropping the rest.
+        const char* ptr = (const char*)data;
+        while (bytes > 0 && !m_exit.load(std::memory_order_acquire)){
+            ssize_t written = write(m_fd, ptr, bytes);
+            if (written > 0){
+                ptr += written;
+                bytes -= written;
+                continue;
+            }
+            if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR){
+                return;
             }
+            struct pollfd fd = {};
+            fd.fd = m_fd;
+            fd.events = POLLOUT;
+            poll(&fd, 1, 100);
         }
     }
-    
 
 
 private:
     int m_fd;
     std::atomic<bool> m_exit;
     SpinLock m_send_lock;
-    std::thread m_listener;
 };
 
 
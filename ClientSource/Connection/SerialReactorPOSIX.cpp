@@ -0,0 +1,236 @@
+/*  Serial Reactor for POSIX
+ * 
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ * 
+ */
+
+#ifndef _WIN32
+
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PanicDump.h"
+#include "SerialReactorPOSIX.h"
+
+namespace PokemonAutomation{
+
+
+SerialReactor& SerialReactor::instance(){
+    static SerialReactor reactor;
+    return reactor;
+}
+
+SerialReactor::SerialReactor()
+    : m_exit(false)
+{
+    int fds[2];
+    if (pipe(fds) == -1){
+        int error = errno;
+        throw ConnectionException(nullptr, "pipe() failed. Error = " + std::to_string(error));
+    }
+    m_wake_read = fds[0];
+    m_wake_write = fds[1];
+    for (int fd : fds){
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+
+#ifdef __linux__
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll == -1){
+        int error = errno;
+        close(m_wake_read);
+        close(m_wake_write);
+        throw ConnectionException(nullptr, "epoll_create1() failed. Error = " + std::to_string(error));
+    }
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wake_read;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake_read, &event);
+#endif
+
+    m_thread = std::thread(run_with_catch, "SerialReactor::SerialReactor()", [this]{ thread_loop(); });
+}
+SerialReactor::~SerialReactor(){
+    m_exit.store(true, std::memory_order_release);
+    wake();
+    m_thread.join();
+#ifdef __linux__
+    close(m_epoll);
+#endif
+    close(m_wake_read);
+    close(m_wake_write);
+}
+void SerialReactor::wake(){
+    char ch = 0;
+    ssize_t bytes = write(m_wake_write, &ch, 1);
+    (void)bytes;
+}
+
+
+void SerialReactor::add(int fd, Callback callback){
+    //  Same as remove(). The reactor thread already holds the lock if we are
+    //  inside a callback.
+    bool on_reactor_thread = std::this_thread::get_id() == m_thread.get_id();
+    std::unique_lock<std::mutex> lg(m_lock, std::defer_lock);
+    if (!on_reactor_thread){
+        lg.lock();
+    }
+    if (on_reactor_thread && fd == m_dispatching_fd){
+        //  Would overwrite the callback that is running right now.
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Cannot add an fd from its own callback.");
+    }
+#ifdef __linux__
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) == -1){
+        int error = errno;
+        throw ConnectionException(nullptr, "epoll_ctl() failed. Error = " + std::to_string(error));
+    }
+#endif
+    m_callbacks[fd] = std::move(callback);
+
+    //  poll() needs to rebuild its list.
+    wake();
+}
+void SerialReactor::remove(int fd){
+    //  Taking the lock waits out any callback that is running right now.
+    //  The reactor thread already holds it if we are inside a callback.
+    bool on_reactor_thread = std::this_thread::get_id() == m_thread.get_id();
+    std::unique_lock<std::mutex> lg(m_lock, std::defer_lock);
+    if (!on_reactor_thread){
+        lg.lock();
+    }
+    auto iter = m_callbacks.find(fd);
+    if (iter == m_callbacks.end()){
+        return;
+    }
+#ifdef __linux__
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+    if (on_reactor_thread && fd == m_dispatching_fd){
+        //  Called from this fd's own callback. dispatch() erases it once the
+        //  callback returns.
+        m_remove_after_dispatch = true;
+    }else{
+        m_callbacks.erase(iter);
+    }
+
+    //  poll() needs to rebuild its list.
+    wake();
+}
+
+
+bool SerialReactor::dispatch(int fd){
+    while (true){
+        ssize_t bytes = read(fd, m_buffer, sizeof(m_buffer));
+        if (bytes > 0){
+            //  Look it up every time. The callback may have removed another fd.
+            auto iter = m_callbacks.find(fd);
+            if (iter == m_callbacks.end()){
+                return true;
+            }
+            m_dispatching_fd = fd;
+            bool ok = true;
+            try{
+                run_with_catch("SerialReactor::dispatch()", [&]{ iter->second(m_buffer, bytes); });
+            }catch (...){
+                //  Already dumped. Drop only this port so the others keep
+                //  receiving.
+                ok = false;
+            }
+            m_dispatching_fd = -1;
+            if (m_remove_after_dispatch){
+                m_remove_after_dispatch = false;
+                m_callbacks.erase(fd);
+                return true;
+            }
+            if (!ok){
+                return false;
+            }
+            continue;
+        }
+        if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)){
+            return true;
+        }
+        if (bytes < 0 && errno == EINTR){
+            continue;
+        }
+        return false;
+    }
+}
+
+void SerialReactor::thread_loop(){
+#ifdef __linux__
+    struct epoll_event events[16];
+#else
+    std::vector<struct pollfd> fds;
+#endif
+
+    while (!m_exit.load(std::memory_order_acquire)){
+        std::vector<int> ready;
+
+#ifdef __linux__
+        int count = epoll_wait(m_epoll, events, 16, -1);
+        for (int c = 0; c < count; c++){
+            int fd = events[c].data.fd;
+            ready.emplace_back(fd);
+        }
+#else
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            fds.resize(1);
+            fds[0].fd = m_wake_read;
+            fds[0].events = POLLIN;
+            for (const auto& item : m_callbacks){
+                fds.emplace_back();
+                fds.back().fd = item.first;
+                fds.back().events = POLLIN;
+            }
+        }
+        for (struct pollfd& item : fds){
+            item.revents = 0;
+        }
+        poll(fds.data(), fds.size(), -1);
+        for (const struct pollfd& item : fds){
+            if (item.revents != 0){
+                ready.emplace_back(item.fd);
+            }
+        }
+#endif
+
+        std::lock_guard<std::mutex> lg(m_lock);
+        for (int fd : ready){
+            if (fd == m_wake_read){
+                char buffer[64];
+                while (read(m_wake_read, buffer, sizeof(buffer)) > 0){}
+                continue;
+            }
+            if (m_callbacks.find(fd) == m_callbacks.end()){
+                continue;
+            }
+            if (!dispatch(fd)){
+                //  The port is gone (device unplugged, other end closed, etc...)
+                //  or its callback threw.
+                //  Stop watching it so we don't spin on the hangup.
+#ifdef __linux__
+                epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+                m_callbacks.erase(fd);
+            }
+        }
+    }
+}
+
+
+
+}
+
+#endif
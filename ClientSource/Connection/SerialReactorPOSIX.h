@@ -0,0 +1,80 @@
+/*  Serial Reactor for POSIX
+ * 
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ * 
+ *      A single thread that waits on every open serial port at once and
+ *  dispatches received bytes to the owning connection. This replaces one
+ *  spinning receive thread per port.
+ * 
+ *  Linux uses epoll. Other POSIX systems use poll().
+ * 
+ */
+
+#ifndef PokemonAutomation_SerialReactorPOSIX_H
+#define PokemonAutomation_SerialReactorPOSIX_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+namespace PokemonAutomation{
+
+
+class SerialReactor{
+public:
+    using Callback = std::function<void(const void* data, size_t bytes)>;
+
+    static SerialReactor& instance();
+
+    //  Start watching "fd". It must be non-blocking.
+    //  "callback" is called on the reactor thread. If it throws, the exception
+    //  is dumped and "fd" is dropped. Other fds are not affected.
+    //  Safe to call from a callback, except for the callback's own fd.
+    //  Callbacks share one thread and must not block.
+    void add(int fd, Callback callback);
+
+    //  Stop watching "fd". When this returns, the callback for "fd" is not
+    //  running and will not be called again. Safe to call from the callback.
+    void remove(int fd);
+
+
+private:
+    SerialReactor();
+    ~SerialReactor();
+
+    void wake();
+    void thread_loop();
+
+    //  Read everything available on "fd". Returns false if the port is gone
+    //  or its callback threw.
+    bool dispatch(int fd);
+
+
+private:
+    int m_wake_read;
+    int m_wake_write;
+#ifdef __linux__
+    int m_epoll;
+#endif
+
+    std::atomic<bool> m_exit;
+
+    //  Held by the reactor thread while it runs callbacks.
+    std::mutex m_lock;
+    std::map<int, Callback> m_callbacks;
+
+    //  The fd whose callback is running. If that callback removes its own fd,
+    //  the entry can't be erased while it runs. It is erased afterwards.
+    int m_dispatching_fd = -1;
+    bool m_remove_after_dispatch = false;
+
+    char m_buffer[4096];
+    std::thread m_thread;
+};
+
+
+}
+
+#endif
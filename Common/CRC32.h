@@ -18,11 +18,23 @@ uint32_t pabb_crc32_basic(uint32_t crc, const void* data, size_t length);
 uint32_t pabb_crc32_table(uint32_t crc, const void* data, size_t length);
 
 //  SSE4.2
-#if _M_IX86 || _M_X64
+#if _M_IX86 || _M_X64 || __SSE4_2__
+#include <string.h>
 #include <nmmintrin.h>
 #include "Common/Compiler.h"
 PA_FORCE_INLINE uint32_t pabb_crc32_SSE42(uint32_t crc, const void* data, size_t length){
     const char* ptr = (const char*)data;
+#if _M_X64 || __x86_64__
+    uint64_t crc64 = crc;
+    while (length >= sizeof(uint64_t)){
+        uint64_t block;
+        memcpy(&block, ptr, sizeof(uint64_t));
+        crc64 = _mm_crc32_u64(crc64, block);
+        ptr += sizeof(uint64_t);
+        length -= sizeof(uint64_t);
+    }
+    crc = (uint32_t)crc64;
+#endif
     for (size_t c = 0; c < length; c++){
         crc = _mm_crc32_u8(crc, ptr[c]);
     }
@@ -31,7 +43,7 @@ PA_FORCE_INLINE uint32_t pabb_crc32_SSE42(uint32_t crc, const void* data, size_t
 #endif
 
 
-#if _M_IX86 || _M_X64
+#if _M_IX86 || _M_X64 || __SSE4_2__
 #define pabb_crc32      pabb_crc32_SSE42
 #elif __AVR__
 #define pabb_crc32      pabb_crc32_table
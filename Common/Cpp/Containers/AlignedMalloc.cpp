@@ -10,7 +10,11 @@
 #include <string.h>
 #include <stdlib.h>
 #include <new>
+#include <atomic>
+#include <vector>
+#include "Common/Compiler.h"
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
 #include "AlignedMalloc.h"
 
 #define PA_ENABLE_MALLOC_CHECKING
@@ -97,4 +101,228 @@ void check_aligned_ptr(const void* ptr){
 }
 
 
+
+namespace{
+
+//  Size classes are 64 bytes and then 4 steps per power of two.
+//  (64, 80, 96, 112, 128, 160, 192, 224, 256, 320, ...)
+const size_t POOL_MIN_BYTES = 64;
+const size_t POOL_MAX_BYTES = (size_t)16 << 20;
+const size_t POOL_CLASSES = 1 + 4 * (24 - 6);
+
+//  Buffers at least this large bypass the thread cache.
+const size_t THREAD_CACHE_MAX_BLOCK = (size_t)256 << 10;
+const size_t THREAD_CACHE_PER_CLASS = 8;
+
+//  Keep at most this much idle memory in the shared pool.
+const size_t SHARED_POOL_MAX_BYTES = (size_t)64 << 20;
+
+
+size_t pool_class(size_t bytes){
+    if (bytes <= POOL_MIN_BYTES){
+        return 0;
+    }
+    size_t n = bytes - 1;
+    size_t e = 6;
+    while ((n >> (e + 1)) != 0){
+        e++;
+    }
+    return 1 + 4 * (e - 6) + ((n >> (e - 2)) & 3);
+}
+size_t pool_class_bytes(size_t index){
+    if (index == 0){
+        return POOL_MIN_BYTES;
+    }
+    index--;
+    size_t e = 6 + index / 4;
+    return (5 + index % 4) << (e - 2);
+}
+
+
+std::atomic<uint64_t> stat_thread_hits(0);
+std::atomic<uint64_t> stat_shared_hits(0);
+std::atomic<uint64_t> stat_system_mallocs(0);
+std::atomic<uint64_t> stat_system_frees(0);
+std::atomic<uint64_t> stat_cached_bytes(0);
+
+
+void* system_malloc(size_t class_bytes){
+    stat_system_mallocs.fetch_add(1, std::memory_order_relaxed);
+    return aligned_malloc(class_bytes, PA_ALIGNMENT);
+}
+void system_free(void* ptr){
+    stat_system_frees.fetch_add(1, std::memory_order_relaxed);
+    aligned_free(ptr);
+}
+
+//  A pooled buffer is allocated at the size of its class, but the caller only
+//  asked for "bytes". Move the top canary to right after the requested length
+//  so that overruns into the rest of the class are still caught.
+//  (aligned_malloc() always leaves at least one word after the class size.)
+void* set_requested_size(void* ptr, size_t bytes){
+#ifdef PA_ENABLE_MALLOC_CHECKING
+    size_t* ret = (size_t*)ptr;
+    ret[-2] = bytes;
+    memcpy((char*)ret + bytes, &BUFFER_CHECK_TOP, sizeof(size_t));
+#else
+    (void)bytes;
+#endif
+    return ptr;
+}
+
+
+class SharedPool{
+public:
+    void* pop(size_t index){
+        SpinLockGuard lg(m_lock, "SharedPool::pop()");
+        std::vector<void*>& bin = m_bins[index];
+        if (bin.empty()){
+            return nullptr;
+        }
+        void* ptr = bin.back();
+        bin.pop_back();
+        m_bytes -= pool_class_bytes(index);
+        stat_cached_bytes.fetch_sub(pool_class_bytes(index), std::memory_order_relaxed);
+        return ptr;
+    }
+    void push(size_t index, void* ptr){
+        size_t bytes = pool_class_bytes(index);
+        {
+            SpinLockGuard lg(m_lock, "SharedPool::push()");
+            if (m_bytes + bytes <= SHARED_POOL_MAX_BYTES){
+                try{
+                    m_bins[index].emplace_back(ptr);
+                    m_bytes += bytes;
+                    stat_cached_bytes.fetch_add(bytes, std::memory_order_relaxed);
+                    return;
+                }catch (...){}
+            }
+        }
+        system_free(ptr);
+    }
+
+private:
+    SpinLock m_lock;
+    size_t m_bytes = 0;
+    std::vector<void*> m_bins[POOL_CLASSES];
+};
+
+//  Never destroyed. Buffers owned by statics can be freed after everything
+//  else has been torn down.
+SharedPool& shared_pool(){
+    static SharedPool* pool = new SharedPool();
+    return *pool;
+}
+
+
+thread_local bool thread_cache_destroyed = false;
+
+class ThreadCache{
+public:
+    ~ThreadCache(){
+        SharedPool& shared = shared_pool();
+        for (size_t c = 0; c < POOL_CLASSES; c++){
+            for (void* ptr : m_bins[c]){
+                stat_cached_bytes.fetch_sub(pool_class_bytes(c), std::memory_order_relaxed);
+                shared.push(c, ptr);
+            }
+        }
+        thread_cache_destroyed = true;
+    }
+
+    void* pop(size_t index){
+        std::vector<void*>& bin = m_bins[index];
+        if (bin.empty()){
+            return nullptr;
+        }
+        void* ptr = bin.back();
+        bin.pop_back();
+        stat_cached_bytes.fetch_sub(pool_class_bytes(index), std::memory_order_relaxed);
+        return ptr;
+    }
+    bool push(size_t index, void* ptr){
+        std::vector<void*>& bin = m_bins[index];
+        if (bin.size() >= THREAD_CACHE_PER_CLASS){
+            return false;
+        }
+        if (bin.capacity() == 0){
+            bin.reserve(THREAD_CACHE_PER_CLASS);
+        }
+        bin.emplace_back(ptr);
+        stat_cached_bytes.fetch_add(pool_class_bytes(index), std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::vector<void*> m_bins[POOL_CLASSES];
+};
+
+ThreadCache* thread_cache(){
+    if (thread_cache_destroyed){
+        return nullptr;
+    }
+    thread_local ThreadCache cache;
+    return &cache;
+}
+
+}
+
+
+void* aligned_pool_malloc(size_t bytes){
+    if (bytes > POOL_MAX_BYTES){
+        return system_malloc(bytes);
+    }
+    size_t index = pool_class(bytes);
+    size_t class_bytes = pool_class_bytes(index);
+
+    if (class_bytes < THREAD_CACHE_MAX_BLOCK){
+        ThreadCache* cache = thread_cache();
+        if (cache != nullptr){
+            void* ptr = cache->pop(index);
+            if (ptr != nullptr){
+                stat_thread_hits.fetch_add(1, std::memory_order_relaxed);
+                return set_requested_size(ptr, bytes);
+            }
+        }
+    }
+
+    void* ptr = shared_pool().pop(index);
+    if (ptr != nullptr){
+        stat_shared_hits.fetch_add(1, std::memory_order_relaxed);
+        return set_requested_size(ptr, bytes);
+    }
+
+    return set_requested_size(system_malloc(class_bytes), bytes);
+}
+void aligned_pool_free(void* ptr, size_t bytes){
+    if (ptr == nullptr){
+        return;
+    }
+    if (bytes > POOL_MAX_BYTES){
+        system_free(ptr);
+        return;
+    }
+    check_aligned_ptr(ptr);
+
+    size_t index = pool_class(bytes);
+    if (pool_class_bytes(index) < THREAD_CACHE_MAX_BLOCK){
+        ThreadCache* cache = thread_cache();
+        if (cache != nullptr && cache->push(index, ptr)){
+            return;
+        }
+    }
+    shared_pool().push(index, ptr);
+}
+
+AlignedPoolStats aligned_pool_stats(){
+    AlignedPoolStats stats;
+    stats.thread_hits = stat_thread_hits.load(std::memory_order_relaxed);
+    stats.shared_hits = stat_shared_hits.load(std::memory_order_relaxed);
+    stats.system_mallocs = stat_system_mallocs.load(std::memory_order_relaxed);
+    stats.system_frees = stat_system_frees.load(std::memory_order_relaxed);
+    stats.cached_bytes = stat_cached_bytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+
 }
@@ -8,6 +8,7 @@
 #define PokemonAutomation_AlignedMalloc_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 namespace PokemonAutomation{
 
@@ -17,5 +18,37 @@ void aligned_free(void* ptr);
 void check_aligned_ptr(const void *ptr);
 
 
+
+//  Pooled version of the above for buffers that are allocated and freed over
+//  and over with the same handful of sizes. (images, binary matrices)
+//
+//  Sizes are rounded up to a size class (at most 25% larger). Freed buffers
+//  are kept in a small per-thread cache and a shared pool instead of being
+//  returned to the system. Large buffers skip the thread cache since they
+//  are usually freed on a different thread than the one that made them.
+//
+//  The returned buffer is uninitialized and aligned to PA_ALIGNMENT.
+//  "bytes" must be the same for the malloc and the free.
+void* aligned_pool_malloc(size_t bytes);
+void aligned_pool_free(void* ptr, size_t bytes);
+
+
+struct AlignedPoolStats{
+    //  Allocations served from the thread cache or the shared pool.
+    uint64_t thread_hits = 0;
+    uint64_t shared_hits = 0;
+
+    //  Allocations that had to go to the system.
+    uint64_t system_mallocs = 0;
+    uint64_t system_frees = 0;
+
+    //  Bytes currently sitting idle in the pools.
+    uint64_t cached_bytes = 0;
+
+    uint64_t allocations() const{ return thread_hits + shared_hits + system_mallocs; }
+};
+AlignedPoolStats aligned_pool_stats();
+
+
 }
 #endif
@@ -12,6 +12,11 @@
 namespace PokemonAutomation{
 
 
+enum AlignedVectorUninitialized{
+    UNINITIALIZED_TOKEN
+};
+
+
 template <typename Object>
 class AlignedVector{
 public:
@@ -25,6 +30,10 @@ public:
     AlignedVector();
     AlignedVector(size_t items);
 
+    //  Skip construction of the elements. Only for trivially destructible
+    //  types. The caller must construct or overwrite every element.
+    AlignedVector(size_t items, AlignedVectorUninitialized);
+
 public:
     size_t empty() const{ return m_size == 0; }
     size_t size() const{ return m_size; }
@@ -22,7 +22,7 @@ namespace PokemonAutomation{
 template <typename Object>
 AlignedVector<Object>::~AlignedVector(){
     clear();
-    aligned_free(m_ptr);
+    aligned_pool_free(m_ptr, m_capacity * sizeof(Object));
     m_capacity = 0;
 }
 template <typename Object>
@@ -38,7 +38,7 @@ AlignedVector<Object>::AlignedVector(AlignedVector&& x) noexcept
 template <typename Object>
 void AlignedVector<Object>::operator=(AlignedVector&& x) noexcept{
     clear();
-    aligned_free(m_ptr);
+    aligned_pool_free(m_ptr, m_capacity * sizeof(Object));
     m_ptr = x.m_ptr;
     m_size = x.m_size;
     m_capacity = x.m_capacity;
@@ -59,7 +59,7 @@ AlignedVector<Object>::AlignedVector(const AlignedVector& x)
             break;
         }
     }
-    m_ptr = (Object*)aligned_malloc(m_capacity * sizeof(Object), 64);
+    m_ptr = (Object*)aligned_pool_malloc(m_capacity * sizeof(Object));
     if (m_ptr == nullptr){
         throw std::bad_alloc();
     }
@@ -78,7 +78,7 @@ AlignedVector<Object>::AlignedVector(const AlignedVector& x)
         }
     }catch (...){
         clear();
-        aligned_free(m_ptr);
+        aligned_pool_free(m_ptr, m_capacity * sizeof(Object));
         throw;
     }
 }
@@ -95,7 +95,7 @@ void AlignedVector<Object>::operator=(const AlignedVector& x){
 
 template <typename Object>
 AlignedVector<Object>::AlignedVector(size_t items){
-    m_ptr = (Object*)aligned_malloc(items * sizeof(Object), PA_ALIGNMENT);
+    m_ptr = (Object*)aligned_pool_malloc(items * sizeof(Object));
     if (m_ptr == nullptr){
         throw std::bad_alloc();
     }
@@ -114,11 +114,25 @@ AlignedVector<Object>::AlignedVector(size_t items){
         }
     }catch (...){
         clear();
-        aligned_free(m_ptr);
+        aligned_pool_free(m_ptr, m_capacity * sizeof(Object));
         throw;
     }
 }
 
+template <typename Object>
+AlignedVector<Object>::AlignedVector(size_t items, AlignedVectorUninitialized){
+    static_assert(
+        std::is_trivially_destructible<Object>::value,
+        "Uninitialized construction requires a trivially destructible type."
+    );
+    m_ptr = (Object*)aligned_pool_malloc(items * sizeof(Object));
+    if (m_ptr == nullptr){
+        throw std::bad_alloc();
+    }
+    m_capacity = items;
+    m_size = items;
+}
+
 template <typename Object>
 template <class... Args>
 void AlignedVector<Object>::emplace_back(Args&&... args){
@@ -146,7 +160,7 @@ void AlignedVector<Object>::clear(){
 template <typename Object>
 PA_NO_INLINE void AlignedVector<Object>::expand(){
     size_t size = m_capacity == 0 ? 1 : m_capacity * 2;
-    Object* ptr = (Object*)aligned_malloc(size * sizeof(Object), PA_ALIGNMENT);
+    Object* ptr = (Object*)aligned_pool_malloc(size * sizeof(Object));
     if (ptr == nullptr){
         throw std::bad_alloc();
     }
@@ -158,7 +172,7 @@ PA_NO_INLINE void AlignedVector<Object>::expand(){
             m_ptr[c].~Object();
         }
     }
-    aligned_free(m_ptr);
+    aligned_pool_free(m_ptr, m_capacity * sizeof(Object));
     m_ptr = ptr;
     m_capacity = size;
 }
@@ -0,0 +1,199 @@
+/*  Latency Tracer
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "LatencyTracer.h"
+
+namespace PokemonAutomation{
+
+
+
+struct LatencyTracer::ThreadBuffer{
+    //  Only contended when dumping.
+    mutable SpinLock lock;
+    uint64_t thread_index;
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+
+    ThreadBuffer(uint64_t p_thread_index)
+        : thread_index(p_thread_index)
+        , events(EVENTS_PER_THREAD)
+    {}
+
+    void push(const Event& event){
+        SpinLockGuard lg(lock, "LatencyTracer::ThreadBuffer::push()");
+        events[next] = event;
+        next++;
+        if (next == events.size()){
+            next = 0;
+            wrapped = true;
+        }
+    }
+    void clear(){
+        SpinLockGuard lg(lock, "LatencyTracer::ThreadBuffer::clear()");
+        next = 0;
+        wrapped = false;
+    }
+    //  Returns the events in chronological order of recording.
+    std::vector<Event> copy() const{
+        SpinLockGuard lg(lock, "LatencyTracer::ThreadBuffer::copy()");
+        std::vector<Event> ret;
+        if (wrapped){
+            ret.insert(ret.end(), events.begin() + next, events.end());
+        }
+        ret.insert(ret.end(), events.begin(), events.begin() + next);
+        return ret;
+    }
+};
+
+
+
+//  Returns the buffer to the tracer when the thread exits.
+struct LatencyTracer::ThreadHandle{
+    std::shared_ptr<ThreadBuffer> buffer;
+
+    ~ThreadHandle(){
+        if (buffer){
+            LatencyTracer::instance().release_buffer(std::move(buffer));
+        }
+    }
+};
+
+
+
+LatencyTracer& LatencyTracer::instance(){
+    static LatencyTracer tracer;
+    return tracer;
+}
+LatencyTracer::LatencyTracer()
+    : m_enabled(false)
+    , m_last_scope(0)
+    , m_epoch(current_time())
+{}
+void LatencyTracer::set_enabled(bool enabled){
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+LatencyTracer::ThreadBuffer& LatencyTracer::thread_buffer(){
+    thread_local ThreadHandle handle;
+    if (!handle.buffer){
+        handle.buffer = acquire_buffer();
+    }
+    return *handle.buffer;
+}
+std::shared_ptr<LatencyTracer::ThreadBuffer> LatencyTracer::acquire_buffer(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    if (!m_free_buffers.empty()){
+        std::shared_ptr<ThreadBuffer> buffer = std::move(m_free_buffers.back());
+        m_free_buffers.pop_back();
+        return buffer;
+    }
+    //  The registry keeps a reference so the events outlive the thread.
+    std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>(m_buffers.size() + 1);
+    m_buffers.emplace_back(buffer);
+    return buffer;
+}
+void LatencyTracer::release_buffer(std::shared_ptr<ThreadBuffer> buffer){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_free_buffers.emplace_back(std::move(buffer));
+}
+void LatencyTracer::record(const Event& event){
+    thread_buffer().push(event);
+}
+
+void LatencyTracer::clear(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    for (const std::shared_ptr<ThreadBuffer>& buffer : m_buffers){
+        buffer->clear();
+    }
+}
+
+JsonObject LatencyTracer::to_chrome_trace() const{
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        buffers = m_buffers;
+    }
+
+    JsonArray trace_events;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers){
+        std::vector<Event> events = buffer->copy();
+        if (events.empty()){
+            continue;
+        }
+
+        JsonObject thread_name;
+        thread_name["name"] = "thread_name";
+        thread_name["ph"] = "M";
+        thread_name["pid"] = 1;
+        thread_name["tid"] = buffer->thread_index;
+        JsonObject thread_args;
+        thread_args["name"] = "Thread " + std::to_string(buffer->thread_index);
+        thread_name["args"] = std::move(thread_args);
+        trace_events.push_back(std::move(thread_name));
+
+        for (const Event& event : events){
+            JsonObject obj;
+            obj["name"] = event.name;
+            obj["cat"] = event.category;
+            obj["ph"] = std::string(1, (char)event.phase);
+            obj["ts"] = std::chrono::duration_cast<std::chrono::microseconds>(event.timestamp - m_epoch).count();
+            obj["pid"] = 1;
+            obj["tid"] = buffer->thread_index;
+            switch (event.phase){
+            case Phase::COMPLETE:
+                obj["dur"] = event.duration_us;
+                break;
+            case Phase::INSTANT:
+                obj["s"] = "t";
+                break;
+            case Phase::ASYNC_BEGIN:
+            case Phase::ASYNC_INSTANT:
+            case Phase::ASYNC_END:
+                obj["id"] = std::to_string(event.scope) + ":" + std::to_string(event.id);
+                break;
+            }
+            JsonObject args;
+            args["seqnum"] = event.id;
+            if (event.latency_us >= 0){
+                args["latency_us"] = event.latency_us;
+            }
+            obj["args"] = std::move(args);
+            trace_events.push_back(std::move(obj));
+        }
+    }
+
+    JsonObject root;
+    root["displayTimeUnit"] = "ms";
+    root["traceEvents"] = std::move(trace_events);
+    return root;
+}
+bool LatencyTracer::dump(const std::string& filename) const{
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        bool empty = std::all_of(
+            m_buffers.begin(), m_buffers.end(),
+            [](const std::shared_ptr<ThreadBuffer>& buffer){
+                SpinLockGuard lg1(buffer->lock, "LatencyTracer::dump()");
+                return buffer->next == 0 && !buffer->wrapped;
+            }
+        );
+        if (empty){
+            return false;
+        }
+    }
+    to_chrome_trace().dump(filename, -1);
+    return true;
+}
+
+
+
+}
@@ -0,0 +1,188 @@
+/*  Latency Tracer
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Low-overhead event tracing for the capture -> inference -> command path.
+ *
+ *  Every thread that records an event gets its own fixed-size ring buffer so
+ *  that recording never contends with other producers. When tracing is
+ *  disabled, recording an event is a single relaxed atomic load.
+ *
+ *  When a thread exits, its buffer is handed to the next new thread. So there
+ *  are only as many buffers as threads that were alive at the same time.
+ *
+ *  The buffers can be dumped at any time as a Chrome "trace_event" JSON file.
+ *  (open with chrome://tracing or https://ui.perfetto.dev)
+ *
+ */
+
+#ifndef PokemonAutomation_LatencyTracer_H
+#define PokemonAutomation_LatencyTracer_H
+
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include "Time.h"
+
+namespace PokemonAutomation{
+
+class JsonObject;
+
+//  Categories. These must be string literals since only the pointer is stored.
+#define PA_TRACE_VIDEO      "video"
+#define PA_TRACE_INFERENCE  "inference"
+#define PA_TRACE_COMMAND    "command"
+
+
+class LatencyTracer{
+public:
+    //  Mirrors the "ph" field of the Chrome trace format.
+    enum class Phase : char{
+        COMPLETE        = 'X',
+        INSTANT         = 'i',
+        ASYNC_BEGIN     = 'b',
+        ASYNC_INSTANT   = 'n',
+        ASYNC_END       = 'e',
+    };
+
+    struct Event{
+        //  Both of these must point to static strings.
+        const char* category;
+        const char* name;
+
+        WallClock timestamp;
+        uint32_t duration_us;
+        Phase phase;
+
+        //  The seqnum of the frame or command this event belongs to.
+        uint64_t id;
+
+        //  Async events only match if they are in the same scope. (0 for none)
+        uint32_t scope;
+
+        //  Optional latency to attach. (e.g. age of the frame when it was processed)
+        //  Negative means not present.
+        int64_t latency_us;
+    };
+
+public:
+    static LatencyTracer& instance();
+
+    bool enabled() const{
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+    void set_enabled(bool enabled);
+
+    //  Number of events each thread will hold before overwriting the oldest.
+    static const size_t EVENTS_PER_THREAD = 8192;
+
+
+public:
+    //  For the functions below, a timestamp of "WallClock::min()" means now.
+    //  The clock is only read if tracing is enabled.
+
+    void instant(
+        const char* category, const char* name,
+        uint64_t id, WallClock timestamp = WallClock::min(),
+        int64_t latency_us = -1
+    ){
+        if (!enabled()){
+            return;
+        }
+        record(Event{category, name, resolve(timestamp), 0, Phase::INSTANT, id, 0, latency_us});
+    }
+    void complete(
+        const char* category, const char* name,
+        uint64_t id, WallClock start, WallClock end,
+        int64_t latency_us = -1
+    ){
+        if (!enabled()){
+            return;
+        }
+        uint32_t duration = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        record(Event{category, name, start, duration, Phase::COMPLETE, id, 0, latency_us});
+    }
+
+    //  Async events are matched across threads by (category, name, scope, id).
+    //  Use these for things like commands which are issued on one thread and
+    //  acked on another. Each source of ids (e.g. each connection) should get
+    //  its own scope from "new_scope()".
+    uint32_t new_scope(){
+        return m_last_scope.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    void async_begin(
+        const char* category, const char* name,
+        uint32_t scope, uint64_t id, WallClock timestamp = WallClock::min()
+    ){
+        if (!enabled()){
+            return;
+        }
+        record(Event{category, name, resolve(timestamp), 0, Phase::ASYNC_BEGIN, id, scope, -1});
+    }
+    void async_instant(
+        const char* category, const char* name,
+        uint32_t scope, uint64_t id, WallClock timestamp = WallClock::min(),
+        int64_t latency_us = -1
+    ){
+        if (!enabled()){
+            return;
+        }
+        record(Event{category, name, resolve(timestamp), 0, Phase::ASYNC_INSTANT, id, scope, latency_us});
+    }
+    void async_end(
+        const char* category, const char* name,
+        uint32_t scope, uint64_t id, WallClock timestamp = WallClock::min(),
+        int64_t latency_us = -1
+    ){
+        if (!enabled()){
+            return;
+        }
+        record(Event{category, name, resolve(timestamp), 0, Phase::ASYNC_END, id, scope, latency_us});
+    }
+
+
+public:
+    //  Clear all events in all threads.
+    void clear();
+
+    //  Returns the Chrome trace JSON for all events currently in the buffers.
+    JsonObject to_chrome_trace() const;
+
+    //  Write the trace to a file. Returns false if there was nothing to write.
+    //  Throws FileException if the file cannot be written.
+    bool dump(const std::string& filename) const;
+
+
+private:
+    struct ThreadBuffer;
+    struct ThreadHandle;
+
+    LatencyTracer();
+    static WallClock resolve(WallClock timestamp){
+        return timestamp == WallClock::min() ? current_time() : timestamp;
+    }
+    void record(const Event& event);
+    ThreadBuffer& thread_buffer();
+    std::shared_ptr<ThreadBuffer> acquire_buffer();
+    void release_buffer(std::shared_ptr<ThreadBuffer> buffer);
+
+private:
+    std::atomic<bool> m_enabled;
+    std::atomic<uint32_t> m_last_scope;
+    WallClock m_epoch;
+
+    mutable std::mutex m_lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> m_buffers;
+
+    //  Buffers of threads that have exited. Their events are kept until the
+    //  next thread that takes the buffer overwrites them.
+    std::vector<std::shared_ptr<ThreadBuffer>> m_free_buffers;
+};
+
+
+
+}
+#endif
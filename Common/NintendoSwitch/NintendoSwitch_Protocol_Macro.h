@@ -0,0 +1,94 @@
+/*  Controller Macros
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      A macro is a short bytecode program of scalar button presses that the
+ *  device runs as a single command. This replaces a long stream of individual
+ *  ssf commands (one packet + ack + finish each) with a few load packets and
+ *  one command.
+ *
+ *  The program is written into a staging buffer on the device with
+ *  PABB_MSG_REQUEST_MACRO_LOAD. Loads are plain offset writes so they are
+ *  idempotent under retransmission. PABB_MSG_COMMAND_MACRO_RUN then runs the
+ *  first "length" bytes of the buffer if their CRC32C matches.
+ *
+ *  Every instruction has the same timing semantics as the ssf command it
+ *  replaces. Each run starts with the timing registers at their defaults:
+ *  delay = 0, hold = 5, cool = 3.
+ *
+ *      0x00 - 0x07     Scroll in direction (low bits).             ssf_issue_scroll()
+ *      0x10 - 0x17     Press dpad position (low bits).             ssf_press_dpad()
+ *      0x20 - 0x2f     Press button (1 << low bits).               ssf_press_button()
+ *      0x30 d h c      Set delay, hold and cool.
+ *      0x31 d          Set delay only.
+ *      0x32 lo hi      Do nothing for a 16-bit number of ticks.    ssf_do_nothing()
+ *      0x33 x y        Press left joystick.                        ssf_press_joystick()
+ *      0x34 x y        Press right joystick.                       ssf_press_joystick()
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_Protocol_Macro_H
+#define PokemonAutomation_NintendoSwitch_Protocol_Macro_H
+
+#ifdef __AVR__
+#include "NativePrograms/NintendoSwitch/Framework/Master.h"
+#endif
+#include "Common/Microcontroller/MessageProtocol.h"
+#include "Common/NintendoSwitch/NintendoSwitch_ControllerDefs.h"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+//  Protocols
+#if _WIN32
+#pragma pack(push, 1)
+#define PABB_PACK
+#else
+#define PABB_PACK   __attribute__((packed))
+#endif
+////////////////////////////////////////////////////////////////////////////////
+
+//  Devices reporting this protocol version (or a later minor version) support macros.
+#define PABB_MACRO_PROTOCOL_VERSION             2021052613
+
+#define PABB_MACRO_BUFFER_SIZE                  128
+
+#define PABB_MACRO_OP_SCROLL                    0x00
+#define PABB_MACRO_OP_PRESS_DPAD                0x10
+#define PABB_MACRO_OP_PRESS_BUTTON              0x20
+#define PABB_MACRO_OP_SET_TIMING                0x30
+#define PABB_MACRO_OP_SET_DELAY                 0x31
+#define PABB_MACRO_OP_WAIT                      0x32
+#define PABB_MACRO_OP_PRESS_JOYSTICK_L          0x33
+#define PABB_MACRO_OP_PRESS_JOYSTICK_R          0x34
+
+#define PABB_MACRO_DEFAULT_DELAY                0
+#define PABB_MACRO_DEFAULT_HOLD                 5
+#define PABB_MACRO_DEFAULT_COOL                 3
+
+
+#define PABB_MSG_REQUEST_MACRO_LOAD             0x48
+#define PABB_MACRO_LOAD_BYTES                   7
+typedef struct{
+    seqnum_t seqnum;
+    uint8_t offset;
+    uint8_t data[PABB_MACRO_LOAD_BYTES];
+} PABB_PACK pabb_macro_load;
+
+#define PABB_MSG_COMMAND_MACRO_RUN              0xa3
+typedef struct{
+    seqnum_t seqnum;
+    uint8_t length;
+    uint32_t crc32;
+} PABB_PACK pabb_macro_run;
+
+////////////////////////////////////////////////////////////////////////////////
+#if _WIN32
+#pragma pack(pop)
+#endif
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+#endif
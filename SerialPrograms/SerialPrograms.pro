@@ -70,6 +70,8 @@ SOURCES += \
     ../ClientSource/Connection/MessageLogger.cpp \
     ../ClientSource/Connection/PABotBase.cpp \
     ../ClientSource/Connection/PABotBaseConnection.cpp \
+    ../ClientSource/Connection/PtyLoopbackPOSIX.cpp \
+    ../ClientSource/Connection/SerialReactorPOSIX.cpp \
     ../ClientSource/Libraries/Logging.cpp \
     ../ClientSource/Libraries/MessageConverter.cpp \
     ../Common/CRC32.cpp \
@@ -89,6 +91,7 @@ SOURCES += \
     ../Common/Cpp/Json/JsonObject.cpp \
     ../Common/Cpp/Json/JsonTools.cpp \
     ../Common/Cpp/Json/JsonValue.cpp \
+    ../Common/Cpp/LatencyTracer.cpp \
     ../Common/Cpp/LifetimeSanitizer.cpp \
     ../Common/Cpp/Options/BatchOption.cpp \
     ../Common/Cpp/Options/BooleanCheckBoxOption.cpp \
@@ -163,6 +166,7 @@ SOURCES += \
     Source/CommonFramework/CrashDump.cpp \
     Source/CommonFramework/Environment/Environment.cpp \
     Source/CommonFramework/Environment/HardwareValidation.cpp \
+    Source/CommonFramework/Environment/KernelCalibration.cpp \
     Source/CommonFramework/GlobalSettingsPanel.cpp \
     Source/CommonFramework/Globals.cpp \
     Source/CommonFramework/ImageMatch/CroppedImageDictionaryMatcher.cpp \
@@ -171,6 +175,7 @@ SOURCES += \
     Source/CommonFramework/ImageMatch/FilterToAlpha.cpp \
     Source/CommonFramework/ImageMatch/ImageCropper.cpp \
     Source/CommonFramework/ImageMatch/ImageDiff.cpp \
+    Source/CommonFramework/ImageMatch/ImageMatchCascade.cpp \
     Source/CommonFramework/ImageMatch/ImageMatchOption.cpp \
     Source/CommonFramework/ImageMatch/ImageMatchResult.cpp \
     Source/CommonFramework/ImageMatch/SilhouetteDictionaryMatcher.cpp \
@@ -184,6 +189,8 @@ SOURCES += \
     Source/CommonFramework/ImageTools/ImageGradient.cpp \
     Source/CommonFramework/ImageTools/ImageManip.cpp \
     Source/CommonFramework/ImageTools/ImageStats.cpp \
+    Source/CommonFramework/ImageTools/RegionSignature.cpp \
+    Source/CommonFramework/ImageTools/SnapshotStats.cpp \
     Source/CommonFramework/ImageTools/SolidColorTest.cpp \
     Source/CommonFramework/ImageTools/WaterfillUtilities.cpp \
     Source/CommonFramework/ImageTypes/BinaryImage.cpp \
@@ -223,12 +230,15 @@ SOURCES += \
     Source/CommonFramework/OCR/OCR_LargeDictionaryMatcher.cpp \
     Source/CommonFramework/OCR/OCR_NumberReader.cpp \
     Source/CommonFramework/OCR/OCR_RawOCR.cpp \
+    Source/CommonFramework/OCR/OCR_ResultCache.cpp \
     Source/CommonFramework/OCR/OCR_Routines.cpp \
     Source/CommonFramework/OCR/OCR_SmallDictionaryMatcher.cpp \
     Source/CommonFramework/OCR/OCR_StringMatchResult.cpp \
     Source/CommonFramework/OCR/OCR_StringNormalization.cpp \
+    Source/CommonFramework/OCR/OCR_TesseractPool.cpp \
     Source/CommonFramework/OCR/OCR_TextMatcher.cpp \
     Source/CommonFramework/OCR/OCR_TrainingTools.cpp \
+    Source/CommonFramework/Options/Environment/KernelSelectionOption.cpp \
     Source/CommonFramework/Options/Environment/ProcessorLevelOption.cpp \
     Source/CommonFramework/Options/Environment/ThemeSelectorOption.cpp \
     Source/CommonFramework/Options/LabelCellOption.cpp \
@@ -250,6 +260,7 @@ SOURCES += \
     Source/CommonFramework/Panels/UI/SettingsPanelWidget.cpp \
     Source/CommonFramework/PersistentSettings.cpp \
     Source/CommonFramework/ProgramSession.cpp \
+    Source/CommonFramework/Resources/ResourceWarmup.cpp \
     Source/CommonFramework/Resources/SpriteDatabase.cpp \
     Source/CommonFramework/Tools/BlackBorderCheck.cpp \
     Source/CommonFramework/Tools/BotBaseHandle.cpp \
@@ -267,8 +278,13 @@ SOURCES += \
     Source/CommonFramework/VideoPipeline/Backends/CameraImplementations.cpp \
     Source/CommonFramework/VideoPipeline/Backends/CameraWidgetQt5.cpp \
     Source/CommonFramework/VideoPipeline/Backends/CameraWidgetQt6.cpp \
+    Source/CommonFramework/VideoPipeline/Backends/CaptureHubQt6.cpp \
     Source/CommonFramework/VideoPipeline/Backends/VideoToolsQt5.cpp \
+    Source/CommonFramework/VideoPipeline/Backends/VideoToolsQt6.cpp \
+    Source/CommonFramework/VideoPipeline/BufferPoolStats.cpp \
     Source/CommonFramework/VideoPipeline/CameraOption.cpp \
+    Source/CommonFramework/VideoPipeline/FrameHistoryOption.cpp \
+    Source/CommonFramework/VideoPipeline/FrameHistoryRecorder.cpp \
     Source/CommonFramework/VideoPipeline/ThreadUtilizationStats.cpp \
     Source/CommonFramework/VideoPipeline/UI/CameraSelectorWidget.cpp \
     Source/CommonFramework/VideoPipeline/UI/VideoDisplayWidget.cpp \
@@ -321,6 +337,10 @@ SOURCES += \
     Source/Kernels/ImageFilters/Kernels_ImageFilter_Basic_x64_AVX2.cpp \
     Source/Kernels/ImageFilters/Kernels_ImageFilter_Basic_x64_AVX512.cpp \
     Source/Kernels/ImageFilters/Kernels_ImageFilter_Basic_x64_SSE42.cpp \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient.cpp \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient_Default.cpp \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient_x64_AVX2.cpp \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient_x64_SSE41.cpp \
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.cpp \
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness_Default.cpp \
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness_arm64_NEON.cpp \
@@ -337,6 +357,10 @@ SOURCES += \
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX2.cpp \
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_AVX512.cpp \
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr_x64_SSE41.cpp \
+    Source/Kernels/ImageStats/Kernels_ImageScaledDeviation.cpp \
+    Source/Kernels/ImageStats/Kernels_ImageScaledDeviation_Default.cpp \
+    Source/Kernels/ImageStats/Kernels_ImageScaledDeviation_x64_AVX2.cpp \
+    Source/Kernels/ImageStats/Kernels_ImageScaledDeviation_x64_SSE41.cpp \
     Source/Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch.cpp \
     Source/Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch_Core_Default.cpp \
     Source/Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch_Core_x86_AVX2.cpp \
@@ -358,6 +382,7 @@ SOURCES += \
     Source/Kernels/Waterfill/Kernels_Waterfill_Session.cpp \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Device.cpp \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_DigitEntry.cpp \
+    Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Macro.cpp \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.cpp \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Routines.cpp \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_ScalarButtons.cpp \
@@ -495,6 +520,7 @@ SOURCES += \
     Source/PokemonHome/PokemonHome_Panels.cpp \
     Source/PokemonHome/PokemonHome_Settings.cpp \
     Source/PokemonHome/Programs/PokemonHome_BoxSorting.cpp \
+    Source/PokemonHome/Programs/PokemonHome_BoxSortingPlanner.cpp \
     Source/PokemonHome/Programs/PokemonHome_GenerateNameOCR.cpp \
     Source/PokemonHome/Programs/PokemonHome_PageSwap.cpp \
     Source/PokemonLA/Inference/Battles/PokemonLA_BattleMenuDetector.cpp \
@@ -816,6 +842,7 @@ SOURCES += \
     Source/PokemonSwSh/Programs/QoLMacros/PokemonSwSh_FriendSearchDisconnect.cpp \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_BasicRNG.cpp \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_CramomaticRNG.cpp \
+    Source/PokemonSwSh/Programs/RNG/PokemonSwSh_LastBitSearch.cpp \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_Seedfinder.cpp \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_Xoroshiro128Plus.cpp \
     Source/PokemonSwSh/Programs/ShinyHuntAutonomous/PokemonSwSh_ShinyHuntAutonomous-BerryTree.cpp \
@@ -846,7 +873,9 @@ SOURCES += \
     Source/Tests/CommandLineTests.cpp \
     Source/Tests/CommonFramework_Tests.cpp \
     Source/Tests/Kernels_Tests.cpp \
+    Source/Tests/NintendoSwitch_DeviceEmulator.cpp \
     Source/Tests/NintendoSwitch_Tests.cpp \
+    Source/Tests/PokemonHome_Tests.cpp \
     Source/Tests/PokemonLA_Tests.cpp \
     Source/Tests/PokemonSV_Tests.cpp \
     Source/Tests/PokemonSwSh_Tests.cpp \
@@ -863,9 +892,11 @@ HEADERS += \
     ../ClientSource/Connection/MessageSniffer.h \
     ../ClientSource/Connection/PABotBase.h \
     ../ClientSource/Connection/PABotBaseConnection.h \
+    ../ClientSource/Connection/PtyLoopbackPOSIX.h \
     ../ClientSource/Connection/SerialConnection.h \
     ../ClientSource/Connection/SerialConnectionPOSIX.h \
     ../ClientSource/Connection/SerialConnectionWinAPI.h \
+    ../ClientSource/Connection/SerialReactorPOSIX.h \
     ../ClientSource/Connection/StreamInterface.h \
     ../ClientSource/Libraries/Logging.h \
     ../ClientSource/Libraries/MessageConverter.h \
@@ -903,6 +934,7 @@ HEADERS += \
     ../Common/Cpp/Json/JsonObject.h \
     ../Common/Cpp/Json/JsonTools.h \
     ../Common/Cpp/Json/JsonValue.h \
+    ../Common/Cpp/LatencyTracer.h \
     ../Common/Cpp/LifetimeSanitizer.h \
     ../Common/Cpp/Options/BatchOption.h \
     ../Common/Cpp/Options/BooleanCheckBoxOption.h \
@@ -934,6 +966,7 @@ HEADERS += \
     ../Common/Microcontroller/MessageProtocol.h \
     ../Common/NintendoSwitch/NintendoSwitch_ControllerDefs.h \
     ../Common/NintendoSwitch/NintendoSwitch_Protocol_DigitEntry.h \
+    ../Common/NintendoSwitch/NintendoSwitch_Protocol_Macro.h \
     ../Common/NintendoSwitch/NintendoSwitch_Protocol_PushButtons.h \
     ../Common/NintendoSwitch/NintendoSwitch_Protocol_Routines.h \
     ../Common/NintendoSwitch/NintendoSwitch_Protocol_ScalarButtons.h \
@@ -1014,6 +1047,7 @@ HEADERS += \
     Source/CommonFramework/Environment/HardwareValidation.h \
     Source/CommonFramework/Environment/HardwareValidation_arm64.tpp \
     Source/CommonFramework/Environment/HardwareValidation_x86.tpp \
+    Source/CommonFramework/Environment/KernelCalibration.h \
     Source/CommonFramework/GlobalSettingsPanel.h \
     Source/CommonFramework/Globals.h \
     Source/CommonFramework/ImageMatch/CroppedImageDictionaryMatcher.h \
@@ -1022,6 +1056,7 @@ HEADERS += \
     Source/CommonFramework/ImageMatch/FilterToAlpha.h \
     Source/CommonFramework/ImageMatch/ImageCropper.h \
     Source/CommonFramework/ImageMatch/ImageDiff.h \
+    Source/CommonFramework/ImageMatch/ImageMatchCascade.h \
     Source/CommonFramework/ImageMatch/ImageMatchOption.h \
     Source/CommonFramework/ImageMatch/ImageMatchResult.h \
     Source/CommonFramework/ImageMatch/SilhouetteDictionaryMatcher.h \
@@ -1036,6 +1071,8 @@ HEADERS += \
     Source/CommonFramework/ImageTools/ImageGradient.h \
     Source/CommonFramework/ImageTools/ImageManip.h \
     Source/CommonFramework/ImageTools/ImageStats.h \
+    Source/CommonFramework/ImageTools/RegionSignature.h \
+    Source/CommonFramework/ImageTools/SnapshotStats.h \
     Source/CommonFramework/ImageTools/SolidColorTest.h \
     Source/CommonFramework/ImageTools/WaterfillUtilities.h \
     Source/CommonFramework/ImageTypes/BinaryImage.h \
@@ -1081,12 +1118,15 @@ HEADERS += \
     Source/CommonFramework/OCR/OCR_LargeDictionaryMatcher.h \
     Source/CommonFramework/OCR/OCR_NumberReader.h \
     Source/CommonFramework/OCR/OCR_RawOCR.h \
+    Source/CommonFramework/OCR/OCR_ResultCache.h \
     Source/CommonFramework/OCR/OCR_Routines.h \
     Source/CommonFramework/OCR/OCR_SmallDictionaryMatcher.h \
     Source/CommonFramework/OCR/OCR_StringMatchResult.h \
     Source/CommonFramework/OCR/OCR_StringNormalization.h \
+    Source/CommonFramework/OCR/OCR_TesseractPool.h \
     Source/CommonFramework/OCR/OCR_TextMatcher.h \
     Source/CommonFramework/OCR/OCR_TrainingTools.h \
+    Source/CommonFramework/Options/Environment/KernelSelectionOption.h \
     Source/CommonFramework/Options/Environment/ProcessPriorityOption.h \
     Source/CommonFramework/Options/Environment/ProcessorLevelOption.h \
     Source/CommonFramework/Options/LabelCellOption.h \
@@ -1110,6 +1150,7 @@ HEADERS += \
     Source/CommonFramework/Panels/UI/SettingsPanelWidget.h \
     Source/CommonFramework/PersistentSettings.h \
     Source/CommonFramework/ProgramSession.h \
+    Source/CommonFramework/Resources/ResourceWarmup.h \
     Source/CommonFramework/Resources/SpriteDatabase.h \
     Source/CommonFramework/Tools/BlackBorderCheck.h \
     Source/CommonFramework/Tools/BotBaseHandle.h \
@@ -1127,10 +1168,15 @@ HEADERS += \
     Source/CommonFramework/VideoPipeline/Backends/CameraImplementations.h \
     Source/CommonFramework/VideoPipeline/Backends/CameraWidgetQt5.h \
     Source/CommonFramework/VideoPipeline/Backends/CameraWidgetQt6.h \
+    Source/CommonFramework/VideoPipeline/Backends/CaptureHubQt6.h \
     Source/CommonFramework/VideoPipeline/Backends/VideoToolsQt5.h \
+    Source/CommonFramework/VideoPipeline/Backends/VideoToolsQt6.h \
+    Source/CommonFramework/VideoPipeline/BufferPoolStats.h \
     Source/CommonFramework/VideoPipeline/CameraInfo.h \
     Source/CommonFramework/VideoPipeline/CameraOption.h \
     Source/CommonFramework/VideoPipeline/CameraSession.h \
+    Source/CommonFramework/VideoPipeline/FrameHistoryOption.h \
+    Source/CommonFramework/VideoPipeline/FrameHistoryRecorder.h \
     Source/CommonFramework/VideoPipeline/ThreadUtilizationStats.h \
     Source/CommonFramework/VideoPipeline/UI/CameraSelectorWidget.h \
     Source/CommonFramework/VideoPipeline/UI/VideoDisplayWidget.h \
@@ -1203,9 +1249,12 @@ HEADERS += \
     Source/Kernels/BinaryMatrix/Kernels_SparseBinaryMatrixCore.h \
     Source/Kernels/BinaryMatrix/Kernels_SparseBinaryMatrixCore.tpp \
     Source/Kernels/ImageFilters/Kernels_ImageFilter_Basic.h \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient.h \
+    Source/Kernels/ImageGradient/Kernels_ImageGradient_Routines.h \
     Source/Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.h \
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqr.h \
     Source/Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h \
+    Source/Kernels/ImageStats/Kernels_ImageScaledDeviation.h \
     Source/Kernels/Kernels_Alignment.h \
     Source/Kernels/Kernels_BitScan.h \
     Source/Kernels/Kernels_BitSet.h \
@@ -1235,11 +1284,13 @@ HEADERS += \
     Source/Kernels/Waterfill/Kernels_Waterfill_Types.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Device.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_DigitEntry.h \
+    Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Macro.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_Routines.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Commands_ScalarButtons.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Messages_Device.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Messages_DigitEntry.h \
+    Source/NintendoSwitch/Commands/NintendoSwitch_Messages_Macro.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Messages_PushButtons.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Messages_Routines.h \
     Source/NintendoSwitch/Commands/NintendoSwitch_Messages_ScalarButtons.h \
@@ -1383,6 +1434,7 @@ HEADERS += \
     Source/PokemonHome/PokemonHome_Panels.h \
     Source/PokemonHome/PokemonHome_Settings.h \
     Source/PokemonHome/Programs/PokemonHome_BoxSorting.h \
+    Source/PokemonHome/Programs/PokemonHome_BoxSortingPlanner.h \
     Source/PokemonHome/Programs/PokemonHome_GenerateNameOCR.h \
     Source/PokemonHome/Programs/PokemonHome_PageSwap.h \
     Source/PokemonLA/Inference/Battles/PokemonLA_BattleMenuDetector.h \
@@ -1713,6 +1765,7 @@ HEADERS += \
     Source/PokemonSwSh/Programs/QoLMacros/PokemonSwSh_FriendSearchDisconnect.h \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_BasicRNG.h \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_CramomaticRNG.h \
+    Source/PokemonSwSh/Programs/RNG/PokemonSwSh_LastBitSearch.h \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_SeedFinder.h \
     Source/PokemonSwSh/Programs/RNG/PokemonSwSh_Xoroshiro128Plus.h \
     Source/PokemonSwSh/Programs/ReleaseHelpers.h \
@@ -1744,7 +1797,9 @@ HEADERS += \
     Source/Tests/CommandLineTests.h \
     Source/Tests/CommonFramework_Tests.h \
     Source/Tests/Kernels_Tests.h \
+    Source/Tests/NintendoSwitch_DeviceEmulator.h \
     Source/Tests/NintendoSwitch_Tests.h \
+    Source/Tests/PokemonHome_Tests.h \
     Source/Tests/PokemonLA_Tests.h \
     Source/Tests/PokemonSV_Tests.h \
     Source/Tests/PokemonSwSh_Tests.h \
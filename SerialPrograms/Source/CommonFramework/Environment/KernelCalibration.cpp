@@ -0,0 +1,210 @@
+/*  Kernel Calibration
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Kernels/BinaryImageFilters/Kernels_BinaryImage_BasicFilters.h"
+#include "Kernels/Waterfill/Kernels_Waterfill.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "KernelCalibration.h"
+
+namespace PokemonAutomation{
+
+using namespace Kernels;
+
+
+const std::vector<KernelVariant>& KERNEL_VARIANTS(){
+    static const std::vector<KernelVariant> variants{
+        {BinaryMatrixType::i64x4_Default,       false,  "64x4 Default"},
+        {BinaryMatrixType::i64x8_x64_SSE42,     false,  "64x8 SSE4.2"},
+        {BinaryMatrixType::i64x16_x64_AVX2,     false,  "64x16 AVX2"},
+        {BinaryMatrixType::i64x32_x64_AVX512,   false,  "64x32 AVX512"},
+        {BinaryMatrixType::i64x32_x64_AVX512,   true,   "64x32 AVX512-GF"},
+        {BinaryMatrixType::i64x64_x64_AVX512,   false,  "64x64 AVX512"},
+        {BinaryMatrixType::i64x64_x64_AVX512,   true,   "64x64 AVX512-GF"},
+    };
+    return variants;
+}
+const KernelVariant* find_kernel_variant(const std::string& name){
+    for (const KernelVariant& variant : KERNEL_VARIANTS()){
+        if (name == variant.name){
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+bool kernel_variant_available(const KernelVariant& variant){
+    if (!BinaryMatrixType_available(variant.type)){
+        return false;
+    }
+    return !variant.avx512gf || Waterfill::AVX512GF_available();
+}
+
+namespace{
+
+const KernelVariant& lookup_variant(BinaryMatrixType type, bool avx512gf){
+    bool is_avx512 =
+        type == BinaryMatrixType::i64x32_x64_AVX512 ||
+        type == BinaryMatrixType::i64x64_x64_AVX512;
+    avx512gf &= is_avx512;
+    for (const KernelVariant& variant : KERNEL_VARIANTS()){
+        if (variant.type == type && variant.avx512gf == avx512gf){
+            return variant;
+        }
+    }
+    return KERNEL_VARIANTS()[0];
+}
+
+}
+
+const KernelVariant& default_kernel_variant(){
+    return lookup_variant(get_default_BinaryMatrixType(), Waterfill::AVX512GF_available());
+}
+const KernelVariant& current_kernel_variant(){
+    return lookup_variant(get_BinaryMatrixType(), Waterfill::use_AVX512GF());
+}
+
+void apply_kernel_variant(const KernelVariant& variant){
+    set_preferred_BinaryMatrixType(variant.type);
+    Waterfill::set_allow_AVX512GF(variant.avx512gf);
+}
+void clear_kernel_variant(){
+    clear_preferred_BinaryMatrixType();
+    Waterfill::set_allow_AVX512GF(true);
+}
+
+
+
+std::string KernelCalibrationResult::to_str() const{
+    std::string str;
+    for (const KernelTiming& timing : timings){
+        if (!str.empty()){
+            str += ", ";
+        }
+        str += timing.variant->name;
+        str += " = ";
+        str += tostr_fixed(timing.milliseconds, 3);
+        str += " ms";
+    }
+    return str;
+}
+
+
+
+namespace{
+
+//  A frame with a noisy background and a few hundred bright blobs. This is
+//  roughly what the white/text detectors see.
+class CalibrationFrame{
+public:
+    static const size_t WIDTH = 1920;
+    static const size_t HEIGHT = 1080;
+
+    CalibrationFrame()
+        : m_pixels(WIDTH * HEIGHT)
+    {
+        uint32_t state = 0x12345678;
+        auto random = [&]{
+            state = state * 1103515245 + 12345;
+            return state >> 8;
+        };
+        for (size_t r = 0; r < HEIGHT; r++){
+            for (size_t c = 0; c < WIDTH; c++){
+                uint32_t v = 0x40 + (uint32_t)((r + c) * 0x60 / (WIDTH + HEIGHT)) + (random() & 0x1f);
+                m_pixels[r * WIDTH + c] = 0xff000000 | (v << 16) | (v << 8) | v;
+            }
+        }
+        for (size_t c = 0; c < 300; c++){
+            size_t x0 = random() % WIDTH;
+            size_t y0 = random() % HEIGHT;
+            size_t radius = 2 + random() % 30;
+            size_t min_y = y0 < radius ? 0 : y0 - radius;
+            size_t max_y = std::min(y0 + radius, HEIGHT);
+            size_t min_x = x0 < radius ? 0 : x0 - radius;
+            size_t max_x = std::min(x0 + radius, WIDTH);
+            for (size_t y = min_y; y < max_y; y++){
+                for (size_t x = min_x; x < max_x; x++){
+                    ptrdiff_t dx = (ptrdiff_t)x - (ptrdiff_t)x0;
+                    ptrdiff_t dy = (ptrdiff_t)y - (ptrdiff_t)y0;
+                    if (dx * dx + dy * dy <= (ptrdiff_t)(radius * radius)){
+                        m_pixels[y * WIDTH + x] = 0xfff0f0f0;
+                    }
+                }
+            }
+        }
+    }
+
+    const uint32_t* data() const{ return m_pixels.data(); }
+    size_t bytes_per_row() const{ return WIDTH * sizeof(uint32_t); }
+
+private:
+    AlignedVector<uint32_t> m_pixels;
+};
+
+
+//  Median time of one filter + waterfill pass.
+double time_variant(const CalibrationFrame& frame, const KernelVariant& variant){
+    const size_t RUNS = 7;
+
+    apply_kernel_variant(variant);
+    std::unique_ptr<PackedBinaryMatrix_IB> matrix = make_PackedBinaryMatrix(
+        variant.type, CalibrationFrame::WIDTH, CalibrationFrame::HEIGHT
+    );
+
+    std::vector<double> times;
+    for (size_t c = 0; c <= RUNS; c++){
+        WallClock start = current_time();
+        compress_rgb32_to_binary_range(
+            frame.data(), frame.bytes_per_row(),
+            *matrix, 0xffc0c0c0, 0xffffffff
+        );
+        Waterfill::find_objects_inplace(*matrix, 10);
+        WallClock end = current_time();
+
+        //  First run is warmup.
+        if (c != 0){
+            times.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.);
+        }
+    }
+
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+}
+
+
+KernelCalibrationResult calibrate_kernels(Logger& logger){
+    logger.log("Calibrating image kernels...", COLOR_BLUE);
+
+    CalibrationFrame frame;
+
+    KernelCalibrationResult result;
+    double best = 0;
+    for (const KernelVariant& variant : KERNEL_VARIANTS()){
+        if (!kernel_variant_available(variant)){
+            continue;
+        }
+        double time = time_variant(frame, variant);
+        result.timings.emplace_back(KernelTiming{&variant, time});
+        if (result.best == nullptr || time < best){
+            result.best = &variant;
+            best = time;
+        }
+    }
+    clear_kernel_variant();
+
+    logger.log("Kernel Timings: " + result.to_str(), COLOR_BLUE);
+    logger.log(std::string("Fastest Kernel: ") + result.best->name, COLOR_BLUE);
+    return result;
+}
+
+
+
+
+}
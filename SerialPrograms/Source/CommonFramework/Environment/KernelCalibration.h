@@ -0,0 +1,74 @@
+/*  Kernel Calibration
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      The CPU features only say which kernels can run. They don't say which
+ *  one is fastest. On some machines (Zen 4, some Xeons) the AVX512 kernels are
+ *  slower than the AVX2 ones due to frequency or port effects.
+ *
+ *  This times every available variant of the binary matrix kernels (binary
+ *  filters + waterfill) on a synthetic frame and picks the fastest one.
+ *
+ */
+
+#ifndef PokemonAutomation_KernelCalibration_H
+#define PokemonAutomation_KernelCalibration_H
+
+#include <string>
+#include <vector>
+#include "Kernels/BinaryMatrix/Kernels_BinaryMatrix.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+
+
+struct KernelVariant{
+    Kernels::BinaryMatrixType type;
+    bool avx512gf;
+    const char* name;
+};
+
+//  All the variants that this binary knows about.
+const std::vector<KernelVariant>& KERNEL_VARIANTS();
+
+//  Returns nullptr if the name is not recognized.
+const KernelVariant* find_kernel_variant(const std::string& name);
+
+bool kernel_variant_available(const KernelVariant& variant);
+
+//  The variant that the CPU features alone would pick.
+const KernelVariant& default_kernel_variant();
+
+//  The variant that is currently in use.
+const KernelVariant& current_kernel_variant();
+
+
+//  Make the kernel dispatchers use this variant.
+void apply_kernel_variant(const KernelVariant& variant);
+
+//  Go back to dispatching on the CPU features.
+void clear_kernel_variant();
+
+
+
+struct KernelTiming{
+    const KernelVariant* variant;
+    double milliseconds;    //  Median time per frame.
+};
+struct KernelCalibrationResult{
+    const KernelVariant* best = nullptr;
+    std::vector<KernelTiming> timings;
+
+    std::string to_str() const;
+};
+
+//  Time all the available variants and return the fastest.
+//  This temporarily changes the active kernels. So don't run it while
+//  anything else is using them.
+KernelCalibrationResult calibrate_kernels(Logger& logger);
+
+
+
+}
+#endif
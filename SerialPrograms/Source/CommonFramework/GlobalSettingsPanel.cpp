@@ -6,7 +6,10 @@
 
 #include <iostream>
 #include <set>
+#include <thread>
+#include <algorithm>
 #include <QCryptographicHash>
+#include "Common/Cpp/LatencyTracer.h"
 #include "Common/Cpp/Json/JsonValue.h"
 #include "Common/Cpp/Json/JsonArray.h"
 #include "Common/Cpp/Json/JsonObject.h"
@@ -87,6 +90,9 @@ GlobalSettings& GlobalSettings::instance(){
     static GlobalSettings settings;
     return settings;
 }
+GlobalSettings::~GlobalSettings(){
+    LATENCY_TRACING.remove_listener(*this);
+}
 GlobalSettings::GlobalSettings()
     : BatchOption(LockWhileRunning::LOCKED)
     , SEND_ERROR_REPORTS(
@@ -189,6 +195,22 @@ GlobalSettings::GlobalSettings()
         LockWhileRunning::LOCKED,
         true
     )
+    , LATENCY_TRACING(
+        "<b>Latency Tracing:</b><br>"
+        "Record frame arrival, inference and command timings for every console. "
+        "The trace is saved alongside error dumps and when taking a screenshot. "
+        "Open the resulting .json file with chrome://tracing.",
+        LockWhileRunning::UNLOCKED,
+        false
+    )
+    , OCR_INSTANCE_LIMIT(
+        "<b>OCR Instance Limit:</b><br>"
+        "Maximum number of Tesseract OCR instances across all consoles and languages. "
+        "Each instance keeps its own copy of the language data in memory. "
+        "Once the limit is reached, idle instances of other languages are freed and text reads wait for a free instance.",
+        LockWhileRunning::UNLOCKED,
+        std::max<uint32_t>(std::thread::hardware_concurrency(), 4), 1
+    )
     , DEVELOPER_TOKEN(
         true,
         "<b>Developer Token:</b><br>Restart application to take full effect after changing this.",
@@ -225,10 +247,16 @@ GlobalSettings::GlobalSettings()
 #if QT_VERSION_MAJOR == 5
     PA_ADD_OPTION(ENABLE_FRAME_SCREENSHOTS);
 #endif
+    PA_ADD_OPTION(LATENCY_TRACING);
+    PA_ADD_OPTION(FRAME_HISTORY);
+    PA_ADD_OPTION(OCR_INSTANCE_LIMIT);
 
     PA_ADD_OPTION(PROCESSOR_LEVEL0);
+    PA_ADD_OPTION(KERNEL_SELECTION);
 
     PA_ADD_OPTION(DEVELOPER_TOKEN);
+
+    LATENCY_TRACING.add_listener(*this);
 }
 
 void GlobalSettings::load_json(const JsonValue& json){
@@ -304,6 +332,10 @@ void GlobalSettings::load_json(const JsonValue& json){
 }
 
 
+void GlobalSettings::value_changed(){
+    LatencyTracer::instance().set_enabled(LATENCY_TRACING);
+}
+
 JsonValue GlobalSettings::to_json() const{
     JsonObject obj = std::move(*BatchOption::to_json().get_object());
     obj["NAUGHTY_MODE"] = PreloadSettings::instance().NAUGHTY_MODE;
@@ -15,7 +15,9 @@
 #include "Common/Cpp/Options/StringOption.h"
 #include "CommonFramework/Options/Environment/ProcessPriorityOption.h"
 #include "CommonFramework/Options/Environment/ProcessorLevelOption.h"
+#include "CommonFramework/Options/Environment/KernelSelectionOption.h"
 #include "CommonFramework/Options/Environment/ThemeSelectorOption.h"
+#include "CommonFramework/VideoPipeline/FrameHistoryOption.h"
 #include "CommonFramework/VideoPipeline/Backends/CameraImplementations.h"
 #include "CommonFramework/Panels/SettingsPanel.h"
 #include "CommonFramework/Panels/PanelTools.h"
@@ -67,7 +69,8 @@ public:
 
 
 
-class GlobalSettings : public BatchOption{
+class GlobalSettings : public BatchOption, private ConfigOption::Listener{
+    ~GlobalSettings();
     GlobalSettings();
 public:
     static GlobalSettings& instance();
@@ -75,6 +78,9 @@ public:
     virtual void load_json(const JsonValue& json) override;
     virtual JsonValue to_json() const override;
 
+private:
+    virtual void value_changed() override;
+
 public:
     BooleanCheckBoxOption SEND_ERROR_REPORTS;
 
@@ -106,8 +112,12 @@ public:
     BooleanCheckBoxOption SHOW_RECORD_FREQUENCIES;
     VideoBackendOption VIDEO_BACKEND;
     BooleanCheckBoxOption ENABLE_FRAME_SCREENSHOTS;
+    BooleanCheckBoxOption LATENCY_TRACING;
+    FrameHistoryOption FRAME_HISTORY;
+    SimpleIntegerOption<uint32_t> OCR_INSTANCE_LIMIT;
 
     ProcessorLevelOption PROCESSOR_LEVEL0;
+    KernelSelectionOption KERNEL_SELECTION;
 
     StringOption DEVELOPER_TOKEN;
 
@@ -5,6 +5,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "ImageCropper.h"
@@ -44,6 +45,19 @@ void CroppedImageDictionaryMatcher::add(const std::string& slug, const ImageView
 ImageMatchResult CroppedImageDictionaryMatcher::match(
     const ImageViewRGB32& image,
     double alpha_spread
+) const{
+    return match(image, alpha_spread, true);
+}
+ImageMatchResult CroppedImageDictionaryMatcher::match_exhaustive(
+    const ImageViewRGB32& image,
+    double alpha_spread
+) const{
+    return match(image, alpha_spread, false);
+}
+ImageMatchResult CroppedImageDictionaryMatcher::match(
+    const ImageViewRGB32& image,
+    double alpha_spread,
+    bool skip_hopeless
 ) const{
     ImageMatchResult results;
     if (!image){
@@ -52,9 +66,19 @@ ImageMatchResult CroppedImageDictionaryMatcher::match(
 
     Color background;
     ImageRGB32 processed = process_image(image, background);
+    ScaledImageCache scaled(processed);
 
     for (const auto& item : m_database){
-        double alpha = item.second.diff(processed, background);
+        //  Skip templates that would be cleared anyway.
+        if (skip_hopeless && !results.results.empty()){
+            double threshold = results.results.begin()->first + std::max(alpha_spread, 0.);
+            if (item.second.diff_exceeds(scaled, threshold, Kernels::SumSquareMode::USE_BACKGROUND, background)){
+                continue;
+            }
+        }
+
+        const ImageRGB32& sprite = item.second.image_template();
+        double alpha = item.second.diff(scaled.scale_to(sprite.width(), sprite.height()), background);
         results.add(alpha, item.first);
         results.clear_beyond_spread(alpha_spread);
     }
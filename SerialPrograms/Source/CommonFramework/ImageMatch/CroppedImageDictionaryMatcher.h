@@ -25,10 +25,17 @@ public:
 
     ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread) const;
 
+    //  Same as match(), but without skipping the templates that can't be in
+    //  the results. Used to check match() against.
+    ImageMatchResult match_exhaustive(const ImageViewRGB32& image, double alpha_spread) const;
+
 
 protected:
     virtual ImageRGB32 process_image(const ImageViewRGB32& image, Color& background) const = 0;
 
+private:
+    ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread, bool skip_hopeless) const;
+
 
 private:
     WeightedExactImageMatcher::InverseStddevWeight m_weight;
@@ -5,8 +5,8 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
-#include "ImageDiff.h"
 #include "ExactImageMatcher.h"
 
 #include <iostream>
@@ -17,6 +17,27 @@ namespace PokemonAutomation{
 namespace ImageMatch{
 
 
+ImageViewRGB32 ScaledImageCache::scale_to(size_t width, size_t height){
+    if (m_image.width() == width && m_image.height() == height){
+        return m_image;
+    }
+    Entry& entry = m_scaled[{width, height}];
+    if (!entry.image){
+        entry.image = m_image.scale_to(width, height);
+    }
+    return entry.image;
+}
+const ImageSumTable& ScaledImageCache::sum_table(size_t width, size_t height, bool alpha_masked){
+    ImageViewRGB32 image = scale_to(width, height);
+    std::unique_ptr<ImageSumTable>& table = m_scaled[{width, height}].tables[alpha_masked];
+    if (!table){
+        table.reset(new ImageSumTable(image, alpha_masked));
+    }
+    return *table;
+}
+
+
+
 ExactImageMatcher::ExactImageMatcher(ImageRGB32 image)
     : m_image(std::move(image))
     , m_stats(image_stats(m_image))
@@ -25,61 +46,153 @@ ExactImageMatcher::ExactImageMatcher(ImageRGB32 image)
         throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Image is null.");
     }
 //    cout << m_stats.stddev.sum() << endl;
+
+    size_t width = m_image.width();
+    size_t height = m_image.height();
+    for (size_t channel = 0; channel < 3; channel++){
+        std::vector<uint32_t>& saturating = m_saturating[channel];
+        for (size_t r = 0; r < height; r++){
+            for (size_t c = 0; c < width; c++){
+                uint32_t pixel = m_image.pixel(c, r);
+                uint8_t value = (uint8_t)(pixel >> (8 * channel));
+                if ((pixel >> 31) && value * MAX_BRIGHTNESS_SCALE > 255){
+                    saturating.emplace_back((uint32_t)(r * width + c));
+                }
+            }
+        }
+        std::stable_sort(
+            saturating.begin(), saturating.end(),
+            [&](uint32_t x, uint32_t y){
+                return (uint8_t)(m_image.pixel(x % width, x / width) >> (8 * channel))
+                     > (uint8_t)(m_image.pixel(y % width, y / width) >> (8 * channel));
+            }
+        );
+    }
+
+    for (size_t grid : {8, 16}){
+        m_cascade.emplace_back(m_image, grid, MIN_BRIGHTNESS_SCALE, MAX_BRIGHTNESS_SCALE);
+    }
 }
 
-ImageRGB32 ExactImageMatcher::scale_template_brightness(const ImageViewRGB32& image) const{
-    FloatPixel image_brightness = pixel_average(image, m_image);
+
+//  The template scaled by "s" is compared against the image as:
+//
+//      sum((s*t - i)^2) = s^2 * sum(t^2) - 2 * s * sum(t*i) + sum(i^2)
+//
+//  This is exact except where "s*t" would exceed 255 and the scaled template
+//  would be clamped. Those pixels are corrected one by one. There are only a
+//  few of them since it needs both a bright template pixel and s > 1.
+double ExactImageMatcher::channel_deviation(
+    const ImageViewRGB32& image, Kernels::SumSquareMode mode,
+    size_t channel, double scale, uint8_t background,
+    uint64_t background_pixels, const Kernels::ScaledDeviationChannel& sums
+) const{
+    double ret = scale * scale * (double)sums.sqr_r - 2 * scale * (double)sums.cross + (double)sums.sqr_i;
+
+    size_t shift = 8 * channel;
+    size_t width = m_image.width();
+    for (uint32_t index : m_saturating[channel]){
+        size_t x = index % width;
+        size_t y = index / width;
+        double t = scale * (uint8_t)(m_image.pixel(x, y) >> shift);
+        if (t <= 255){
+            break;
+        }
+        uint32_t pixel = image.pixel(x, y);
+        if (mode == Kernels::SumSquareMode::ARBITRATE_ALPHAS && (pixel >> 31) == 0){
+            continue;
+        }
+        double i = (uint8_t)(pixel >> shift);
+        ret += (255 - i) * (255 - i) - (t - i) * (t - i);
+    }
+
+    if (mode == Kernels::SumSquareMode::USE_BACKGROUND){
+        double bg = background;
+        ret += (double)background_pixels * bg * bg - 2 * bg * (double)sums.bg_sum_i + (double)sums.bg_sqr_i;
+    }
+
+    return ret;
+}
+double ExactImageMatcher::rmsd(const ImageViewRGB32& image, Kernels::SumSquareMode mode, Color background) const{
+    if (!image){
+        return 1000.;
+    }
+
+    size_t width = m_image.width();
+    size_t height = m_image.height();
+
+    ImageRGB32 scaled;
+    ImageViewRGB32 view = image;
+    if (image.width() != width || image.height() != height){
+        scaled = image.scale_to(width, height);
+        view = scaled;
+    }
+
+    Kernels::ScaledDeviationSums sums;
+    Kernels::scaled_deviation_sums(
+        sums, mode,
+        width, height,
+        m_image.data(), m_image.bytes_per_row(),
+        view.data(), view.bytes_per_row()
+    );
+
+    //  Scale the template brightness to match the image.
+    FloatPixel image_brightness((double)sums.r.sum_i, (double)sums.g.sum_i, (double)sums.b.sum_i);
+    image_brightness /= (double)sums.opaque;
     FloatPixel scale = image_brightness / m_stats.average;
 
     if (std::isnan(scale.r)) scale.r = 1.0;
     if (std::isnan(scale.g)) scale.g = 1.0;
     if (std::isnan(scale.b)) scale.b = 1.0;
-    scale.bound(0.8, 1.2);
+    scale.bound(MIN_BRIGHTNESS_SCALE, MAX_BRIGHTNESS_SCALE);
 
-    ImageRGB32 ret = m_image.copy();
-    scale_brightness(ret, scale);
-    return ret;
-}
+    uint64_t background_pixels = width * height - sums.count;
+    double sumsqrs = 0;
+    sumsqrs += channel_deviation(view, mode, 0, (float)scale.b, background.blue(), background_pixels, sums.b);
+    sumsqrs += channel_deviation(view, mode, 1, (float)scale.g, background.green(), background_pixels, sums.g);
+    sumsqrs += channel_deviation(view, mode, 2, (float)scale.r, background.red(), background_pixels, sums.r);
 
-
-double ExactImageMatcher::rmsd(const ImageViewRGB32& image) const{
-    if (!image){
-        return 1000.;
+    if (mode == Kernels::SumSquareMode::ARBITRATE_ALPHAS){
+        sumsqrs += (double)sums.disagree * (3 * 255 * 255);
     }
 
-//    image.save("test.png");
+    //  Rounding can take an exact match slightly below zero.
+    sumsqrs = std::max(sumsqrs, 0.);
 
-//    cout << "ExactImageMatcher::rmsd(): image = " << image.width() << " x " << image.height() << endl;
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-//    cout << "ExactImageMatcher::rmsd(): scaled = " << scaled.width() << " x " << scaled.height() << endl;
-    ImageRGB32 reference = scale_template_brightness(scaled);
+    return std::sqrt(sumsqrs / (double)sums.count);
+}
 
-#if 0
-    static int c = 0;
-    image.save("test-" + std::to_string(c) + "-image.png");
-    reference.save("test-" + std::to_string(c) + "-sprite.png");
-    c++;
-#endif
 
-    double rmsd = pixel_RMSD(reference, scaled);
-//    cout << "rmsd = " << rmsd << endl;
-    return rmsd;
+double ExactImageMatcher::rmsd(const ImageViewRGB32& image) const{
+    return rmsd(image, Kernels::SumSquareMode::REFERENCE_ALPHA, Color());
 }
 double ExactImageMatcher::rmsd(const ImageViewRGB32& image, Color background) const{
-    if (!image){
-        return 1000.;
-    }
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-    ImageRGB32 reference = scale_template_brightness(scaled);
-    return pixel_RMSD(reference, scaled, background);
+    return rmsd(image, Kernels::SumSquareMode::USE_BACKGROUND, background);
 }
 double ExactImageMatcher::rmsd_masked(const ImageViewRGB32& image) const{
-    if (!image){
-        return 1000.;
+    return rmsd(image, Kernels::SumSquareMode::ARBITRATE_ALPHAS, Color());
+}
+bool ExactImageMatcher::rmsd_exceeds(
+    ScaledImageCache& image, double threshold,
+    Kernels::SumSquareMode mode, Color background
+) const{
+    if (m_stats.count == 0){
+        return false;
+    }
+
+    //  Leave some room for rounding in rmsd().
+    double max_sumsqrs = threshold * threshold * (1 + 1e-6) * m_stats.count + 1e-6;
+
+    const ImageSumTable& table = image.sum_table(
+        m_image.width(), m_image.height(),
+        mode == Kernels::SumSquareMode::ARBITRATE_ALPHAS
+    );
+    for (const CascadeSignature& signature : m_cascade){
+        if (signature.lower_bound(table, mode, background) > max_sumsqrs){
+            return true;
+        }
     }
-    ImageRGB32 scaled = image.scale_to(m_image.width(), m_image.height());
-    ImageRGB32 reference = scale_template_brightness(scaled);
-    return pixel_RMSD_masked(reference, scaled);
+    return false;
 }
 
 
@@ -109,6 +222,15 @@ double WeightedExactImageMatcher::diff_masked(const ImageViewRGB32& image) const
     }
     return rmsd_masked(image) * m_multiplier;
 }
+bool WeightedExactImageMatcher::diff_exceeds(
+    ScaledImageCache& image, double threshold,
+    Kernels::SumSquareMode mode, Color background
+) const{
+    if (m_multiplier <= 0){
+        return false;
+    }
+    return rmsd_exceeds(image, threshold / m_multiplier, mode, background);
+}
 
 
 
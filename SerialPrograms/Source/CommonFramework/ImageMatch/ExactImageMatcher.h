@@ -7,14 +7,49 @@
 #ifndef PokemonAutomation_ExactImageMatcher_H
 #define PokemonAutomation_ExactImageMatcher_H
 
+#include <vector>
+#include <map>
+#include <memory>
+#include "Common/Cpp/Color.h"
+#include "Kernels/ImageStats/Kernels_ImageScaledDeviation.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTools/FloatPixel.h"
 #include "CommonFramework/ImageTools/ImageStats.h"
+#include "ImageMatchCascade.h"
 
 namespace PokemonAutomation{
 namespace ImageMatch{
 
 
+//  Scaled copies of an image, one per size.
+//  Dictionary matchers compare one input against many templates and most of
+//  the templates share a handful of sizes. Scale the input once per size
+//  instead of once per template.
+class ScaledImageCache{
+public:
+    ScaledImageCache(const ImageViewRGB32& image)
+        : m_image(image)
+    {}
+
+    //  The returned view is valid until this cache is destroyed.
+    ImageViewRGB32 scale_to(size_t width, size_t height);
+
+    //  Summed-area table of the image scaled to this size.
+    //  The returned table is valid until this cache is destroyed.
+    const ImageSumTable& sum_table(size_t width, size_t height, bool alpha_masked);
+
+private:
+    struct Entry{
+        ImageRGB32 image;
+        std::unique_ptr<ImageSumTable> tables[2];
+    };
+
+    ImageViewRGB32 m_image;
+    std::map<std::pair<size_t, size_t>, Entry> m_scaled;
+};
+
+
+
 //  Match images against a template.
 //  Before matching, resize the input image to the template shape and scale template brightness to
 //  match the input image. Alpha channels as used as masks in matching.
@@ -25,6 +60,11 @@ class ExactImageMatcher{
     ExactImageMatcher(const ExactImageMatcher&) = delete;
     void operator=(const ExactImageMatcher&) = delete;
 
+public:
+    //  Limits on how much the template brightness is scaled to match the input.
+    static constexpr double MIN_BRIGHTNESS_SCALE = 0.8;
+    static constexpr double MAX_BRIGHTNESS_SCALE = 1.2;
+
 public:
     ExactImageMatcher(ImageRGB32 image_template);
     
@@ -32,6 +72,7 @@ public:
 
     // Resize image to match the shape of the image template, scale the template brightness to match
     // the input image, then compute their RMSD (root mean square deviation).
+    // Images already of the template shape are used as is. No copies of the template are made.
     // The part of the image template where alpha is 0 is not used to compare with the corresponding
     // part in the input image.
     double rmsd(const ImageViewRGB32& image) const;
@@ -48,16 +89,39 @@ public:
     // If both two images have alpha==0 on one pixel, that pixel is ignored.
     double rmsd_masked(const ImageViewRGB32& image) const;
 
+    // Returns true if the corresponding rmsd() above is certainly greater than `threshold`.
+    // This only looks at block sums of the input and is much cheaper than rmsd(). It may return
+    // false even when the RMSD is above the threshold.
+    // `background` is only used for SumSquareMode::USE_BACKGROUND.
+    bool rmsd_exceeds(
+        ScaledImageCache& image, double threshold,
+        Kernels::SumSquareMode mode, Color background = Color()
+    ) const;
+
     const ImageRGB32& image_template() const { return m_image; }
 
 private:
-    // scale stored image template according to the brightness of `image`, assign
-    // the scaled template to `reference`.
-    ImageRGB32 scale_template_brightness(const ImageViewRGB32& image) const;
+    double rmsd(const ImageViewRGB32& image, Kernels::SumSquareMode mode, Color background) const;
+
+    //  The deviation of one channel with the template scaled by `scale`.
+    double channel_deviation(
+        const ImageViewRGB32& image, Kernels::SumSquareMode mode,
+        size_t channel, double scale, uint8_t background,
+        uint64_t background_pixels, const Kernels::ScaledDeviationChannel& sums
+    ) const;
 
 protected:
     ImageRGB32 m_image;
     ImageStats m_stats;
+
+private:
+    //  For each channel, (B, G, R), the template pixels that saturate at the
+    //  maximum brightness scale, brightest first. These are the only pixels
+    //  where the scaled template is clamped.
+    std::vector<uint32_t> m_saturating[3];
+
+    //  Coarse to fine signatures for rmsd_exceeds().
+    std::vector<CascadeSignature> m_cascade;
 };
 
 
@@ -88,6 +152,12 @@ public:
     // Like ExactImageMatcher::rmsd_masked(image) but scale based on template stddev.
     double diff_masked(const ImageViewRGB32& image) const;
 
+    // Like ExactImageMatcher::rmsd_exceeds() but for diff...().
+    bool diff_exceeds(
+        ScaledImageCache& image, double threshold,
+        Kernels::SumSquareMode mode, Color background = Color()
+    ) const;
+
 public:
     double m_multiplier;
 };
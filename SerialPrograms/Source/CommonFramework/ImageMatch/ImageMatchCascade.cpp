@@ -0,0 +1,163 @@
+/*  Image Match Cascade
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <algorithm>
+#include "Common/Cpp/Exceptions.h"
+#include "ImageMatchCascade.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace ImageMatch{
+
+
+
+ImageSumTable::ImageSumTable(const ImageViewRGB32& image, bool alpha_masked)
+    : m_width(image.width())
+    , m_height(image.height())
+    , m_table((m_width + 1) * (m_height + 1))
+{
+    for (size_t r = 0; r < m_height; r++){
+        Sums row;
+        const Sums* above = &m_table[r * (m_width + 1)];
+        Sums* current = &m_table[(r + 1) * (m_width + 1)];
+        for (size_t c = 0; c < m_width; c++){
+            uint32_t pixel = image.pixel(c, r);
+            if (!alpha_masked || (pixel >> 31)){
+                row.count++;
+                row.r += (pixel >> 16) & 0xff;
+                row.g += (pixel >>  8) & 0xff;
+                row.b += (pixel >>  0) & 0xff;
+            }
+            Sums& out = current[c + 1];
+            out.count = above[c + 1].count + row.count;
+            out.r = above[c + 1].r + row.r;
+            out.g = above[c + 1].g + row.g;
+            out.b = above[c + 1].b + row.b;
+        }
+    }
+}
+ImageSumTable::Sums ImageSumTable::sum(size_t x0, size_t y0, size_t x1, size_t y1) const{
+    const Sums& a = entry(x0, y0);
+    const Sums& b = entry(x1, y0);
+    const Sums& c = entry(x0, y1);
+    const Sums& d = entry(x1, y1);
+    Sums ret;
+    ret.count = d.count + a.count - b.count - c.count;
+    ret.r = d.r + a.r - b.r - c.r;
+    ret.g = d.g + a.g - b.g - c.g;
+    ret.b = d.b + a.b - b.b - c.b;
+    return ret;
+}
+
+
+
+CascadeSignature::CascadeSignature(
+    const ImageViewRGB32& image_template, size_t grid,
+    double min_scale, double max_scale
+){
+    size_t width = image_template.width();
+    size_t height = image_template.height();
+    if (width > 65535 || height > 65535){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Template too large.");
+    }
+
+    //  The brightness scale is applied in single precision.
+    min_scale = (float)min_scale * (1 - 1e-6);
+    max_scale = (float)max_scale * (1 + 1e-6);
+
+    for (size_t gy = 0; gy < grid; gy++){
+        size_t y0 = gy * height / grid;
+        size_t y1 = (gy + 1) * height / grid;
+        for (size_t gx = 0; gx < grid; gx++){
+            size_t x0 = gx * width / grid;
+            size_t x1 = (gx + 1) * width / grid;
+            if (x0 == x1 || y0 == y1){
+                continue;
+            }
+
+            Cell cell{};
+            cell.x0 = (uint16_t)x0;
+            cell.y0 = (uint16_t)y0;
+            cell.x1 = (uint16_t)x1;
+            cell.y1 = (uint16_t)y1;
+            cell.pixels = (uint32_t)((x1 - x0) * (y1 - y0));
+
+            size_t alpha = 0;
+            for (size_t r = y0; r < y1; r++){
+                for (size_t c = x0; c < x1; c++){
+                    uint32_t pixel = image_template.pixel(c, r);
+                    alpha += pixel >> 31;
+                    for (size_t ch = 0; ch < 3; ch++){
+                        double value = (pixel >> (16 - 8 * ch)) & 0xff;
+                        cell.low[ch] += std::min(value * min_scale, 255.);
+                        cell.high[ch] += std::min(value * max_scale, 255.);
+                    }
+                }
+            }
+            if (alpha != 0 && alpha != cell.pixels){
+                continue;
+            }
+            cell.opaque = alpha != 0;
+            m_cells.emplace_back(cell);
+        }
+    }
+}
+
+
+double CascadeSignature::lower_bound(
+    const ImageSumTable& image,
+    Kernels::SumSquareMode mode, Color background
+) const{
+    const double MAX_PIXEL_DEVIATION = 3 * 255 * 255;
+    const double bg[3] = {
+        (double)background.red(),
+        (double)background.green(),
+        (double)background.blue(),
+    };
+
+    double ret = 0;
+    for (const Cell& cell : m_cells){
+        if (!cell.opaque && mode == Kernels::SumSquareMode::REFERENCE_ALPHA){
+            continue;
+        }
+
+        ImageSumTable::Sums sums = image.sum(cell.x0, cell.y0, cell.x1, cell.y1);
+        const double sum[3] = {(double)sums.r, (double)sums.g, (double)sums.b};
+        double pixels = cell.pixels;
+
+        if (mode == Kernels::SumSquareMode::ARBITRATE_ALPHAS){
+            //  Every pixel where the alphas disagree is the max deviation.
+            if (!cell.opaque){
+                ret += (double)sums.count * MAX_PIXEL_DEVIATION;
+                continue;
+            }
+            if (sums.count != cell.pixels){
+                ret += (double)(cell.pixels - sums.count) * MAX_PIXEL_DEVIATION;
+                continue;
+            }
+        }
+
+        for (size_t ch = 0; ch < 3; ch++){
+            double diff;
+            if (cell.opaque){
+                diff = std::max(sum[ch] - cell.high[ch], cell.low[ch] - sum[ch]);
+                diff = std::max(diff, 0.);
+            }else{
+                diff = bg[ch] * pixels - sum[ch];
+            }
+            ret += diff * diff / pixels;
+        }
+    }
+    return ret;
+}
+
+
+
+}
+}
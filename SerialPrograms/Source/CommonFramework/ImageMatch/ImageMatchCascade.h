@@ -0,0 +1,107 @@
+/*  Image Match Cascade
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Cheap lower bounds on the RMSD computed by ExactImageMatcher so that
+ *  dictionary matchers can skip templates that cannot make it into the
+ *  results without computing their full RMSD.
+ *
+ *  Each template is split into a coarse grid of cells. Within a cell, the sum
+ *  of squared deviations is at least (sum(template) - sum(image))^2 / pixels.
+ *  The image sums of a cell come from a summed-area table of the input which
+ *  is shared by all templates of the same size. The template sums are known
+ *  only up to the brightness scale, so they are kept as a [low, high] range.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_ImageMatchCascade_H
+#define PokemonAutomation_CommonFramework_ImageMatchCascade_H
+
+#include <stdint.h>
+#include <vector>
+#include "Common/Cpp/Color.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+
+namespace PokemonAutomation{
+namespace ImageMatch{
+
+
+//  Summed-area table of the RGB channels of an image.
+class ImageSumTable{
+public:
+    struct Sums{
+        //  # of pixels. (with alpha if the table is alpha-masked)
+        uint64_t count = 0;
+        uint64_t r = 0;
+        uint64_t g = 0;
+        uint64_t b = 0;
+    };
+
+public:
+    //  If "alpha_masked" is true, pixels without alpha are left out.
+    ImageSumTable(const ImageViewRGB32& image, bool alpha_masked);
+
+    size_t width() const{ return m_width; }
+    size_t height() const{ return m_height; }
+
+    //  Sums over [x0, x1) x [y0, y1).
+    Sums sum(size_t x0, size_t y0, size_t x1, size_t y1) const;
+
+private:
+    const Sums& entry(size_t x, size_t y) const{
+        return m_table[y * (m_width + 1) + x];
+    }
+
+private:
+    size_t m_width;
+    size_t m_height;
+    std::vector<Sums> m_table;
+};
+
+
+
+//  The cells of one template at one grid resolution.
+class CascadeSignature{
+public:
+    CascadeSignature() = default;
+
+    //  "min_scale" and "max_scale" are the limits of the brightness scale
+    //  that may be applied to the template.
+    CascadeSignature(
+        const ImageViewRGB32& image_template, size_t grid,
+        double min_scale, double max_scale
+    );
+
+    //  A lower bound on the sum of squared deviations between the template
+    //  and the image whose table is given. The table must be alpha-masked
+    //  if and only if "mode" is SumSquareMode::ARBITRATE_ALPHAS.
+    double lower_bound(
+        const ImageSumTable& image,
+        Kernels::SumSquareMode mode, Color background
+    ) const;
+
+private:
+    //  Only cells where the template alpha is uniform are kept. Partial
+    //  cells would need the per-pixel alpha of the template to bound.
+    struct Cell{
+        uint16_t x0;
+        uint16_t y0;
+        uint16_t x1;
+        uint16_t y1;
+        uint32_t pixels;
+        bool opaque;
+
+        //  Range of the sum of each channel (R, G, B) of the scaled template.
+        double low[3];
+        double high[3];
+    };
+
+    std::vector<Cell> m_cells;
+};
+
+
+
+}
+}
+#endif
@@ -5,6 +5,7 @@
  */
 
 #include <cmath>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "ImageCropper.h"
@@ -40,17 +41,42 @@ void SilhouetteDictionaryMatcher::add(const std::string& slug, const ImageViewRG
 ImageMatchResult SilhouetteDictionaryMatcher::match(
     const ImageViewRGB32& image,
     double alpha_spread
+) const{
+    return match(image, alpha_spread, true);
+}
+ImageMatchResult SilhouetteDictionaryMatcher::match_exhaustive(
+    const ImageViewRGB32& image,
+    double alpha_spread
+) const{
+    return match(image, alpha_spread, false);
+}
+ImageMatchResult SilhouetteDictionaryMatcher::match(
+    const ImageViewRGB32& image,
+    double alpha_spread,
+    bool skip_hopeless
 ) const{
     ImageMatchResult results;
     if (!image){
         return results;
     }
 
+    ScaledImageCache scaled(image);
+
     for (const auto& item : m_database){
 //        if (item.first != "solosis"){
 //            continue;
 //        }
-        double alpha = item.second.rmsd_masked(image);
+
+        //  Skip templates that would be cleared anyway.
+        if (skip_hopeless && !results.results.empty()){
+            double threshold = results.results.begin()->first + std::max(alpha_spread, 0.);
+            if (item.second.rmsd_exceeds(scaled, threshold, Kernels::SumSquareMode::ARBITRATE_ALPHAS)){
+                continue;
+            }
+        }
+
+        const ImageRGB32& sprite = item.second.image_template();
+        double alpha = item.second.rmsd_masked(scaled.scale_to(sprite.width(), sprite.height()));
         results.add(alpha, item.first);
         results.clear_beyond_spread(alpha_spread);
     }
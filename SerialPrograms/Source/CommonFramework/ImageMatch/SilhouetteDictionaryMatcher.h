@@ -44,6 +44,13 @@ public:
     // If both two images have alpha==0 on one pixel, that pixel is ignored.
     ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread) const;
 
+    // Same as match(), but without skipping the templates that can't be in the results.
+    // Used to check match() against.
+    ImageMatchResult match_exhaustive(const ImageViewRGB32& image, double alpha_spread) const;
+
+
+private:
+    ImageMatchResult match(const ImageViewRGB32& image, double alpha_spread, bool skip_hopeless) const;
 
 private:
     std::map<std::string, ExactImageMatcher> m_database;
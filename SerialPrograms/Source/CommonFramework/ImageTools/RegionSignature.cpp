@@ -0,0 +1,75 @@
+/*  Region Signature
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "RegionSignature.h"
+
+namespace PokemonAutomation{
+
+
+const size_t BLOCK_SIZE = 8;
+
+
+RegionSignature::RegionSignature(const ImageViewRGB32& frame, const std::vector<ImageFloatBox>& boxes)
+    : m_width(frame.width())
+    , m_height(frame.height())
+{
+    if (!frame){
+        return;
+    }
+    for (const ImageFloatBox& box : boxes){
+        ImageViewRGB32 region = extract_box_reference(frame, box);
+        size_t width = region.width();
+        size_t height = region.height();
+        for (size_t r0 = 0; r0 < height; r0 += BLOCK_SIZE){
+            size_t r1 = std::min(r0 + BLOCK_SIZE, height);
+            for (size_t c0 = 0; c0 < width; c0 += BLOCK_SIZE){
+                size_t c1 = std::min(c0 + BLOCK_SIZE, width);
+                uint32_t sum_r = 0;
+                uint32_t sum_g = 0;
+                uint32_t sum_b = 0;
+                for (size_t r = r0; r < r1; r++){
+                    for (size_t c = c0; c < c1; c++){
+                        uint32_t pixel = region.pixel(c, r);
+                        sum_r += (pixel >> 16) & 0xff;
+                        sum_g += (pixel >> 8) & 0xff;
+                        sum_b += pixel & 0xff;
+                    }
+                }
+                uint32_t count = (uint32_t)((r1 - r0) * (c1 - c0));
+                uint32_t half = count / 2;
+                m_blocks.emplace_back(
+                    ((sum_r + half) / count << 16) |
+                    ((sum_g + half) / count << 8) |
+                    ((sum_b + half) / count)
+                );
+            }
+        }
+    }
+}
+
+bool RegionSignature::matches(const RegionSignature& x, uint8_t tolerance) const{
+    if (m_width != x.m_width || m_height != x.m_height || m_blocks.size() != x.m_blocks.size()){
+        return false;
+    }
+    for (size_t c = 0; c < m_blocks.size(); c++){
+        uint32_t a = m_blocks[c];
+        uint32_t b = x.m_blocks[c];
+        if (abs((int)((a >> 16) & 0xff) - (int)((b >> 16) & 0xff)) > tolerance ||
+            abs((int)((a >> 8) & 0xff) - (int)((b >> 8) & 0xff)) > tolerance ||
+            abs((int)(a & 0xff) - (int)(b & 0xff)) > tolerance
+        ){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+}
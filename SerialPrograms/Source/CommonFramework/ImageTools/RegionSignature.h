@@ -0,0 +1,49 @@
+/*  Region Signature
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      A coarse summary of the pixels inside some boxes of a frame. It is the
+ *  average color of every 8x8 block of each box. Comparing two of them tells
+ *  whether anything in the boxes changed between two frames.
+ *
+ *  Averaging the blocks hides the noise of a capture card. So two frames of a
+ *  still screen match. Anything that moves a block's average by more than the
+ *  tolerance is a change. A few pixels changing slightly is not.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_RegionSignature_H
+#define PokemonAutomation_CommonFramework_RegionSignature_H
+
+#include <stdint.h>
+#include <vector>
+#include "ImageBoxes.h"
+
+namespace PokemonAutomation{
+
+class ImageViewRGB32;
+
+
+class RegionSignature{
+public:
+    RegionSignature() = default;
+    RegionSignature(const ImageViewRGB32& frame, const std::vector<ImageFloatBox>& boxes);
+
+    //  Returns true if this has any blocks.
+    explicit operator bool() const{ return !m_blocks.empty(); }
+
+    //  Returns true if both are of the same boxes in frames of the same size
+    //  and no block average differs by more than "tolerance" in any channel.
+    bool matches(const RegionSignature& x, uint8_t tolerance) const;
+
+
+private:
+    size_t m_width = 0;
+    size_t m_height = 0;
+    std::vector<uint32_t> m_blocks;
+};
+
+
+
+}
+#endif
@@ -0,0 +1,111 @@
+/*  Snapshot Stats
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <vector>
+#include <algorithm>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "SnapshotStats.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+namespace{
+
+struct BoxStats{
+    ImageFloatBox box;
+    ImageStats stats;
+};
+
+//  The boxes computed so far for one snapshot.
+struct SnapshotEntry{
+    //  Weak so the cache doesn't keep frames alive. An expired entry can't be
+    //  mistaken for a new frame at the same address since it still holds the
+    //  old control block.
+    std::weak_ptr<const ImageRGB32> frame;
+    std::vector<BoxStats> boxes;
+};
+
+//  Enough for a few consoles running at once.
+const size_t MAX_SNAPSHOTS = 8;
+
+SpinLock cache_lock;
+std::vector<SnapshotEntry> cache;
+
+bool same_box(const ImageFloatBox& x, const ImageFloatBox& y){
+    return x.x == y.x && x.y == y.y && x.width == y.width && x.height == y.height;
+}
+bool same_frame(const std::weak_ptr<const ImageRGB32>& x, const std::shared_ptr<const ImageRGB32>& y){
+    return !x.owner_before(y) && !y.owner_before(x);
+}
+
+}
+
+
+
+ImageStats image_stats(const VideoSnapshot& snapshot, const ImageFloatBox& box){
+    const std::shared_ptr<const ImageRGB32>& frame = snapshot.frame;
+    if (!frame){
+        return ImageStats();
+    }
+
+    {
+        SpinLockGuard lg(cache_lock, "image_stats(VideoSnapshot)");
+        for (const SnapshotEntry& entry : cache){
+            if (!same_frame(entry.frame, frame)){
+                continue;
+            }
+            for (const BoxStats& item : entry.boxes){
+                if (same_box(item.box, box)){
+                    return item.stats;
+                }
+            }
+            break;
+        }
+    }
+
+    //  Not under the lock. Two callers may both compute a box the first time.
+    //  That costs no more than before.
+    ImageStats stats = image_stats(extract_box_reference(*frame, box));
+
+    SpinLockGuard lg(cache_lock, "image_stats(VideoSnapshot)");
+
+    //  Drop the snapshots that nobody holds anymore.
+    for (auto iter = cache.begin(); iter != cache.end();){
+        if (iter->frame.expired()){
+            iter = cache.erase(iter);
+        }else{
+            ++iter;
+        }
+    }
+
+    auto iter = std::find_if(
+        cache.begin(), cache.end(),
+        [&](const SnapshotEntry& entry){ return same_frame(entry.frame, frame); }
+    );
+    if (iter == cache.end()){
+        if (cache.size() >= MAX_SNAPSHOTS){
+            cache.erase(cache.begin());
+        }
+        cache.emplace_back();
+        cache.back().frame = frame;
+        iter = cache.end() - 1;
+    }
+    iter->boxes.emplace_back(BoxStats{box, stats});
+    return stats;
+}
+FloatPixel image_average(const VideoSnapshot& snapshot, const ImageFloatBox& box){
+    return image_stats(snapshot, box).average;
+}
+
+
+
+}
@@ -0,0 +1,33 @@
+/*  Snapshot Stats
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      "image_stats()" of a box of a video snapshot, computed once per
+ *  snapshot and box and shared by every caller.
+ *
+ *  Callbacks that run together often check the same box of the same frame.
+ *  (e.g. the black and white screen watchers with their default box) Each of
+ *  them used to scan the box again. Only the requested boxes are scanned, so
+ *  this doesn't undo the partial frame conversion.
+ *
+ */
+
+#ifndef PokemonAutomation_CommonFramework_SnapshotStats_H
+#define PokemonAutomation_CommonFramework_SnapshotStats_H
+
+#include "ImageStats.h"
+#include "ImageBoxes.h"
+
+namespace PokemonAutomation{
+
+struct VideoSnapshot;
+
+
+//  Same as "image_stats(extract_box_reference(snapshot, box))".
+ImageStats image_stats(const VideoSnapshot& snapshot, const ImageFloatBox& box);
+FloatPixel image_average(const VideoSnapshot& snapshot, const ImageFloatBox& box);
+
+
+
+}
+#endif
@@ -9,6 +9,7 @@
  */
 
 #include "CommonFramework/ImageTools/SolidColorTest.h"
+#include "CommonFramework/ImageTools/SnapshotStats.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayScopes.h"
 #include "BlackScreenDetector.h"
 
@@ -35,6 +36,9 @@ void BlackScreenDetector::make_overlays(VideoOverlaySet& items) const{
 bool BlackScreenDetector::detect(const ImageViewRGB32& screen) const{
     return is_black(extract_box_reference(screen, m_box), m_max_rgb_sum, m_max_stddev_sum);
 }
+bool BlackScreenDetector::detect(const VideoSnapshot& snapshot) const{
+    return is_black(image_stats(snapshot, m_box), m_max_rgb_sum, m_max_stddev_sum);
+}
 
 
 
@@ -54,6 +58,9 @@ void WhiteScreenDetector::make_overlays(VideoOverlaySet& items) const{
 bool WhiteScreenDetector::detect(const ImageViewRGB32& screen) const{
     return is_white(extract_box_reference(screen, m_box), m_min_rgb_sum, m_max_stddev_sum);
 }
+bool WhiteScreenDetector::detect(const VideoSnapshot& snapshot) const{
+    return is_white(image_stats(snapshot, m_box), m_min_rgb_sum, m_max_stddev_sum);
+}
 
 
 
@@ -68,6 +75,9 @@ BlackScreenWatcher::BlackScreenWatcher(
 void BlackScreenWatcher::make_overlays(VideoOverlaySet& items) const{
     BlackScreenDetector::make_overlays(items);
 }
+bool BlackScreenWatcher::process_frame(const VideoSnapshot& snapshot){
+    return detect(snapshot);
+}
 bool BlackScreenWatcher::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
     return detect(frame);
 }
@@ -86,11 +96,17 @@ BlackScreenOverWatcher::BlackScreenOverWatcher(
 void BlackScreenOverWatcher::make_overlays(VideoOverlaySet& items) const{
     m_detector.make_overlays(items);
 }
+bool BlackScreenOverWatcher::process_frame(const VideoSnapshot& snapshot){
+    return update(m_detector.detect(snapshot));
+}
 bool BlackScreenOverWatcher::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
     return black_is_over(frame);
 }
 bool BlackScreenOverWatcher::black_is_over(const ImageViewRGB32& frame){
-    if (m_detector.detect(frame)){
+    return update(m_detector.detect(frame));
+}
+bool BlackScreenOverWatcher::update(bool black){
+    if (black){
         m_has_been_black = true;
         return false;
     }
@@ -112,11 +128,17 @@ void WhiteScreenOverWatcher::make_overlays(VideoOverlaySet& items) const{
     m_detector.make_overlays(items);
 }
 
+bool WhiteScreenOverWatcher::process_frame(const VideoSnapshot& snapshot){
+    return update(m_detector.detect(snapshot));
+}
 bool WhiteScreenOverWatcher::process_frame(const ImageViewRGB32& frame, WallClock timestamp){
     return white_is_over(frame);
 }
 bool WhiteScreenOverWatcher::white_is_over(const ImageViewRGB32& frame){
-    if (m_detector.detect(frame)){
+    return update(m_detector.detect(frame));
+}
+bool WhiteScreenOverWatcher::update(bool white){
+    if (white){
         m_has_been_white = true;
         return false;
     }
@@ -30,6 +30,11 @@ public:
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
     virtual bool detect(const ImageViewRGB32& screen) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
+
+    //  Same as above. Shares the stats of the box with everyone else checking
+    //  it on the same snapshot.
+    bool detect(const VideoSnapshot& snapshot) const;
 
 private:
     Color m_color;
@@ -48,6 +53,11 @@ public:
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
     virtual bool detect(const ImageViewRGB32& screen) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
+
+    //  Same as above. Shares the stats of the box with everyone else checking
+    //  it on the same snapshot.
+    bool detect(const VideoSnapshot& snapshot) const;
 
 private:
     Color m_color;
@@ -67,6 +77,8 @@ public:
     );
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
+    virtual bool process_frame(const VideoSnapshot& snapshot) override;
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
 };
 
@@ -83,9 +95,14 @@ public:
     bool black_is_over(const ImageViewRGB32& frame);
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
 
+    virtual bool process_frame(const VideoSnapshot& snapshot) override;
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
 
+private:
+    bool update(bool black);
+
 private:
     BlackScreenDetector m_detector;
     bool m_has_been_black = false;
@@ -106,9 +123,14 @@ public:
     bool white_is_over(const ImageViewRGB32& frame);
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
 
+    virtual bool process_frame(const VideoSnapshot& snapshot) override;
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
 
+private:
+    bool update(bool white);
+
 private:
     WhiteScreenDetector m_detector;
     bool m_has_been_white = false;
@@ -19,6 +19,16 @@ class StaticScreenDetector{
 public:
     virtual void make_overlays(VideoOverlaySet& items) const = 0;
     virtual bool detect(const ImageViewRGB32& screen) const = 0;
+
+    //  Return true if "detect()" never reads a pixel outside the boxes added
+    //  by "make_overlays()".
+    virtual bool reads_only_overlay_boxes() const{ return false; }
+
+    //  Return true if "detect()" costs enough that it is worth skipping on
+    //  frames where its boxes haven't changed. See "skip_unchanged_frames()"
+    //  in VisualInferenceCallback. Only used if "reads_only_overlay_boxes()"
+    //  is true.
+    virtual bool skip_unchanged_frames() const{ return false; }
 };
 
 
@@ -66,15 +76,39 @@ public:
     virtual void make_overlays(VideoOverlaySet& items) const override{
         Detector::make_overlays(items);
     }
+    virtual bool reads_only_overlay_boxes() const override{
+        return Detector::reads_only_overlay_boxes();
+    }
+
+    //  "detect()" is const so it gives the same result for the same pixels.
+    virtual bool skip_unchanged_frames() const override{
+        return Detector::reads_only_overlay_boxes() && Detector::skip_unchanged_frames();
+    }
 
     //  If m_finder_type is PRESENT, return true only when it is consecutively detected.
     //  If m_finder_type is GONE, return true only when it is consecutively not detected.
     //  if m_finder_type is CONSISTENT, return true when it is consecutively detected, or consecutively not detected.
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override{
+        m_last_result = this->detect(frame);
+        return process_result(m_last_result, timestamp);
+    }
+
+    //  The detector would see the same thing as last time. Reuse its result
+    //  so the time it has been detected for keeps going up.
+    virtual bool process_unchanged_frame(WallClock timestamp) override{
+        return process_result(m_last_result, timestamp);
+    }
+
+    //  If m_finder_type is CONSISTENT and process_frame() returns true,
+    //  whether it is consecutively detected , or consecutively not detected.
+    bool consistent_result() const { return m_consistent_result; }
+
+private:
+    bool process_result(bool detected, WallClock timestamp){
         switch (m_finder_type){
         case FinderType::PRESENT:
         case FinderType::GONE:
-            if (this->detect(frame) == (m_finder_type == FinderType::GONE)){
+            if (detected == (m_finder_type == FinderType::GONE)){
                 m_start_of_detection = WallClock::min();
                 return false;
             }
@@ -83,7 +117,7 @@ public:
             }
             return timestamp - m_start_of_detection >= m_duration;
         case FinderType::CONSISTENT:{
-            const bool result = this->detect(frame);
+            const bool result = detected;
             const bool result_changed = (result && m_last_detected < 0) || (!result && m_last_detected > 0);
 
             m_last_detected = (result ? 1 : -1);
@@ -107,16 +141,13 @@ public:
         return false;
     }
 
-    //  If m_finder_type is CONSISTENT and process_frame() returns true,
-    //  whether it is consecutively detected , or consecutively not detected.
-    bool consistent_result() const { return m_consistent_result; }
-
 private:
     std::chrono::milliseconds m_duration;
     FinderType m_finder_type;
     WallClock m_start_of_detection = WallClock::min();
     int8_t m_last_detected = 0; // 0: no prior detection, 1: last detected positive, -1: last detected negative
     bool m_consistent_result = false;
+    bool m_last_result = false;
 };
 
 
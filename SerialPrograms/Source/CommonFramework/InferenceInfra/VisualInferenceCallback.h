@@ -32,6 +32,29 @@ public:
     //  regions of interest of the inference callback.
     virtual void make_overlays(VideoOverlaySet& items) const = 0;
 
+    //  Return true if "process_frame()" never reads a pixel outside the boxes
+    //  added by "make_overlays()". When every running callback does this, the
+    //  video feed only needs to convert those parts of the frame.
+    virtual bool reads_only_overlay_boxes() const{ return false; }
+
+    //  Return true to skip "process_frame()" when nothing in the overlay boxes
+    //  has changed since the last frame it was given. "process_unchanged_frame()"
+    //  is called instead. Only used if "reads_only_overlay_boxes()" is true.
+    //  Checking the boxes for changes is not free. It costs about as much as
+    //  averaging 8x8 blocks of them. Only turn this on for callbacks that cost
+    //  a lot more than that, like ones that run waterfill. See the
+    //  "SkipUnchanged/*" kernel benchmarks.
+    virtual bool skip_unchanged_frames() const{ return false; }
+
+    //  Called in place of "process_frame()" for a frame that looks the same
+    //  as the last one that was processed. Callbacks that depend on time, like
+    //  ones that wait for something to be seen for a while, must override this
+    //  to keep their timers going.
+    //  The default returns false. This is right for callbacks whose result
+    //  only depends on the frame since they returned false for the last one.
+    //  Return true if the inference session should stop.
+    virtual bool process_unchanged_frame(WallClock){ return false; }
+
     //  Return true if the inference session should stop.
     //  You must override at least one of the overloaded `process_frame()`.
     virtual bool process_frame(const VideoSnapshot& snapshot);
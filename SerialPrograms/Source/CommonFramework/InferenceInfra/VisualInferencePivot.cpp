@@ -5,7 +5,11 @@
  */
 
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/LatencyTracer.h"
+#include "CommonFramework/ImageTools/RegionSignature.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "CommonFramework/VideoPipeline/VideoOverlay.h"
+#include "CommonFramework/VideoPipeline/VideoOverlayScopes.h"
 #include "VisualInferencePivot.h"
 
 #include <iostream>
@@ -16,6 +20,33 @@ namespace PokemonAutomation{
 
 
 
+namespace{
+
+//  How far the average of an 8x8 block can move in any channel before a
+//  frame counts as changed for "skip_unchanged_frames()".
+const uint8_t UNCHANGED_FRAME_TOLERANCE = 2;
+
+//  Records the boxes a callback draws instead of drawing them.
+class OverlayBoxRecorder : public VideoOverlay{
+public:
+    std::vector<ImageFloatBox> boxes;
+
+    virtual void add_box(const OverlayBox& box) override{
+        boxes.emplace_back(box.box);
+    }
+    virtual void remove_box(const OverlayBox&) override{}
+    virtual void add_text(const OverlayText&) override{}
+    virtual void remove_text(const OverlayText&) override{}
+    virtual void add_log(std::string, Color) override{}
+    virtual void clear_log() override{}
+    virtual void add_stat(OverlayStat&) override{}
+    virtual void remove_stat(OverlayStat&) override{}
+};
+
+}
+
+
+
 struct VisualInferencePivot::PeriodicCallback{
     Cancellable& scope;
     std::atomic<InferenceCallback*>* set_when_triggered;
@@ -24,6 +55,15 @@ struct VisualInferencePivot::PeriodicCallback{
     StatAccumulatorI32 stats;
     uint64_t last_seqnum;
 
+    //  The boxes this callback reads. Only used if "full_frame" is false.
+    std::vector<ImageFloatBox> regions;
+    bool full_frame;
+    uint64_t epoch;     //  "m_regions_epoch" once "regions" were added.
+
+    //  What "regions" looked like in the last frame given to "process_frame()".
+    bool skip_unchanged;
+    RegionSignature signature;
+
     PeriodicCallback(
         Cancellable& p_scope,
         std::atomic<InferenceCallback*>* p_set_when_triggered,
@@ -35,7 +75,24 @@ struct VisualInferencePivot::PeriodicCallback{
         , callback(p_callback)
         , period(p_period)
         , last_seqnum(0)
+        , full_frame(true)
+        , epoch(0)
+        , skip_unchanged(false)
     {}
+
+    //  Returns true if "regions" in "snapshot" look the same as in the last
+    //  frame that was processed. Otherwise "snapshot" becomes that frame.
+    bool is_unchanged(const VideoSnapshot& snapshot){
+        if (!skip_unchanged || !snapshot){
+            return false;
+        }
+        RegionSignature current(*snapshot.frame, regions);
+        if (signature && current.matches(signature, UNCHANGED_FRAME_TOLERANCE)){
+            return true;
+        }
+        signature = std::move(current);
+        return false;
+    }
 };
 
 
@@ -56,6 +113,12 @@ void VisualInferencePivot::add_callback(
     VisualInferenceCallback& callback,
     std::chrono::milliseconds period
 ){
+    OverlayBoxRecorder recorder;
+    if (callback.reads_only_overlay_boxes()){
+        VideoOverlaySet set(recorder);
+        callback.make_overlays(set);
+    }
+
     SpinLockGuard lg(m_lock);
     auto iter = m_map.find(&callback);
     if (iter != m_map.end()){
@@ -66,10 +129,16 @@ void VisualInferencePivot::add_callback(
         std::forward_as_tuple(&callback),
         std::forward_as_tuple(scope, set_when_triggered, callback, period)
     ).first;
+    iter->second.regions = std::move(recorder.boxes);
+    iter->second.full_frame = iter->second.regions.empty();
+    iter->second.skip_unchanged = !iter->second.full_frame && callback.skip_unchanged_frames();
+    update_regions();
+    iter->second.epoch = m_regions_epoch;
     try{
         PeriodicRunner::add_event(&iter->second, period);
     }catch (...){
         m_map.erase(iter);
+        update_regions();
         throw;
     }
 }
@@ -82,23 +151,85 @@ StatAccumulatorI32 VisualInferencePivot::remove_callback(VisualInferenceCallback
     StatAccumulatorI32 stats = iter->second.stats;
     PeriodicRunner::remove_event(&iter->second);
     m_map.erase(iter);
+    update_regions();
     return stats;
 }
+void VisualInferencePivot::update_regions(){
+    m_regions.clear();
+    m_full_frame_callbacks = 0;
+    for (const auto& item : m_map){
+        const PeriodicCallback& callback = item.second;
+        if (callback.full_frame){
+            m_full_frame_callbacks++;
+        }else{
+            m_regions.insert(m_regions.end(), callback.regions.begin(), callback.regions.end());
+        }
+    }
+    m_regions_epoch++;
+}
+void VisualInferencePivot::take_snapshot(){
+    //  Only ask for part of the frame if no running callback needs all of it.
+    //  Otherwise the frame would be converted twice.
+    std::vector<ImageFloatBox> regions;
+    bool full_frame;
+    uint64_t epoch;
+    {
+        SpinLockGuard lg(m_lock);
+        full_frame = m_full_frame_callbacks > 0 || m_regions.empty();
+        if (!full_frame){
+            regions = m_regions;
+        }
+        epoch = m_regions_epoch;
+    }
+
+    LatencyTracer& tracer = LatencyTracer::instance();
+    WallClock time0 = tracer.enabled() ? current_time() : WallClock::min();
+    m_last = full_frame
+        ? m_feed.snapshot()
+        : m_feed.snapshot_regions(regions);
+    m_last_full = full_frame;
+    m_last_epoch = epoch;
+    m_seqnum++;
+
+    //  Tag with the camera's frame seqnum so these join with its "Frame" events.
+    if (time0 != WallClock::min()){
+        tracer.complete(PA_TRACE_INFERENCE, "Snapshot", m_last.seqnum, time0, current_time());
+    }
+}
 void VisualInferencePivot::run(void* event, bool is_back_to_back) noexcept{
     PeriodicCallback& callback = *(PeriodicCallback*)event;
     try{
-        //  Reuse the cached screenshot.
-        if (!is_back_to_back || callback.last_seqnum == m_seqnum){
+        //  Reuse the cached screenshot if it has every pixel this callback
+        //  reads. A partial snapshot only covers the callbacks that were
+        //  running when it was taken.
+        bool covered = m_last_full || (!callback.full_frame && callback.epoch <= m_last_epoch);
+        if (!is_back_to_back || callback.last_seqnum == m_seqnum || !covered){
 //            cout << "back-to-back" << endl;
-            m_last = m_feed.snapshot();
-            m_seqnum++;
+            take_snapshot();
         }
 
         WallClock time0 = current_time();
-        bool stop = callback.callback.process_frame(m_last);
+        bool unchanged = callback.is_unchanged(m_last);
+        bool stop = unchanged
+            ? callback.callback.process_unchanged_frame(m_last.timestamp)
+            : callback.callback.process_frame(m_last);
         WallClock time1 = current_time();
         callback.stats += (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count();
         callback.last_seqnum = m_seqnum;
+
+        //  Latency is the age of the frame at the time the decision was made.
+        LatencyTracer& tracer = LatencyTracer::instance();
+        if (tracer.enabled()){
+            int64_t frame_age = std::chrono::duration_cast<std::chrono::microseconds>(time1 - m_last.timestamp).count();
+            tracer.complete(
+                PA_TRACE_INFERENCE, unchanged ? "process_unchanged_frame" : "process_frame",
+                m_last.seqnum, time0, time1, frame_age
+            );
+            if (stop){
+                tracer.instant(PA_TRACE_INFERENCE, "Triggered", m_last.seqnum, time1, frame_age);
+            }
+        }
+
         if (stop){
             if (callback.set_when_triggered){
                 InferenceCallback* expected = nullptr;
@@ -7,9 +7,11 @@
 #ifndef PokemonAutomation_CommonFramework_VisualInferencePivot_H
 #define PokemonAutomation_CommonFramework_VisualInferencePivot_H
 
+#include <vector>
 #include "Common/Cpp/Concurrency/SpinLock.h"
 #include "Common/Cpp/Concurrency/PeriodicScheduler.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
 #include "CommonFramework/Inference/StatAccumulator.h"
 #include "VisualInferenceCallback.h"
@@ -40,6 +42,11 @@ public:
     StatAccumulatorI32 remove_callback(VisualInferenceCallback& callback);
 
 private:
+    //  Must be called under "m_lock".
+    void update_regions();
+
+    void take_snapshot();
+
     virtual void run(void* event, bool is_back_to_back) noexcept override;
     virtual OverlayStatSnapshot get_current() override;
 
@@ -49,8 +56,16 @@ private:
     VideoFeed& m_feed;
     SpinLock m_lock;
     std::map<VisualInferenceCallback*, PeriodicCallback> m_map;
+
+    //  Union of the boxes of the callbacks that only read their overlays.
+    std::vector<ImageFloatBox> m_regions;
+    size_t m_full_frame_callbacks = 0;
+    uint64_t m_regions_epoch = 0;
+
     VideoSnapshot m_last;
     uint64_t m_seqnum = 0;
+    bool m_last_full = true;
+    uint64_t m_last_epoch = 0;
 
     OverlayStatUtilizationPrinter m_printer;
 };
@@ -61,6 +61,9 @@ int main(int argc, char *argv[]){
         return 1;
     }
 
+    //  Pick the fastest image kernels for this machine. (cached after the first run)
+    GlobalSettings::instance().KERNEL_SELECTION.initialize(global_logger_tagged());
+
 #if 0
     application.connect(
         &application, &QGuiApplication::primaryScreenChanged,
@@ -19,11 +19,13 @@ bool language_available(Language language);
 
 
 //  OCR the image in the specified language.
+//  Results are cached. (see "OCR_ResultCache.h")
 std::string ocr_read(Language language, const ImageViewRGB32& image);
 
 //  Ensure that there are this many parallel instances for this language.
 //  Call this if you expect to need to do many OCR instances in parallel and you
 //  want to preload the OCR instances.
+//  This stops at the global instance limit. (see "OCR_TesseractPool.h")
 void ensure_instances(Language language, size_t instances);
 
 
@@ -0,0 +1,171 @@
+/*  OCR Result Cache
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <string.h>
+#include <algorithm>
+#include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "OCR_ResultCache.h"
+
+namespace PokemonAutomation{
+namespace OCR{
+
+
+namespace{
+
+inline uint64_t mix(uint64_t h, uint64_t x){
+    h ^= x;
+    h *= 0x9e3779b97f4a7c15;
+    h ^= h >> 29;
+    return h;
+}
+
+uint64_t hash_image(const ImageViewRGB32& image){
+    size_t width = image.width();
+    size_t height = image.height();
+    uint64_t h = mix(mix(0xcbf29ce484222325, width), height);
+    for (size_t r = 0; r < height; r++){
+        const uint32_t* row = (const uint32_t*)((const char*)image.data() + r * image.bytes_per_row());
+        size_t c = 0;
+        for (; c + 2 <= width; c += 2){
+            uint64_t x;
+            memcpy(&x, row + c, sizeof(x));
+            h = mix(h, x);
+        }
+        if (c < width){
+            h = mix(h, row[c]);
+        }
+    }
+    return h;
+}
+
+}
+
+
+ResultCache& ResultCache::instance(){
+    static ResultCache cache;
+    return cache;
+}
+
+ResultCache::Key ResultCache::make_key(Language language, const ImageViewRGB32& image){
+    const size_t GRID = 16;
+
+    Key key;
+    key.width = image.width();
+    key.height = image.height();
+    key.hash = mix(hash_image(image), (uint64_t)language);
+
+    size_t grid_x = std::min(GRID, key.width);
+    size_t grid_y = std::min(GRID, key.height);
+    key.samples.reserve(grid_x * grid_y + 1);
+    key.samples.emplace_back((uint32_t)language);
+    for (size_t r = 0; r < grid_y; r++){
+        size_t y = (2 * r + 1) * key.height / (2 * grid_y);
+        for (size_t c = 0; c < grid_x; c++){
+            size_t x = (2 * c + 1) * key.width / (2 * grid_x);
+            key.samples.emplace_back(image.pixel(x, y));
+        }
+    }
+    return key;
+}
+
+
+bool ResultCache::lookup(Language language, const ImageViewRGB32& image, std::string& text){
+    if (!image || image.width() * image.height() > MAX_PIXELS){
+        return false;
+    }
+    Key key = make_key(language, image);
+
+    SpinLockGuard lg(m_lock, "ResultCache::lookup()");
+    auto iter = m_map.find(key.hash);
+    if (iter == m_map.end()){
+        m_misses++;
+        return false;
+    }
+    if (!(iter->second->key == key)){
+        m_collisions++;
+        m_misses++;
+        return false;
+    }
+    m_hits++;
+    m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    text = iter->second->text;
+    return true;
+}
+void ResultCache::store(Language language, const ImageViewRGB32& image, std::string text){
+    if (!image || image.width() * image.height() > MAX_PIXELS){
+        return;
+    }
+    Key key = make_key(language, image);
+
+    SpinLockGuard lg(m_lock, "ResultCache::store()");
+    auto iter = m_map.find(key.hash);
+    if (iter != m_map.end()){
+        //  Either another thread got here first or this is a collision.
+        //  Either way, the newest one wins.
+        iter->second->key = std::move(key);
+        iter->second->text = std::move(text);
+        m_entries.splice(m_entries.begin(), m_entries, iter->second);
+        return;
+    }
+
+    if (m_entries.size() >= MAX_ENTRIES){
+        m_map.erase(m_entries.back().key.hash);
+        m_entries.pop_back();
+    }
+    uint64_t hash = key.hash;
+    m_entries.emplace_front(Entry{std::move(key), std::move(text)});
+    try{
+        m_map.emplace(hash, m_entries.begin());
+    }catch (...){
+        m_entries.pop_front();
+        throw;
+    }
+}
+
+ResultCacheStats ResultCache::stats() const{
+    ResultCacheStats ret;
+    SpinLockGuard lg(m_lock, "ResultCache::stats()");
+    ret.entries = m_entries.size();
+    ret.hits = m_hits;
+    ret.misses = m_misses;
+    ret.collisions = m_collisions;
+    return ret;
+}
+void ResultCache::clear(){
+    SpinLockGuard lg(m_lock, "ResultCache::clear()");
+    m_map.clear();
+    m_entries.clear();
+}
+
+
+
+ResultCacheStat::ResultCacheStat()
+    : m_start(ResultCache::instance().stats())
+{}
+OverlayStatSnapshot ResultCacheStat::get_current(){
+    ResultCacheStats current = ResultCache::instance().stats();
+    uint64_t hits = current.hits - m_start.hits;
+    uint64_t lookups = hits + current.misses - m_start.misses;
+    if (lookups == 0){
+        return OverlayStatSnapshot();
+    }
+
+    OverlayStatSnapshot ret;
+    ret.text =
+        "OCR Cache: " + tostr_fixed(100. * hits / lookups, 1) + "% hits (" +
+        tostr_u_commas(current.entries) + " entries)";
+    uint64_t collisions = current.collisions - m_start.collisions;
+    if (collisions != 0){
+        ret.text += ", " + tostr_u_commas(collisions) + " collisions";
+    }
+    return ret;
+}
+
+
+
+}
+}
@@ -0,0 +1,109 @@
+/*  OCR Result Cache
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Menu-driven programs OCR the same rendered text over and over. Since
+ *  the text is filtered to black/white before it is OCR'ed, the exact same
+ *  filtered image shows up again and again. This remembers the Tesseract
+ *  output for the most recently seen images.
+ *
+ *  Entries are keyed by a 64-bit hash of the pixels and the language. Each
+ *  entry also keeps a small point-sampled copy of the image which must match
+ *  before a hit is returned. So a hash collision is a miss, not a wrong read.
+ *
+ *  The cache is global and shared by all consoles.
+ *
+ */
+
+#ifndef PokemonAutomation_OCR_ResultCache_H
+#define PokemonAutomation_OCR_ResultCache_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/Language.h"
+#include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
+
+namespace PokemonAutomation{
+    class ImageViewRGB32;
+namespace OCR{
+
+
+struct ResultCacheStats{
+    size_t entries = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t collisions = 0;
+};
+
+
+class ResultCache{
+public:
+    static const size_t MAX_ENTRIES = 2048;
+
+    //  Images larger than this aren't worth keeping a sample of.
+    static const size_t MAX_PIXELS = 1024 * 1024;
+
+public:
+    static ResultCache& instance();
+
+    //  Returns true and sets "text" if this image was seen before.
+    bool lookup(Language language, const ImageViewRGB32& image, std::string& text);
+
+    void store(Language language, const ImageViewRGB32& image, std::string text);
+
+    ResultCacheStats stats() const;
+    void clear();
+
+private:
+    struct Key{
+        uint64_t hash;
+        size_t width;
+        size_t height;
+        std::vector<uint32_t> samples;
+
+        bool operator==(const Key& x) const{
+            return width == x.width && height == x.height && samples == x.samples;
+        }
+    };
+    struct Entry{
+        Key key;
+        std::string text;
+    };
+
+    ResultCache() = default;
+    static Key make_key(Language language, const ImageViewRGB32& image);
+
+private:
+    mutable SpinLock m_lock;
+
+    //  Most recently used at the front.
+    std::list<Entry> m_entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_map;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_collisions = 0;
+};
+
+
+
+//  Cache hit rate since this stat was created.
+class ResultCacheStat : public OverlayStat{
+public:
+    ResultCacheStat();
+
+    virtual OverlayStatSnapshot get_current() override;
+
+private:
+    ResultCacheStats m_start;
+};
+
+
+
+}
+}
+#endif
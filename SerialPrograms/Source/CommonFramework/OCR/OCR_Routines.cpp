@@ -4,6 +4,7 @@
  *
  */
 
+#include "Kernels/ImageFilters/Kernels_ImageFilter_Basic.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTools/ImageFilter.h"
 #include "OCR_RawOCR.h"
@@ -71,30 +72,26 @@ StringMatchResult multifiltered_OCR(
 
 
 
+//  These come from the kernel's constant sets so that multifiltered_OCR() runs
+//  the versions of to_blackwhite_rgb32_range() that are specialized for them.
+template <typename RangeSet>
+std::vector<TextColorRange> make_text_filters(){
+    std::vector<TextColorRange> filters;
+    for (const Kernels::Rgb32Range& range : RangeSet::RANGES){
+        filters.emplace_back(range.mins, range.maxs);
+    }
+    return filters;
+}
 const std::vector<TextColorRange>& BLACK_TEXT_FILTERS(){
-    static std::vector<TextColorRange> filters{
-        {0xff000000, 0xff404040},
-        {0xff000000, 0xff606060},
-        {0xff000000, 0xff808080},
-    };
+    static std::vector<TextColorRange> filters = make_text_filters<Kernels::BlackTextRanges>();
     return filters;
 }
 const std::vector<TextColorRange>& WHITE_TEXT_FILTERS(){
-    static std::vector<TextColorRange> filters{
-        {0xff808080, 0xffffffff},
-        {0xffa0a0a0, 0xffffffff},
-        {0xffc0c0c0, 0xffffffff},
-    };
+    static std::vector<TextColorRange> filters = make_text_filters<Kernels::WhiteTextRanges>();
     return filters;
 }
 const std::vector<TextColorRange>& BLACK_OR_WHITE_TEXT_FILTERS(){
-    static std::vector<TextColorRange> filters{
-        {0xff000000, 0xff404040},
-        {0xff000000, 0xff606060},
-        {0xff000000, 0xff808080},
-        {0xff808080, 0xffffffff},
-        {0xffa0a0a0, 0xffffffff},
-    };
+    static std::vector<TextColorRange> filters = make_text_filters<Kernels::BlackOrWhiteTextRanges>();
     return filters;
 }
 
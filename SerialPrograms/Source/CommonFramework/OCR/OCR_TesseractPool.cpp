@@ -0,0 +1,379 @@
+/*  Tesseract Pool
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <QDir>
+#include "3rdParty/TesseractPA/TesseractPA.h"
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/Globals.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "OCR_TesseractPool.h"
+
+namespace PokemonAutomation{
+namespace OCR{
+
+
+TesseractPool& TesseractPool::instance(){
+    static TesseractPool pool;
+    return pool;
+}
+TesseractPool::TesseractPool()
+    : m_training_data_path(
+        QDir::current().relativeFilePath(QString::fromStdString(RESOURCE_PATH() + "Tesseract/")).toStdString()
+    )
+{}
+TesseractPool::~TesseractPool(){
+    for (auto& item : m_pools){
+        for (IdleInstance& idle : item.second.idle){
+            destroy_instance(std::move(idle.api));
+        }
+    }
+}
+
+
+void TesseractPool::destroy_instances(std::vector<std::unique_ptr<TesseractAPI>>& instances){
+    for (std::unique_ptr<TesseractAPI>& api : instances){
+        destroy_instance(std::move(api));
+    }
+    instances.clear();
+}
+void TesseractPool::destroy_instance(std::unique_ptr<TesseractAPI> api){
+#if defined(__APPLE__) && defined(UNIX_LINK_TESSERACT)
+    // As of Feb 05, 2022, the newest Tesseract (5.0.1) installed by HomeBrew on macOS
+    // has a bug that will crash the program when deleting internal Tesseract API intances,
+    // giving error: 
+    // libc++abi.dylib: terminating with uncaught exception of type std::__1::system_error: mutex lock failed: Invalid argument
+    // A similar issue is posted on Tesseract Github: https://github.com/tesseract-ocr/tesseract/issues/3655
+    // There is no way of using HomeBrew to reinstall the older version.
+    // So the instances are leaked instead. This also applies to evicted
+    // instances. So on this build, the limit caps the live instances but
+    // evictions still cost memory.
+    if (api){
+        std::cout << "Warning: not release Tesseract API istance due to mutex bug similar to https://github.com/tesseract-ocr/tesseract/issues/3655" << std::endl;
+        api.release();
+    }
+#else
+    api.reset();
+#endif
+}
+
+
+size_t TesseractPool::instance_limit() const{
+    return std::max<size_t>(GlobalSettings::instance().OCR_INSTANCE_LIMIT, 1);
+}
+std::unique_ptr<TesseractAPI> TesseractPool::evict_idle(Language except, WallClock idle_since){
+    LanguagePool* oldest = nullptr;
+    for (auto& item : m_pools){
+        LanguagePool& current = item.second;
+        if (item.first == except || current.idle.empty() || current.idle.back().last_used > idle_since){
+            continue;
+        }
+        if (oldest == nullptr || current.idle.back().last_used < oldest->idle.back().last_used){
+            oldest = &current;
+        }
+    }
+    if (oldest == nullptr){
+        return nullptr;
+    }
+
+    std::unique_ptr<TesseractAPI> api = std::move(oldest->idle.back().api);
+    oldest->idle.pop_back();
+    oldest->instances--;
+    m_instances--;
+    m_idle--;
+    m_evicted++;
+    return api;
+}
+void TesseractPool::trim_to_limit(std::vector<std::unique_ptr<TesseractAPI>>& freed){
+    size_t limit = instance_limit();
+    while (m_instances > limit){
+        std::unique_ptr<TesseractAPI> api = evict_idle(Language::EndOfList, WallClock::max());
+        if (!api){
+            return;
+        }
+        freed.emplace_back(std::move(api));
+    }
+}
+bool TesseractPool::has_starving_language(Language except) const{
+    for (const auto& item : m_pools){
+        if (item.first != except && item.second.instances == 0 && item.second.waiting != 0){
+            return true;
+        }
+    }
+    return false;
+}
+bool TesseractPool::reserve_slot(
+    Language language, LanguagePool& pool,
+    std::vector<std::unique_ptr<TesseractAPI>>& freed
+){
+    trim_to_limit(freed);
+
+    //  Leave room for languages that have no instances at all.
+    if (pool.instances != 0 && has_starving_language(language)){
+        return false;
+    }
+
+    if (m_instances >= instance_limit()){
+        //  Take over an idle instance of another language. If this language
+        //  already has instances, only take ones that haven't been used in a
+        //  while. Otherwise two busy languages will keep evicting each other
+        //  and creating an instance costs far more than waiting for a read.
+        WallClock idle_since = pool.instances == 0
+            ? WallClock::max()
+            : current_time() - STEAL_AFTER_IDLE;
+        std::unique_ptr<TesseractAPI> api = evict_idle(language, idle_since);
+        if (!api){
+            return false;
+        }
+        freed.emplace_back(std::move(api));
+    }
+
+    pool.instances++;
+    m_instances++;
+    return true;
+}
+void TesseractPool::unreserve_slot(LanguagePool& pool){
+    pool.instances--;
+    m_instances--;
+    m_cv.notify_all();
+}
+
+
+std::unique_ptr<TesseractAPI> TesseractPool::create_instance(Language language){
+    //  Check for non-ascii characters in path.
+    for (char ch : m_training_data_path){
+        if (ch < 0){
+            throw InternalSystemError(
+                nullptr, PA_CURRENT_FUNCTION,
+                "Detected non-ASCII character in Tesseract path. Please move the program to a path with only ASCII characters."
+            );
+        }
+    }
+
+    const std::string& language_code = language_data(language).code;
+    global_logger_tagged().log(
+        "Initializing TesseractAPI (" + language_code + "): " + m_training_data_path
+    );
+    std::unique_ptr<TesseractAPI> api(
+        new TesseractAPI(m_training_data_path.c_str(), language_code.c_str())
+    );
+    if (!api->valid()){
+        throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, "Could not initialize TesseractAPI.");
+    }
+    return api;
+}
+
+
+std::unique_ptr<TesseractAPI> TesseractPool::acquire(Language language){
+    WallClock start = current_time();
+    WallClock deadline = start + ACQUIRE_TIMEOUT;
+    bool waited = false;
+
+    std::vector<std::unique_ptr<TesseractAPI>> freed;
+    {
+        std::unique_lock<std::mutex> lg(m_lock);
+        LanguagePool& pool = m_pools[language];
+        auto record_acquisition = [&]{
+            m_acquisitions++;
+            if (waited){
+                m_waits++;
+                m_wait_micros += std::chrono::duration_cast<std::chrono::microseconds>(current_time() - start).count();
+            }
+        };
+        while (true){
+            if (!pool.idle.empty()){
+                std::unique_ptr<TesseractAPI> api = std::move(pool.idle.front().api);
+                pool.idle.pop_front();
+                m_idle--;
+                record_acquisition();
+                lg.unlock();
+                destroy_instances(freed);
+                return api;
+            }
+            if (reserve_slot(language, pool, freed)){
+                record_acquisition();
+                m_created++;
+                break;
+            }
+
+            if (current_time() >= deadline){
+                m_timeouts++;
+                std::string message =
+                    "Timed out waiting for a Tesseract instance (" + language_data(language).code + "). "
+                    "All " + std::to_string(m_instances) + " instances are busy.";
+                lg.unlock();
+                destroy_instances(freed);
+                throw InternalSystemError(nullptr, PA_CURRENT_FUNCTION, std::move(message));
+            }
+            waited = true;
+            m_waiting++;
+            pool.waiting++;
+            m_cv.wait_until(lg, deadline);
+            pool.waiting--;
+            m_waiting--;
+        }
+    }
+
+    //  A slot is reserved. Free the evicted instances and create the new one
+    //  outside the lock since both are slow.
+    destroy_instances(freed);
+    try{
+        return create_instance(language);
+    }catch (...){
+        std::lock_guard<std::mutex> lg(m_lock);
+        unreserve_slot(m_pools[language]);
+        throw;
+    }
+}
+void TesseractPool::release(Language language, std::unique_ptr<TesseractAPI> api){
+    std::vector<std::unique_ptr<TesseractAPI>> freed;
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        LanguagePool& pool = m_pools[language];
+        if (has_starving_language(language)){
+            //  Another language is waiting with no instances. Free this one
+            //  so it can make its own.
+            freed.emplace_back(std::move(api));
+            pool.instances--;
+            m_instances--;
+            m_evicted++;
+        }else{
+            pool.idle.emplace_front(IdleInstance{std::move(api), current_time()});
+            m_idle++;
+        }
+
+        //  The limit may have been lowered while this instance was in use.
+        trim_to_limit(freed);
+        m_cv.notify_all();
+    }
+    destroy_instances(freed);
+}
+
+
+std::string TesseractPool::read(Language language, const ImageViewRGB32& image){
+    std::unique_ptr<TesseractAPI> api = acquire(language);
+
+    std::string text;
+    try{
+        TesseractString str = api->read32(
+            (const unsigned char*)image.data(),
+            image.width(),
+            image.height(),
+            image.bytes_per_row()
+        );
+        if (str.c_str() != nullptr){
+            text = str.c_str();
+        }
+    }catch (...){
+        release(language, std::move(api));
+        throw;
+    }
+    release(language, std::move(api));
+    return text;
+}
+void TesseractPool::ensure_instances(Language language, size_t instances){
+    while (true){
+        std::vector<std::unique_ptr<TesseractAPI>> freed;
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            LanguagePool& pool = m_pools[language];
+            if (pool.instances >= instances){
+                return;
+            }
+            if (!reserve_slot(language, pool, freed)){
+                global_logger_tagged().log(
+                    "OCR instance limit reached. Unable to preload " + std::to_string(instances) +
+                    " instances of " + language_data(language).code + ".",
+                    COLOR_ORANGE
+                );
+                return;
+            }
+            m_created++;
+        }
+        destroy_instances(freed);
+        std::unique_ptr<TesseractAPI> api;
+        try{
+            api = create_instance(language);
+        }catch (...){
+            std::lock_guard<std::mutex> lg(m_lock);
+            unreserve_slot(m_pools[language]);
+            throw;
+        }
+        release(language, std::move(api));
+    }
+}
+
+
+TesseractPoolStats TesseractPool::stats() const{
+    TesseractPoolStats ret;
+    std::lock_guard<std::mutex> lg(m_lock);
+    ret.instance_limit = instance_limit();
+    ret.instances = m_instances;
+    ret.busy = m_instances - m_idle;
+    ret.waiting = m_waiting;
+    for (const auto& item : m_pools){
+        if (item.second.instances != 0){
+            ret.instances_by_language[item.first] = item.second.instances;
+        }
+    }
+    ret.acquisitions = m_acquisitions;
+    ret.waits = m_waits;
+    ret.wait_micros = m_wait_micros;
+    ret.created = m_created;
+    ret.evicted = m_evicted;
+    ret.timeouts = m_timeouts;
+    return ret;
+}
+
+
+
+TesseractPoolStat::TesseractPoolStat()
+    : m_start(TesseractPool::instance().stats())
+{}
+OverlayStatSnapshot TesseractPoolStat::get_current(){
+    TesseractPoolStats current = TesseractPool::instance().stats();
+    if (current.instances == 0){
+        return OverlayStatSnapshot();
+    }
+
+    OverlayStatSnapshot ret;
+    ret.text =
+        "OCR Pool: " + std::to_string(current.instances) + "/" +
+        std::to_string(current.instance_limit) + " instances (";
+    bool first = true;
+    for (const auto& item : current.instances_by_language){
+        if (!first){
+            ret.text += ", ";
+        }
+        first = false;
+        ret.text += language_data(item.first).code + " " + std::to_string(item.second);
+    }
+    ret.text += "), " + std::to_string(current.busy) + " busy";
+
+    uint64_t acquisitions = current.acquisitions - m_start.acquisitions;
+    if (acquisitions != 0){
+        double wait_ms = (current.wait_micros - m_start.wait_micros) / 1000. / acquisitions;
+        ret.text += ", " + tostr_fixed(wait_ms, 2) + " ms avg wait";
+    }
+    if (current.waiting != 0){
+        ret.text += ", " + std::to_string(current.waiting) + " waiting";
+        ret.color = COLOR_ORANGE;
+    }
+    uint64_t evicted = current.evicted - m_start.evicted;
+    if (evicted != 0){
+        ret.text += ", " + tostr_u_commas(evicted) + " evicted";
+    }
+    return ret;
+}
+
+
+
+}
+}
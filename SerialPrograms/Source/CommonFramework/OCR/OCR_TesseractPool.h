@@ -0,0 +1,149 @@
+/*  Tesseract Pool
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Tesseract instances are not thread-safe and each one holds its own copy
+ *  of the language data. So they are pooled and handed out one reader at a
+ *  time.
+ *
+ *  The pool is global and shared by all consoles and languages. The total
+ *  number of instances is capped by "OCR_INSTANCE_LIMIT" in the global
+ *  settings. When a language needs a new instance and the cap is reached, the
+ *  least recently used idle instance of another language is freed to make
+ *  room. Otherwise the reader waits for an instance to become free.
+ *
+ */
+
+#ifndef PokemonAutomation_OCR_TesseractPool_H
+#define PokemonAutomation_OCR_TesseractPool_H
+
+#include <stdint.h>
+#include <string>
+#include <memory>
+#include <vector>
+#include <list>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include "Common/Cpp/Time.h"
+#include "CommonFramework/Language.h"
+#include "CommonFramework/VideoPipeline/VideoOverlayTypes.h"
+
+class TesseractAPI;
+
+namespace PokemonAutomation{
+    class ImageViewRGB32;
+namespace OCR{
+
+
+struct TesseractPoolStats{
+    size_t instance_limit = 0;
+    size_t instances = 0;           //  Including ones being created.
+    size_t busy = 0;
+    size_t waiting = 0;             //  Readers waiting for an instance.
+    std::map<Language, size_t> instances_by_language;
+
+    uint64_t acquisitions = 0;
+    uint64_t waits = 0;             //  Acquisitions that had to wait.
+    uint64_t wait_micros = 0;       //  Total time spent waiting.
+    uint64_t created = 0;
+    uint64_t evicted = 0;
+    uint64_t timeouts = 0;
+};
+
+
+class TesseractPool{
+public:
+    //  Give up on getting an instance after this long. Reads take tens of
+    //  milliseconds so this only happens if something is stuck.
+    static constexpr Seconds ACQUIRE_TIMEOUT = Seconds(30);
+
+    //  A language that already has instances only takes over idle instances
+    //  of other languages that have been unused for this long.
+    static constexpr Seconds STEAL_AFTER_IDLE = Seconds(10);
+
+public:
+    static TesseractPool& instance();
+    ~TesseractPool();
+
+    std::string read(Language language, const ImageViewRGB32& image);
+
+    //  Create instances until this language has at least this many. Stops
+    //  early if the instance limit is reached and nothing can be evicted.
+    void ensure_instances(Language language, size_t instances);
+
+    TesseractPoolStats stats() const;
+
+
+private:
+    struct IdleInstance{
+        std::unique_ptr<TesseractAPI> api;
+        WallClock last_used;
+    };
+    struct LanguagePool{
+        size_t instances = 0;       //  Idle, busy and being created.
+        size_t waiting = 0;
+        std::list<IdleInstance> idle;   //  Most recently used at the front.
+    };
+
+    TesseractPool();
+
+    std::unique_ptr<TesseractAPI> acquire(Language language);
+    void release(Language language, std::unique_ptr<TesseractAPI> api);
+
+    //  Create an instance for a slot that has already been reserved.
+    std::unique_ptr<TesseractAPI> create_instance(Language language);
+
+    //  These must be called under "m_lock". Instances that are freed are
+    //  returned so they can be destroyed outside the lock.
+    size_t instance_limit() const;
+    std::unique_ptr<TesseractAPI> evict_idle(Language except, WallClock idle_since);
+    void trim_to_limit(std::vector<std::unique_ptr<TesseractAPI>>& freed);
+    bool has_starving_language(Language except) const;
+    bool reserve_slot(
+        Language language, LanguagePool& pool,
+        std::vector<std::unique_ptr<TesseractAPI>>& freed
+    );
+    void unreserve_slot(LanguagePool& pool);
+
+    static void destroy_instances(std::vector<std::unique_ptr<TesseractAPI>>& instances);
+    static void destroy_instance(std::unique_ptr<TesseractAPI> api);
+
+
+private:
+    const std::string m_training_data_path;
+
+    mutable std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::map<Language, LanguagePool> m_pools;
+    size_t m_instances = 0;
+    size_t m_idle = 0;
+    size_t m_waiting = 0;
+
+    uint64_t m_acquisitions = 0;
+    uint64_t m_waits = 0;
+    uint64_t m_wait_micros = 0;
+    uint64_t m_created = 0;
+    uint64_t m_evicted = 0;
+    uint64_t m_timeouts = 0;
+};
+
+
+
+//  Instance counts and the average wait for an instance since this stat was
+//  created.
+class TesseractPoolStat : public OverlayStat{
+public:
+    TesseractPoolStat();
+
+    virtual OverlayStatSnapshot get_current() override;
+
+private:
+    TesseractPoolStats m_start;
+};
+
+
+
+}
+}
+#endif
@@ -0,0 +1,152 @@
+/*  Kernel Selection Option
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "CommonFramework/Environment/Environment.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "KernelSelectionOption.h"
+
+namespace PokemonAutomation{
+
+
+
+KernelSelectionOption::KernelSelectionOption()
+    : GroupOption("Kernel Selection", LockWhileRunning::LOCKED, true, true)
+    , DESCRIPTION(
+        "Time each available version of the image kernels (binary filters and waterfill) "
+        "and use the fastest one. If disabled, the kernels are chosen by CPU features only.<br>"
+        "The calibration runs once at startup and the result is saved for this processor."
+    )
+    , STATUS("")
+    , RECALIBRATE(
+        "<b>Recalibrate:</b><br>Discard the saved result and run the calibration again on the next launch.",
+        LockWhileRunning::LOCKED,
+        false
+    )
+{
+    PA_ADD_STATIC(DESCRIPTION);
+    PA_ADD_STATIC(STATUS);
+    PA_ADD_OPTION(RECALIBRATE);
+    update_status();
+}
+
+void KernelSelectionOption::load_json(const JsonValue& json){
+    GroupOption::load_json(json);
+    const JsonObject* obj = json.get_object();
+    if (obj == nullptr){
+        return;
+    }
+    const JsonObject* calibration = obj->get_object("Calibration");
+    if (calibration == nullptr){
+        return;
+    }
+
+    //  Same rule as ProcessorLevelOption. Timings from another processor are useless.
+    const std::string* processor = calibration->get_string("ProcessorString");
+    if (processor == nullptr || *processor != get_processor_name()){
+        global_logger_tagged().log("Mismatched processor string. Will not load saved kernel calibration.", COLOR_RED);
+        return;
+    }
+    const std::string* best = calibration->get_string("Best");
+    if (best == nullptr){
+        return;
+    }
+
+    KernelCalibrationResult result;
+    result.best = find_kernel_variant(*best);
+    if (result.best == nullptr){
+        return;
+    }
+    const JsonObject* timings = calibration->get_object("Timings");
+    if (timings != nullptr){
+        for (const KernelVariant& variant : KERNEL_VARIANTS()){
+            double milliseconds;
+            if (timings->read_float(milliseconds, variant.name)){
+                result.timings.emplace_back(KernelTiming{&variant, milliseconds});
+            }
+        }
+    }
+
+    {
+        SpinLockGuard lg(m_lock);
+        m_processor = *processor;
+        m_result = std::move(result);
+    }
+    apply();
+}
+JsonValue KernelSelectionOption::to_json() const{
+    JsonObject obj = std::move(*GroupOption::to_json().get_object());
+
+    SpinLockGuard lg(m_lock);
+    if (m_result.best == nullptr){
+        return obj;
+    }
+    JsonObject calibration;
+    calibration["ProcessorString"] = m_processor;
+    calibration["Best"] = m_result.best->name;
+    JsonObject timings;
+    for (const KernelTiming& timing : m_result.timings){
+        timings[timing.variant->name] = timing.milliseconds;
+    }
+    calibration["Timings"] = std::move(timings);
+    obj["Calibration"] = std::move(calibration);
+    return obj;
+}
+
+void KernelSelectionOption::on_set_enabled(bool){
+    apply();
+}
+
+void KernelSelectionOption::initialize(Logger& logger){
+    bool cached;
+    {
+        SpinLockGuard lg(m_lock);
+        cached = m_result.best != nullptr && kernel_variant_available(*m_result.best);
+    }
+    if (enabled() && (!cached || RECALIBRATE)){
+        KernelCalibrationResult result = calibrate_kernels(logger);
+        if (result.best != nullptr){
+            SpinLockGuard lg(m_lock);
+            m_processor = get_processor_name();
+            m_result = std::move(result);
+        }
+        RECALIBRATE = false;
+    }
+    apply();
+    logger.log(std::string("Image Kernels: ") + current_kernel_variant().name, COLOR_BLUE);
+}
+
+void KernelSelectionOption::apply(){
+    const KernelVariant* best;
+    {
+        SpinLockGuard lg(m_lock);
+        best = m_result.best;
+    }
+    if (enabled() && best != nullptr){
+        apply_kernel_variant(*best);
+    }else{
+        clear_kernel_variant();
+    }
+    update_status();
+}
+void KernelSelectionOption::update_status(){
+    std::string text = "<b>Current Kernels:</b> ";
+    text += current_kernel_variant().name;
+    text += "<br><b>CPU Feature Default:</b> ";
+    text += default_kernel_variant().name;
+
+    SpinLockGuard lg(m_lock);
+    if (!m_result.timings.empty()){
+        text += "<br><b>Calibration (ms per 1080p frame):</b> " + m_result.to_str();
+    }
+    STATUS.set_text(std::move(text));
+}
+
+
+
+}
@@ -0,0 +1,54 @@
+/*  Kernel Selection Option
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Pick the image kernels by timing them instead of by CPU features alone.
+ *  The result is cached in the settings along with the processor string so
+ *  the calibration only runs once per machine.
+ *
+ */
+
+#ifndef PokemonAutomation_KernelSelectionOption_H
+#define PokemonAutomation_KernelSelectionOption_H
+
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Options/StaticTextOption.h"
+#include "Common/Cpp/Options/BooleanCheckBoxOption.h"
+#include "Common/Cpp/Options/GroupOption.h"
+#include "CommonFramework/Environment/KernelCalibration.h"
+
+namespace PokemonAutomation{
+
+
+class KernelSelectionOption : public GroupOption{
+public:
+    KernelSelectionOption();
+
+    virtual void load_json(const JsonValue& json) override;
+    virtual JsonValue to_json() const override;
+
+    virtual void on_set_enabled(bool enabled) override;
+
+    //  Call once at startup before anything uses the kernels.
+    //  Runs the calibration if there is no cached result for this machine.
+    void initialize(Logger& logger);
+
+public:
+    StaticTextOption DESCRIPTION;
+    StaticTextOption STATUS;
+    BooleanCheckBoxOption RECALIBRATE;
+
+private:
+    void apply();
+    void update_status();
+
+private:
+    mutable SpinLock m_lock;
+    std::string m_processor;
+    KernelCalibrationResult m_result;
+};
+
+
+
+}
+#endif
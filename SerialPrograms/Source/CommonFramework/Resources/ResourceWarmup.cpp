@@ -0,0 +1,136 @@
+/*  Resource Warmup
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/AbstractLogger.h"
+#include "Common/Cpp/Concurrency/ParallelTaskRunner.h"
+#include "CommonFramework/GlobalSettingsPanel.h"
+#include "ResourceWarmup.h"
+
+namespace PokemonAutomation{
+
+
+struct WarmupResourceEntry{
+    std::function<void()> loader;
+
+    //  Held while loading so that two sessions starting at the same time
+    //  don't both pay for it.
+    std::mutex lock;
+    bool loaded = false;
+};
+
+std::map<std::string, std::unique_ptr<WarmupResourceEntry>>& warmup_registry(){
+    static std::map<std::string, std::unique_ptr<WarmupResourceEntry>> registry;
+    return registry;
+}
+std::mutex& warmup_registry_lock(){
+    static std::mutex lock;
+    return lock;
+}
+
+
+
+ResourceWarmupRegistration::ResourceWarmupRegistration(std::string name, std::function<void()> loader){
+    std::lock_guard<std::mutex> lg(warmup_registry_lock());
+    std::unique_ptr<WarmupResourceEntry>& entry = warmup_registry()[std::move(name)];
+    if (!entry){
+        entry.reset(new WarmupResourceEntry());
+    }
+    entry->loader = std::move(loader);
+}
+
+
+
+void ResourceWarmupManifest::add(std::string name){
+    if (std::find(m_names.begin(), m_names.end(), name) == m_names.end()){
+        m_names.emplace_back(std::move(name));
+    }
+}
+
+
+
+void preload_resources(Logger& logger, const ResourceWarmupManifest& manifest){
+    if (manifest.empty()){
+        return;
+    }
+
+    std::vector<std::pair<const std::string*, WarmupResourceEntry*>> entries;
+    {
+        std::lock_guard<std::mutex> lg(warmup_registry_lock());
+        const auto& registry = warmup_registry();
+        for (const std::string& name : manifest.names()){
+            auto iter = registry.find(name);
+            if (iter == registry.end()){
+                throw InternalProgramError(
+                    &logger, PA_CURRENT_FUNCTION,
+                    "Resource was never registered for warmup: " + name
+                );
+            }
+            entries.emplace_back(&iter->first, iter->second.get());
+        }
+    }
+
+    logger.log("Preloading " + std::to_string(entries.size()) + " resource(s)...");
+    auto start = std::chrono::steady_clock::now();
+
+    //  Milliseconds per resource. Negative if it was already loaded.
+    std::vector<double> times(entries.size(), -1);
+    {
+        size_t threads = std::thread::hardware_concurrency();
+        threads = std::max<size_t>(std::min(threads, entries.size()), 1);
+        ParallelTaskRunner runner(
+            [](){ GlobalSettings::instance().COMPUTE_PRIORITY0.set_on_this_thread(); },
+            0, threads
+        );
+        std::vector<std::shared_ptr<AsyncTask>> tasks;
+        for (size_t c = 0; c < entries.size(); c++){
+            tasks.emplace_back(runner.dispatch([&, c]{
+                WarmupResourceEntry& entry = *entries[c].second;
+                std::lock_guard<std::mutex> lg(entry.lock);
+                if (entry.loaded){
+                    return;
+                }
+                auto time0 = std::chrono::steady_clock::now();
+                entry.loader();
+                auto time1 = std::chrono::steady_clock::now();
+                entry.loaded = true;
+                times[c] = std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() / 1000.;
+            }));
+        }
+        runner.wait_for_everything();
+        for (std::shared_ptr<AsyncTask>& task : tasks){
+            task->wait_and_rethrow_exceptions();
+        }
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double total = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.;
+
+    size_t skipped = 0;
+    for (size_t c = 0; c < entries.size(); c++){
+        if (times[c] < 0){
+            skipped++;
+            continue;
+        }
+        logger.log("    " + *entries[c].first + ": " + tostr_fixed(times[c], 1) + " ms");
+    }
+    std::string summary = "Preloaded resources in " + tostr_fixed(total, 1) + " ms.";
+    if (skipped != 0){
+        summary += " (" + std::to_string(skipped) + " already loaded)";
+    }
+    logger.log(summary);
+}
+
+
+
+}
@@ -0,0 +1,57 @@
+/*  Resource Warmup
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Most matchers and sprite databases are function-local statics that are
+ *  built on first use. If that first use is inside "process_frame()", the
+ *  inference thread stalls until they are loaded.
+ *
+ *  To avoid this, detectors register a loader for each such resource under a
+ *  name. Programs list the names they need and the program session loads all
+ *  of them in parallel before "program()" is called.
+ *
+ */
+
+#ifndef PokemonAutomation_Resources_ResourceWarmup_H
+#define PokemonAutomation_Resources_ResourceWarmup_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace PokemonAutomation{
+
+class Logger;
+
+
+//  Declare one of these at namespace scope in the file that owns the resource.
+//  The loader may be called from any thread. It only needs to touch the
+//  resource so that it gets built.
+class ResourceWarmupRegistration{
+public:
+    ResourceWarmupRegistration(std::string name, std::function<void()> loader);
+};
+
+
+//  The resources that a program wants loaded before it starts.
+class ResourceWarmupManifest{
+public:
+    void add(std::string name);
+
+    bool empty() const{ return m_names.empty(); }
+    const std::vector<std::string>& names() const{ return m_names; }
+
+private:
+    std::vector<std::string> m_names;
+};
+
+
+//  Load everything in the manifest in parallel and wait for it to finish.
+//  Logs how long each resource took. Resources that were already loaded are
+//  skipped. Throws if a name was never registered or if a loader throws.
+void preload_resources(Logger& logger, const ResourceWarmupManifest& manifest);
+
+
+
+}
+#endif
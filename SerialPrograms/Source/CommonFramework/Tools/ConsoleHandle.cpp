@@ -4,10 +4,15 @@
  *
  */
 
+#include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/VideoPipeline/VideoOverlay.h"
 #include "CommonFramework/VideoPipeline/ThreadUtilizationStats.h"
+#include "CommonFramework/VideoPipeline/FrameHistoryRecorder.h"
+#include "CommonFramework/VideoPipeline/BufferPoolStats.h"
 #include "CommonFramework/InferenceInfra/VisualInferencePivot.h"
 #include "CommonFramework/InferenceInfra/AudioInferencePivot.h"
+#include "CommonFramework/OCR/OCR_ResultCache.h"
+#include "CommonFramework/OCR/OCR_TesseractPool.h"
 #include "ConsoleHandle.h"
 
 //#include <iostream>
@@ -19,6 +24,18 @@ namespace PokemonAutomation{
 
 ConsoleHandle::ConsoleHandle(ConsoleHandle&& x) = default;
 ConsoleHandle::~ConsoleHandle(){
+    if (m_frame_history){
+        m_overlay.remove_stat(*m_frame_history);
+    }
+    if (m_buffer_pool){
+        m_overlay.remove_stat(*m_buffer_pool);
+    }
+    if (m_ocr_pool){
+        m_overlay.remove_stat(*m_ocr_pool);
+    }
+    if (m_ocr_cache){
+        m_overlay.remove_stat(*m_ocr_cache);
+    }
     m_overlay.remove_stat(*m_audio_pivot);
     m_overlay.remove_stat(*m_video_pivot);
     m_overlay.remove_stat(*m_thread_utilization);
@@ -50,6 +67,20 @@ void ConsoleHandle::initialize_inference_threads(CancellableScope& scope, AsyncD
     m_audio_pivot = std::make_unique<AudioInferencePivot>(scope, m_audio, dispatcher);
     m_overlay.add_stat(*m_video_pivot);
     m_overlay.add_stat(*m_audio_pivot);
+    m_ocr_cache = std::make_unique<OCR::ResultCacheStat>();
+    m_overlay.add_stat(*m_ocr_cache);
+    m_ocr_pool = std::make_unique<OCR::TesseractPoolStat>();
+    m_overlay.add_stat(*m_ocr_pool);
+    if (PreloadSettings::instance().DEVELOPER_MODE){
+        m_buffer_pool = std::make_unique<BufferPoolStat>();
+        m_overlay.add_stat(*m_buffer_pool);
+    }
+
+    const FrameHistoryOption& frame_history = GlobalSettings::instance().FRAME_HISTORY;
+    if (frame_history.enabled()){
+        m_frame_history = std::make_unique<FrameHistoryRecorder>(scope, m_logger, m_video, dispatcher, frame_history);
+        m_overlay.add_stat(*m_frame_history);
+    }
 }
 
 
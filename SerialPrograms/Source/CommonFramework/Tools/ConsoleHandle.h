@@ -22,6 +22,12 @@ class AudioFeed;
 class ThreadUtilizationStat;
 class VisualInferencePivot;
 class AudioInferencePivot;
+class FrameHistoryRecorder;
+class BufferPoolStat;
+namespace OCR{
+    class ResultCacheStat;
+    class TesseractPoolStat;
+}
 
 
 class ConsoleHandle{
@@ -80,6 +86,10 @@ private:
     std::unique_ptr<ThreadUtilizationStat> m_thread_utilization;
     std::unique_ptr<VisualInferencePivot> m_video_pivot;
     std::unique_ptr<AudioInferencePivot> m_audio_pivot;
+    std::unique_ptr<FrameHistoryRecorder> m_frame_history;
+    std::unique_ptr<OCR::ResultCacheStat> m_ocr_cache;
+    std::unique_ptr<OCR::TesseractPoolStat> m_ocr_pool;
+    std::unique_ptr<BufferPoolStat> m_buffer_pool;
 };
 
 
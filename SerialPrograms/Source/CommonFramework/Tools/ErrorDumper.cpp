@@ -7,12 +7,14 @@
 #include <mutex>
 #include <QDir>
 #include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/LatencyTracer.h"
 #include "Common/Cpp/PrettyPrint.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/Notifications/EventNotificationOption.h"
 #include "CommonFramework/Notifications/ProgramInfo.h"
 #include "CommonFramework/Notifications/ProgramNotifications.h"
+#include "CommonFramework/VideoPipeline/FrameHistoryRecorder.h"
 #include "CommonFramework/VideoPipeline/VideoFeed.h"
 #include "CommonFramework/VideoPipeline/VideoOverlay.h"
 #include "ConsoleHandle.h"
@@ -22,8 +24,11 @@ namespace PokemonAutomation{
 
 
 
+namespace{
+
+//  If "feed" is null, save the frame history of every console.
 std::string dump_image(
-    Logger& logger,
+    Logger& logger, const VideoFeed* feed,
     const ProgramInfo& program_info, const std::string& label,
     const ImageViewRGB32& image
 ){
@@ -31,13 +36,19 @@ std::string dump_image(
     std::lock_guard<std::mutex> lg(lock);
 
     QDir().mkdir("ErrorDumps");
-    std::string name = "ErrorDumps/";
-    name += now_to_filestring();
-    name += "-";
-    name += label;
-    name += ".png";
+    std::string prefix = "ErrorDumps/";
+    prefix += now_to_filestring();
+    prefix += "-";
+    prefix += label;
+    std::string name = prefix + ".png";
     logger.log("Saving failed inference image to: " + name, COLOR_RED);
     image.save(name);
+    dump_latency_trace(logger, prefix);
+    if (feed != nullptr){
+        FrameHistoryRecorder::dump(logger, *feed, prefix);
+    }else{
+        FrameHistoryRecorder::dump_all(logger, prefix);
+    }
     send_program_telemetry(
         logger, true, COLOR_RED,
         program_info,
@@ -48,6 +59,41 @@ std::string dump_image(
     return name;
 }
 
+}
+
+std::string dump_image(
+    ConsoleHandle& console,
+    const ProgramInfo& program_info, const std::string& label,
+    const ImageViewRGB32& image
+){
+    return dump_image(console.logger(), &console.video(), program_info, label, image);
+}
+std::string dump_image(
+    Logger& logger,
+    const ProgramInfo& program_info, const std::string& label,
+    const ImageViewRGB32& image
+){
+    return dump_image(logger, nullptr, program_info, label, image);
+}
+
+std::string dump_latency_trace(Logger& logger, const std::string& path_prefix){
+    LatencyTracer& tracer = LatencyTracer::instance();
+    if (!tracer.enabled()){
+        return "";
+    }
+    std::string name = path_prefix + "-trace.json";
+    try{
+        if (!tracer.dump(name)){
+            return "";
+        }
+    }catch (FileException& e){
+        logger.log("Unable to save latency trace: " + e.message(), COLOR_RED);
+        return "";
+    }
+    logger.log("Saved latency trace to: " + name, COLOR_PURPLE);
+    return name;
+}
+
 void dump_image_and_throw_recoverable_exception(
     ProgramEnvironment& env,
     ConsoleHandle& console,
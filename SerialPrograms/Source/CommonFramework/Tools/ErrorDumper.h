@@ -21,12 +21,23 @@ struct ProgramInfo;
 
 // Dump error image to ./ErrorDumps/ folder. Also send image as telemetry if user allows.
 // Return image path.
+// The frame history of the console is saved with it. The overload without a console
+// saves the frame history of every console.
+std::string dump_image(
+    ConsoleHandle& console,
+    const ProgramInfo& program_info, const std::string& label,
+    const ImageViewRGB32& image
+);
 std::string dump_image(
     Logger& logger,
     const ProgramInfo& program_info, const std::string& label,
     const ImageViewRGB32& image
 );
 
+// If latency tracing is enabled, save the trace to "<path_prefix>-trace.json".
+// Return the trace path, or an empty string if nothing was saved.
+std::string dump_latency_trace(Logger& logger, const std::string& path_prefix);
+
 // dump a screenshot to ./ErrorDumps/ folder and throw an OperationFailedException.
 // Also send image as telemetry if user allows.
 // notification_error: the notification option used to set whether user wants to receive notifiction for
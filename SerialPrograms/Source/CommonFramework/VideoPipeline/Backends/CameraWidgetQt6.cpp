@@ -9,10 +9,8 @@
 
 #include <chrono>
 #include <iostream>
-#include <QCamera>
 #include <QPainter>
 #include <QMediaDevices>
-#include <QVideoSink>
 //#include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/VideoPipeline/CameraOption.h"
 #include "CameraWidgetQt6.h"
@@ -81,9 +79,6 @@ CameraSession::CameraSession(Logger& logger, Resolution default_resolution)
     : m_logger(logger)
     , m_default_resolution(default_resolution)
     , m_resolution(default_resolution)
-    , m_last_frame_seqnum(0)
-    , m_last_image_timestamp(WallClock::min())
-    , m_stats_conversion("ConvertFrame", "ms", 1000, std::chrono::seconds(10))
 {}
 
 void CameraSession::get(CameraOption& option){
@@ -118,23 +113,21 @@ void CameraSession::set_source(CameraInfo device){
 }
 void CameraSession::set_resolution(Resolution resolution){
     QMetaObject::invokeMethod(this, [this, resolution]{
-        std::lock_guard<std::mutex> lg(m_lock);
-        if (!m_capture){
-            m_resolution = resolution;
-            return;
+        std::shared_ptr<CaptureDevice> capture;
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+            capture = m_capture;
+            if (!capture){
+                m_resolution = resolution;
+                return;
+            }
         }
         m_logger.log("Setting resolution to: " + resolution.to_string());
-        auto iter = m_resolution_map.find(resolution);
-        if (iter == m_resolution_map.end()){
+
+        //  This changes it for every session on the device. They are all
+        //  told through "resolution_change()". Including this one.
+        if (!capture->set_resolution(resolution)){
             m_logger.log("Resolution not supported.", COLOR_RED);
-            return;
-        }
-        m_resolution = resolution;
-        m_camera->stop();
-        m_camera->setCameraFormat(*iter->second);
-        m_camera->start();
-        for (Listener* listener : m_ui_listeners){
-            listener->resolution_change(resolution);
         }
     });
 }
@@ -147,75 +140,75 @@ Resolution CameraSession::current_resolution() const{
     return m_resolution;
 }
 std::vector<Resolution> CameraSession::supported_resolutions() const{
-    std::lock_guard<std::mutex> lg(m_lock);
-    std::vector<Resolution> ret;
-    for (const auto& item : m_resolution_map){
-        ret.emplace_back(item.first);
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
+        return {};
     }
-    return ret;
+    return capture->supported_resolutions();
+}
+std::shared_ptr<CaptureDevice> CameraSession::capture() const{
+    SpinLockGuard lg(m_capture_lock);
+    return m_capture;
 }
 std::pair<QVideoFrame, uint64_t> CameraSession::latest_frame(){
-    SpinLockGuard lg(m_frame_lock);
-    return {m_last_frame, m_last_frame_seqnum};
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
+        return {QVideoFrame(), 0};
+    }
+    return capture->latest_frame();
 }
 void CameraSession::report_rendered_frame(WallClock timestamp){
-    SpinLockGuard lg(m_frame_lock);
+    SpinLockGuard lg(m_capture_lock);
     m_fps_tracker_display.push_event(timestamp);
 }
 
 VideoSnapshot CameraSession::snapshot(){
-    //  Prevent multiple concurrent screenshots from entering here.
-    std::lock_guard<std::mutex> lg(m_lock);
-
-    if (m_camera == nullptr){
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
         return VideoSnapshot();
     }
-
-    //  Frame is already cached and is not stale.
-    QVideoFrame frame;
-    WallClock frame_timestamp;
-    uint64_t frame_seqnum;
-    {
-        SpinLockGuard lg0(m_frame_lock);
-        frame_seqnum = m_last_frame_seqnum;
-        if (!m_last_image.isNull() && m_last_image_seqnum == frame_seqnum){
-            return VideoSnapshot(m_last_image, m_last_image_timestamp);
-        }
-        frame = m_last_frame;
-        frame_timestamp = m_last_frame_timestamp;
-    }
-
-    if (!frame.isValid()){
-        global_logger_tagged().log("QVideoFrame is null.", COLOR_RED);
+    return capture->snapshot();
+}
+VideoSnapshot CameraSession::snapshot_regions(const std::vector<ImageFloatBox>& regions){
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
         return VideoSnapshot();
     }
-
-    WallClock time0 = current_time();
-
-    QImage image = frame.toImage();
-    QImage::Format format = image.format();
-    if (format != QImage::Format_ARGB32 && format != QImage::Format_RGB32){
-        image = image.convertToFormat(QImage::Format_ARGB32);
+    return capture->snapshot_regions(regions);
+}
+VideoSnapshot CameraSession::snapshot_downscaled(size_t max_width){
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
+        return VideoSnapshot();
     }
-
-    m_last_image = std::move(image);
-    m_last_image_timestamp = frame_timestamp;
-    m_last_image_seqnum = frame_seqnum;
-
-    WallClock time1 = current_time();
-    m_stats_conversion.report_data(m_logger, std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count());
-
-    return VideoSnapshot(m_last_image, m_last_image_timestamp);
+    return capture->snapshot_downscaled(max_width);
 }
 double CameraSession::fps_source(){
-    SpinLockGuard lg(m_frame_lock);
-    return m_fps_tracker_source.events_per_second();
+    std::shared_ptr<CaptureDevice> capture = this->capture();
+    if (!capture){
+        return 0;
+    }
+    return capture->fps_source();
 }
 double CameraSession::fps_display(){
-    SpinLockGuard lg(m_frame_lock);
+    SpinLockGuard lg(m_capture_lock);
     return m_fps_tracker_display.events_per_second();
 }
 
+void CameraSession::new_frame_available(){
+    std::lock_guard<std::mutex> lg(m_lock);
+    for (FrameListener* listener : m_frame_listeners){
+        listener->new_frame_available();
+    }
+}
+void CameraSession::resolution_change(Resolution resolution){
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_resolution = resolution;
+    for (Listener* listener : m_ui_listeners){
+        listener->resolution_change(resolution);
+    }
+}
+
 
 void CameraSession::shutdown(){
     if (!m_capture){
@@ -223,26 +216,17 @@ void CameraSession::shutdown(){
     }
     m_logger.log("Stopping Camera...");
 
-    m_camera->stop();
     for (Listener* listener : m_ui_listeners){
         listener->shutdown();
     }
-    m_capture.reset();
-    m_video_sink.reset();
-    m_camera.reset();
-    m_resolution_map.clear();
-    m_formats.clear();
-
-    SpinLockGuard lg(m_frame_lock);
-
-    m_last_frame = QVideoFrame();
-    m_last_frame_timestamp = current_time();
-    m_last_frame_seqnum++;
-
-    m_last_image = QImage();
-    m_last_image_timestamp = m_last_frame_timestamp;
-    m_last_image_seqnum = m_last_frame_seqnum;
 
+    std::shared_ptr<CaptureDevice> capture;
+    {
+        SpinLockGuard lg(m_capture_lock);
+        capture = std::move(m_capture);
+    }
+    capture->remove_consumer(*this);
+    CaptureHub::instance().release(capture);
 }
 void CameraSession::startup(){
     if (!m_device){
@@ -250,89 +234,18 @@ void CameraSession::startup(){
     }
     m_logger.log("Starting Camera: Backend = CameraQt6QVideoSink");
 
-    auto cameras = QMediaDevices::videoInputs();
-    const QCameraDevice* device = nullptr;
-    for (const auto& camera : cameras){
-        if (camera.id().toStdString() == m_device.device_name()){
-            device = &camera;
-            break;
-        }
-    }
-    if (device == nullptr){
-        m_logger.log("Camera not found: " + m_device.device_name(), COLOR_RED);
-        return;
-    }
-
-    m_formats = device->videoFormats();
-    if (m_formats.empty()){
-        m_logger.log("No usable resolutions: " + device->description().toStdString(), COLOR_RED);
+    std::shared_ptr<CaptureDevice> capture = CaptureHub::instance().acquire(
+        m_logger, m_device, m_resolution, m_default_resolution
+    );
+    if (!capture){
         return;
     }
-
-    m_resolution_map.clear();
-    for (const QCameraFormat& format : m_formats){
-        QSize resolution = format.resolution();
-        m_resolution_map.emplace(
-            std::piecewise_construct,
-            std::forward_as_tuple(resolution.width(), resolution.height()),
-            std::forward_as_tuple(&format)
-        );
-    }
-
-    const QCameraFormat* default_format = nullptr;
-    const QCameraFormat* desired_format = nullptr;
-    m_resolutions.clear();
-    for (const auto& item : m_resolution_map){
-        m_resolutions.emplace_back(item.first);
-        if (item.first == m_default_resolution){
-            default_format = item.second;
-        }
-        if (item.first == m_resolution){
-            desired_format = item.second;
-        }
-    }
-    if (desired_format == nullptr){
-        desired_format = default_format;
-    }
-    if (desired_format == nullptr){
-        desired_format = m_resolution_map.rbegin()->second;
+    m_resolution = capture->resolution();
+    capture->add_consumer(*this);
+    {
+        SpinLockGuard lg(m_capture_lock);
+        m_capture = std::move(capture);
     }
-//    cout << "CameraSession::m_resolutions = " << m_resolutions.size() << endl;
-
-    QSize size = desired_format->resolution();
-    m_resolution = Resolution(size.width(), size.height());
-
-    m_camera.reset(new QCamera(*device));
-    m_camera->setCameraFormat(*desired_format);
-    m_video_sink.reset(new QVideoSink());
-    m_capture.reset(new QMediaCaptureSession());
-    m_capture->setCamera(m_camera.get());
-    m_capture->setVideoSink(m_video_sink.get());
-
-    connect(m_camera.get(), &QCamera::errorOccurred, this, [&](){
-        if (m_camera->error() != QCamera::NoError){
-            m_logger.log("QCamera error: " + m_camera->errorString().toStdString());
-        }
-    });
-    connect(
-        m_video_sink.get(), &QVideoSink::videoFrameChanged,
-        this, [&](const QVideoFrame& frame){
-            {
-                WallClock now = current_time();
-                SpinLockGuard lg(m_frame_lock);
-                m_last_frame = frame;
-                m_last_frame_timestamp = now;
-                m_last_frame_seqnum++;
-                m_fps_tracker_source.push_event(now);
-            }
-            std::lock_guard<std::mutex> lg(m_lock);
-            for (FrameListener* listener : m_frame_listeners){
-                listener->new_frame_available();
-            }
-        }
-    );
-
-    m_camera->start();
 
     for (Listener* listener : m_ui_listeners){
         listener->new_source(m_device, m_resolution);
@@ -12,20 +12,16 @@
 
 #include <set>
 #include <mutex>
-#include <QCameraDevice>
-#include <QMediaCaptureSession>
 #include <QVideoFrame>
 #include "Common/Cpp/EventRateTracker.h"
 #include "Common/Cpp/LifetimeSanitizer.h"
 #include "Common/Cpp/Concurrency/SpinLock.h"
-#include "CommonFramework/Inference/StatAccumulator.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
 #include "CommonFramework/VideoPipeline/CameraInfo.h"
 #include "CommonFramework/VideoPipeline/CameraSession.h"
 #include "CommonFramework/VideoPipeline/UI/VideoWidget.h"
 #include "CameraImplementations.h"
-
-class QCamera;
-class QVideoSink;
+#include "CaptureHubQt6.h"
 
 namespace PokemonAutomation{
 namespace CameraQt6QVideoSink{
@@ -46,7 +42,7 @@ struct FrameListener{
 
 
 
-class CameraSession : public QObject, public PokemonAutomation::CameraSession{
+class CameraSession : public QObject, public PokemonAutomation::CameraSession, private CaptureDevice::Consumer{
 public:
     virtual void add_listener(Listener& listener) override;
     virtual void remove_listener(Listener& listener) override;
@@ -70,6 +66,8 @@ public:
     virtual std::vector<Resolution> supported_resolutions() const override;
 
     virtual VideoSnapshot snapshot() override;
+    virtual VideoSnapshot snapshot_regions(const std::vector<ImageFloatBox>& regions) override;
+    virtual VideoSnapshot snapshot_downscaled(size_t max_width) override;
     virtual double fps_source() override;
     virtual double fps_display() override;
 
@@ -84,6 +82,11 @@ private:
     void shutdown();
     void startup();
 
+    std::shared_ptr<CaptureDevice> capture() const;
+
+    virtual void new_frame_available() override;
+    virtual void resolution_change(Resolution resolution) override;
+
 
 private:
     Logger& m_logger;
@@ -91,34 +94,17 @@ private:
 
     //  If you need both locks, acquire "m_lock" first.
     mutable std::mutex m_lock;
-    mutable SpinLock m_frame_lock;
+    mutable SpinLock m_capture_lock;
 
     CameraInfo m_device;
     Resolution m_resolution;
 
-    QList<QCameraFormat> m_formats;
-    std::map<Resolution, const QCameraFormat*> m_resolution_map;
+    //  Shared with every other session on the same device. Snapshots only
+    //  take "m_capture_lock" to get this. So they never wait on the UI.
+    std::shared_ptr<CaptureDevice> m_capture;
 
-    std::unique_ptr<QCamera> m_camera;
-    std::unique_ptr<QVideoSink> m_video_sink;
-    std::unique_ptr<QMediaCaptureSession> m_capture;
-
-    std::vector<Resolution> m_resolutions;
-
-    EventRateTracker m_fps_tracker_source;
     EventRateTracker m_fps_tracker_display;
 
-    //  Last Frame
-    QVideoFrame m_last_frame;
-    WallClock m_last_frame_timestamp;
-    uint64_t m_last_frame_seqnum = 0;
-
-    //  Last Cached Image
-    QImage m_last_image;
-    WallClock m_last_image_timestamp;
-    uint64_t m_last_image_seqnum = 0;
-    PeriodicStatsReporterI32 m_stats_conversion;
-
     std::set<Listener*> m_ui_listeners;
     std::set<FrameListener*> m_frame_listeners;
 
@@ -0,0 +1,377 @@
+/*  Capture Hub (Qt6)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <QtGlobal>
+#if QT_VERSION_MAJOR == 6
+
+#include <algorithm>
+#include <QCamera>
+#include <QMediaDevices>
+#include <QVideoSink>
+#include "Common/Cpp/LatencyTracer.h"
+#include "VideoToolsQt6.h"
+#include "CaptureHubQt6.h"
+
+namespace PokemonAutomation{
+namespace CameraQt6QVideoSink{
+
+
+
+void CaptureDevice::add_consumer(Consumer& consumer){
+    std::lock_guard<std::mutex> lg(m_consumer_lock);
+    m_consumers.insert(&consumer);
+}
+void CaptureDevice::remove_consumer(Consumer& consumer){
+    std::lock_guard<std::mutex> lg(m_consumer_lock);
+    m_consumers.erase(&consumer);
+}
+
+
+CaptureDevice::~CaptureDevice(){
+    stop();
+}
+CaptureDevice::CaptureDevice(
+    const QCameraDevice& device,
+    Resolution desired_resolution,
+    Resolution default_resolution
+)
+    : m_last_frame_timestamp(WallClock::min())
+    , m_last_image_timestamp(WallClock::min())
+    , m_stats_conversion("ConvertFrame", "ms", 1000, std::chrono::seconds(10))
+    , m_stats_region_conversion("ConvertFrameRegions", "ms", 1000, std::chrono::seconds(10))
+{
+    for (const QCameraFormat& format : device.videoFormats()){
+        QSize resolution = format.resolution();
+        m_resolution_map.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(resolution.width(), resolution.height()),
+            std::forward_as_tuple(format)
+        );
+    }
+    if (m_resolution_map.empty()){
+        return;
+    }
+
+    auto iter = m_resolution_map.find(desired_resolution);
+    if (iter == m_resolution_map.end()){
+        iter = m_resolution_map.find(default_resolution);
+    }
+    if (iter == m_resolution_map.end()){
+        iter = std::prev(m_resolution_map.end());
+    }
+    m_resolution = iter->first;
+
+    m_camera.reset(new QCamera(device));
+    m_camera->setCameraFormat(iter->second);
+    m_video_sink.reset(new QVideoSink());
+    m_capture.reset(new QMediaCaptureSession());
+    m_capture->setCamera(m_camera.get());
+    m_capture->setVideoSink(m_video_sink.get());
+
+    connect(m_camera.get(), &QCamera::errorOccurred, this, [&](){
+        if (m_camera->error() != QCamera::NoError){
+            global_logger_tagged().log("QCamera error: " + m_camera->errorString().toStdString());
+        }
+    });
+    connect(
+        m_video_sink.get(), &QVideoSink::videoFrameChanged,
+        this, [&](const QVideoFrame& frame){
+            {
+                WallClock now = current_time();
+                SpinLockGuard lg(m_frame_lock);
+                m_last_frame = frame;
+                m_last_frame_timestamp = now;
+                m_last_frame_seqnum++;
+                m_fps_tracker_source.push_event(now);
+                LatencyTracer::instance().instant(PA_TRACE_VIDEO, "Frame", m_last_frame_seqnum, now);
+            }
+            std::lock_guard<std::mutex> lg(m_consumer_lock);
+            for (Consumer* consumer : m_consumers){
+                consumer->new_frame_available();
+            }
+        }
+    );
+
+    m_camera->start();
+}
+void CaptureDevice::stop(){
+    if (!m_camera){
+        return;
+    }
+    m_camera->stop();
+    m_capture.reset();
+    m_video_sink.reset();
+    m_camera.reset();
+
+    std::lock_guard<std::mutex> lg0(m_convert_lock);
+    SpinLockGuard lg1(m_frame_lock);
+
+    m_last_frame = QVideoFrame();
+    m_last_frame_timestamp = current_time();
+    m_last_frame_seqnum++;
+
+    m_last_image = QImage();
+    m_last_image_timestamp = m_last_frame_timestamp;
+    m_last_image_seqnum = m_last_frame_seqnum;
+
+    m_last_regions_image = VideoSnapshot();
+    m_last_regions.clear();
+    m_last_regions_seqnum = m_last_frame_seqnum;
+}
+
+Resolution CaptureDevice::resolution() const{
+    SpinLockGuard lg(m_frame_lock);
+    return m_resolution;
+}
+std::vector<Resolution> CaptureDevice::supported_resolutions() const{
+    //  Only written by the constructor.
+    std::vector<Resolution> ret;
+    for (const auto& item : m_resolution_map){
+        ret.emplace_back(item.first);
+    }
+    return ret;
+}
+bool CaptureDevice::set_resolution(Resolution resolution){
+    if (!m_camera){
+        return false;
+    }
+    auto iter = m_resolution_map.find(resolution);
+    if (iter == m_resolution_map.end()){
+        return false;
+    }
+    {
+        SpinLockGuard lg(m_frame_lock);
+        m_resolution = resolution;
+    }
+    m_camera->stop();
+    m_camera->setCameraFormat(iter->second);
+    m_camera->start();
+
+    std::lock_guard<std::mutex> lg(m_consumer_lock);
+    for (Consumer* consumer : m_consumers){
+        consumer->resolution_change(resolution);
+    }
+    return true;
+}
+
+std::pair<QVideoFrame, uint64_t> CaptureDevice::latest_frame(){
+    SpinLockGuard lg(m_frame_lock);
+    return {m_last_frame, m_last_frame_seqnum};
+}
+double CaptureDevice::fps_source(){
+    SpinLockGuard lg(m_frame_lock);
+    return m_fps_tracker_source.events_per_second();
+}
+
+
+VideoSnapshot CaptureDevice::snapshot(){
+    //  Prevent multiple concurrent screenshots from entering here.
+    std::lock_guard<std::mutex> lg(m_convert_lock);
+    return snapshot_full();
+}
+VideoSnapshot CaptureDevice::snapshot_full(){
+    //  Frame is already cached and is not stale.
+    QVideoFrame frame;
+    WallClock frame_timestamp;
+    uint64_t frame_seqnum;
+    {
+        SpinLockGuard lg0(m_frame_lock);
+        frame_seqnum = m_last_frame_seqnum;
+        if (!m_last_image.isNull() && m_last_image_seqnum == frame_seqnum){
+            return VideoSnapshot(m_last_image, m_last_image_timestamp, m_last_image_seqnum);
+        }
+        frame = m_last_frame;
+        frame_timestamp = m_last_frame_timestamp;
+    }
+
+    if (!frame.isValid()){
+        global_logger_tagged().log("QVideoFrame is null.", COLOR_RED);
+        return VideoSnapshot();
+    }
+
+    WallClock time0 = current_time();
+
+    QImage image = frame.toImage();
+    QImage::Format format = image.format();
+    if (format != QImage::Format_ARGB32 && format != QImage::Format_RGB32){
+        image = image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    m_last_image = std::move(image);
+    m_last_image_timestamp = frame_timestamp;
+    m_last_image_seqnum = frame_seqnum;
+
+    WallClock time1 = current_time();
+    m_stats_conversion.report_data(global_logger_tagged(), std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count());
+    LatencyTracer::instance().complete(
+        PA_TRACE_VIDEO, "ConvertFrame", frame_seqnum, time0, time1,
+        std::chrono::duration_cast<std::chrono::microseconds>(time1 - frame_timestamp).count()
+    );
+
+    return VideoSnapshot(m_last_image, m_last_image_timestamp, m_last_image_seqnum);
+}
+VideoSnapshot CaptureDevice::snapshot_regions(const std::vector<ImageFloatBox>& regions){
+    std::lock_guard<std::mutex> lg(m_convert_lock);
+
+    QVideoFrame frame;
+    WallClock frame_timestamp;
+    uint64_t frame_seqnum;
+    {
+        SpinLockGuard lg0(m_frame_lock);
+        frame_seqnum = m_last_frame_seqnum;
+        frame = m_last_frame;
+        frame_timestamp = m_last_frame_timestamp;
+    }
+    if (!frame.isValid()){
+        return snapshot_full();
+    }
+
+    std::vector<ImagePixelBox> boxes = regions_to_pixel_boxes(frame.width(), frame.height(), regions);
+
+    //  Something already converted what we need from this frame.
+    if (!m_last_image.isNull() && m_last_image_seqnum == frame_seqnum){
+        return VideoSnapshot(m_last_image, m_last_image_timestamp, m_last_image_seqnum);
+    }
+    if (m_last_regions_image && m_last_regions_seqnum == frame_seqnum && m_last_regions == boxes){
+        return m_last_regions_image;
+    }
+
+    //  Past half the frame it is no longer worth doing it in pieces.
+    size_t area = 0;
+    for (const ImagePixelBox& box : boxes){
+        area += box.area();
+    }
+    if (boxes.empty() || area > (size_t)frame.width() * frame.height() / 2){
+        return snapshot_full();
+    }
+
+    WallClock time0 = current_time();
+
+    ImageRGB32 image = frame_regions_to_image(frame, boxes);
+    if (!image){
+        return snapshot_full();
+    }
+
+    m_last_regions_image = VideoSnapshot(std::move(image), frame_timestamp, frame_seqnum);
+    m_last_regions = std::move(boxes);
+    m_last_regions_seqnum = frame_seqnum;
+
+    WallClock time1 = current_time();
+    m_stats_region_conversion.report_data(global_logger_tagged(), std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count());
+    LatencyTracer::instance().complete(
+        PA_TRACE_VIDEO, "ConvertFrameRegions", frame_seqnum, time0, time1,
+        std::chrono::duration_cast<std::chrono::microseconds>(time1 - frame_timestamp).count()
+    );
+
+    return m_last_regions_image;
+}
+VideoSnapshot CaptureDevice::snapshot_downscaled(size_t max_width){
+    std::lock_guard<std::mutex> lg(m_convert_lock);
+
+    QVideoFrame frame;
+    WallClock frame_timestamp;
+    uint64_t frame_seqnum;
+    {
+        SpinLockGuard lg0(m_frame_lock);
+        frame_seqnum = m_last_frame_seqnum;
+        frame = m_last_frame;
+        frame_timestamp = m_last_frame_timestamp;
+    }
+    if (!frame.isValid() || (size_t)frame.width() <= max_width){
+        return snapshot_full();
+    }
+    if (!m_last_image.isNull() && m_last_image_seqnum == frame_seqnum){
+        return VideoSnapshot(m_last_image, m_last_image_timestamp, m_last_image_seqnum);
+    }
+
+    size_t height = std::max<size_t>(1, (size_t)frame.height() * max_width / frame.width());
+    ImageRGB32 image = frame_to_downscaled_image(frame, max_width, height);
+    if (!image){
+        return snapshot_full();
+    }
+    return VideoSnapshot(std::move(image), frame_timestamp, frame_seqnum);
+}
+
+
+
+
+CaptureHub& CaptureHub::instance(){
+    static CaptureHub hub;
+    return hub;
+}
+
+std::shared_ptr<CaptureDevice> CaptureHub::acquire(
+    Logger& logger,
+    const CameraInfo& info,
+    Resolution desired_resolution,
+    Resolution default_resolution
+){
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    auto iter = m_devices.find(info.device_name());
+    if (iter != m_devices.end()){
+        Entry& entry = iter->second;
+        entry.users++;
+        logger.log(
+            "Sharing camera that is already open. Users = " + std::to_string(entry.users) +
+            ", Resolution = " + entry.device->resolution().to_string()
+        );
+        return entry.device;
+    }
+
+    auto cameras = QMediaDevices::videoInputs();
+    const QCameraDevice* device = nullptr;
+    for (const auto& camera : cameras){
+        if (camera.id().toStdString() == info.device_name()){
+            device = &camera;
+            break;
+        }
+    }
+    if (device == nullptr){
+        logger.log("Camera not found: " + info.device_name(), COLOR_RED);
+        return nullptr;
+    }
+
+    //  The last reference may be dropped by a snapshot on another thread.
+    //  Let the UI thread delete it.
+    std::shared_ptr<CaptureDevice> ret(
+        new CaptureDevice(*device, desired_resolution, default_resolution),
+        [](CaptureDevice* device){ device->deleteLater(); }
+    );
+    if (ret->supported_resolutions().empty()){
+        logger.log("No usable resolutions: " + device->description().toStdString(), COLOR_RED);
+        return nullptr;
+    }
+
+    Entry& entry = m_devices[info.device_name()];
+    entry.device = ret;
+    entry.users = 1;
+    return ret;
+}
+void CaptureHub::release(const std::shared_ptr<CaptureDevice>& device){
+    if (!device){
+        return;
+    }
+    std::lock_guard<std::mutex> lg(m_lock);
+    for (auto iter = m_devices.begin(); iter != m_devices.end(); ++iter){
+        Entry& entry = iter->second;
+        if (entry.device != device){
+            continue;
+        }
+        if (--entry.users == 0){
+            global_logger_tagged().log("Closing camera. No more users.");
+            entry.device->stop();
+            m_devices.erase(iter);
+        }
+        return;
+    }
+}
+
+
+
+}
+}
+#endif
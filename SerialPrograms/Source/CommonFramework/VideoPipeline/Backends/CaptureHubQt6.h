@@ -0,0 +1,170 @@
+/*  Capture Hub (Qt6)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      A capture device can only be opened once. CaptureHub opens each one
+ *  for the first CameraSession that asks for it and gives the same
+ *  CaptureDevice to every other session that asks for it later. The device
+ *  is closed when the last of them lets go.
+ *
+ *  CaptureDevice owns the QCamera and the last frame. It also converts that
+ *  frame for snapshots. So a frame is converted only once no matter how many
+ *  sessions, programs or inference threads ask for it. Every consumer
+ *  gets a reference-counted copy of the same image.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_CaptureHubQt6_H
+#define PokemonAutomation_VideoPipeline_CaptureHubQt6_H
+
+#include <QtGlobal>
+#if QT_VERSION_MAJOR == 6
+
+#include <set>
+#include <map>
+#include <mutex>
+#include <QImage>
+#include <QCameraDevice>
+#include <QMediaCaptureSession>
+#include <QVideoFrame>
+#include "Common/Cpp/ImageResolution.h"
+#include "Common/Cpp/EventRateTracker.h"
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "CommonFramework/Inference/StatAccumulator.h"
+#include "CommonFramework/VideoPipeline/CameraInfo.h"
+#include "CommonFramework/VideoPipeline/VideoFeed.h"
+
+class QCamera;
+class QVideoSink;
+
+namespace PokemonAutomation{
+namespace CameraQt6QVideoSink{
+
+
+class CaptureDevice : public QObject{
+public:
+    //  These are called on the UI thread.
+    struct Consumer{
+        virtual void new_frame_available() = 0;
+        virtual void resolution_change(Resolution resolution) = 0;
+    };
+    void add_consumer(Consumer& consumer);
+    void remove_consumer(Consumer& consumer);
+
+
+public:
+    //  Use "CaptureHub::acquire()" to get one.
+    CaptureDevice(
+        const QCameraDevice& device,
+        Resolution desired_resolution,
+        Resolution default_resolution
+    );
+    virtual ~CaptureDevice();
+
+    Resolution resolution() const;
+    std::vector<Resolution> supported_resolutions() const;
+
+    //  Change the resolution for every consumer.
+    //  Must be called on the UI thread.
+    bool set_resolution(Resolution resolution);
+
+    std::pair<QVideoFrame, uint64_t> latest_frame();
+    double fps_source();
+
+    //  These are thread-safe and can be called at a high rate. The last
+    //  conversion of each kind is cached until the next frame.
+    VideoSnapshot snapshot();
+    VideoSnapshot snapshot_regions(const std::vector<ImageFloatBox>& regions);
+
+    //  Not cached. If the full frame has already been converted, that is
+    //  returned instead.
+    VideoSnapshot snapshot_downscaled(size_t max_width);
+
+
+private:
+    friend class CaptureHub;
+
+    //  Release the camera. Snapshots will be empty after this.
+    //  Must be called on the UI thread.
+    void stop();
+
+    //  Must be called under "m_convert_lock".
+    VideoSnapshot snapshot_full();
+
+
+private:
+    //  If you need more than one lock, take them in this order.
+    std::mutex m_consumer_lock;
+    std::mutex m_convert_lock;
+    mutable SpinLock m_frame_lock;
+
+    std::map<Resolution, QCameraFormat> m_resolution_map;
+    Resolution m_resolution;
+
+    std::unique_ptr<QCamera> m_camera;
+    std::unique_ptr<QVideoSink> m_video_sink;
+    std::unique_ptr<QMediaCaptureSession> m_capture;
+
+    EventRateTracker m_fps_tracker_source;
+
+    //  Last Frame
+    QVideoFrame m_last_frame;
+    WallClock m_last_frame_timestamp;
+    uint64_t m_last_frame_seqnum = 0;
+
+    //  Last Cached Image
+    QImage m_last_image;
+    WallClock m_last_image_timestamp;
+    uint64_t m_last_image_seqnum = 0;
+    PeriodicStatsReporterI32 m_stats_conversion;
+
+    //  Last Cached Partial Image
+    VideoSnapshot m_last_regions_image;
+    std::vector<ImagePixelBox> m_last_regions;
+    uint64_t m_last_regions_seqnum = 0;
+    PeriodicStatsReporterI32 m_stats_region_conversion;
+
+    std::set<Consumer*> m_consumers;
+};
+
+
+
+class CaptureHub{
+public:
+    static CaptureHub& instance();
+
+    //  Open the camera or share it if it is already open. If it is already
+    //  open, the resolution stays what it is. Returns null if the camera
+    //  cannot be opened.
+    //  Must be called on the UI thread.
+    std::shared_ptr<CaptureDevice> acquire(
+        Logger& logger,
+        const CameraInfo& info,
+        Resolution desired_resolution,
+        Resolution default_resolution
+    );
+
+    //  Call once for every "acquire()". The camera is closed when there are
+    //  no more users. Snapshots already taken from it are still valid.
+    //  Must be called on the UI thread.
+    void release(const std::shared_ptr<CaptureDevice>& device);
+
+
+private:
+    struct Entry{
+        std::shared_ptr<CaptureDevice> device;
+        size_t users = 0;
+    };
+
+    std::mutex m_lock;
+    std::map<std::string, Entry> m_devices;
+};
+
+
+
+}
+}
+#endif
+#endif
@@ -0,0 +1,408 @@
+/*  Video Tools (QT6)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Conversion of parts of a video frame. This is used when every running
+ *  inference callback only looks at a few small boxes of the screen. Only the
+ *  uncompressed formats that cameras commonly give are handled here. All of
+ *  them are converted with the frame's own color matrix.
+ *
+ */
+
+#include <QtGlobal>
+#if QT_VERSION_MAJOR == 6
+
+#include <cmath>
+#include <string.h>
+#include <algorithm>
+#include <QImage>
+#include <QVideoFrameFormat>
+#include "Common/Compiler.h"
+#include "VideoToolsQt6.h"
+
+namespace PokemonAutomation{
+
+
+
+std::vector<ImagePixelBox> regions_to_pixel_boxes(
+    size_t width, size_t height,
+    const std::vector<ImageFloatBox>& regions
+){
+    std::vector<ImagePixelBox> boxes;
+    for (const ImageFloatBox& region : regions){
+        double min_x = std::floor(width * region.x) - 1;
+        double min_y = std::floor(height * region.y) - 1;
+        double max_x = std::ceil(width * (region.x + region.width)) + 1;
+        double max_y = std::ceil(height * (region.y + region.height)) + 1;
+        ImagePixelBox box(
+            (size_t)std::max(min_x, 0.) & ~(size_t)1,
+            (size_t)std::max(min_y, 0.) & ~(size_t)1,
+            std::min(((size_t)std::max(max_x, 0.) + 1) & ~(size_t)1, width),
+            std::min(((size_t)std::max(max_y, 0.) + 1) & ~(size_t)1, height)
+        );
+        if (box.min_x < box.max_x && box.min_y < box.max_y){
+            boxes.emplace_back(box);
+        }
+    }
+
+    //  Callbacks often watch the same box. Drop the duplicates and anything
+    //  that is already covered by a bigger box.
+    std::sort(
+        boxes.begin(), boxes.end(),
+        [](const ImagePixelBox& a, const ImagePixelBox& b){ return a.area() > b.area(); }
+    );
+    std::vector<ImagePixelBox> ret;
+    for (const ImagePixelBox& box : boxes){
+        bool covered = false;
+        for (const ImagePixelBox& kept : ret){
+            if (kept.min_x <= box.min_x && kept.min_y <= box.min_y &&
+                box.max_x <= kept.max_x && box.max_y <= kept.max_y
+            ){
+                covered = true;
+                break;
+            }
+        }
+        if (!covered){
+            ret.emplace_back(box);
+        }
+    }
+    return ret;
+}
+
+
+
+
+namespace{
+
+
+PA_FORCE_INLINE uint32_t clamp_to_byte(int32_t x){
+    return (uint32_t)std::min(std::max(x, 0), 255);
+}
+
+//  YUV to RGB in fixed point with 12 fractional bits. For every matrix and
+//  range here, all 2^24 inputs are within 1 per channel of the exact
+//  conversion rounded to the nearest byte.
+//
+//  This is not bit-exact with "QVideoFrame::toImage()". That does the same
+//  math in floats on the GPU when it can, and it interpolates the chroma
+//  instead of repeating it. Flat areas should agree within about 2 per
+//  channel, but pixels next to a sharp color edge can differ by more. The
+//  detectors that use partial frames have far looser thresholds than that.
+class YuvToRgb{
+public:
+    YuvToRgb(const QVideoFrameFormat& format){
+        double kr = 0.2126;
+        double kb = 0.0722;
+        bool full_range = false;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+        switch (format.colorSpace()){
+        case QVideoFrameFormat::ColorSpace_BT601:
+            kr = 0.299;
+            kb = 0.114;
+            break;
+        case QVideoFrameFormat::ColorSpace_BT2020:
+            kr = 0.2627;
+            kb = 0.0593;
+            break;
+        default:;
+        }
+        full_range = format.colorRange() == QVideoFrameFormat::ColorRange_Full;
+#else
+        switch (format.yCbCrColorSpace()){
+        case QVideoFrameFormat::YCbCr_BT601:
+        case QVideoFrameFormat::YCbCr_xvYCC601:
+            kr = 0.299;
+            kb = 0.114;
+            break;
+        case QVideoFrameFormat::YCbCr_JPEG:
+            kr = 0.299;
+            kb = 0.114;
+            full_range = true;
+            break;
+        case QVideoFrameFormat::YCbCr_BT2020:
+            kr = 0.2627;
+            kb = 0.0593;
+            break;
+        default:;
+        }
+#endif
+        double kg = 1 - kr - kb;
+        double y_scale = full_range ? 1. : 255. / 219.;
+        double c_scale = full_range ? 1. : 255. / 224.;
+        const double ONE = 1 << 12;
+        m_y_offset = full_range ? 0 : 16;
+        m_y_scale = (int32_t)std::lround(y_scale * ONE);
+        m_r_v = (int32_t)std::lround(2 * (1 - kr) * c_scale * ONE);
+        m_g_u = (int32_t)std::lround(2 * (1 - kb) * kb / kg * c_scale * ONE);
+        m_g_v = (int32_t)std::lround(2 * (1 - kr) * kr / kg * c_scale * ONE);
+        m_b_u = (int32_t)std::lround(2 * (1 - kb) * c_scale * ONE);
+    }
+
+    PA_FORCE_INLINE uint32_t operator()(uint8_t y, uint8_t u, uint8_t v) const{
+        int32_t yy = ((int32_t)y - m_y_offset) * m_y_scale + (1 << 11);
+        int32_t uu = (int32_t)u - 128;
+        int32_t vv = (int32_t)v - 128;
+        uint32_t r = clamp_to_byte((yy + m_r_v * vv) >> 12);
+        uint32_t g = clamp_to_byte((yy - m_g_u * uu - m_g_v * vv) >> 12);
+        uint32_t b = clamp_to_byte((yy + m_b_u * uu) >> 12);
+        return 0xff000000 | (r << 16) | (g << 8) | b;
+    }
+
+private:
+    int32_t m_y_offset;
+    int32_t m_y_scale;
+    int32_t m_r_v;
+    int32_t m_g_u;
+    int32_t m_g_v;
+    int32_t m_b_u;
+};
+
+
+
+void copy_rgb32(ImageRGB32& image, const QVideoFrame& frame, const ImagePixelBox& box){
+    const uint8_t* in = frame.bits(0);
+    size_t in_bytes_per_row = frame.bytesPerLine(0);
+    for (size_t r = box.min_y; r < box.max_y; r++){
+        const uint32_t* in_row = (const uint32_t*)(in + r * in_bytes_per_row);
+        uint32_t* out_row = (uint32_t*)((char*)image.data() + r * image.bytes_per_row());
+        for (size_t c = box.min_x; c < box.max_x; c++){
+            out_row[c] = in_row[c] | 0xff000000;
+        }
+    }
+}
+
+//  4:2:0 with the chroma in one or two planes. "u_step" is the distance
+//  between chroma samples of the same plane.
+void convert_yuv420(
+    ImageRGB32& image, const QVideoFrame& frame, const ImagePixelBox& box,
+    const YuvToRgb& yuv,
+    int u_plane, int v_plane, size_t u_offset, size_t v_offset, size_t step
+){
+    const uint8_t* y_data = frame.bits(0);
+    const uint8_t* u_data = frame.bits(u_plane) + u_offset;
+    const uint8_t* v_data = frame.bits(v_plane) + v_offset;
+    size_t y_bytes_per_row = frame.bytesPerLine(0);
+    size_t u_bytes_per_row = frame.bytesPerLine(u_plane);
+    size_t v_bytes_per_row = frame.bytesPerLine(v_plane);
+    for (size_t r = box.min_y; r < box.max_y; r++){
+        const uint8_t* y_row = y_data + r * y_bytes_per_row;
+        const uint8_t* u_row = u_data + (r / 2) * u_bytes_per_row;
+        const uint8_t* v_row = v_data + (r / 2) * v_bytes_per_row;
+        uint32_t* out_row = (uint32_t*)((char*)image.data() + r * image.bytes_per_row());
+        for (size_t c = box.min_x; c < box.max_x; c += 2){
+            uint8_t u = u_row[(c / 2) * step];
+            uint8_t v = v_row[(c / 2) * step];
+            out_row[c + 0] = yuv(y_row[c + 0], u, v);
+            out_row[c + 1] = yuv(y_row[c + 1], u, v);
+        }
+    }
+}
+
+//  Packed 4:2:2. "y_offset" is the byte of the first luma sample in each
+//  group of 4 bytes. "u_offset" and "v_offset" are for the chroma.
+void convert_yuv422_packed(
+    ImageRGB32& image, const QVideoFrame& frame, const ImagePixelBox& box,
+    const YuvToRgb& yuv,
+    size_t y_offset, size_t u_offset, size_t v_offset
+){
+    const uint8_t* in = frame.bits(0);
+    size_t in_bytes_per_row = frame.bytesPerLine(0);
+    for (size_t r = box.min_y; r < box.max_y; r++){
+        const uint8_t* in_row = in + r * in_bytes_per_row;
+        uint32_t* out_row = (uint32_t*)((char*)image.data() + r * image.bytes_per_row());
+        for (size_t c = box.min_x; c < box.max_x; c += 2){
+            const uint8_t* group = in_row + c * 2;
+            uint8_t u = group[u_offset];
+            uint8_t v = group[v_offset];
+            out_row[c + 0] = yuv(group[y_offset + 0], u, v);
+            out_row[c + 1] = yuv(group[y_offset + 2], u, v);
+        }
+    }
+}
+
+
+
+
+//  Like the converters above, but only for the pixels in "columns" of row "r".
+void sample_rgb32(
+    uint32_t* out_row, const QVideoFrame& frame, size_t r,
+    const std::vector<size_t>& columns
+){
+    const uint32_t* in_row = (const uint32_t*)(frame.bits(0) + r * frame.bytesPerLine(0));
+    for (size_t c = 0; c < columns.size(); c++){
+        out_row[c] = in_row[columns[c]] | 0xff000000;
+    }
+}
+void sample_yuv420(
+    uint32_t* out_row, const QVideoFrame& frame, size_t r,
+    const std::vector<size_t>& columns,
+    const YuvToRgb& yuv,
+    int u_plane, int v_plane, size_t u_offset, size_t v_offset, size_t step
+){
+    const uint8_t* y_row = frame.bits(0) + r * frame.bytesPerLine(0);
+    const uint8_t* u_row = frame.bits(u_plane) + u_offset + (r / 2) * frame.bytesPerLine(u_plane);
+    const uint8_t* v_row = frame.bits(v_plane) + v_offset + (r / 2) * frame.bytesPerLine(v_plane);
+    for (size_t c = 0; c < columns.size(); c++){
+        size_t x = columns[c];
+        out_row[c] = yuv(y_row[x], u_row[(x / 2) * step], v_row[(x / 2) * step]);
+    }
+}
+void sample_yuv422_packed(
+    uint32_t* out_row, const QVideoFrame& frame, size_t r,
+    const std::vector<size_t>& columns,
+    const YuvToRgb& yuv,
+    size_t y_offset, size_t u_offset, size_t v_offset
+){
+    const uint8_t* in_row = frame.bits(0) + r * frame.bytesPerLine(0);
+    for (size_t c = 0; c < columns.size(); c++){
+        size_t x = columns[c];
+        const uint8_t* group = in_row + (x / 2) * 4;
+        out_row[c] = yuv(group[y_offset + (x % 2) * 2], group[u_offset], group[v_offset]);
+    }
+}
+
+
+//  Returns false if "frame" can't be converted here. Otherwise maps it.
+bool map_convertible_frame(QVideoFrame& frame){
+    const QVideoFrameFormat format = frame.surfaceFormat();
+    if (format.scanLineDirection() != QVideoFrameFormat::TopToBottom){
+        return false;
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(6, 7, 0)
+    if (frame.mirrored() || frame.rotation() != QtVideo::Rotation::None){
+        return false;
+    }
+#endif
+
+    QVideoFrameFormat::PixelFormat pixel_format = frame.pixelFormat();
+    QImage::Format image_format = QVideoFrameFormat::imageFormatFromPixelFormat(pixel_format);
+    bool rgb32 =
+        image_format == QImage::Format_ARGB32 ||
+        image_format == QImage::Format_RGB32 ||
+        image_format == QImage::Format_ARGB32_Premultiplied;
+    if (!rgb32){
+        switch (pixel_format){
+        case QVideoFrameFormat::Format_NV12:
+        case QVideoFrameFormat::Format_NV21:
+        case QVideoFrameFormat::Format_YUV420P:
+        case QVideoFrameFormat::Format_YV12:
+        case QVideoFrameFormat::Format_YUYV:
+        case QVideoFrameFormat::Format_UYVY:
+            //  Boxes are on even coordinates. The frame must be too.
+            if (frame.width() % 2 != 0 || frame.height() % 2 != 0){
+                return false;
+            }
+            break;
+        default:
+            return false;
+        }
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+    return frame.map(QtVideo::MapMode::ReadOnly);
+#else
+    return frame.map(QVideoFrame::ReadOnly);
+#endif
+}
+
+
+}
+
+
+
+ImageRGB32 frame_regions_to_image(QVideoFrame frame, const std::vector<ImagePixelBox>& boxes){
+    if (!map_convertible_frame(frame)){
+        return ImageRGB32();
+    }
+
+    const QVideoFrameFormat format = frame.surfaceFormat();
+    QVideoFrameFormat::PixelFormat pixel_format = frame.pixelFormat();
+    size_t width = frame.width();
+    size_t height = frame.height();
+
+    //  The buffer may be reused. Clear it so nothing from an old frame shows
+    //  outside the boxes if the image ends up saved or dumped.
+    ImageRGB32 image(width, height);
+    image.fill(0);
+    YuvToRgb yuv(format);
+    for (const ImagePixelBox& box : boxes){
+        switch (pixel_format){
+        case QVideoFrameFormat::Format_NV12:
+            convert_yuv420(image, frame, box, yuv, 1, 1, 0, 1, 2);
+            break;
+        case QVideoFrameFormat::Format_NV21:
+            convert_yuv420(image, frame, box, yuv, 1, 1, 1, 0, 2);
+            break;
+        case QVideoFrameFormat::Format_YUV420P:
+            convert_yuv420(image, frame, box, yuv, 1, 2, 0, 0, 1);
+            break;
+        case QVideoFrameFormat::Format_YV12:
+            convert_yuv420(image, frame, box, yuv, 2, 1, 0, 0, 1);
+            break;
+        case QVideoFrameFormat::Format_YUYV:
+            convert_yuv422_packed(image, frame, box, yuv, 0, 1, 3);
+            break;
+        case QVideoFrameFormat::Format_UYVY:
+            convert_yuv422_packed(image, frame, box, yuv, 1, 0, 2);
+            break;
+        default:
+            copy_rgb32(image, frame, box);
+        }
+    }
+
+    frame.unmap();
+    return image;
+}
+ImageRGB32 frame_to_downscaled_image(QVideoFrame frame, size_t width, size_t height){
+    if (width == 0 || height == 0 || !map_convertible_frame(frame)){
+        return ImageRGB32();
+    }
+
+    const QVideoFrameFormat format = frame.surfaceFormat();
+    QVideoFrameFormat::PixelFormat pixel_format = frame.pixelFormat();
+    size_t frame_width = frame.width();
+    size_t frame_height = frame.height();
+
+    //  Take the pixel nearest to the center of each output pixel.
+    std::vector<size_t> columns(width);
+    for (size_t c = 0; c < width; c++){
+        columns[c] = std::min((2 * c + 1) * frame_width / (2 * width), frame_width - 1);
+    }
+
+    ImageRGB32 image(width, height);
+    YuvToRgb yuv(format);
+    for (size_t r = 0; r < height; r++){
+        size_t y = std::min((2 * r + 1) * frame_height / (2 * height), frame_height - 1);
+        uint32_t* out_row = (uint32_t*)((char*)image.data() + r * image.bytes_per_row());
+        switch (pixel_format){
+        case QVideoFrameFormat::Format_NV12:
+            sample_yuv420(out_row, frame, y, columns, yuv, 1, 1, 0, 1, 2);
+            break;
+        case QVideoFrameFormat::Format_NV21:
+            sample_yuv420(out_row, frame, y, columns, yuv, 1, 1, 1, 0, 2);
+            break;
+        case QVideoFrameFormat::Format_YUV420P:
+            sample_yuv420(out_row, frame, y, columns, yuv, 1, 2, 0, 0, 1);
+            break;
+        case QVideoFrameFormat::Format_YV12:
+            sample_yuv420(out_row, frame, y, columns, yuv, 2, 1, 0, 0, 1);
+            break;
+        case QVideoFrameFormat::Format_YUYV:
+            sample_yuv422_packed(out_row, frame, y, columns, yuv, 0, 1, 3);
+            break;
+        case QVideoFrameFormat::Format_UYVY:
+            sample_yuv422_packed(out_row, frame, y, columns, yuv, 1, 0, 2);
+            break;
+        default:
+            sample_rgb32(out_row, frame, y, columns);
+        }
+    }
+
+    frame.unmap();
+    return image;
+}
+
+
+
+}
+#endif
@@ -0,0 +1,46 @@
+/*  Video Tools (QT6)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_VideoToolsQt6_H
+#define PokemonAutomation_VideoPipeline_VideoToolsQt6_H
+
+#include <QtGlobal>
+#if QT_VERSION_MAJOR == 6
+
+#include <vector>
+#include <QVideoFrame>
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+
+namespace PokemonAutomation{
+
+
+//  Pixel boxes that cover "regions" in a "width" x "height" frame. Each box
+//  is grown by a pixel on every side and snapped to even coordinates so that
+//  it covers whole chroma samples. Boxes that lie inside another are dropped.
+std::vector<ImagePixelBox> regions_to_pixel_boxes(
+    size_t width, size_t height,
+    const std::vector<ImageFloatBox>& regions
+);
+
+//  Convert only the parts of "frame" inside "boxes". The image has the size
+//  of the whole frame. The pixels outside the boxes are zero (transparent).
+//
+//  Returns an empty image if the frame has a pixel format or orientation that
+//  cannot be converted in pieces. Use "QVideoFrame::toImage()" for those.
+ImageRGB32 frame_regions_to_image(QVideoFrame frame, const std::vector<ImagePixelBox>& boxes);
+
+//  Convert "frame" scaled down to "width" x "height" by taking the nearest
+//  pixel. Only the pixels that are kept are converted.
+//
+//  Returns an empty image for the same frames as "frame_regions_to_image()".
+ImageRGB32 frame_to_downscaled_image(QVideoFrame frame, size_t width, size_t height);
+
+
+
+}
+#endif
+#endif
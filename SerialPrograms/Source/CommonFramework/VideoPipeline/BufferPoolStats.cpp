@@ -0,0 +1,54 @@
+/*  Buffer Pool Stats
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "Common/Cpp/PrettyPrint.h"
+#include "BufferPoolStats.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+BufferPoolStat::BufferPoolStat()
+    : m_last_time(current_time())
+    , m_last(aligned_pool_stats())
+{}
+
+OverlayStatSnapshot BufferPoolStat::get_current(){
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    WallClock now = current_time();
+    AlignedPoolStats current = aligned_pool_stats();
+
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(now - m_last_time).count() / 1000000.;
+    uint64_t allocations = current.allocations() - m_last.allocations();
+    uint64_t mallocs = current.system_mallocs - m_last.system_mallocs;
+    if (seconds < 1 && allocations != 0){
+        //  Too short to give a stable rate. Keep accumulating.
+        return m_snapshot;
+    }
+    m_last_time = now;
+    m_last = current;
+
+    if (allocations == 0){
+        m_snapshot = OverlayStatSnapshot();
+        return m_snapshot;
+    }
+
+    double hit_rate = 100. * (allocations - mallocs) / allocations;
+    m_snapshot.text =
+        "Buffer Pool: " + tostr_fixed(hit_rate, 1) + "% hits, " +
+        tostr_fixed(mallocs / seconds, 1) + " mallocs/s, " +
+        tostr_fixed((double)current.cached_bytes / (1024 * 1024), 1) + " MB idle";
+    m_snapshot.color = hit_rate < 90 ? COLOR_ORANGE : COLOR_WHITE;
+    return m_snapshot;
+}
+
+
+
+}
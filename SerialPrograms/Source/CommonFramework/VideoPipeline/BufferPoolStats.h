@@ -0,0 +1,37 @@
+/*  Buffer Pool Stats
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Overlay line for the image/matrix buffer pool. In steady state, the
+ *  inference loops should make almost no system allocations.
+ *
+ */
+
+#ifndef PokemonAutomation_BufferPoolStats_H
+#define PokemonAutomation_BufferPoolStats_H
+
+#include <mutex>
+#include "Common/Cpp/Time.h"
+#include "Common/Cpp/Containers/AlignedMalloc.h"
+#include "VideoOverlayTypes.h"
+
+namespace PokemonAutomation{
+
+
+class BufferPoolStat : public OverlayStat{
+public:
+    BufferPoolStat();
+
+    virtual OverlayStatSnapshot get_current() override;
+
+private:
+    std::mutex m_lock;
+    WallClock m_last_time;
+    AlignedPoolStats m_last;
+    OverlayStatSnapshot m_snapshot;
+};
+
+
+
+}
+#endif
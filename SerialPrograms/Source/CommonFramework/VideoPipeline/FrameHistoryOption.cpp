@@ -0,0 +1,48 @@
+/*  Frame History Option
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "FrameHistoryOption.h"
+
+namespace PokemonAutomation{
+
+
+FrameHistoryOption::FrameHistoryOption()
+    : GroupOption("Frame History", LockWhileRunning::LOCKED, true, false)
+    , DESCRIPTION(
+        "Keep a rolling history of recent video frames for each console. "
+        "When a program saves an error image, the frames leading up to it are saved as well."
+    )
+    , SECONDS(
+        "<b>Seconds of History:</b>",
+        LockWhileRunning::LOCKED,
+        10, 1, 300
+    )
+    , PERIOD_MS(
+        "<b>Frame Period (ms):</b><br>Record one frame every this many milliseconds. Larger values use less CPU.",
+        LockWhileRunning::LOCKED,
+        100, 10, 10000
+    )
+    , WIDTH(
+        "<b>Width:</b><br>Frames are downscaled to this width before they are stored.",
+        LockWhileRunning::LOCKED,
+        480, 16, 3840
+    )
+    , MAX_MEMORY_MB(
+        "<b>Max Memory (MB):</b><br>Memory limit for each console. The oldest frames are dropped first.",
+        LockWhileRunning::LOCKED,
+        64, 1, 4096
+    )
+{
+    PA_ADD_STATIC(DESCRIPTION);
+    PA_ADD_OPTION(SECONDS);
+    PA_ADD_OPTION(PERIOD_MS);
+    PA_ADD_OPTION(WIDTH);
+    PA_ADD_OPTION(MAX_MEMORY_MB);
+}
+
+
+
+}
@@ -0,0 +1,39 @@
+/*  Frame History Option
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_FrameHistoryOption_H
+#define PokemonAutomation_VideoPipeline_FrameHistoryOption_H
+
+#include "Common/Cpp/Options/StaticTextOption.h"
+#include "Common/Cpp/Options/SimpleIntegerOption.h"
+#include "Common/Cpp/Options/GroupOption.h"
+
+namespace PokemonAutomation{
+
+
+class FrameHistoryOption : public GroupOption{
+public:
+    FrameHistoryOption();
+
+    StaticTextOption DESCRIPTION;
+
+    //  How far back to keep frames.
+    SimpleIntegerOption<uint32_t> SECONDS;
+
+    //  Time between recorded frames. This is the CPU ceiling.
+    SimpleIntegerOption<uint32_t> PERIOD_MS;
+
+    //  Frames are downscaled to this width before being stored.
+    SimpleIntegerOption<uint32_t> WIDTH;
+
+    //  Memory ceiling per console. Oldest frames are dropped first.
+    SimpleIntegerOption<uint32_t> MAX_MEMORY_MB;
+};
+
+
+
+}
+#endif
@@ -0,0 +1,358 @@
+/*  Frame History Recorder
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <map>
+#include <mutex>
+#include <algorithm>
+#include <QDir>
+#include "Common/Cpp/PrettyPrint.h"
+#include "CommonFramework/Logging/Logger.h"
+#include "VideoFeed.h"
+#include "FrameHistoryOption.h"
+#include "FrameHistoryRecorder.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+
+
+namespace{
+
+//  Recorders are looked up by the feed they are attached to. This is only held
+//  to copy the history. The frames are decoded and saved outside of it.
+std::mutex recorder_lock;
+std::map<const VideoFeed*, FrameHistoryRecorder*> recorders;
+
+}
+
+
+
+struct FrameHistoryRecorder::EncodedFrame{
+    WallClock timestamp;
+    size_t width;
+    size_t height;
+    bool keyframe;
+
+    //  Indices of the tiles that are stored in this frame.
+    std::vector<uint32_t> tiles;
+
+    //  Packed RGB888 of each stored tile in the same order as "tiles".
+    std::vector<uint8_t> pixels;
+
+    size_t tiles_x() const{ return (width + TILE_SIZE - 1) / TILE_SIZE; }
+    size_t tiles_y() const{ return (height + TILE_SIZE - 1) / TILE_SIZE; }
+
+    size_t bytes() const{
+        return sizeof(EncodedFrame) + tiles.size() * sizeof(uint32_t) + pixels.size();
+    }
+
+    void append_tile(const ImageViewRGB32& image, uint32_t index){
+        size_t x0 = (index % tiles_x()) * TILE_SIZE;
+        size_t y0 = (index / tiles_x()) * TILE_SIZE;
+        size_t x1 = std::min(x0 + TILE_SIZE, width);
+        size_t y1 = std::min(y0 + TILE_SIZE, height);
+        tiles.emplace_back(index);
+        for (size_t r = y0; r < y1; r++){
+            for (size_t c = x0; c < x1; c++){
+                uint32_t pixel = image.pixel(c, r);
+                pixels.emplace_back((uint8_t)(pixel >> 16));
+                pixels.emplace_back((uint8_t)(pixel >>  8));
+                pixels.emplace_back((uint8_t)(pixel >>  0));
+            }
+        }
+    }
+};
+
+
+namespace{
+
+bool tile_matches(
+    const ImageViewRGB32& x, const ImageViewRGB32& y,
+    size_t x0, size_t y0, size_t x1, size_t y1,
+    uint8_t tolerance
+){
+    for (size_t r = y0; r < y1; r++){
+        for (size_t c = x0; c < x1; c++){
+            uint32_t p0 = x.pixel(c, r);
+            uint32_t p1 = y.pixel(c, r);
+            for (size_t s = 0; s < 24; s += 8){
+                int d = (int)((p0 >> s) & 0xff) - (int)((p1 >> s) & 0xff);
+                if (d > tolerance || d < -(int)tolerance){
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+
+
+FrameHistoryRecorder::FrameHistoryRecorder(
+    CancellableScope& scope,
+    Logger& logger,
+    VideoFeed& feed,
+    AsyncDispatcher& dispatcher,
+    const FrameHistoryOption& option
+)
+    : PeriodicRunner(dispatcher)
+    , m_logger(logger)
+    , m_feed(feed)
+    , m_period(option.PERIOD_MS)
+    , m_window(option.SECONDS)
+    , m_width(option.WIDTH)
+    , m_memory_limit((size_t)option.MAX_MEMORY_MB * 1024 * 1024)
+{
+    {
+        std::lock_guard<std::mutex> lg(recorder_lock);
+        recorders[&feed] = this;
+    }
+    attach(scope);
+    PeriodicRunner::add_event(this, m_period);
+}
+FrameHistoryRecorder::~FrameHistoryRecorder(){
+    {
+        std::lock_guard<std::mutex> lg(recorder_lock);
+        auto iter = recorders.find(&m_feed);
+        if (iter != recorders.end() && iter->second == this){
+            recorders.erase(iter);
+        }
+    }
+    detach();
+    stop_thread();
+}
+
+size_t FrameHistoryRecorder::frames() const{
+    SpinLockGuard lg(m_lock);
+    return m_history.size();
+}
+size_t FrameHistoryRecorder::memory_usage() const{
+    SpinLockGuard lg(m_lock);
+    return m_memory_usage;
+}
+FrameHistoryRecorder::History FrameHistoryRecorder::history() const{
+    SpinLockGuard lg(m_lock);
+    return m_history;
+}
+
+
+std::shared_ptr<const FrameHistoryRecorder::EncodedFrame> FrameHistoryRecorder::encode(
+    const ImageViewRGB32& image, WallClock timestamp
+){
+    std::shared_ptr<EncodedFrame> frame = std::make_shared<EncodedFrame>();
+    frame->timestamp = timestamp;
+    frame->width = image.width();
+    frame->height = image.height();
+
+    size_t tiles_x = frame->tiles_x();
+    size_t tiles_y = frame->tiles_y();
+
+    frame->keyframe =
+        m_since_keyframe >= KEYFRAME_INTERVAL ||
+        m_reference.width() != image.width() ||
+        m_reference.height() != image.height();
+
+    if (frame->keyframe){
+        m_since_keyframe = 0;
+        frame->pixels.reserve(image.width() * image.height() * 3);
+        for (uint32_t index = 0; index < tiles_x * tiles_y; index++){
+            frame->append_tile(image, index);
+        }
+        m_reference = image.copy();
+    }else{
+        m_since_keyframe++;
+        for (size_t ty = 0; ty < tiles_y; ty++){
+            for (size_t tx = 0; tx < tiles_x; tx++){
+                size_t x0 = tx * TILE_SIZE;
+                size_t y0 = ty * TILE_SIZE;
+                size_t x1 = std::min(x0 + TILE_SIZE, image.width());
+                size_t y1 = std::min(y0 + TILE_SIZE, image.height());
+                if (tile_matches(image, m_reference, x0, y0, x1, y1, DELTA_TOLERANCE)){
+                    continue;
+                }
+                frame->append_tile(image, (uint32_t)(ty * tiles_x + tx));
+
+                //  Track what the decoder will see so errors don't accumulate.
+                for (size_t r = y0; r < y1; r++){
+                    for (size_t c = x0; c < x1; c++){
+                        m_reference.pixel(c, r) = image.pixel(c, r);
+                    }
+                }
+            }
+        }
+    }
+
+    frame->tiles.shrink_to_fit();
+    frame->pixels.shrink_to_fit();
+    return frame;
+}
+void FrameHistoryRecorder::apply(ImageRGB32& image, const EncodedFrame& frame){
+    if (frame.keyframe){
+        image = ImageRGB32(frame.width, frame.height);
+    }
+    size_t tiles_x = frame.tiles_x();
+    const uint8_t* ptr = frame.pixels.data();
+    for (uint32_t index : frame.tiles){
+        size_t x0 = (index % tiles_x) * TILE_SIZE;
+        size_t y0 = (index / tiles_x) * TILE_SIZE;
+        size_t x1 = std::min(x0 + TILE_SIZE, frame.width);
+        size_t y1 = std::min(y0 + TILE_SIZE, frame.height);
+        for (size_t r = y0; r < y1; r++){
+            for (size_t c = x0; c < x1; c++){
+                image.pixel(c, r) = 0xff000000 | ((uint32_t)ptr[0] << 16) | ((uint32_t)ptr[1] << 8) | ptr[2];
+                ptr += 3;
+            }
+        }
+    }
+}
+void FrameHistoryRecorder::drop_oldest(){
+    //  Only the recording thread modifies the history. So it is safe to read
+    //  it without the lock here.
+    const EncodedFrame& oldest = *m_history[0];
+
+    //  Dropping a keyframe would orphan the deltas behind it. Promote the
+    //  next frame to a keyframe first.
+    std::shared_ptr<EncodedFrame> promoted;
+    if (oldest.keyframe && m_history.size() > 1 && !m_history[1]->keyframe){
+        ImageRGB32 image;
+        apply(image, oldest);
+        apply(image, *m_history[1]);
+        promoted = std::make_shared<EncodedFrame>();
+        promoted->timestamp = m_history[1]->timestamp;
+        promoted->width = image.width();
+        promoted->height = image.height();
+        promoted->keyframe = true;
+        promoted->pixels.reserve(image.width() * image.height() * 3);
+        for (uint32_t index = 0; index < promoted->tiles_x() * promoted->tiles_y(); index++){
+            promoted->append_tile(image, index);
+        }
+    }
+
+    SpinLockGuard lg(m_lock);
+    m_memory_usage -= m_history.front()->bytes();
+    m_history.pop_front();
+    if (promoted){
+        m_memory_usage -= m_history.front()->bytes();
+        m_memory_usage += promoted->bytes();
+        m_history.front() = std::move(promoted);
+    }
+}
+
+void FrameHistoryRecorder::run(void*, bool) noexcept{
+    try{
+        VideoSnapshot snapshot = m_feed.snapshot_downscaled(m_width);
+        if (!snapshot || snapshot.timestamp == m_last_timestamp){
+            return;
+        }
+        m_last_timestamp = snapshot.timestamp;
+
+        const ImageRGB32& full = *snapshot.frame;
+        std::shared_ptr<const EncodedFrame> frame;
+        if (full.width() > m_width){
+            size_t height = std::max<size_t>(1, full.height() * m_width / full.width());
+            frame = encode(full.scale_to(m_width, height), snapshot.timestamp);
+        }else{
+            frame = encode(full, snapshot.timestamp);
+        }
+
+        {
+            SpinLockGuard lg(m_lock);
+            m_memory_usage += frame->bytes();
+            m_history.emplace_back(std::move(frame));
+        }
+
+        WallClock threshold = snapshot.timestamp - m_window;
+        while (m_history.size() > 1 &&
+            (m_memory_usage > m_memory_limit || m_history.front()->timestamp < threshold)
+        ){
+            drop_oldest();
+        }
+    }catch (std::exception& e){
+        m_logger.log(std::string("FrameHistoryRecorder: ") + e.what(), COLOR_RED);
+    }catch (...){}
+}
+
+
+size_t FrameHistoryRecorder::dump(const std::string& path_prefix) const{
+    return save(m_logger, history(), path_prefix + "-history");
+}
+size_t FrameHistoryRecorder::dump(Logger& logger, const VideoFeed& feed, const std::string& path_prefix){
+    History history;
+    {
+        std::lock_guard<std::mutex> lg(recorder_lock);
+        auto iter = recorders.find(&feed);
+        if (iter == recorders.end()){
+            return 0;
+        }
+        history = iter->second->history();
+    }
+    return save(logger, history, path_prefix + "-history");
+}
+size_t FrameHistoryRecorder::dump_all(Logger& logger, const std::string& path_prefix){
+    std::vector<History> histories;
+    {
+        std::lock_guard<std::mutex> lg(recorder_lock);
+        for (const auto& item : recorders){
+            histories.emplace_back(item.second->history());
+        }
+    }
+    size_t ret = 0;
+    for (size_t c = 0; c < histories.size(); c++){
+        std::string folder = path_prefix + "-history";
+        if (histories.size() > 1){
+            folder += "-" + std::to_string(c);
+        }
+        ret += save(logger, histories[c], folder);
+    }
+    return ret;
+}
+size_t FrameHistoryRecorder::save(Logger& logger, const History& history, const std::string& folder){
+    if (history.empty()){
+        return 0;
+    }
+
+    QDir().mkpath(QString::fromStdString(folder));
+    logger.log("Saving frame history to: " + folder, COLOR_PURPLE);
+
+    WallClock last = history.back()->timestamp;
+    ImageRGB32 image;
+    size_t index = 0;
+    for (const std::shared_ptr<const EncodedFrame>& frame : history){
+        apply(image, *frame);
+        int64_t ms = std::chrono::duration_cast<Milliseconds>(last - frame->timestamp).count();
+        std::string name = folder + "/" + tostr_padded(4, index) + "-minus" + std::to_string(ms) + "ms.jpg";
+        image.save(name);
+        index++;
+    }
+    return index;
+}
+
+
+OverlayStatSnapshot FrameHistoryRecorder::get_current(){
+    size_t frames;
+    size_t bytes;
+    {
+        SpinLockGuard lg(m_lock);
+        frames = m_history.size();
+        bytes = m_memory_usage;
+    }
+    OverlayStatSnapshot snapshot = m_printer.get_snapshot("Frame History:", current_utilization());
+    if (snapshot.text.empty()){
+        return snapshot;
+    }
+    snapshot.text +=
+        " (" + std::to_string(frames) + " frames, " +
+        tostr_fixed((double)bytes / (1024 * 1024), 1) + " MB)";
+    return snapshot;
+}
+
+
+
+}
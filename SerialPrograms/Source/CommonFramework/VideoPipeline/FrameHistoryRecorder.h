@@ -0,0 +1,112 @@
+/*  Frame History Recorder
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Keep the last N seconds of video in a fixed amount of memory so that
+ *  the frames leading up to an error can be saved along with the error image.
+ *
+ *  Frames are downscaled and split into 16x16 tiles. Every few frames a
+ *  keyframe stores all the tiles. The frames in between only store the tiles
+ *  that changed from the previous frame. Tiles are stored as packed RGB888.
+ *
+ *  All the encoding happens on the dispatcher thread. Frames are taken with
+ *  "VideoFeed::snapshot_downscaled()" so the recorder doesn't force a full
+ *  conversion of every frame. Nothing is written to disk until dump() is
+ *  called.
+ *
+ */
+
+#ifndef PokemonAutomation_VideoPipeline_FrameHistoryRecorder_H
+#define PokemonAutomation_VideoPipeline_FrameHistoryRecorder_H
+
+#include <memory>
+#include <deque>
+#include <vector>
+#include "Common/Cpp/Concurrency/SpinLock.h"
+#include "Common/Cpp/Concurrency/PeriodicScheduler.h"
+#include "CommonFramework/ImageTypes/ImageRGB32.h"
+#include "VideoOverlayTypes.h"
+
+namespace PokemonAutomation{
+
+class Logger;
+class VideoFeed;
+class FrameHistoryOption;
+
+
+class FrameHistoryRecorder final : public PeriodicRunner, public OverlayStat{
+public:
+    static const size_t TILE_SIZE = 16;
+    static const size_t KEYFRAME_INTERVAL = 30;
+
+    //  Tiles whose channels are all within this of the previous frame are not stored.
+    static const uint8_t DELTA_TOLERANCE = 6;
+
+public:
+    FrameHistoryRecorder(
+        CancellableScope& scope,
+        Logger& logger,
+        VideoFeed& feed,
+        AsyncDispatcher& dispatcher,
+        const FrameHistoryOption& option
+    );
+    virtual ~FrameHistoryRecorder();
+
+    size_t frames() const;
+    size_t memory_usage() const;
+
+    //  Decode and save all frames in the history to "<path_prefix>-history/".
+    //  Returns the number of frames saved.
+    size_t dump(const std::string& path_prefix) const;
+
+    //  Dump the history of the recorder attached to this feed. (if any)
+    //  Returns the number of frames saved.
+    static size_t dump(Logger& logger, const VideoFeed& feed, const std::string& path_prefix);
+
+    //  Dump the history of every recorder. Use this when the feed is not
+    //  known. If there is more than one, each goes to its own folder.
+    //  Returns the number of frames saved.
+    static size_t dump_all(Logger& logger, const std::string& path_prefix);
+
+
+private:
+    struct EncodedFrame;
+    using History = std::deque<std::shared_ptr<const EncodedFrame>>;
+
+    virtual void run(void* event, bool is_back_to_back) noexcept override;
+    virtual OverlayStatSnapshot get_current() override;
+
+    std::shared_ptr<const EncodedFrame> encode(const ImageViewRGB32& image, WallClock timestamp);
+    void drop_oldest();
+
+    History history() const;
+
+    static void apply(ImageRGB32& image, const EncodedFrame& frame);
+    static size_t save(Logger& logger, const History& history, const std::string& folder);
+
+
+private:
+    Logger& m_logger;
+    VideoFeed& m_feed;
+
+    const std::chrono::milliseconds m_period;
+    const std::chrono::seconds m_window;
+    const size_t m_width;
+    const size_t m_memory_limit;
+
+    //  Only touched by the recording thread.
+    WallClock m_last_timestamp = WallClock::min();
+    ImageRGB32 m_reference;
+    size_t m_since_keyframe = 0;
+
+    mutable SpinLock m_lock;
+    History m_history;
+    size_t m_memory_usage = 0;
+
+    OverlayStatUtilizationPrinter m_printer;
+};
+
+
+
+}
+#endif
@@ -26,9 +26,9 @@ VideoOverlayWidget::~VideoOverlayWidget(){
 VideoOverlayWidget::VideoOverlayWidget(QWidget& parent, VideoOverlaySession& session)
     : QWidget(&parent)
     , m_session(session)
-    , m_boxes(std::make_shared<std::vector<OverlayBox>>(session.boxes()))
-    , m_texts(std::make_shared<std::vector<OverlayText>>(session.texts()))
-    , m_log(std::make_shared<std::vector<OverlayLogLine>>(session.log_texts()))
+    , m_boxes(session.box_snapshot())
+    , m_texts(session.text_snapshot())
+    , m_log(session.log_snapshot())
     , m_stats(nullptr)
 {
     setAttribute(Qt::WA_NoSystemBackground);
@@ -51,18 +51,6 @@ void VideoOverlayWidget::enabled_stats(bool enabled){
     QMetaObject::invokeMethod(this, [this]{ this->update(); });
 }
 
-void VideoOverlayWidget::update_boxes(const std::shared_ptr<const std::vector<OverlayBox>>& boxes){
-    SpinLockGuard lg(m_lock, "VideoOverlay::update_boxes()");
-    m_boxes = boxes;
-}
-void VideoOverlayWidget::update_text(const std::shared_ptr<const std::vector<OverlayText>>& texts){
-    SpinLockGuard lg(m_lock, "VideoOverlay::update_text()");
-    m_texts = texts;
-}
-void VideoOverlayWidget::update_log(const std::shared_ptr<const std::vector<OverlayLogLine>>& texts){
-    SpinLockGuard lg(m_lock, "VideoOverlay::update_log_text()");
-    m_log = texts;
-}
 #if 0
 void VideoOverlayWidget::update_log_background(const std::shared_ptr<const std::vector<VideoOverlaySession::Box>>& bg_boxes){
     SpinLockGuard lg(m_lock, "VideoOverlay::update_log_background()");
@@ -78,17 +66,21 @@ void VideoOverlayWidget::resizeEvent(QResizeEvent* event){}
 void VideoOverlayWidget::paintEvent(QPaintEvent*){
     QPainter painter(this);
 
-    SpinLockGuard lg(m_lock, "VideoOverlay::paintEvent()");
-
+    //  Everything that changed since the last frame shows up here at once.
     if (m_session.enabled_boxes()){
+        m_boxes = m_session.box_snapshot();
         update_boxes(painter);
     }
     if (m_session.enabled_text()){
+        m_texts = m_session.text_snapshot();
         update_text(painter);
     }
     if (m_session.enabled_log()){
+        m_log = m_session.log_snapshot();
         update_log(painter);
     }
+
+    SpinLockGuard lg(m_lock, "VideoOverlay::paintEvent()");
     if (m_session.enabled_stats() && m_stats){
         update_stats(painter);
     }
@@ -35,9 +35,6 @@ private:
     virtual void enabled_log  (bool enabled) override;
     virtual void enabled_stats(bool enabled) override;
 
-    virtual void update_boxes(const std::shared_ptr<const std::vector<OverlayBox>>& boxes) override;
-    virtual void update_text (const std::shared_ptr<const std::vector<OverlayText>>& texts) override;
-    virtual void update_log  (const std::shared_ptr<const std::vector<OverlayLogLine>>& texts) override;
     virtual void update_stats(const std::list<OverlayStat*>* stats) override;
 
     virtual void resizeEvent(QResizeEvent* event) override;
@@ -52,10 +49,13 @@ private:
 private:
     VideoOverlaySession& m_session;
 
-    SpinLock m_lock;
+    //  Snapshots pulled from the session at the start of each paint.
+    //  Only touched by the UI thread.
     std::shared_ptr<const std::vector<OverlayBox>> m_boxes;
     std::shared_ptr<const std::vector<OverlayText>> m_texts;
     std::shared_ptr<const std::vector<OverlayLogLine>> m_log;
+
+    SpinLock m_lock;
     const std::list<OverlayStat*>* m_stats;
 };
 
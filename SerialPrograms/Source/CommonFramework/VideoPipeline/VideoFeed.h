@@ -8,11 +8,14 @@
 #define PokemonAutomation_VideoFeedInterface_H
 
 #include <memory>
+#include <vector>
 #include "Common/Cpp/Time.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 
 namespace PokemonAutomation{
 
+struct ImageFloatBox;
+
 
 struct VideoSnapshot{
     //  The frame itself. Null means no snapshot was available.
@@ -22,13 +25,18 @@ struct VideoSnapshot{
     //  This will be as close as possible to when the frame was taken.
     WallClock timestamp = WallClock::min();
 
+    //  The seqnum the video source gave this frame. Zero if the source does
+    //  not number its frames.
+    uint64_t seqnum = 0;
+
     VideoSnapshot()
          : frame(std::make_shared<const ImageRGB32>())
          , timestamp(WallClock::min())
     {}
-    VideoSnapshot(ImageRGB32 p_frame, WallClock p_timestamp)
+    VideoSnapshot(ImageRGB32 p_frame, WallClock p_timestamp, uint64_t p_seqnum = 0)
          : frame(std::make_shared<const ImageRGB32>(std::move(p_frame)))
          , timestamp(p_timestamp)
+         , seqnum(p_seqnum)
     {}
 
     //  Returns true if the snapshot is valid.
@@ -53,6 +61,21 @@ public:
     //  Do not call this on the main thread or it may deadlock.
     virtual VideoSnapshot snapshot() = 0;
 
+    //  Same as "snapshot()", but only the pixels inside "regions" need to be
+    //  valid. The rest of the frame is blank (zero), never stale data. Feeds
+    //  that cannot convert part of a frame return the full frame.
+    //  Do not call this on the main thread or it may deadlock.
+    virtual VideoSnapshot snapshot_regions(const std::vector<ImageFloatBox>&){
+        return snapshot();
+    }
+
+    //  Same as "snapshot()", but the frame may be scaled down to no wider than
+    //  "max_width". Feeds that cannot do this cheaply return the full frame.
+    //  Do not call this on the main thread or it may deadlock.
+    virtual VideoSnapshot snapshot_downscaled(size_t){
+        return snapshot();
+    }
+
     //  Returns the currently measured frames/second for the video source + display.
     //  Use this for diagnostic purposes.
     virtual double fps_source() = 0;
@@ -95,77 +95,68 @@ void VideoOverlaySession::set_enabled_stats(bool enabled){
 
 
 
+//  Adding and removing only invalidates the snapshot. The old snapshot is
+//  kept alive by whoever is still drawing it.
 void VideoOverlaySession::add_box(const OverlayBox& box){
+    std::shared_ptr<const std::vector<OverlayBox>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::add_box()");
     m_boxes.insert(&box);
-    push_box_update();
+    old = std::move(m_box_snapshot);
 }
 void VideoOverlaySession::remove_box(const OverlayBox& box){
+    std::shared_ptr<const std::vector<OverlayBox>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::remove_box()");
     m_boxes.erase(&box);
-    push_box_update();
+    old = std::move(m_box_snapshot);
 }
 
-void VideoOverlaySession::push_box_update(){
-    if (m_listeners.empty()){
-        return;
-    }
-    
-    // We create a newly allocated Box vector to avoid listeners accessing `m_boxes` asynchronously.
-    std::shared_ptr<std::vector<OverlayBox>> ptr = std::make_shared<std::vector<OverlayBox>>();
-    for (const auto& item : m_boxes){
-        ptr->emplace_back(*item);
-    }
-    for (Listener* listeners : m_listeners){
-        listeners->update_boxes(ptr);
+std::shared_ptr<const std::vector<OverlayBox>> VideoOverlaySession::box_snapshot() const{
+    SpinLockGuard lg(m_lock);
+    if (!m_box_snapshot){
+        std::shared_ptr<std::vector<OverlayBox>> ptr = std::make_shared<std::vector<OverlayBox>>();
+        ptr->reserve(m_boxes.size());
+        for (const auto& item : m_boxes){
+            ptr->emplace_back(*item);
+        }
+        m_box_snapshot = std::move(ptr);
     }
+    return m_box_snapshot;
 }
-
 std::vector<OverlayBox> VideoOverlaySession::boxes() const{
-    SpinLockGuard lg(m_lock);
-    std::vector<OverlayBox> ret;
-    for (const auto& item : m_boxes){
-        ret.emplace_back(*item);
-    }
-    return ret;
+    return *box_snapshot();
 }
 
 void VideoOverlaySession::add_text(const OverlayText& text){
+    std::shared_ptr<const std::vector<OverlayText>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::add_text()");
     m_texts.insert(&text);
-    push_text_update();
+    old = std::move(m_text_snapshot);
 }
 void VideoOverlaySession::remove_text(const OverlayText& text){
+    std::shared_ptr<const std::vector<OverlayText>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::remove_text()");
     m_texts.erase(&text);
-    push_text_update();
+    old = std::move(m_text_snapshot);
 }
 
-void VideoOverlaySession::push_text_update(){
-    if (m_listeners.empty()){
-        return;
-    }
-
-    // We create a newly allocated Box vector to avoid listeners accessing `m_texts` asynchronously.
-    std::shared_ptr<std::vector<OverlayText>> ptr = std::make_shared<std::vector<OverlayText>>();
-    for (const auto& item : m_texts){
-        ptr->emplace_back(*item);
-    }
-    for (Listener* listeners : m_listeners){
-        listeners->update_text(ptr);
+std::shared_ptr<const std::vector<OverlayText>> VideoOverlaySession::text_snapshot() const{
+    SpinLockGuard lg(m_lock);
+    if (!m_text_snapshot){
+        std::shared_ptr<std::vector<OverlayText>> ptr = std::make_shared<std::vector<OverlayText>>();
+        ptr->reserve(m_texts.size());
+        for (const auto& item : m_texts){
+            ptr->emplace_back(*item);
+        }
+        m_text_snapshot = std::move(ptr);
     }
+    return m_text_snapshot;
 }
-
 std::vector<OverlayText> VideoOverlaySession::texts() const{
-    SpinLockGuard lg(m_lock);
-    std::vector<OverlayText> ret;
-    for (const auto& item : m_texts){
-        ret.emplace_back(*item);
-    }
-    return ret;
+    return *text_snapshot();
 }
 
 void VideoOverlaySession::add_log(std::string message, Color color){
+    std::shared_ptr<const std::vector<OverlayLogLine>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::add_log_text()");
     m_log_texts.emplace_front(color, std::move(message));
 
@@ -173,37 +164,25 @@ void VideoOverlaySession::add_log(std::string message, Color color){
         m_log_texts.pop_back();
     }
 
-    push_log_text_update();
+    old = std::move(m_log_snapshot);
 }
 
 void VideoOverlaySession::clear_log(){
+    std::shared_ptr<const std::vector<OverlayLogLine>> old;
     SpinLockGuard lg(m_lock, "VideoOverlaySession::clear_log_texts()");
     m_log_texts.clear();
-    push_log_text_update();
+    old = std::move(m_log_snapshot);
 }
 
-void VideoOverlaySession::push_log_text_update(){
-    if (m_listeners.empty()){
-        return;
-    }
-    
-    // We create a newly allocated Box vector to avoid listeners accessing `m_log_texts` asynchronously.
-    std::shared_ptr<std::vector<OverlayLogLine>> ptr = std::make_shared<std::vector<OverlayLogLine>>();
-    for(const auto& item : m_log_texts){
-        ptr->emplace_back(item);
-    }
-    for (Listener* listeners : m_listeners){
-        listeners->update_log(ptr);
+std::shared_ptr<const std::vector<OverlayLogLine>> VideoOverlaySession::log_snapshot() const{
+    SpinLockGuard lg(m_lock);
+    if (!m_log_snapshot){
+        m_log_snapshot = std::make_shared<std::vector<OverlayLogLine>>(m_log_texts.begin(), m_log_texts.end());
     }
+    return m_log_snapshot;
 }
-
 std::vector<OverlayLogLine> VideoOverlaySession::log_texts() const{
-    SpinLockGuard lg(m_lock);
-    std::vector<OverlayLogLine> ret;
-    for(const auto& item : m_log_texts){
-        ret.emplace_back(item);
-    }
-    return ret;
+    return *log_snapshot();
 }
 
 
@@ -8,6 +8,12 @@
  *  This class is not responsible for any UI. However, any changes made to this
  *  class will be forwarded to any UI components that are attached to it.
  *
+ *  Boxes, text and log lines are published as immutable snapshots. Adding or
+ *  removing them only marks the snapshot as stale. The UI pulls a new
+ *  snapshot when it paints a frame. So any number of changes between two
+ *  frames are published once, and the inference threads never wait for the
+ *  UI to paint.
+ *
  */
 
 #ifndef PokemonAutomation_VideoPipeline_VideoOverlaySession_H
@@ -47,10 +53,6 @@ public:
         virtual void enabled_log  (bool enabled){}
         virtual void enabled_stats(bool enabled){}
 
-        virtual void update_boxes(const std::shared_ptr<const std::vector<OverlayBox>>& boxes){}
-        virtual void update_text (const std::shared_ptr<const std::vector<OverlayText>>& texts){}
-        virtual void update_log  (const std::shared_ptr<const std::vector<OverlayLogLine>>& boxes){}
-
         //  This one is different from the others. The listeners will store this
         //  pointer and access it directly and asynchronously. If you need to
         //  change the structure of the list itself, you must first call this
@@ -87,6 +89,12 @@ public:
     std::vector<OverlayText> texts() const;
     std::vector<OverlayLogLine> log_texts() const;
 
+    //  The current overlays. The snapshot is only rebuilt if something changed
+    //  since the last call. Snapshots are never modified after they are returned.
+    std::shared_ptr<const std::vector<OverlayBox>> box_snapshot() const;
+    std::shared_ptr<const std::vector<OverlayText>> text_snapshot() const;
+    std::shared_ptr<const std::vector<OverlayLogLine>> log_snapshot() const;
+
     virtual void add_box(const OverlayBox& box) override;
     virtual void remove_box(const OverlayBox& box) override;
 
@@ -99,12 +107,6 @@ public:
     virtual void add_stat(OverlayStat& stat) override;
     virtual void remove_stat(OverlayStat& stat) override;
 
-private:
-    //  Push updates to the various listeners.
-    void push_box_update();
-    void push_text_update();
-    void push_log_text_update();
-
 private:
     mutable SpinLock m_lock;
 
@@ -114,6 +116,11 @@ private:
     std::set<const OverlayText*> m_texts;
     std::deque<OverlayLogLine> m_log_texts;
 
+    //  Last published snapshots. Null if stale.
+    mutable std::shared_ptr<const std::vector<OverlayBox>> m_box_snapshot;
+    mutable std::shared_ptr<const std::vector<OverlayText>> m_text_snapshot;
+    mutable std::shared_ptr<const std::vector<OverlayLogLine>> m_log_snapshot;
+
     std::list<OverlayStat*> m_stats_order;
     std::map<OverlayStat*, std::list<OverlayStat*>::iterator> m_stats;
 
@@ -5,6 +5,7 @@
  */
 
 
+#include <atomic>
 #include "Common/Cpp/CpuId/CpuId.h"
 #include "Kernels_PackedBinaryMatrixCore.tpp"
 #include "Kernels_SparseBinaryMatrixCore.tpp"
@@ -14,8 +15,22 @@ namespace PokemonAutomation{
 namespace Kernels{
 
 
+namespace{
+
+//  -1 means no preference. Use the CPU features.
+std::atomic<int> preferred_type(-1);
+
+}
+
 
 BinaryMatrixType get_BinaryMatrixType(){
+    int preferred = preferred_type.load(std::memory_order_relaxed);
+    if (preferred >= 0 && BinaryMatrixType_available((BinaryMatrixType)preferred)){
+        return (BinaryMatrixType)preferred;
+    }
+    return get_default_BinaryMatrixType();
+}
+BinaryMatrixType get_default_BinaryMatrixType(){
 
 #ifdef PA_ARCH_x86
 //    if (CPU_CAPABILITY_CURRENT.OK_19_IceLake){
@@ -35,6 +50,38 @@ BinaryMatrixType get_BinaryMatrixType(){
 //    return BinaryMatrixType::i64x8_Default;
     return BinaryMatrixType::i64x4_Default;
 }
+bool BinaryMatrixType_available(BinaryMatrixType type){
+    switch (type){
+
+#ifdef PA_ARCH_x86
+#ifdef PA_AutoDispatch_x64_17_Skylake
+    case BinaryMatrixType::i64x64_x64_AVX512:
+    case BinaryMatrixType::i64x32_x64_AVX512:
+        return CPU_CAPABILITY_CURRENT.OK_17_Skylake;
+#endif
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    case BinaryMatrixType::i64x16_x64_AVX2:
+        return CPU_CAPABILITY_CURRENT.OK_13_Haswell;
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    case BinaryMatrixType::i64x8_x64_SSE42:
+        return CPU_CAPABILITY_CURRENT.OK_08_Nehalem;
+#endif
+#endif
+
+    //  i64x8_Default has no filter kernels.
+    case BinaryMatrixType::i64x4_Default:
+        return true;
+    default:
+        return false;
+    }
+}
+void set_preferred_BinaryMatrixType(BinaryMatrixType type){
+    preferred_type.store((int)type, std::memory_order_relaxed);
+}
+void clear_preferred_BinaryMatrixType(){
+    preferred_type.store(-1, std::memory_order_relaxed);
+}
 
 
 std::unique_ptr<PackedBinaryMatrix_IB> make_PackedBinaryMatrix_64x4_Default();
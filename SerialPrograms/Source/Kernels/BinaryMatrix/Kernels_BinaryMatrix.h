@@ -39,6 +39,17 @@ enum class BinaryMatrixType{
 // by waterfill functions and others.
 BinaryMatrixType get_BinaryMatrixType();
 
+// The binary matrix type that the CPU features alone would pick.
+BinaryMatrixType get_default_BinaryMatrixType();
+
+// Whether the type is compiled in and supported by the current CPU capability.
+bool BinaryMatrixType_available(BinaryMatrixType type);
+
+// Override the CPU feature based choice of get_BinaryMatrixType(). This is set
+// by the kernel calibration. It is ignored if the type is not available.
+void set_preferred_BinaryMatrixType(BinaryMatrixType type);
+void clear_preferred_BinaryMatrixType();
+
 // Abstract class for all implmentations of packed binary matrices.
 // Those binary matrices are memory-efficient: each binary element is stored as just one bit in memory.
 // The representation uses "tiles". So instead of having each row contiguous in memory, the space is
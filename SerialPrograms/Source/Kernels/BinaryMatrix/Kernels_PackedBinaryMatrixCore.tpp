@@ -55,11 +55,12 @@ PackedBinaryMatrixCore<Tile>::PackedBinaryMatrixCore(const PackedBinaryMatrixCor
     , m_logical_height(x.m_logical_height)
     , m_tile_width(x.m_tile_width)
     , m_tile_height(x.m_tile_height)
-    , m_data(m_tile_width * m_tile_height)
+    , m_data(m_tile_width * m_tile_height, UNINITIALIZED_TOKEN)
 {
+    //  Every tile is copied. No need to zero them first.
     size_t stop = m_tile_width * m_tile_height;
     for (size_t c = 0; c < stop; c++){
-        m_data[c] = x.m_data[c];
+        new (&m_data[c]) Tile(x.m_data[c]);
     }
 }
 template <typename Tile>
@@ -105,6 +105,79 @@ void to_blackwhite_rgb32_range(
 );
 
 
+//  The filter sets used for OCR text.
+//
+//  The multi-filter "to_blackwhite_rgb32_range()" above has versions that are
+//  specialized for these sets with the ranges as compile-time constants. They
+//  run when the filters are exactly one of these sets, in this order, with
+//  "in_range_black" set on all of them. Anything else runs the generic version.
+struct Rgb32Range{
+    uint32_t mins;
+    uint32_t maxs;
+};
+struct BlackTextRanges{
+    static constexpr size_t COUNT = 3;
+    static constexpr Rgb32Range RANGES[COUNT]{
+        {0xff000000, 0xff404040},
+        {0xff000000, 0xff606060},
+        {0xff000000, 0xff808080},
+    };
+};
+struct WhiteTextRanges{
+    static constexpr size_t COUNT = 3;
+    static constexpr Rgb32Range RANGES[COUNT]{
+        {0xff808080, 0xffffffff},
+        {0xffa0a0a0, 0xffffffff},
+        {0xffc0c0c0, 0xffffffff},
+    };
+};
+struct BlackOrWhiteTextRanges{
+    static constexpr size_t COUNT = 5;
+    static constexpr Rgb32Range RANGES[COUNT]{
+        {0xff000000, 0xff404040},
+        {0xff000000, 0xff606060},
+        {0xff000000, 0xff808080},
+        {0xff808080, 0xffffffff},
+        {0xffa0a0a0, 0xffffffff},
+    };
+};
+
+
+//  The filter sets of the LA mount detector. Pixels outside the range are
+//  replaced with black.
+//
+//  Like the text sets above, the multi-filter "filter_rgb32_range()" has
+//  versions that are specialized for these. They run when the filters are
+//  exactly one of these sets, in this order, with this replacement and
+//  "invert" on all of them.
+struct MountBrightRanges{
+    static constexpr size_t COUNT = 8;
+    static constexpr uint32_t REPLACEMENT = 0xff000000;
+    static constexpr bool INVERT = false;
+    static constexpr Rgb32Range RANGES[COUNT]{
+        {0xff808060, 0xffffffff},
+        {0xff909070, 0xffffffff},
+        {0xffa0a080, 0xffffffff},
+        {0xffb0b090, 0xffffffff},
+        {0xffc0c0a0, 0xffffffff},
+        {0xffd0d0b0, 0xffffffff},
+        {0xffe0e0c0, 0xffffffff},
+        {0xfff0f0d0, 0xffffffff},
+    };
+};
+struct MountYellowRanges{
+    static constexpr size_t COUNT = 4;
+    static constexpr uint32_t REPLACEMENT = 0xff000000;
+    static constexpr bool INVERT = false;
+    static constexpr Rgb32Range RANGES[COUNT]{
+        {0xff606000, 0xffffff7f},
+        {0xff808000, 0xffffff6f},
+        {0xffa0a000, 0xffffff5f},
+        {0xffc0c000, 0xffffff4f},
+    };
+};
+
+
 
 
 
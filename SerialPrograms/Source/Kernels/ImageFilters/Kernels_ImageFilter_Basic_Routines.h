@@ -9,6 +9,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <utility>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Containers/FixedLimitVector.tpp"
 #include "Kernels_ImageFilter_Basic.h"
@@ -107,13 +108,13 @@ PA_FORCE_INLINE void to_blackwhite_rbg32(
         const uint32_t* in = image;
         size_t shift = 0;
         size_t lc = width / VECTOR_SIZE;
-        do{
+        while (lc--){
             for (size_t c = 0; c < filter_count; c++){
                 entries[c].process_full(filter[c].data + shift, in);
             }
             in += VECTOR_SIZE;
             shift += VECTOR_SIZE;
-        }while (--lc);
+        }
         size_t left = width % VECTOR_SIZE;
         if (left != 0){
             for (size_t c = 0; c < filter_count; c++){
@@ -131,6 +132,120 @@ PA_FORCE_INLINE void to_blackwhite_rbg32(
 }
 
 
+//  Same as the multi-filter versions above, but for one of the constant filter
+//  sets. "Runner" processes all the filters of the set at once and takes an
+//  array of output pointers.
+template <typename Runner, typename Filter>
+PA_FORCE_INLINE void filter_per_pixel_set(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    Filter* filter
+){
+    if (width == 0 || height == 0){
+        return;
+    }
+
+    const size_t FILTER_COUNT = Runner::FILTER_COUNT;
+    Runner runner;
+    uint32_t* out[FILTER_COUNT];
+    for (size_t c = 0; c < FILTER_COUNT; c++){
+        out[c] = filter[c].data;
+    }
+
+    const size_t VECTOR_SIZE = Runner::VECTOR_SIZE;
+    do{
+        const uint32_t* in = image;
+        size_t shift = 0;
+        size_t lc = width / VECTOR_SIZE;
+        while (lc--){
+            runner.process_full(out, shift, in);
+            in += VECTOR_SIZE;
+            shift += VECTOR_SIZE;
+        }
+        size_t left = width % VECTOR_SIZE;
+        if (left != 0){
+            runner.process_partial(out, shift, in, left);
+        }
+        image = (const uint32_t*)((const char*)image + bytes_per_row);
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            out[c] = (uint32_t*)((const char*)out[c] + filter[c].bytes_per_row);
+        }
+    }while (--height);
+    for (size_t c = 0; c < FILTER_COUNT; c++){
+        filter[c].data = out[c];
+        filter[c].pixels_in_range = runner.count(c);
+    }
+}
+
+template <typename RangeSet>
+bool matches_range_set(const ToBlackWhiteRgb32RangeFilter* filter, size_t filter_count){
+    if (filter_count != RangeSet::COUNT){
+        return false;
+    }
+    for (size_t c = 0; c < filter_count; c++){
+        if (!filter[c].in_range_black ||
+            filter[c].mins != RangeSet::RANGES[c].mins ||
+            filter[c].maxs != RangeSet::RANGES[c].maxs
+        ){
+            return false;
+        }
+    }
+    return true;
+}
+template <typename RangeSet>
+bool matches_range_set(const FilterRgb32RangeFilter* filter, size_t filter_count){
+    if (filter_count != RangeSet::COUNT){
+        return false;
+    }
+    for (size_t c = 0; c < filter_count; c++){
+        if (filter[c].replacement != RangeSet::REPLACEMENT ||
+            filter[c].invert != RangeSet::INVERT ||
+            filter[c].mins != RangeSet::RANGES[c].mins ||
+            filter[c].maxs != RangeSet::RANGES[c].maxs
+        ){
+            return false;
+        }
+    }
+    return true;
+}
+
+//  Run the specialized version if the filters are one of the constant sets.
+//  Otherwise run the generic version.
+template <template <typename RangeSet> class SetRunner, typename Runner>
+PA_FORCE_INLINE void to_blackwhite_rbg32_dispatch(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    ToBlackWhiteRgb32RangeFilter* filter, size_t filter_count
+){
+    if (matches_range_set<BlackTextRanges>(filter, filter_count)){
+        filter_per_pixel_set<SetRunner<BlackTextRanges>>(image, bytes_per_row, width, height, filter);
+        return;
+    }
+    if (matches_range_set<WhiteTextRanges>(filter, filter_count)){
+        filter_per_pixel_set<SetRunner<WhiteTextRanges>>(image, bytes_per_row, width, height, filter);
+        return;
+    }
+    if (matches_range_set<BlackOrWhiteTextRanges>(filter, filter_count)){
+        filter_per_pixel_set<SetRunner<BlackOrWhiteTextRanges>>(image, bytes_per_row, width, height, filter);
+        return;
+    }
+    to_blackwhite_rbg32<Runner>(image, bytes_per_row, width, height, filter, filter_count);
+}
+template <template <typename RangeSet> class SetRunner, typename Runner>
+PA_FORCE_INLINE void filter_rgb32_range_dispatch(
+    const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
+    FilterRgb32RangeFilter* filter, size_t filter_count
+){
+    if (matches_range_set<MountBrightRanges>(filter, filter_count)){
+        filter_per_pixel_set<SetRunner<MountBrightRanges>>(image, bytes_per_row, width, height, filter);
+        return;
+    }
+    if (matches_range_set<MountYellowRanges>(filter, filter_count)){
+        filter_per_pixel_set<SetRunner<MountYellowRanges>>(image, bytes_per_row, width, height, filter);
+        return;
+    }
+    filter_per_pixel<Runner>(image, bytes_per_row, width, height, filter, filter_count);
+}
+
+
 
 
 
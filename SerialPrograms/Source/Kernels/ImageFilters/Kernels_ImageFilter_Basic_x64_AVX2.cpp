@@ -68,6 +68,83 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ImageFilterByMaskSet_x64_AVX2{
+public:
+    static const size_t VECTOR_SIZE = 8;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ImageFilterByMaskSet_x64_AVX2(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm256_setzero_si256();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return reduce_add32_x64_AVX2(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m256i pixel = _mm256_loadu_si256((const __m256i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m256i word){
+                _mm256_storeu_si256((__m256i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        PartialWordAccess32_x64_AVX2 loader(left);
+        __m256i pixel = loader.load_i32(in);
+        process_words(
+            pixel,
+            [&](size_t index, __m256i word){
+                loader.store(out[index] + shift, word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m256i pixel, Store&& store, std::index_sequence<Index...>){
+        __m256i adj = _mm256_xor_si256(pixel, _mm256_set1_epi8((uint8_t)0x80));
+        (store(Index, process_word<Index>(pixel, adj)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m256i process_word(__m256i pixel, __m256i adj){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __m256i out_of_range = _mm256_setzero_si256();
+        if constexpr (MINS != 0){
+            out_of_range = _mm256_cmpgt_epi8(_mm256_set1_epi32(MINS ^ 0x80808080), adj);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            __m256i cmp = _mm256_cmpgt_epi8(adj, _mm256_set1_epi32(MAXS ^ 0x80808080));
+            out_of_range = _mm256_or_si256(out_of_range, cmp);
+        }
+        __m256i in_range = _mm256_cmpeq_epi32(out_of_range, _mm256_setzero_si256());
+        m_count[Index] = _mm256_sub_epi32(m_count[Index], in_range);
+
+        __m256i replacement = _mm256_set1_epi32(RangeSet::REPLACEMENT);
+        if constexpr (RangeSet::INVERT){
+            return _mm256_blendv_epi8(pixel, replacement, in_range);
+        }else{
+            return _mm256_blendv_epi8(replacement, pixel, in_range);
+        }
+    }
+
+private:
+    __m256i m_count[FILTER_COUNT];
+};
+
+
+
 size_t filter_rgb32_range_x64_AVX2(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row,
@@ -82,7 +159,7 @@ void filter_rgb32_range_x64_AVX2(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     FilterRgb32RangeFilter* filter, size_t filter_count
 ){
-    filter_per_pixel<ImageFilterByMask_x64_AVX2>(
+    filter_rgb32_range_dispatch<ImageFilterByMaskSet_x64_AVX2, ImageFilterByMask_x64_AVX2>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
@@ -217,6 +294,82 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ToBlackWhite_RgbRangeSet_x64_AVX2{
+public:
+    static const size_t VECTOR_SIZE = 8;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ToBlackWhite_RgbRangeSet_x64_AVX2(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm256_setzero_si256();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return reduce_add32_x64_AVX2(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m256i pixel = _mm256_loadu_si256((const __m256i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m256i word){
+                _mm256_storeu_si256((__m256i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        PartialWordAccess32_x64_AVX2 loader(left);
+        __m256i pixel = loader.load_i32(in);
+        process_words(
+            pixel,
+            [&](size_t index, __m256i word){
+                loader.store(out[index] + shift, word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m256i pixel, Store&& store, std::index_sequence<Index...>){
+        __m256i adj = _mm256_xor_si256(pixel, _mm256_set1_epi8((uint8_t)0x80));
+        (store(Index, process_word<Index>(adj)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m256i process_word(__m256i adj){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __m256i out_of_range = _mm256_setzero_si256();
+        if constexpr (MINS != 0){
+            out_of_range = _mm256_cmpgt_epi8(_mm256_set1_epi32(MINS ^ 0x80808080), adj);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            __m256i cmp = _mm256_cmpgt_epi8(adj, _mm256_set1_epi32(MAXS ^ 0x80808080));
+            out_of_range = _mm256_or_si256(out_of_range, cmp);
+        }
+        __m256i in_range = _mm256_cmpeq_epi32(out_of_range, _mm256_setzero_si256());
+        m_count[Index] = _mm256_sub_epi32(m_count[Index], in_range);
+
+        //  In range is black.
+        return _mm256_or_si256(
+            _mm256_andnot_si256(in_range, _mm256_set1_epi32(-1)),
+            _mm256_set1_epi32(0xff000000)
+        );
+    }
+
+private:
+    __m256i m_count[FILTER_COUNT];
+};
+
+
+
 size_t to_blackwhite_rgb32_range_x64_AVX2(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row,
@@ -230,7 +383,7 @@ void to_blackwhite_rgb32_range_x64_AVX2(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     ToBlackWhiteRgb32RangeFilter* filter, size_t filter_count
 ){
-    to_blackwhite_rbg32<ToBlackWhite_RgbRange_x64_AVX2>(
+    to_blackwhite_rbg32_dispatch<ToBlackWhite_RgbRangeSet_x64_AVX2, ToBlackWhite_RgbRange_x64_AVX2>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
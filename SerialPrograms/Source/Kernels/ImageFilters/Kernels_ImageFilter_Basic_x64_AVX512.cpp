@@ -40,7 +40,7 @@ public:
     }
     PA_FORCE_INLINE void process_partial(uint32_t* out, const uint32_t* in, size_t left){
         uint64_t mask = ((uint64_t)1 << left) - 1;
-        __m512i pixel = _mm512_maskz_load_epi32((__mmask16)mask, in);
+        __m512i pixel = _mm512_maskz_loadu_epi32((__mmask16)mask, in);
         pixel = process_word(pixel);
         _mm512_mask_storeu_epi32(out, (__mmask16)mask, pixel);
     }
@@ -73,6 +73,82 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ImageFilterByMaskSet_x64_AVX512{
+public:
+    static const size_t VECTOR_SIZE = 16;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ImageFilterByMaskSet_x64_AVX512(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm512_setzero_si512();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return _mm512_reduce_add_epi32(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m512i pixel = _mm512_loadu_si512((const __m512i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m512i word){
+                _mm512_storeu_si512((__m512i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        __mmask16 mask = (__mmask16)(((uint64_t)1 << left) - 1);
+        __m512i pixel = _mm512_maskz_loadu_epi32(mask, in);
+        process_words(
+            pixel,
+            [=](size_t index, __m512i word){
+                _mm512_mask_storeu_epi32(out[index] + shift, mask, word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m512i pixel, Store&& store, std::index_sequence<Index...>){
+        (store(Index, process_word<Index>(pixel)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m512i process_word(__m512i pixel){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __mmask64 cmp64 = (__mmask64)-1;
+        if constexpr (MINS != 0){
+            cmp64 = _mm512_cmple_epu8_mask(_mm512_set1_epi32(MINS), pixel);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            cmp64 = _mm512_mask_cmple_epu8_mask(cmp64, pixel, _mm512_set1_epi32(MAXS));
+        }
+        __m512i mask = _mm512_movm_epi8(cmp64);
+        __mmask16 in_range = _mm512_cmpeq_epi32_mask(mask, _mm512_set1_epi32(-1));
+        m_count[Index] = _mm512_mask_sub_epi32(m_count[Index], in_range, m_count[Index], _mm512_set1_epi32(-1));
+
+        __m512i replacement = _mm512_set1_epi32(RangeSet::REPLACEMENT);
+        if constexpr (RangeSet::INVERT){
+            return _mm512_mask_blend_epi32(in_range, pixel, replacement);
+        }else{
+            return _mm512_mask_blend_epi32(in_range, replacement, pixel);
+        }
+    }
+
+private:
+    __m512i m_count[FILTER_COUNT];
+};
+
+
+
 size_t filter_rgb32_range_x64_AVX512(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row, uint32_t mins, uint32_t maxs, uint32_t replacement, bool invert
@@ -85,7 +161,7 @@ void filter_rgb32_range_x64_AVX512(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     FilterRgb32RangeFilter* filter, size_t filter_count
 ){
-    filter_per_pixel<ImageFilterByMask_x64_AVX512>(
+    filter_rgb32_range_dispatch<ImageFilterByMaskSet_x64_AVX512, ImageFilterByMask_x64_AVX512>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
@@ -119,7 +195,7 @@ public:
     }
     PA_FORCE_INLINE void process_partial(uint32_t* out, const uint32_t* in, size_t left){
         uint64_t mask = ((uint64_t)1 << left) - 1;
-        __m512i pixel = _mm512_maskz_load_epi32((__mmask16)mask, in);
+        __m512i pixel = _mm512_maskz_loadu_epi32((__mmask16)mask, in);
         pixel = process_word(pixel);
         _mm512_mask_storeu_epi32(out, (__mmask16)mask, pixel);
     }
@@ -197,7 +273,7 @@ public:
     }
     PA_FORCE_INLINE void process_partial(uint32_t* out, const uint32_t* in, size_t left){
         uint64_t mask = ((uint64_t)1 << left) - 1;
-        __m512i pixel = _mm512_maskz_load_epi32((__mmask16)mask, in);
+        __m512i pixel = _mm512_maskz_loadu_epi32((__mmask16)mask, in);
         pixel = process_word(pixel);
         _mm512_mask_storeu_epi32(out, (__mmask16)mask, pixel);
     }
@@ -229,6 +305,78 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ToBlackWhite_RgbRangeSet_x64_AVX512{
+public:
+    static const size_t VECTOR_SIZE = 16;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ToBlackWhite_RgbRangeSet_x64_AVX512(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm512_setzero_si512();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return _mm512_reduce_add_epi32(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m512i pixel = _mm512_loadu_si512((const __m512i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m512i word){
+                _mm512_storeu_si512((__m512i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        __mmask16 mask = (__mmask16)(((uint64_t)1 << left) - 1);
+        __m512i pixel = _mm512_maskz_loadu_epi32(mask, in);
+        process_words(
+            pixel,
+            [=](size_t index, __m512i word){
+                _mm512_mask_storeu_epi32(out[index] + shift, mask, word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m512i pixel, Store&& store, std::index_sequence<Index...>){
+        (store(Index, process_word<Index>(pixel)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m512i process_word(__m512i pixel){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __mmask64 cmp64 = (__mmask64)-1;
+        if constexpr (MINS != 0){
+            cmp64 = _mm512_cmple_epu8_mask(_mm512_set1_epi32(MINS), pixel);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            cmp64 = _mm512_mask_cmple_epu8_mask(cmp64, pixel, _mm512_set1_epi32(MAXS));
+        }
+        __m512i mask = _mm512_movm_epi8(cmp64);
+        __mmask16 in_range = _mm512_cmpeq_epi32_mask(mask, _mm512_set1_epi32(-1));
+        m_count[Index] = _mm512_mask_sub_epi32(m_count[Index], in_range, m_count[Index], _mm512_set1_epi32(-1));
+
+        //  In range is black.
+        return _mm512_mask_blend_epi32(in_range, _mm512_set1_epi32(-1), _mm512_set1_epi32(0xff000000));
+    }
+
+private:
+    __m512i m_count[FILTER_COUNT];
+};
+
+
+
 size_t to_blackwhite_rgb32_range_x64_AVX512(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row,
@@ -242,7 +390,7 @@ void to_blackwhite_rgb32_range_x64_AVX512(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     ToBlackWhiteRgb32RangeFilter* filter, size_t filter_count
 ){
-    to_blackwhite_rbg32<ToBlackWhite_RgbRange_x64_AVX512>(
+    to_blackwhite_rbg32_dispatch<ToBlackWhite_RgbRangeSet_x64_AVX512, ToBlackWhite_RgbRange_x64_AVX512>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
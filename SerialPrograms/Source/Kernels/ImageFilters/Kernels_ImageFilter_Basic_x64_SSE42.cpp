@@ -72,6 +72,89 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ImageFilter_RgbRangeSet_x64_SSE42{
+public:
+    static const size_t VECTOR_SIZE = 4;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ImageFilter_RgbRangeSet_x64_SSE42(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm_setzero_si128();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return reduce32_x64_SSE41(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m128i pixel = _mm_loadu_si128((const __m128i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m128i word){
+                _mm_storeu_si128((__m128i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        PartialWordAccess_x64_SSE41 loader(left * sizeof(uint32_t));
+        __m128i pixel = loader.load(in);
+        process_words(
+            pixel,
+            [=](size_t index, __m128i word){
+                uint32_t* ptr = out[index] + shift;
+                size_t lc = left;
+                do{
+                    ptr[0] = _mm_cvtsi128_si32(word);
+                    word = _mm_srli_si128(word, 4);
+                    ptr++;
+                }while(--lc);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m128i pixel, Store&& store, std::index_sequence<Index...>){
+        __m128i adj = _mm_xor_si128(pixel, _mm_set1_epi8((uint8_t)0x80));
+        (store(Index, process_word<Index>(pixel, adj)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m128i process_word(__m128i pixel, __m128i adj){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __m128i out_of_range = _mm_setzero_si128();
+        if constexpr (MINS != 0){
+            out_of_range = _mm_cmpgt_epi8(_mm_set1_epi32(MINS ^ 0x80808080), adj);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            __m128i cmp = _mm_cmpgt_epi8(adj, _mm_set1_epi32(MAXS ^ 0x80808080));
+            out_of_range = _mm_or_si128(out_of_range, cmp);
+        }
+        __m128i in_range = _mm_cmpeq_epi32(out_of_range, _mm_setzero_si128());
+        m_count[Index] = _mm_sub_epi32(m_count[Index], in_range);
+
+        __m128i replacement = _mm_set1_epi32(RangeSet::REPLACEMENT);
+        if constexpr (RangeSet::INVERT){
+            return _mm_blendv_epi8(pixel, replacement, in_range);
+        }else{
+            return _mm_blendv_epi8(replacement, pixel, in_range);
+        }
+    }
+
+private:
+    __m128i m_count[FILTER_COUNT];
+};
+
+
+
 size_t filter_rgb32_range_x64_SSE42(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row,
@@ -86,7 +169,7 @@ void filter_rgb32_range_x64_SSE42(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     FilterRgb32RangeFilter* filter, size_t filter_count
 ){
-    filter_per_pixel<ImageFilter_RgbRange_x64_SSE42>(
+    filter_rgb32_range_dispatch<ImageFilter_RgbRangeSet_x64_SSE42, ImageFilter_RgbRange_x64_SSE42>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
@@ -231,6 +314,88 @@ private:
 
 
 
+//  All the filters of a constant set at once. The pixels are loaded once for
+//  the whole set and the comparisons that can't fail are left out.
+template <typename RangeSet>
+class ToBlackWhite_RgbRangeSet_x64_SSE42{
+public:
+    static const size_t VECTOR_SIZE = 4;
+    static const size_t FILTER_COUNT = RangeSet::COUNT;
+
+public:
+    ToBlackWhite_RgbRangeSet_x64_SSE42(){
+        for (size_t c = 0; c < FILTER_COUNT; c++){
+            m_count[c] = _mm_setzero_si128();
+        }
+    }
+
+    PA_FORCE_INLINE size_t count(size_t index) const{
+        return reduce32_x64_SSE41(m_count[index]);
+    }
+
+    PA_FORCE_INLINE void process_full(uint32_t* const* out, size_t shift, const uint32_t* in){
+        __m128i pixel = _mm_loadu_si128((const __m128i*)in);
+        process_words(
+            pixel,
+            [=](size_t index, __m128i word){
+                _mm_storeu_si128((__m128i*)(out[index] + shift), word);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+    PA_FORCE_INLINE void process_partial(uint32_t* const* out, size_t shift, const uint32_t* in, size_t left){
+        PartialWordAccess_x64_SSE41 loader(left * sizeof(uint32_t));
+        __m128i pixel = loader.load(in);
+        process_words(
+            pixel,
+            [=](size_t index, __m128i word){
+                uint32_t* ptr = out[index] + shift;
+                size_t lc = left;
+                do{
+                    ptr[0] = _mm_cvtsi128_si32(word);
+                    word = _mm_srli_si128(word, 4);
+                    ptr++;
+                }while(--lc);
+            },
+            std::make_index_sequence<FILTER_COUNT>()
+        );
+    }
+
+private:
+    template <typename Store, size_t... Index>
+    PA_FORCE_INLINE void process_words(__m128i pixel, Store&& store, std::index_sequence<Index...>){
+        __m128i adj = _mm_xor_si128(pixel, _mm_set1_epi8((uint8_t)0x80));
+        (store(Index, process_word<Index>(adj)), ...);
+    }
+
+    template <size_t Index>
+    PA_FORCE_INLINE __m128i process_word(__m128i adj){
+        constexpr uint32_t MINS = RangeSet::RANGES[Index].mins;
+        constexpr uint32_t MAXS = RangeSet::RANGES[Index].maxs;
+        __m128i out_of_range = _mm_setzero_si128();
+        if constexpr (MINS != 0){
+            out_of_range = _mm_cmpgt_epi8(_mm_set1_epi32(MINS ^ 0x80808080), adj);
+        }
+        if constexpr (MAXS != 0xffffffff){
+            __m128i cmp = _mm_cmpgt_epi8(adj, _mm_set1_epi32(MAXS ^ 0x80808080));
+            out_of_range = _mm_or_si128(out_of_range, cmp);
+        }
+        __m128i in_range = _mm_cmpeq_epi32(out_of_range, _mm_setzero_si128());
+        m_count[Index] = _mm_sub_epi32(m_count[Index], in_range);
+
+        //  In range is black.
+        return _mm_or_si128(
+            _mm_andnot_si128(in_range, _mm_set1_epi32(-1)),
+            _mm_set1_epi32(0xff000000)
+        );
+    }
+
+private:
+    __m128i m_count[FILTER_COUNT];
+};
+
+
+
 size_t to_blackwhite_rgb32_range_x64_SSE42(
     const uint32_t* in, size_t in_bytes_per_row, size_t width, size_t height,
     uint32_t* out, size_t out_bytes_per_row,
@@ -244,7 +409,7 @@ void to_blackwhite_rgb32_range_x64_SSE42(
     const uint32_t* image, size_t bytes_per_row, size_t width, size_t height,
     ToBlackWhiteRgb32RangeFilter* filter, size_t filter_count
 ){
-    to_blackwhite_rbg32<ToBlackWhite_RgbRange_x64_SSE42>(
+    to_blackwhite_rbg32_dispatch<ToBlackWhite_RgbRangeSet_x64_SSE42, ToBlackWhite_RgbRange_x64_SSE42>(
         image, bytes_per_row, width, height, filter, filter_count
     );
 }
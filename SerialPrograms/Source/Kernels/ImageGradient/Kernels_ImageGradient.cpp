@@ -0,0 +1,137 @@
+/*  Image Gradient
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageGradient.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+void smooth5_rgb32_rows_Default(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+void smooth5_rgb32_rows_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+void smooth5_rgb32_rows_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+
+void smooth5_rgb32_rows(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        smooth5_rgb32_rows_x64_AVX2(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        smooth5_rgb32_rows_x64_SSE41(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+        return;
+    }
+#endif
+    smooth5_rgb32_rows_Default(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+}
+
+
+
+void smooth5_rgb32_columns_Default(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+void smooth5_rgb32_columns_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+void smooth5_rgb32_columns_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+
+void smooth5_rgb32_columns(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        smooth5_rgb32_columns_x64_AVX2(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        smooth5_rgb32_columns_x64_SSE41(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+        return;
+    }
+#endif
+    smooth5_rgb32_columns_Default(width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter);
+}
+
+
+
+void sobel_gradient_rgb32_Default(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+);
+void sobel_gradient_rgb32_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+);
+void sobel_gradient_rgb32_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+);
+
+void sobel_gradient_rgb32(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+){
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        sobel_gradient_rgb32_x64_AVX2(width, height, image, bytes_per_row, gx, gy, valid, output_stride);
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        sobel_gradient_rgb32_x64_SSE41(width, height, image, bytes_per_row, gx, gy, valid, output_stride);
+        return;
+    }
+#endif
+    sobel_gradient_rgb32_Default(width, height, image, bytes_per_row, gx, gy, valid, output_stride);
+}
+
+
+
+}
+}
@@ -0,0 +1,62 @@
+/*  Image Gradient
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Smoothing and Sobel gradients of RGB32 images that skip transparent
+ *  pixels. (alpha < 128)
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageGradient_H
+#define PokemonAutomation_Kernels_ImageGradient_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  5-tap blur along each row. Transparent pixels under the filter are
+//  skipped and the remaining weights are renormalized. An output pixel is
+//  opaque unless every pixel under the filter is transparent. Then it is 0.
+//
+//  The input and output must not overlap.
+void smooth5_rgb32_rows(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+
+//  Same as above, but along each column.
+void smooth5_rgb32_columns(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+);
+
+
+//  3x3 Sobel gradient of the sum of the R, G and B channels.
+//
+//  The outputs are (width - 2) x (height - 2). Output (x, y) is the gradient
+//  at input pixel (x + 1, y + 1). "gx" is the right side minus the left side.
+//  "gy" is the top side minus the bottom side.
+//
+//  If any of the 9 pixels under the filter is transparent, there is no
+//  gradient. Then "valid" is 0 and "gx" and "gy" are 0. Otherwise "valid"
+//  is 1.
+//
+//  "output_stride" is in elements and is the same for all 3 outputs.
+void sobel_gradient_rgb32(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,67 @@
+/*  Image Gradient (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "Kernels_ImageGradient_Routines.h"
+#include "Kernels_ImageGradient.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ImageGradientContext_Default{
+    static void smooth5_row(size_t width, const uint32_t* in, uint32_t* out, const float filter[5]){
+        smooth5_rgb32_row_Default(0, width, width, in, out, filter);
+    }
+    static void smooth5_column_row(size_t width, const uint32_t* const rows[5], uint32_t* out, const float filter[5]){
+        smooth5_rgb32_column_row_Default(0, width, rows, out, filter);
+    }
+    static void sobel_prepare_row(size_t width, const uint32_t* in, int16_t* sums, int16_t* opaque){
+        sobel_prepare_row_Default(0, width, in, sums, opaque);
+    }
+    static void sobel_gradient_row(
+        size_t out_width,
+        const int16_t* const sums[3], const int16_t* const opaque[3],
+        int16_t* gx, int16_t* gy, uint8_t* valid
+    ){
+        sobel_gradient_row_Default(0, out_width, sums, opaque, gx, gy, valid);
+    }
+};
+
+
+void smooth5_rgb32_rows_Default(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_rows<ImageGradientContext_Default>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void smooth5_rgb32_columns_Default(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_columns<ImageGradientContext_Default>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void sobel_gradient_rgb32_Default(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+){
+    run_sobel_gradient_rgb32<ImageGradientContext_Default>(
+        width, height, image, bytes_per_row, gx, gy, valid, output_stride
+    );
+}
+
+
+
+}
+}
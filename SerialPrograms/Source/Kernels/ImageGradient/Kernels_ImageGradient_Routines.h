@@ -0,0 +1,205 @@
+/*  Image Gradient Routines
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      The loops over the whole image and scalar versions of the per-pixel
+ *  work. Each instruction set provides a context with the row functions:
+ *
+ *      //  Horizontal smoothing of a row.
+ *      static void smooth5_row(size_t width, const uint32_t* in, uint32_t* out, const float filter[5]);
+ *
+ *      //  Vertical smoothing of a row. Null rows are outside the image.
+ *      static void smooth5_column_row(size_t width, const uint32_t* const rows[5], uint32_t* out, const float filter[5]);
+ *
+ *      //  Channel sums and opacity masks (0 or -1) of a row.
+ *      static void sobel_prepare_row(size_t width, const uint32_t* in, int16_t* sums, int16_t* opaque);
+ *
+ *      //  One row of gradients from 3 prepared rows.
+ *      static void sobel_gradient_row(
+ *          size_t out_width,
+ *          const int16_t* const sums[3], const int16_t* const opaque[3],
+ *          int16_t* gx, int16_t* gy, uint8_t* valid
+ *      );
+ *
+ *  The smoothing must round the same as the scalar version. So the vector
+ *  contexts do not fall back to it for edges and tails. Built for AVX2, the
+ *  compiler is free to fuse its multiply-adds into FMAs which round once
+ *  instead of twice.
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageGradient_Routines_H
+#define PokemonAutomation_Kernels_ImageGradient_Routines_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <algorithm>
+#include "Common/Compiler.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Kernels_ImageGradient.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Null taps are outside the image.
+PA_FORCE_INLINE uint32_t smooth5_rgb32_pixel_Default(const uint32_t* const taps[5], const float filter[5]){
+    float sumR = 0;
+    float sumG = 0;
+    float sumB = 0;
+    float weights = 0;
+    for (size_t i = 0; i < 5; i++){
+        if (taps[i] == nullptr){
+            continue;
+        }
+        uint32_t pixel = *taps[i];
+        if ((pixel >> 24) < 128){
+            continue;
+        }
+        weights += filter[i];
+        sumR += filter[i] * (float)((pixel >> 16) & 0xff);
+        sumG += filter[i] * (float)((pixel >> 8) & 0xff);
+        sumB += filter[i] * (float)(pixel & 0xff);
+    }
+    if (weights == 0){
+        return 0;
+    }
+    uint32_t r = (uint32_t)std::min(std::max((int)(sumR / weights + 0.5f), 0), 255);
+    uint32_t g = (uint32_t)std::min(std::max((int)(sumG / weights + 0.5f), 0), 255);
+    uint32_t b = (uint32_t)std::min(std::max((int)(sumB / weights + 0.5f), 0), 255);
+    return 0xff000000 | (r << 16) | (g << 8) | b;
+}
+PA_FORCE_INLINE void smooth5_rgb32_row_Default(
+    size_t start, size_t end, size_t width,
+    const uint32_t* in, uint32_t* out, const float filter[5]
+){
+    for (size_t x = start; x < end; x++){
+        const uint32_t* taps[5];
+        for (size_t i = 0; i < 5; i++){
+            taps[i] = x + i >= 2 && x + i < width + 2 ? in + x + i - 2 : nullptr;
+        }
+        out[x] = smooth5_rgb32_pixel_Default(taps, filter);
+    }
+}
+PA_FORCE_INLINE void smooth5_rgb32_column_row_Default(
+    size_t start, size_t end,
+    const uint32_t* const rows[5], uint32_t* out, const float filter[5]
+){
+    for (size_t x = start; x < end; x++){
+        const uint32_t* taps[5];
+        for (size_t i = 0; i < 5; i++){
+            taps[i] = rows[i] == nullptr ? nullptr : rows[i] + x;
+        }
+        out[x] = smooth5_rgb32_pixel_Default(taps, filter);
+    }
+}
+
+
+PA_FORCE_INLINE void sobel_prepare_row_Default(
+    size_t start, size_t end,
+    const uint32_t* in, int16_t* sums, int16_t* opaque
+){
+    for (size_t x = start; x < end; x++){
+        uint32_t pixel = in[x];
+        sums[x] = (int16_t)((pixel & 0xff) + ((pixel >> 8) & 0xff) + ((pixel >> 16) & 0xff));
+        opaque[x] = (int16_t)((int32_t)pixel >> 31);
+    }
+}
+PA_FORCE_INLINE void sobel_gradient_row_Default(
+    size_t start, size_t end,
+    const int16_t* const sums[3], const int16_t* const opaque[3],
+    int16_t* gx, int16_t* gy, uint8_t* valid
+){
+    const int16_t* s0 = sums[0];
+    const int16_t* s1 = sums[1];
+    const int16_t* s2 = sums[2];
+    for (size_t x = start; x < end; x++){
+        int16_t mask = -1;
+        for (size_t r = 0; r < 3; r++){
+            mask &= opaque[r][x] & opaque[r][x + 1] & opaque[r][x + 2];
+        }
+        int x_gradient = (s0[x + 2] - s0[x]) + 2 * (s1[x + 2] - s1[x]) + (s2[x + 2] - s2[x]);
+        int y_gradient = (s0[x] + 2 * s0[x + 1] + s0[x + 2]) - (s2[x] + 2 * s2[x + 1] + s2[x + 2]);
+        gx[x] = (int16_t)(x_gradient & mask);
+        gy[x] = (int16_t)(y_gradient & mask);
+        valid[x] = (uint8_t)(mask & 1);
+    }
+}
+
+
+
+template <typename Context>
+void run_smooth5_rgb32_rows(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    for (size_t y = 0; y < height; y++){
+        Context::smooth5_row(width, in, out, filter);
+        in = (const uint32_t*)((const char*)in + in_bytes_per_row);
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+template <typename Context>
+void run_smooth5_rgb32_columns(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    for (size_t y = 0; y < height; y++){
+        const uint32_t* rows[5];
+        for (size_t i = 0; i < 5; i++){
+            rows[i] = y + i >= 2 && y + i < height + 2
+                ? (const uint32_t*)((const char*)in + (y + i - 2) * in_bytes_per_row)
+                : nullptr;
+        }
+        Context::smooth5_column_row(width, rows, out, filter);
+        out = (uint32_t*)((char*)out + out_bytes_per_row);
+    }
+}
+
+
+template <typename Context>
+void run_sobel_gradient_rgb32(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+){
+    if (width < 3 || height < 3){
+        return;
+    }
+
+    //  The last 3 prepared rows.
+    AlignedVector<int16_t> buffer(6 * width, UNINITIALIZED_TOKEN);
+    auto prepare = [&](size_t y){
+        int16_t* sums = buffer.data() + (y % 3) * width;
+        int16_t* opaque = sums + 3 * width;
+        Context::sobel_prepare_row(
+            width, (const uint32_t*)((const char*)image + y * bytes_per_row),
+            sums, opaque
+        );
+    };
+    prepare(0);
+    prepare(1);
+    for (size_t y = 0; y < height - 2; y++){
+        prepare(y + 2);
+        const int16_t* sums[3];
+        const int16_t* opaque[3];
+        for (size_t r = 0; r < 3; r++){
+            sums[r] = buffer.data() + ((y + r) % 3) * width;
+            opaque[r] = sums[r] + 3 * width;
+        }
+        Context::sobel_gradient_row(width - 2, sums, opaque, gx, gy, valid);
+        gx += output_stride;
+        gy += output_stride;
+        valid += output_stride;
+    }
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,233 @@
+/*  Image Gradient (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <string.h>
+#include <algorithm>
+#include <immintrin.h>
+#include "Kernels/Kernels_x64_AVX2.h"
+#include "Kernels_ImageGradient_Routines.h"
+#include "Kernels_ImageGradient.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Accumulates 8 pixels the same way as "smooth5_rgb32_pixel_Default()".
+//  Transparent pixels are masked to zero after the multiply so the compiler
+//  cannot fuse it with the add. Adding zero doesn't change the sums so the
+//  results are exactly the same.
+class Smooth5Rgb32_x64_AVX2{
+public:
+    PA_FORCE_INLINE Smooth5Rgb32_x64_AVX2()
+        : m_sumR(_mm256_setzero_ps())
+        , m_sumG(_mm256_setzero_ps())
+        , m_sumB(_mm256_setzero_ps())
+        , m_weights(_mm256_setzero_ps())
+    {}
+
+    PA_FORCE_INLINE void add(const uint32_t* ptr, float weight){
+        __m256i pixel = _mm256_loadu_si256((const __m256i*)ptr);
+        __m256 opaque = _mm256_castsi256_ps(_mm256_srai_epi32(pixel, 31));
+        __m256 w = _mm256_set1_ps(weight);
+        m_weights = _mm256_add_ps(m_weights, _mm256_and_ps(opaque, w));
+        m_sumR = _mm256_add_ps(m_sumR, _mm256_and_ps(opaque, _mm256_mul_ps(w, channel(pixel, 16))));
+        m_sumG = _mm256_add_ps(m_sumG, _mm256_and_ps(opaque, _mm256_mul_ps(w, channel(pixel, 8))));
+        m_sumB = _mm256_add_ps(m_sumB, _mm256_and_ps(opaque, _mm256_mul_ps(w, channel(pixel, 0))));
+    }
+
+    PA_FORCE_INLINE void store(uint32_t* ptr) const{
+        __m256i pixel = _mm256_or_si256(
+            _mm256_set1_epi32(0xff000000),
+            _mm256_slli_epi32(average(m_sumR), 16)
+        );
+        pixel = _mm256_or_si256(pixel, _mm256_slli_epi32(average(m_sumG), 8));
+        pixel = _mm256_or_si256(pixel, average(m_sumB));
+        __m256 opaque = _mm256_cmp_ps(m_weights, _mm256_setzero_ps(), _CMP_NEQ_OQ);
+        pixel = _mm256_and_si256(pixel, _mm256_castps_si256(opaque));
+        _mm256_storeu_si256((__m256i*)ptr, pixel);
+    }
+
+private:
+    static PA_FORCE_INLINE __m256 channel(__m256i pixel, int shift){
+        return _mm256_cvtepi32_ps(_mm256_and_si256(
+            _mm256_srli_epi32(pixel, shift),
+            _mm256_set1_epi32(0xff)
+        ));
+    }
+    PA_FORCE_INLINE __m256i average(__m256 sum) const{
+        __m256 x = _mm256_add_ps(_mm256_div_ps(sum, m_weights), _mm256_set1_ps(0.5f));
+        __m256i v = _mm256_cvttps_epi32(x);
+        v = _mm256_max_epi32(v, _mm256_setzero_si256());
+        return _mm256_min_epi32(v, _mm256_set1_epi32(255));
+    }
+
+private:
+    __m256 m_sumR;
+    __m256 m_sumG;
+    __m256 m_sumB;
+    __m256 m_weights;
+};
+
+
+
+struct ImageGradientContext_x64_AVX2{
+    static void smooth5_row(size_t width, const uint32_t* in, uint32_t* out, const float filter[5]){
+        for (size_t x = 0; x < width; x += 8){
+            if (x < 2 || x + 10 > width){
+                smooth5_row_padded(width, in, out, x, filter);
+                continue;
+            }
+            Smooth5Rgb32_x64_AVX2 sums;
+            for (size_t i = 0; i < 5; i++){
+                sums.add(in + x + i - 2, filter[i]);
+            }
+            sums.store(out + x);
+        }
+    }
+    static void smooth5_column_row(size_t width, const uint32_t* const rows[5], uint32_t* out, const float filter[5]){
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8){
+            Smooth5Rgb32_x64_AVX2 sums;
+            for (size_t i = 0; i < 5; i++){
+                if (rows[i] != nullptr){
+                    sums.add(rows[i] + x, filter[i]);
+                }
+            }
+            sums.store(out + x);
+        }
+        if (x < width){
+            smooth5_column_row_padded(width, rows, out, x, filter);
+        }
+    }
+
+    //  Blocks that touch the edge of the image. Pixels outside it are zero
+    //  which is transparent.
+    static void smooth5_row_padded(size_t width, const uint32_t* in, uint32_t* out, size_t x, const float filter[5]){
+        uint32_t padded[12] = {};
+        for (size_t c = 0; c < 12; c++){
+            if (x + c >= 2 && x + c < width + 2){
+                padded[c] = in[x + c - 2];
+            }
+        }
+        Smooth5Rgb32_x64_AVX2 sums;
+        for (size_t i = 0; i < 5; i++){
+            sums.add(padded + i, filter[i]);
+        }
+        uint32_t block[8];
+        sums.store(block);
+        memcpy(out + x, block, std::min<size_t>(width - x, 8) * sizeof(uint32_t));
+    }
+    static void smooth5_column_row_padded(size_t width, const uint32_t* const rows[5], uint32_t* out, size_t x, const float filter[5]){
+        size_t count = std::min<size_t>(width - x, 8);
+        Smooth5Rgb32_x64_AVX2 sums;
+        for (size_t i = 0; i < 5; i++){
+            if (rows[i] == nullptr){
+                continue;
+            }
+            uint32_t padded[8] = {};
+            memcpy(padded, rows[i] + x, count * sizeof(uint32_t));
+            sums.add(padded, filter[i]);
+        }
+        uint32_t block[8];
+        sums.store(block);
+        memcpy(out + x, block, count * sizeof(uint32_t));
+    }
+
+    static void sobel_prepare_row(size_t width, const uint32_t* in, int16_t* sums, int16_t* opaque){
+        const __m256i channels = _mm256_set1_epi32(0x00010101);
+        const __m256i ones = _mm256_set1_epi16(1);
+        size_t x = 0;
+        for (; x + 16 <= width; x += 16){
+            __m256i p0 = _mm256_loadu_si256((const __m256i*)(in + x));
+            __m256i p1 = _mm256_loadu_si256((const __m256i*)(in + x + 8));
+            __m256i s0 = _mm256_madd_epi16(_mm256_maddubs_epi16(p0, channels), ones);
+            __m256i s1 = _mm256_madd_epi16(_mm256_maddubs_epi16(p1, channels), ones);
+            __m256i s = _mm256_permute4x64_epi64(_mm256_packs_epi32(s0, s1), 216);
+            __m256i a = _mm256_permute4x64_epi64(
+                _mm256_packs_epi32(_mm256_srai_epi32(p0, 31), _mm256_srai_epi32(p1, 31)),
+                216
+            );
+            _mm256_storeu_si256((__m256i*)(sums + x), s);
+            _mm256_storeu_si256((__m256i*)(opaque + x), a);
+        }
+        sobel_prepare_row_Default(x, width, in, sums, opaque);
+    }
+    static void sobel_gradient_row(
+        size_t out_width,
+        const int16_t* const sums[3], const int16_t* const opaque[3],
+        int16_t* gx, int16_t* gy, uint8_t* valid
+    ){
+        size_t x = 0;
+        for (; x + 16 <= out_width; x += 16){
+            __m256i mask = _mm256_set1_epi16(-1);
+            __m256i l[3];
+            __m256i c[3];
+            __m256i r[3];
+            for (size_t row = 0; row < 3; row++){
+                l[row] = _mm256_loadu_si256((const __m256i*)(sums[row] + x));
+                c[row] = _mm256_loadu_si256((const __m256i*)(sums[row] + x + 1));
+                r[row] = _mm256_loadu_si256((const __m256i*)(sums[row] + x + 2));
+                mask = _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i*)(opaque[row] + x)));
+                mask = _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i*)(opaque[row] + x + 1)));
+                mask = _mm256_and_si256(mask, _mm256_loadu_si256((const __m256i*)(opaque[row] + x + 2)));
+            }
+            __m256i x_gradient = _mm256_add_epi16(
+                _mm256_add_epi16(_mm256_sub_epi16(r[0], l[0]), _mm256_sub_epi16(r[2], l[2])),
+                _mm256_slli_epi16(_mm256_sub_epi16(r[1], l[1]), 1)
+            );
+            __m256i top = _mm256_add_epi16(_mm256_add_epi16(l[0], r[0]), _mm256_slli_epi16(c[0], 1));
+            __m256i bottom = _mm256_add_epi16(_mm256_add_epi16(l[2], r[2]), _mm256_slli_epi16(c[2], 1));
+            __m256i y_gradient = _mm256_sub_epi16(top, bottom);
+
+            _mm256_storeu_si256((__m256i*)(gx + x), _mm256_and_si256(x_gradient, mask));
+            _mm256_storeu_si256((__m256i*)(gy + x), _mm256_and_si256(y_gradient, mask));
+            __m256i flags = _mm256_permute4x64_epi64(_mm256_packs_epi16(mask, mask), 216);
+            flags = _mm256_and_si256(flags, _mm256_set1_epi8(1));
+            _mm_storeu_si128((__m128i*)(valid + x), _mm256_castsi256_si128(flags));
+        }
+        sobel_gradient_row_Default(x, out_width, sums, opaque, gx, gy, valid);
+    }
+};
+
+
+
+void smooth5_rgb32_rows_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_rows<ImageGradientContext_x64_AVX2>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void smooth5_rgb32_columns_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_columns<ImageGradientContext_x64_AVX2>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void sobel_gradient_rgb32_x64_AVX2(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+){
+    run_sobel_gradient_rgb32<ImageGradientContext_x64_AVX2>(
+        width, height, image, bytes_per_row, gx, gy, valid, output_stride
+    );
+}
+
+
+
+}
+}
+#endif
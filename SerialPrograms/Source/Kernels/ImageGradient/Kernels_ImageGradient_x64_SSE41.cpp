@@ -0,0 +1,228 @@
+/*  Image Gradient (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <string.h>
+#include <algorithm>
+#include <smmintrin.h>
+#include "Kernels/Kernels_x64_SSE41.h"
+#include "Kernels_ImageGradient_Routines.h"
+#include "Kernels_ImageGradient.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+//  Accumulates 4 pixels the same way as "smooth5_rgb32_pixel_Default()".
+//  Transparent pixels are masked to zero after the multiply so the compiler
+//  cannot fuse it with the add. Adding zero doesn't change the sums so the
+//  results are exactly the same.
+class Smooth5Rgb32_x64_SSE41{
+public:
+    PA_FORCE_INLINE Smooth5Rgb32_x64_SSE41()
+        : m_sumR(_mm_setzero_ps())
+        , m_sumG(_mm_setzero_ps())
+        , m_sumB(_mm_setzero_ps())
+        , m_weights(_mm_setzero_ps())
+    {}
+
+    PA_FORCE_INLINE void add(const uint32_t* ptr, float weight){
+        __m128i pixel = _mm_loadu_si128((const __m128i*)ptr);
+        __m128 opaque = _mm_castsi128_ps(_mm_srai_epi32(pixel, 31));
+        __m128 w = _mm_set1_ps(weight);
+        m_weights = _mm_add_ps(m_weights, _mm_and_ps(opaque, w));
+        m_sumR = _mm_add_ps(m_sumR, _mm_and_ps(opaque, _mm_mul_ps(w, channel(pixel, 16))));
+        m_sumG = _mm_add_ps(m_sumG, _mm_and_ps(opaque, _mm_mul_ps(w, channel(pixel, 8))));
+        m_sumB = _mm_add_ps(m_sumB, _mm_and_ps(opaque, _mm_mul_ps(w, channel(pixel, 0))));
+    }
+
+    PA_FORCE_INLINE void store(uint32_t* ptr) const{
+        __m128i pixel = _mm_or_si128(
+            _mm_set1_epi32(0xff000000),
+            _mm_slli_epi32(average(m_sumR), 16)
+        );
+        pixel = _mm_or_si128(pixel, _mm_slli_epi32(average(m_sumG), 8));
+        pixel = _mm_or_si128(pixel, average(m_sumB));
+        __m128 opaque = _mm_cmpneq_ps(m_weights, _mm_setzero_ps());
+        pixel = _mm_and_si128(pixel, _mm_castps_si128(opaque));
+        _mm_storeu_si128((__m128i*)ptr, pixel);
+    }
+
+private:
+    static PA_FORCE_INLINE __m128 channel(__m128i pixel, int shift){
+        return _mm_cvtepi32_ps(_mm_and_si128(
+            _mm_srli_epi32(pixel, shift),
+            _mm_set1_epi32(0xff)
+        ));
+    }
+    PA_FORCE_INLINE __m128i average(__m128 sum) const{
+        __m128 x = _mm_add_ps(_mm_div_ps(sum, m_weights), _mm_set1_ps(0.5f));
+        __m128i v = _mm_cvttps_epi32(x);
+        v = _mm_max_epi32(v, _mm_setzero_si128());
+        return _mm_min_epi32(v, _mm_set1_epi32(255));
+    }
+
+private:
+    __m128 m_sumR;
+    __m128 m_sumG;
+    __m128 m_sumB;
+    __m128 m_weights;
+};
+
+
+
+struct ImageGradientContext_x64_SSE41{
+    static void smooth5_row(size_t width, const uint32_t* in, uint32_t* out, const float filter[5]){
+        for (size_t x = 0; x < width; x += 4){
+            if (x < 2 || x + 6 > width){
+                smooth5_row_padded(width, in, out, x, filter);
+                continue;
+            }
+            Smooth5Rgb32_x64_SSE41 sums;
+            for (size_t i = 0; i < 5; i++){
+                sums.add(in + x + i - 2, filter[i]);
+            }
+            sums.store(out + x);
+        }
+    }
+    static void smooth5_column_row(size_t width, const uint32_t* const rows[5], uint32_t* out, const float filter[5]){
+        size_t x = 0;
+        for (; x + 4 <= width; x += 4){
+            Smooth5Rgb32_x64_SSE41 sums;
+            for (size_t i = 0; i < 5; i++){
+                if (rows[i] != nullptr){
+                    sums.add(rows[i] + x, filter[i]);
+                }
+            }
+            sums.store(out + x);
+        }
+        if (x < width){
+            smooth5_column_row_padded(width, rows, out, x, filter);
+        }
+    }
+
+    //  Blocks that touch the edge of the image. Pixels outside it are zero
+    //  which is transparent.
+    static void smooth5_row_padded(size_t width, const uint32_t* in, uint32_t* out, size_t x, const float filter[5]){
+        uint32_t padded[8] = {};
+        for (size_t c = 0; c < 8; c++){
+            if (x + c >= 2 && x + c < width + 2){
+                padded[c] = in[x + c - 2];
+            }
+        }
+        Smooth5Rgb32_x64_SSE41 sums;
+        for (size_t i = 0; i < 5; i++){
+            sums.add(padded + i, filter[i]);
+        }
+        uint32_t block[4];
+        sums.store(block);
+        memcpy(out + x, block, std::min<size_t>(width - x, 4) * sizeof(uint32_t));
+    }
+    static void smooth5_column_row_padded(size_t width, const uint32_t* const rows[5], uint32_t* out, size_t x, const float filter[5]){
+        size_t count = std::min<size_t>(width - x, 4);
+        Smooth5Rgb32_x64_SSE41 sums;
+        for (size_t i = 0; i < 5; i++){
+            if (rows[i] == nullptr){
+                continue;
+            }
+            uint32_t padded[4] = {};
+            memcpy(padded, rows[i] + x, count * sizeof(uint32_t));
+            sums.add(padded, filter[i]);
+        }
+        uint32_t block[4];
+        sums.store(block);
+        memcpy(out + x, block, count * sizeof(uint32_t));
+    }
+
+    static void sobel_prepare_row(size_t width, const uint32_t* in, int16_t* sums, int16_t* opaque){
+        const __m128i channels = _mm_set1_epi32(0x00010101);
+        const __m128i ones = _mm_set1_epi16(1);
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8){
+            __m128i p0 = _mm_loadu_si128((const __m128i*)(in + x));
+            __m128i p1 = _mm_loadu_si128((const __m128i*)(in + x + 4));
+            __m128i s0 = _mm_madd_epi16(_mm_maddubs_epi16(p0, channels), ones);
+            __m128i s1 = _mm_madd_epi16(_mm_maddubs_epi16(p1, channels), ones);
+            __m128i a = _mm_packs_epi32(_mm_srai_epi32(p0, 31), _mm_srai_epi32(p1, 31));
+            _mm_storeu_si128((__m128i*)(sums + x), _mm_packs_epi32(s0, s1));
+            _mm_storeu_si128((__m128i*)(opaque + x), a);
+        }
+        sobel_prepare_row_Default(x, width, in, sums, opaque);
+    }
+    static void sobel_gradient_row(
+        size_t out_width,
+        const int16_t* const sums[3], const int16_t* const opaque[3],
+        int16_t* gx, int16_t* gy, uint8_t* valid
+    ){
+        size_t x = 0;
+        for (; x + 8 <= out_width; x += 8){
+            __m128i mask = _mm_set1_epi16(-1);
+            __m128i l[3];
+            __m128i c[3];
+            __m128i r[3];
+            for (size_t row = 0; row < 3; row++){
+                l[row] = _mm_loadu_si128((const __m128i*)(sums[row] + x));
+                c[row] = _mm_loadu_si128((const __m128i*)(sums[row] + x + 1));
+                r[row] = _mm_loadu_si128((const __m128i*)(sums[row] + x + 2));
+                mask = _mm_and_si128(mask, _mm_loadu_si128((const __m128i*)(opaque[row] + x)));
+                mask = _mm_and_si128(mask, _mm_loadu_si128((const __m128i*)(opaque[row] + x + 1)));
+                mask = _mm_and_si128(mask, _mm_loadu_si128((const __m128i*)(opaque[row] + x + 2)));
+            }
+            __m128i x_gradient = _mm_add_epi16(
+                _mm_add_epi16(_mm_sub_epi16(r[0], l[0]), _mm_sub_epi16(r[2], l[2])),
+                _mm_slli_epi16(_mm_sub_epi16(r[1], l[1]), 1)
+            );
+            __m128i top = _mm_add_epi16(_mm_add_epi16(l[0], r[0]), _mm_slli_epi16(c[0], 1));
+            __m128i bottom = _mm_add_epi16(_mm_add_epi16(l[2], r[2]), _mm_slli_epi16(c[2], 1));
+            __m128i y_gradient = _mm_sub_epi16(top, bottom);
+
+            _mm_storeu_si128((__m128i*)(gx + x), _mm_and_si128(x_gradient, mask));
+            _mm_storeu_si128((__m128i*)(gy + x), _mm_and_si128(y_gradient, mask));
+            __m128i flags = _mm_and_si128(_mm_packs_epi16(mask, mask), _mm_set1_epi8(1));
+            _mm_storel_epi64((__m128i*)(valid + x), flags);
+        }
+        sobel_gradient_row_Default(x, out_width, sums, opaque, gx, gy, valid);
+    }
+};
+
+
+
+void smooth5_rgb32_rows_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_rows<ImageGradientContext_x64_SSE41>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void smooth5_rgb32_columns_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* in, size_t in_bytes_per_row,
+    uint32_t* out, size_t out_bytes_per_row,
+    const float filter[5]
+){
+    run_smooth5_rgb32_columns<ImageGradientContext_x64_SSE41>(
+        width, height, in, in_bytes_per_row, out, out_bytes_per_row, filter
+    );
+}
+void sobel_gradient_rgb32_x64_SSE41(
+    size_t width, size_t height,
+    const uint32_t* image, size_t bytes_per_row,
+    int16_t* gx, int16_t* gy, uint8_t* valid, size_t output_stride
+){
+    run_sobel_gradient_rgb32<ImageGradientContext_x64_SSE41>(
+        width, height, image, bytes_per_row, gx, gy, valid, output_stride
+    );
+}
+
+
+
+}
+}
+#endif
@@ -0,0 +1,107 @@
+/*  Scaled Deviation Sums
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Kernels_ImageScaledDeviation.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_Default(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_deviation_sums_x64_SSE41(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template <SumSquareMode mode>
+void scaled_deviation_sums_x64_AVX2(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+#ifdef PA_AutoDispatch_x64_13_Haswell
+    if (CPU_CAPABILITY_CURRENT.OK_13_Haswell){
+        scaled_deviation_sums_x64_AVX2<mode>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+#endif
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+    if (CPU_CAPABILITY_CURRENT.OK_08_Nehalem){
+        scaled_deviation_sums_x64_SSE41<mode>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+#endif
+    scaled_deviation_sums_Default<mode>(
+        sums, width, height,
+        ref, ref_bytes_per_line,
+        img, img_bytes_per_line
+    );
+}
+
+
+void scaled_deviation_sums(
+    ScaledDeviationSums& sums, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    switch (mode){
+    case SumSquareMode::REFERENCE_ALPHA:
+        scaled_deviation_sums<SumSquareMode::REFERENCE_ALPHA>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    case SumSquareMode::USE_BACKGROUND:
+        scaled_deviation_sums<SumSquareMode::USE_BACKGROUND>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    case SumSquareMode::ARBITRATE_ALPHAS:
+        scaled_deviation_sums<SumSquareMode::ARBITRATE_ALPHAS>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+}
+
+
+
+}
+}
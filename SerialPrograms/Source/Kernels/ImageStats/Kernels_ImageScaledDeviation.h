@@ -0,0 +1,72 @@
+/*  Scaled Deviation Sums
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Per-channel sums that let the sum of squares of deviation between
+ *  "ref * scale" and "img" be evaluated for any per-channel "scale" without
+ *  building the scaled reference:
+ *
+ *      sum((s*r - i)^2) = s^2 * sqr_r - 2 * s * cross + sqr_i
+ *
+ */
+
+#ifndef PokemonAutomation_Kernels_ImageScaledDeviation_H
+#define PokemonAutomation_Kernels_ImageScaledDeviation_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "Kernels_ImagePixelSumSqrDev.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledDeviationChannel{
+    //  Sum of "img" over pixels where "ref" has alpha.
+    uint64_t sum_i = 0;
+
+    //  Over the compared pixels. (see below)
+    uint64_t sqr_i = 0;
+    uint64_t cross = 0;     //  Sum of "ref * img".
+    uint64_t sqr_r = 0;
+
+    //  Sum and sum of squares of "img" over pixels where "ref" has no alpha.
+    //  Only filled in for SumSquareMode::USE_BACKGROUND.
+    uint64_t bg_sum_i = 0;
+    uint64_t bg_sqr_i = 0;
+};
+
+struct ScaledDeviationSums{
+    //  # of pixels where "ref" has alpha.
+    uint64_t count = 0;
+
+    //  # of pixels where both "ref" and "img" have alpha.
+    uint64_t opaque = 0;
+
+    //  # of pixels where exactly one of "ref" and "img" has alpha.
+    //  Only filled in for SumSquareMode::ARBITRATE_ALPHAS.
+    uint64_t disagree = 0;
+
+    ScaledDeviationChannel r;
+    ScaledDeviationChannel g;
+    ScaledDeviationChannel b;
+};
+
+
+//
+//  Accumulate the sums for "ref" vs. "img" into "sums".
+//
+//  The compared pixels are the ones where "ref" has alpha. For
+//  SumSquareMode::ARBITRATE_ALPHAS, they are the ones where both have alpha.
+//
+void scaled_deviation_sums(
+    ScaledDeviationSums& sums, SumSquareMode mode,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+}
+}
+#endif
@@ -0,0 +1,141 @@
+/*  Scaled Deviation Sums (Default)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <stdint.h>
+#include "Common/Compiler.h"
+#include "Common/Cpp/Exceptions.h"
+#include "Kernels_ImageScaledDeviation.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+struct ScaledDeviationChannel_Default{
+    uint32_t sum_i = 0;
+    uint32_t sqr_i = 0;
+    uint32_t cross = 0;
+    uint32_t sqr_r = 0;
+    uint32_t bg_sum_i = 0;
+    uint32_t bg_sqr_i = 0;
+
+    template <SumSquareMode mode>
+    PA_FORCE_INLINE void accumulate(
+        uint32_t r, uint32_t i,
+        uint32_t alphaR, uint32_t match
+    ){
+        uint32_t ri = i & alphaR;
+        sum_i += ri;
+
+        uint32_t mr = r & match;
+        uint32_t mi = i & match;
+        sqr_i += mi * mi;
+        cross += mr * mi;
+        sqr_r += mr * mr;
+
+        if (mode == SumSquareMode::USE_BACKGROUND){
+            uint32_t bi = i & ~alphaR;
+            bg_sum_i += bi;
+            bg_sqr_i += bi * bi;
+        }
+    }
+    void flush(ScaledDeviationChannel& sums) const{
+        sums.sum_i += sum_i;
+        sums.sqr_i += sqr_i;
+        sums.cross += cross;
+        sums.sqr_r += sqr_r;
+        sums.bg_sum_i += bg_sum_i;
+        sums.bg_sqr_i += bg_sqr_i;
+    }
+};
+
+
+template <SumSquareMode mode>
+PA_FORCE_INLINE void scaled_deviation_sums_Default(
+    ScaledDeviationSums& sums,
+    uint16_t width,
+    const uint32_t* ref, const uint32_t* img
+){
+    uint32_t count = 0;
+    uint32_t opaque = 0;
+    uint32_t disagree = 0;
+    ScaledDeviationChannel_Default r;
+    ScaledDeviationChannel_Default g;
+    ScaledDeviationChannel_Default b;
+
+    for (size_t c = 0; c < width; c++){
+        uint32_t pr = ref[c];
+        uint32_t pi = img[c];
+
+        uint32_t alphaR = (int32_t)pr >> 31;
+        uint32_t alphaI = (int32_t)pi >> 31;
+        uint32_t match = mode == SumSquareMode::ARBITRATE_ALPHAS
+            ? alphaR & alphaI
+            : alphaR;
+
+        count -= alphaR;
+        opaque -= alphaR & alphaI;
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            disagree -= alphaR ^ alphaI;
+        }
+
+        r.accumulate<mode>((pr >> 16) & 0xff, (pi >> 16) & 0xff, alphaR, match);
+        g.accumulate<mode>((pr >>  8) & 0xff, (pi >>  8) & 0xff, alphaR, match);
+        b.accumulate<mode>((pr >>  0) & 0xff, (pi >>  0) & 0xff, alphaR, match);
+    }
+
+    sums.count += count;
+    sums.opaque += opaque;
+    sums.disagree += disagree;
+    r.flush(sums.r);
+    g.flush(sums.g);
+    b.flush(sums.b);
+}
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_Default(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    if (width > 22017){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Width limit exceeded: " + std::to_string(width));
+    }
+    for (size_t r = 0; r < height; r++){
+        scaled_deviation_sums_Default<mode>(sums, (uint16_t)width, ref, img);
+        ref = (const uint32_t*)((const char*)ref + ref_bytes_per_line);
+        img = (const uint32_t*)((const char*)img + img_bytes_per_line);
+    }
+}
+
+
+template
+void scaled_deviation_sums_Default<SumSquareMode::REFERENCE_ALPHA>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_Default<SumSquareMode::USE_BACKGROUND>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_Default<SumSquareMode::ARBITRATE_ALPHAS>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+
+}
+}
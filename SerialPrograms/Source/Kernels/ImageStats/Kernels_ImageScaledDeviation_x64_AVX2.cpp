@@ -0,0 +1,207 @@
+/*  Scaled Deviation Sums (x64 AVX2)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_13_Haswell
+
+#include <immintrin.h>
+#include "Common/Cpp/Exceptions.h"
+#include "Kernels/Kernels_x64_AVX2.h"
+#include "Kernels_ImageScaledDeviation.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_Default(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+//  Move one channel of each pixel into the bottom of its 32-bit lane.
+template <int channel>
+PA_FORCE_INLINE __m256i scaled_deviation_extract_x64_AVX2(__m256i x){
+    if (channel == 0){
+        return _mm256_and_si256(x, _mm256_set1_epi32(0x000000ff));
+    }
+    return _mm256_shuffle_epi8(x, _mm256_setr_epi8(
+        channel +  0, -1, -1, -1, channel +  4, -1, -1, -1,
+        channel +  8, -1, -1, -1, channel + 12, -1, -1, -1,
+        channel +  0, -1, -1, -1, channel +  4, -1, -1, -1,
+        channel +  8, -1, -1, -1, channel + 12, -1, -1, -1
+    ));
+}
+
+
+//  32-bit lanes are enough for one row. (255^2 * 22017 / 4 < 2^31 after the halves are added)
+struct ScaledDeviationChannel_x64_AVX2{
+    __m256i sum_i = _mm256_setzero_si256();
+    __m256i sqr_i = _mm256_setzero_si256();
+    __m256i cross = _mm256_setzero_si256();
+    __m256i sqr_r = _mm256_setzero_si256();
+    __m256i bg_sum_i = _mm256_setzero_si256();
+    __m256i bg_sqr_i = _mm256_setzero_si256();
+
+    template <SumSquareMode mode, int channel>
+    PA_FORCE_INLINE void accumulate(__m256i ri, __m256i mr, __m256i mi, __m256i bi){
+        ri = scaled_deviation_extract_x64_AVX2<channel>(ri);
+        mr = scaled_deviation_extract_x64_AVX2<channel>(mr);
+        mi = scaled_deviation_extract_x64_AVX2<channel>(mi);
+
+        sum_i = _mm256_add_epi32(sum_i, ri);
+        sqr_i = _mm256_add_epi32(sqr_i, _mm256_madd_epi16(mi, mi));
+        cross = _mm256_add_epi32(cross, _mm256_madd_epi16(mr, mi));
+        sqr_r = _mm256_add_epi32(sqr_r, _mm256_madd_epi16(mr, mr));
+
+        if (mode == SumSquareMode::USE_BACKGROUND){
+            bi = scaled_deviation_extract_x64_AVX2<channel>(bi);
+            bg_sum_i = _mm256_add_epi32(bg_sum_i, bi);
+            bg_sqr_i = _mm256_add_epi32(bg_sqr_i, _mm256_madd_epi16(bi, bi));
+        }
+    }
+    void flush(ScaledDeviationChannel& sums) const{
+        sums.sum_i += reduce_add32_x64_AVX2(sum_i);
+        sums.sqr_i += reduce_add32_x64_AVX2(sqr_i);
+        sums.cross += reduce_add32_x64_AVX2(cross);
+        sums.sqr_r += reduce_add32_x64_AVX2(sqr_r);
+        sums.bg_sum_i += reduce_add32_x64_AVX2(bg_sum_i);
+        sums.bg_sqr_i += reduce_add32_x64_AVX2(bg_sqr_i);
+    }
+};
+
+
+template <SumSquareMode mode>
+struct ScaledDeviationRow_x64_AVX2{
+    __m256i count = _mm256_setzero_si256();
+    __m256i opaque = _mm256_setzero_si256();
+    __m256i disagree = _mm256_setzero_si256();
+    ScaledDeviationChannel_x64_AVX2 r;
+    ScaledDeviationChannel_x64_AVX2 g;
+    ScaledDeviationChannel_x64_AVX2 b;
+
+    PA_FORCE_INLINE void accumulate(__m256i pr, __m256i pi){
+        __m256i alphaR = _mm256_srai_epi32(pr, 31);
+        __m256i alphaI = _mm256_srai_epi32(pi, 31);
+        __m256i both = _mm256_and_si256(alphaR, alphaI);
+        __m256i match = mode == SumSquareMode::ARBITRATE_ALPHAS ? both : alphaR;
+
+        count = _mm256_sub_epi32(count, alphaR);
+        opaque = _mm256_sub_epi32(opaque, both);
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            disagree = _mm256_sub_epi32(disagree, _mm256_xor_si256(alphaR, alphaI));
+        }
+
+        __m256i ri = _mm256_and_si256(pi, alphaR);
+        __m256i mr = _mm256_and_si256(pr, match);
+        __m256i mi = _mm256_and_si256(pi, match);
+        __m256i bi = _mm256_andnot_si256(alphaR, pi);
+
+        r.template accumulate<mode, 2>(ri, mr, mi, bi);
+        g.template accumulate<mode, 1>(ri, mr, mi, bi);
+        b.template accumulate<mode, 0>(ri, mr, mi, bi);
+    }
+    void flush(ScaledDeviationSums& sums) const{
+        sums.count += reduce_add32_x64_AVX2(count);
+        sums.opaque += reduce_add32_x64_AVX2(opaque);
+        sums.disagree += reduce_add32_x64_AVX2(disagree);
+        r.flush(sums.r);
+        g.flush(sums.g);
+        b.flush(sums.b);
+    }
+};
+
+
+template <SumSquareMode mode>
+PA_FORCE_INLINE void scaled_deviation_sums_x64_AVX2(
+    ScaledDeviationSums& sums,
+    uint16_t width,
+    const uint32_t* ref, const uint32_t* img
+){
+    ScaledDeviationRow_x64_AVX2<mode> row;
+
+    const __m256i* ptrR = (const __m256i*)ref;
+    const __m256i* ptrI = (const __m256i*)img;
+
+    size_t lc = width / 8;
+    do{
+        row.accumulate(_mm256_loadu_si256(ptrR), _mm256_loadu_si256(ptrI));
+        ptrR++;
+        ptrI++;
+    }while (--lc);
+
+    if (width % 8){
+        //  Masked-off pixels load as zero which has no alpha and adds nothing.
+        __m256i mask = _mm256_cmpgt_epi32(
+            _mm256_set1_epi32(width % 8),
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+        );
+        __m256i r = _mm256_maskload_epi32((const int*)ptrR, mask);
+        __m256i i = _mm256_maskload_epi32((const int*)ptrI, mask);
+        row.accumulate(r, i);
+    }
+
+    row.flush(sums);
+}
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_x64_AVX2(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    if (width < 8){
+        scaled_deviation_sums_Default<mode>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+    if (width > 22017){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Width limit exceeded: " + std::to_string(width));
+    }
+    for (size_t r = 0; r < height; r++){
+        scaled_deviation_sums_x64_AVX2<mode>(sums, (uint16_t)width, ref, img);
+        ref = (const uint32_t*)((const char*)ref + ref_bytes_per_line);
+        img = (const uint32_t*)((const char*)img + img_bytes_per_line);
+    }
+}
+
+
+template
+void scaled_deviation_sums_x64_AVX2<SumSquareMode::REFERENCE_ALPHA>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_x64_AVX2<SumSquareMode::USE_BACKGROUND>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_x64_AVX2<SumSquareMode::ARBITRATE_ALPHAS>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+
+}
+}
+#endif
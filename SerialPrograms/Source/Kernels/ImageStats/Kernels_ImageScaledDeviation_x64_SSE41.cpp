@@ -0,0 +1,208 @@
+/*  Scaled Deviation Sums (x64 SSE4.1)
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifdef PA_AutoDispatch_x64_08_Nehalem
+
+#include <smmintrin.h>
+#include "Common/Cpp/Exceptions.h"
+#include "Kernels/Kernels_x64_SSE41.h"
+#include "Kernels_ImageScaledDeviation.h"
+
+namespace PokemonAutomation{
+namespace Kernels{
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_Default(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+//  Move one channel of each pixel into the bottom of its 32-bit lane.
+template <int channel>
+PA_FORCE_INLINE __m128i scaled_deviation_extract_x64_SSE41(__m128i x){
+    if (channel == 0){
+        return _mm_and_si128(x, _mm_set1_epi32(0x000000ff));
+    }
+    return _mm_shuffle_epi8(x, _mm_setr_epi8(
+        channel +  0, -1, -1, -1, channel +  4, -1, -1, -1,
+        channel +  8, -1, -1, -1, channel + 12, -1, -1, -1
+    ));
+}
+
+
+//  32-bit lanes are enough for one row. (255^2 * 22017 / 4 < 2^31)
+struct ScaledDeviationChannel_x64_SSE41{
+    __m128i sum_i = _mm_setzero_si128();
+    __m128i sqr_i = _mm_setzero_si128();
+    __m128i cross = _mm_setzero_si128();
+    __m128i sqr_r = _mm_setzero_si128();
+    __m128i bg_sum_i = _mm_setzero_si128();
+    __m128i bg_sqr_i = _mm_setzero_si128();
+
+    template <SumSquareMode mode, int channel>
+    PA_FORCE_INLINE void accumulate(__m128i ri, __m128i mr, __m128i mi, __m128i bi){
+        ri = scaled_deviation_extract_x64_SSE41<channel>(ri);
+        mr = scaled_deviation_extract_x64_SSE41<channel>(mr);
+        mi = scaled_deviation_extract_x64_SSE41<channel>(mi);
+
+        sum_i = _mm_add_epi32(sum_i, ri);
+        sqr_i = _mm_add_epi32(sqr_i, _mm_madd_epi16(mi, mi));
+        cross = _mm_add_epi32(cross, _mm_madd_epi16(mr, mi));
+        sqr_r = _mm_add_epi32(sqr_r, _mm_madd_epi16(mr, mr));
+
+        if (mode == SumSquareMode::USE_BACKGROUND){
+            bi = scaled_deviation_extract_x64_SSE41<channel>(bi);
+            bg_sum_i = _mm_add_epi32(bg_sum_i, bi);
+            bg_sqr_i = _mm_add_epi32(bg_sqr_i, _mm_madd_epi16(bi, bi));
+        }
+    }
+    void flush(ScaledDeviationChannel& sums) const{
+        sums.sum_i += reduce32_x64_SSE41(sum_i);
+        sums.sqr_i += reduce32_x64_SSE41(sqr_i);
+        sums.cross += reduce32_x64_SSE41(cross);
+        sums.sqr_r += reduce32_x64_SSE41(sqr_r);
+        sums.bg_sum_i += reduce32_x64_SSE41(bg_sum_i);
+        sums.bg_sqr_i += reduce32_x64_SSE41(bg_sqr_i);
+    }
+};
+
+
+template <SumSquareMode mode>
+struct ScaledDeviationRow_x64_SSE41{
+    __m128i count = _mm_setzero_si128();
+    __m128i opaque = _mm_setzero_si128();
+    __m128i disagree = _mm_setzero_si128();
+    ScaledDeviationChannel_x64_SSE41 r;
+    ScaledDeviationChannel_x64_SSE41 g;
+    ScaledDeviationChannel_x64_SSE41 b;
+
+    PA_FORCE_INLINE void accumulate(__m128i pr, __m128i pi){
+        __m128i alphaR = _mm_srai_epi32(pr, 31);
+        __m128i alphaI = _mm_srai_epi32(pi, 31);
+        __m128i both = _mm_and_si128(alphaR, alphaI);
+        __m128i match = mode == SumSquareMode::ARBITRATE_ALPHAS ? both : alphaR;
+
+        count = _mm_sub_epi32(count, alphaR);
+        opaque = _mm_sub_epi32(opaque, both);
+        if (mode == SumSquareMode::ARBITRATE_ALPHAS){
+            disagree = _mm_sub_epi32(disagree, _mm_xor_si128(alphaR, alphaI));
+        }
+
+        __m128i ri = _mm_and_si128(pi, alphaR);
+        __m128i mr = _mm_and_si128(pr, match);
+        __m128i mi = _mm_and_si128(pi, match);
+        __m128i bi = _mm_andnot_si128(alphaR, pi);
+
+        r.template accumulate<mode, 2>(ri, mr, mi, bi);
+        g.template accumulate<mode, 1>(ri, mr, mi, bi);
+        b.template accumulate<mode, 0>(ri, mr, mi, bi);
+    }
+    void flush(ScaledDeviationSums& sums) const{
+        sums.count += reduce32_x64_SSE41(count);
+        sums.opaque += reduce32_x64_SSE41(opaque);
+        sums.disagree += reduce32_x64_SSE41(disagree);
+        r.flush(sums.r);
+        g.flush(sums.g);
+        b.flush(sums.b);
+    }
+};
+
+
+template <SumSquareMode mode>
+PA_FORCE_INLINE void scaled_deviation_sums_x64_SSE41(
+    ScaledDeviationSums& sums,
+    uint16_t width,
+    const uint32_t* ref, const uint32_t* img
+){
+    ScaledDeviationRow_x64_SSE41<mode> row;
+
+    const __m128i* ptrR = (const __m128i*)ref;
+    const __m128i* ptrI = (const __m128i*)img;
+
+    size_t lc = width / 4;
+    do{
+        row.accumulate(_mm_loadu_si128(ptrR), _mm_loadu_si128(ptrI));
+        ptrR++;
+        ptrI++;
+    }while (--lc);
+
+    if (width % 4){
+        __m128i r = _mm_loadu_si128((const __m128i*)(ref + width - 4));
+        __m128i i = _mm_loadu_si128((const __m128i*)(img + width - 4));
+
+        //  Keep only the pixels that haven't been seen yet. The rest become
+        //  zero which has no alpha and adds nothing.
+        uint8_t shift = (uint8_t)(ref + width - (const uint32_t*)ptrR);
+
+        __m128i s = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        s = _mm_add_epi8(s, _mm_set1_epi8(128 - 4*shift));
+
+        row.accumulate(_mm_shuffle_epi8(r, s), _mm_shuffle_epi8(i, s));
+    }
+
+    row.flush(sums);
+}
+
+
+template <SumSquareMode mode>
+void scaled_deviation_sums_x64_SSE41(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+){
+    if (width < 4){
+        scaled_deviation_sums_Default<mode>(
+            sums, width, height,
+            ref, ref_bytes_per_line,
+            img, img_bytes_per_line
+        );
+        return;
+    }
+    if (width > 22017){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Width limit exceeded: " + std::to_string(width));
+    }
+    for (size_t r = 0; r < height; r++){
+        scaled_deviation_sums_x64_SSE41<mode>(sums, (uint16_t)width, ref, img);
+        ref = (const uint32_t*)((const char*)ref + ref_bytes_per_line);
+        img = (const uint32_t*)((const char*)img + img_bytes_per_line);
+    }
+}
+
+
+template
+void scaled_deviation_sums_x64_SSE41<SumSquareMode::REFERENCE_ALPHA>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_x64_SSE41<SumSquareMode::USE_BACKGROUND>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+template
+void scaled_deviation_sums_x64_SSE41<SumSquareMode::ARBITRATE_ALPHAS>(
+    ScaledDeviationSums& sums,
+    size_t width, size_t height,
+    const uint32_t* ref, size_t ref_bytes_per_line,
+    const uint32_t* img, size_t img_bytes_per_line
+);
+
+
+
+
+}
+}
+#endif
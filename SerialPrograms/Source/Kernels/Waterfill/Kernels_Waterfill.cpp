@@ -4,6 +4,7 @@
  *
  */
 
+#include <atomic>
 #include "Common/Cpp/Exceptions.h"
 #include "Common/Cpp/CpuId/CpuId.h"
 #include "Kernels_Waterfill.h"
@@ -18,6 +19,27 @@ namespace Kernels{
 namespace Waterfill{
 
 
+namespace{
+
+std::atomic<bool> allow_AVX512GF(true);
+
+}
+
+bool AVX512GF_available(){
+#ifdef PA_ARCH_x86
+    return CPU_CAPABILITY_CURRENT.OK_19_IceLake;
+#else
+    return false;
+#endif
+}
+bool use_AVX512GF(){
+    return allow_AVX512GF.load(std::memory_order_relaxed) && AVX512GF_available();
+}
+void set_allow_AVX512GF(bool allowed){
+    allow_AVX512GF.store(allowed, std::memory_order_relaxed);
+}
+
+
 
 std::vector<WaterfillObject> find_objects_inplace_64x4_Default      (PackedBinaryMatrix_IB& matrix, size_t min_area);
 std::vector<WaterfillObject> find_objects_inplace_64x8_Default      (PackedBinaryMatrix_IB& matrix, size_t min_area);
@@ -37,13 +59,13 @@ std::vector<WaterfillObject> find_objects_inplace(PackedBinaryMatrix_IB& matrix,
 #ifdef PA_ARCH_x86
 #ifdef PA_AutoDispatch_x64_17_Skylake
     case BinaryMatrixType::i64x64_x64_AVX512:
-        if (CPU_CAPABILITY_CURRENT.OK_19_IceLake){
+        if (use_AVX512GF()){
             return find_objects_inplace_64x64_x64_AVX512GF(matrix, min_area);
         }else{
             return find_objects_inplace_64x64_x64_AVX512(matrix, min_area);
         }
     case BinaryMatrixType::i64x32_x64_AVX512:
-        if (CPU_CAPABILITY_CURRENT.OK_19_IceLake){
+        if (use_AVX512GF()){
             return find_objects_inplace_64x32_x64_AVX512GF(matrix, min_area);
         }else{
             return find_objects_inplace_64x32_x64_AVX512(matrix, min_area);
@@ -21,6 +21,15 @@ namespace Waterfill{
 std::vector<WaterfillObject> find_objects_inplace(PackedBinaryMatrix_IB& matrix, size_t min_area);
 
 
+//  Whether the AVX512 matrix types can use the AVX512-GF cores on this CPU.
+bool AVX512GF_available();
+
+//  Whether the AVX512 matrix types will use the AVX512-GF cores.
+//  This is AVX512GF_available() unless the calibration turned it off.
+bool use_AVX512GF();
+void set_allow_AVX512GF(bool allowed);
+
+
 
 
 }
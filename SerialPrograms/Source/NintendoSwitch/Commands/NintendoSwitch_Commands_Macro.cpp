@@ -0,0 +1,272 @@
+/*  Controller Macros
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <algorithm>
+#include <sstream>
+#include "Common/CRC32.h"
+#include "Common/Cpp/Exceptions.h"
+#include "ClientSource/Connection/BotBase.h"
+#include "ClientSource/Libraries/MessageConverter.h"
+#include "NintendoSwitch_Commands_Macro.h"
+#include "NintendoSwitch_Messages_Macro.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+void ControllerMacro::add_press(
+    Op op, uint16_t value, uint8_t x, uint8_t y,
+    uint16_t delay, uint16_t hold, uint8_t cool
+){
+    if (hold > 255){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Macro hold is limited to 255 ticks: " + std::to_string(hold));
+    }
+    m_steps.emplace_back(Step{op, value, x, y, delay, (uint8_t)hold, cool});
+}
+void ControllerMacro::press_button(Button button, uint16_t delay, uint16_t hold, uint8_t cool){
+    add_press(Op::PRESS_BUTTON, button, 0, 0, delay, hold, cool);
+}
+void ControllerMacro::press_dpad(DpadPosition position, uint16_t delay, uint16_t hold, uint8_t cool){
+    if (position >= DPAD_NONE){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid dpad position: " + std::to_string(position));
+    }
+    add_press(Op::PRESS_DPAD, position, 0, 0, delay, hold, cool);
+}
+void ControllerMacro::press_joystick(
+    bool left,
+    uint8_t x, uint8_t y,
+    uint16_t delay, uint16_t hold, uint8_t cool
+){
+    add_press(left ? Op::PRESS_JOYSTICK_L : Op::PRESS_JOYSTICK_R, 0, x, y, delay, hold, cool);
+}
+void ControllerMacro::issue_scroll(ssf_ScrollDirection direction, uint16_t delay, uint16_t hold, uint8_t cool){
+    if (direction >= DPAD_NONE){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Invalid scroll direction: " + std::to_string(direction));
+    }
+    add_press(Op::SCROLL, direction, 0, 0, delay, hold, cool);
+}
+void ControllerMacro::do_nothing(uint16_t ticks){
+    m_steps.emplace_back(Step{Op::WAIT, ticks, 0, 0, 0, 0, 0});
+}
+
+
+
+void ControllerMacro::encode_press(
+    std::string& program, Registers& registers,
+    uint8_t opcode, const uint8_t* operands, size_t operand_bytes,
+    uint8_t delay, uint8_t hold, uint8_t cool
+){
+    if (registers.hold != hold || registers.cool != cool){
+        program += (char)PABB_MACRO_OP_SET_TIMING;
+        program += (char)delay;
+        program += (char)hold;
+        program += (char)cool;
+        registers.delay = delay;
+        registers.hold = hold;
+        registers.cool = cool;
+    }else if (registers.delay != delay){
+        program += (char)PABB_MACRO_OP_SET_DELAY;
+        program += (char)delay;
+        registers.delay = delay;
+    }
+    program += (char)opcode;
+    if (operand_bytes > 0){
+        program.append((const char*)operands, operand_bytes);
+    }
+}
+void ControllerMacro::encode(std::string& program, Registers& registers, const Step& step){
+    auto encode_wait = [&](uint16_t ticks){
+        program += (char)PABB_MACRO_OP_WAIT;
+        program += (char)(ticks & 0xff);
+        program += (char)(ticks >> 8);
+    };
+
+    if (step.op == Op::WAIT){
+        encode_wait(step.value);
+        return;
+    }
+
+    //  The delay register is 8 bits. A longer delay is the same as no delay
+    //  followed by doing nothing.
+    uint8_t delay = step.delay <= 255 ? (uint8_t)step.delay : 0;
+
+    uint8_t operands[2] = {step.x, step.y};
+    switch (step.op){
+    case Op::SCROLL:
+        encode_press(program, registers, (uint8_t)(PABB_MACRO_OP_SCROLL | step.value), nullptr, 0, delay, step.hold, step.cool);
+        break;
+    case Op::PRESS_DPAD:
+        encode_press(program, registers, (uint8_t)(PABB_MACRO_OP_PRESS_DPAD | step.value), nullptr, 0, delay, step.hold, step.cool);
+        break;
+    case Op::PRESS_BUTTON:{
+        //  Pressing no buttons still takes the delay.
+        if (step.value == 0){
+            if (step.delay > 0){
+                encode_wait(step.delay);
+            }
+            return;
+        }
+
+        //  One instruction per button. All but the last start together.
+        uint16_t remaining = step.value;
+        for (uint8_t bit = 0; bit < 16; bit++){
+            uint16_t mask = (uint16_t)1 << bit;
+            if ((remaining & mask) == 0){
+                continue;
+            }
+            remaining &= ~mask;
+            encode_press(
+                program, registers,
+                (uint8_t)(PABB_MACRO_OP_PRESS_BUTTON | bit), nullptr, 0,
+                remaining == 0 ? delay : 0, step.hold, step.cool
+            );
+        }
+        break;
+    }
+    case Op::PRESS_JOYSTICK_L:
+        encode_press(program, registers, PABB_MACRO_OP_PRESS_JOYSTICK_L, operands, 2, delay, step.hold, step.cool);
+        break;
+    case Op::PRESS_JOYSTICK_R:
+        encode_press(program, registers, PABB_MACRO_OP_PRESS_JOYSTICK_R, operands, 2, delay, step.hold, step.cool);
+        break;
+    case Op::WAIT:
+        break;
+    }
+
+    if (step.delay > 255){
+        encode_wait(step.delay);
+    }
+}
+
+std::vector<std::string> ControllerMacro::compile(size_t max_bytes) const{
+    std::vector<std::string> programs;
+    std::string program;
+    Registers registers;
+    for (const Step& step : m_steps){
+        std::string instruction;
+        Registers after = registers;
+        encode(instruction, after, step);
+        if (program.size() + instruction.size() <= max_bytes){
+            program += instruction;
+            registers = after;
+            continue;
+        }
+
+        //  Doesn't fit. Start a new program with fresh registers.
+        if (!program.empty()){
+            programs.emplace_back(std::move(program));
+            program.clear();
+        }
+        registers = Registers();
+        encode(program, registers, step);
+        if (program.size() > max_bytes){
+            throw InternalProgramError(
+                nullptr, PA_CURRENT_FUNCTION,
+                "Macro instruction does not fit in a program: " + std::to_string(program.size()) + " bytes"
+            );
+        }
+    }
+    if (!program.empty()){
+        programs.emplace_back(std::move(program));
+    }
+    return programs;
+}
+
+void ControllerMacro::run_ssf(BotBaseContext& context) const{
+    for (const Step& step : m_steps){
+        switch (step.op){
+        case Op::SCROLL:
+            ssf_issue_scroll(context, step.value, step.delay, step.hold, step.cool);
+            break;
+        case Op::PRESS_DPAD:
+            ssf_press_dpad(context, (DpadPosition)step.value, step.delay, step.hold, step.cool);
+            break;
+        case Op::PRESS_BUTTON:
+            ssf_press_button(context, step.value, step.delay, step.hold, step.cool);
+            break;
+        case Op::PRESS_JOYSTICK_L:
+            ssf_press_joystick(context, true, step.x, step.y, step.delay, step.hold, step.cool);
+            break;
+        case Op::PRESS_JOYSTICK_R:
+            ssf_press_joystick(context, false, step.x, step.y, step.delay, step.hold, step.cool);
+            break;
+        case Op::WAIT:
+            ssf_do_nothing(context, step.value);
+            break;
+        }
+    }
+}
+
+
+
+bool device_supports_macros(BotBase& botbase){
+    uint32_t version = botbase.device_protocol_version();
+    return
+        version / 100 == PABB_MACRO_PROTOCOL_VERSION / 100 &&
+        version % 100 >= PABB_MACRO_PROTOCOL_VERSION % 100;
+}
+
+void run_macro(BotBaseContext& context, const ControllerMacro& macro){
+    if (macro.empty()){
+        return;
+    }
+    if (!device_supports_macros(context.botbase())){
+        macro.run_ssf(context);
+        return;
+    }
+
+    for (const std::string& program : macro.compile()){
+        //  Don't overwrite the staging buffer while an earlier run may still
+        //  be waiting in the device's command queue.
+        context.wait_for_all_requests();
+
+        const uint8_t* data = (const uint8_t*)program.data();
+        size_t bytes = program.size();
+        for (size_t offset = 0; offset < bytes; offset += PABB_MACRO_LOAD_BYTES){
+            size_t block = std::min<size_t>(PABB_MACRO_LOAD_BYTES, bytes - offset);
+            context.issue_request(DeviceRequest_macro_load((uint8_t)offset, data + offset, block));
+        }
+        context.issue_request(DeviceRequest_macro_run((uint8_t)bytes, pabb_crc32(0xffffffff, data, bytes)));
+    }
+}
+
+
+
+int register_message_converters_switch_macro(){
+    register_message_converter(
+        PABB_MSG_REQUEST_MACRO_LOAD,
+        [](const std::string& body){
+            std::ostringstream ss;
+            ss << "macro_load() - ";
+            if (body.size() != sizeof(pabb_macro_load)){ ss << "(invalid size)" << std::endl; return ss.str(); }
+            const auto* params = (const pabb_macro_load*)body.c_str();
+            ss << "seqnum = " << (uint64_t)params->seqnum;
+            ss << ", offset = " << (unsigned)params->offset;
+            return ss.str();
+        }
+    );
+    register_message_converter(
+        PABB_MSG_COMMAND_MACRO_RUN,
+        [](const std::string& body){
+            std::ostringstream ss;
+            ss << "macro_run() - ";
+            if (body.size() != sizeof(pabb_macro_run)){ ss << "(invalid size)" << std::endl; return ss.str(); }
+            const auto* params = (const pabb_macro_run*)body.c_str();
+            ss << "seqnum = " << (uint64_t)params->seqnum;
+            ss << ", length = " << (unsigned)params->length;
+            ss << ", crc32 = " << params->crc32;
+            return ss.str();
+        }
+    );
+    return 0;
+}
+int init_SwitchMacro = register_message_converters_switch_macro();
+
+
+
+}
+}
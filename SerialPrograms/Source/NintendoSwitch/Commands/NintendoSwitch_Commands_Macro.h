@@ -0,0 +1,107 @@
+/*  Controller Macros
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Build a sequence of scalar button presses and run it on the device as
+ *  a single command. See "NintendoSwitch_Protocol_Macro.h" for the bytecode.
+ *
+ *  Devices that don't support macros get the equivalent ssf commands instead.
+ *  Either way the button timings are the same.
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_Commands_Macro_H
+#define PokemonAutomation_NintendoSwitch_Commands_Macro_H
+
+#include <string>
+#include <vector>
+#include "Common/NintendoSwitch/NintendoSwitch_ControllerDefs.h"
+#include "Common/NintendoSwitch/NintendoSwitch_Protocol_Macro.h"
+#include "ClientSource/Connection/BotBase.h"
+#include "NintendoSwitch_Commands_ScalarButtons.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+class ControllerMacro{
+public:
+    //  Same parameters as the ssf functions of the same name.
+    //  Hold times are limited to 255 ticks.
+    void press_button(Button button, uint16_t delay, uint16_t hold = 5, uint8_t cool = 3);
+    void press_dpad(DpadPosition position, uint16_t delay, uint16_t hold = 5, uint8_t cool = 3);
+    void press_joystick(
+        bool left,
+        uint8_t x, uint8_t y,
+        uint16_t delay, uint16_t hold, uint8_t cool = 0
+    );
+    void issue_scroll(ssf_ScrollDirection direction, uint16_t delay, uint16_t hold = 5, uint8_t cool = 3);
+    void do_nothing(uint16_t ticks);
+
+    bool empty() const{ return m_steps.empty(); }
+    size_t steps() const{ return m_steps.size(); }
+
+    //  Compile into one or more programs of at most "max_bytes" each.
+    //  Each program starts with the default timing registers.
+    std::vector<std::string> compile(size_t max_bytes = PABB_MACRO_BUFFER_SIZE) const;
+
+    //  Issue the equivalent ssf commands one at a time.
+    void run_ssf(BotBaseContext& context) const;
+
+
+private:
+    enum class Op : uint8_t{
+        SCROLL,
+        PRESS_DPAD,
+        PRESS_BUTTON,
+        PRESS_JOYSTICK_L,
+        PRESS_JOYSTICK_R,
+        WAIT,
+    };
+    struct Step{
+        Op op;
+        uint16_t value;     //  Button mask, dpad position, scroll direction or wait ticks.
+        uint8_t x;
+        uint8_t y;
+        uint16_t delay;
+        uint8_t hold;
+        uint8_t cool;
+    };
+    struct Registers{
+        uint8_t delay = PABB_MACRO_DEFAULT_DELAY;
+        uint8_t hold = PABB_MACRO_DEFAULT_HOLD;
+        uint8_t cool = PABB_MACRO_DEFAULT_COOL;
+    };
+
+    void add_press(Op op, uint16_t value, uint8_t x, uint8_t y, uint16_t delay, uint16_t hold, uint8_t cool);
+
+    static void encode_press(
+        std::string& program, Registers& registers,
+        uint8_t opcode, const uint8_t* operands, size_t operand_bytes,
+        uint8_t delay, uint8_t hold, uint8_t cool
+    );
+    static void encode(std::string& program, Registers& registers, const Step& step);
+
+
+private:
+    std::vector<Step> m_steps;
+};
+
+
+
+//  Whether the device has reported a protocol version that supports macros.
+bool device_supports_macros(BotBase& botbase);
+
+//  Run the macro on the device. Falls back to ssf commands if the device
+//  doesn't support macros.
+//
+//  Like all the ssf functions, this returns once the commands are queued.
+//  Since the device has a single staging buffer, a macro run first waits for
+//  all earlier commands to finish. The ssf fallback does not wait.
+void run_macro(BotBaseContext& context, const ControllerMacro& macro);
+
+
+
+}
+}
+#endif
@@ -0,0 +1,52 @@
+/*  Controller Macros
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#ifndef PokemonAutomation_NintendoSwitch_Messages_Macro_H
+#define PokemonAutomation_NintendoSwitch_Messages_Macro_H
+
+#include <string.h>
+#include "Common/NintendoSwitch/NintendoSwitch_Protocol_Macro.h"
+#include "ClientSource/Connection/BotBaseMessage.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+class DeviceRequest_macro_load : public BotBaseRequest{
+public:
+    pabb_macro_load params;
+    DeviceRequest_macro_load(uint8_t offset, const uint8_t* data, size_t bytes)
+        : BotBaseRequest(false)
+    {
+        params.seqnum = 0;
+        params.offset = offset;
+        memset(params.data, 0, sizeof(params.data));
+        memcpy(params.data, data, bytes < sizeof(params.data) ? bytes : sizeof(params.data));
+    }
+    virtual BotBaseMessage message() const override{
+        return BotBaseMessage(PABB_MSG_REQUEST_MACRO_LOAD, params);
+    }
+};
+class DeviceRequest_macro_run : public BotBaseRequest{
+public:
+    pabb_macro_run params;
+    DeviceRequest_macro_run(uint8_t length, uint32_t crc32)
+        : BotBaseRequest(true)
+    {
+        params.seqnum = 0;
+        params.length = length;
+        params.crc32 = crc32;
+    }
+    virtual BotBaseMessage message() const override{
+        return BotBaseMessage(PABB_MSG_COMMAND_MACRO_RUN, params);
+    }
+};
+
+
+
+}
+}
+#endif
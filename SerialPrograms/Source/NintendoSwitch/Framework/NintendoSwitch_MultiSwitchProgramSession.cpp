@@ -9,6 +9,7 @@
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Notifications/ProgramInfo.h"
 #include "CommonFramework/Notifications/ProgramNotifications.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "CommonFramework/Tools/BlackBorderCheck.h"
 #include "NintendoSwitch_MultiSwitchProgramOption.h"
 #include "NintendoSwitch_MultiSwitchProgramSession.h"
@@ -72,6 +73,10 @@ void MultiSwitchProgramSession::run_program_instance(const ProgramInfo& info){
         }
     }
 
+    //  Load these now so the first detection doesn't have to. This is done
+    //  before taking the lock since it can take a while.
+    preload_resources(logger(), m_option.instance().warmup_resources());
+
     //  Acquire lock here to block the session from changing the # of consoles.
     std::unique_lock<std::mutex> lg(m_lock);
 
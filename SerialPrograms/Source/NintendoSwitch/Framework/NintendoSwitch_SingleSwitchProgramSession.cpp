@@ -8,6 +8,7 @@
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "CommonFramework/Notifications/ProgramInfo.h"
 #include "CommonFramework/Notifications/ProgramNotifications.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "CommonFramework/Tools/BlackBorderCheck.h"
 #include "NintendoSwitch_SingleSwitchProgramOption.h"
 #include "NintendoSwitch_SingleSwitchProgramSession.h"
@@ -57,6 +58,9 @@ void SingleSwitchProgramSession::run_program_instance(const ProgramInfo& info){
         throw UserSetupError(m_system.logger(), "Cannot Start: Serial connection not ready.");
     }
 
+    //  Load these now so the first detection doesn't have to.
+    preload_resources(logger(), m_option.instance().warmup_resources());
+
     CancellableHolder<CancellableScope> scope;
     SingleSwitchProgramEnvironment env(
         info,
@@ -15,6 +15,7 @@
 #include "CommonFramework/AudioPipeline/UI/AudioSelectorWidget.h"
 #include "CommonFramework/AudioPipeline/UI/AudioDisplayWidget.h"
 #include "CommonFramework/ControllerDevices/SerialPortWidget.h"
+#include "CommonFramework/Tools/ErrorDumper.h"
 #include "CommonFramework/VideoPipeline/UI/CameraSelectorWidget.h"
 #include "CommonFramework/VideoPipeline/UI/VideoDisplayWidget.h"
 #include "NintendoSwitch_CommandRow.h"
@@ -140,9 +141,11 @@ SwitchSystemWidget::SwitchSystemWidget(
                 if (!image){
                     return;
                 }
-                std::string filename = "screenshot-" + now_to_filestring() + ".png";
+                std::string prefix = "screenshot-" + now_to_filestring();
+                std::string filename = prefix + ".png";
                 m_session.logger().log("Saving screenshot to: " + filename, COLOR_PURPLE);
                 image->save(filename);
+                dump_latency_trace(m_session.logger(), prefix);
             });
         }
     );
@@ -13,6 +13,7 @@
 #include "Common/Cpp/Options/BatchOption.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/Notifications/EventNotificationOption.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "CommonFramework/ControllerDevices/SerialPortGlobals.h"
 #include "CommonFramework/Tools/ProgramEnvironment.h"
 #include "CommonFramework/Tools/ConsoleHandle.h"
@@ -138,6 +139,9 @@ public:
     virtual std::string check_validity() const;
     virtual void restore_defaults();
 
+    //  Resources to load before "program()" is called.
+    const ResourceWarmupManifest& warmup_resources() const{ return m_warmup_resources; }
+
     //  Called when the # of Switches changes.
     virtual void update_active_consoles(size_t switch_count){}
 
@@ -148,6 +152,8 @@ protected:
     BatchOption m_options;
     void add_option(ConfigOption& option, std::string serialization_string);
 
+    ResourceWarmupManifest m_warmup_resources;
+
 
 public:
     EventNotificationOption NOTIFICATION_PROGRAM_FINISH;
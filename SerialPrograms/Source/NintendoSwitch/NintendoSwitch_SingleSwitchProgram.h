@@ -11,6 +11,7 @@
 #include "Common/Cpp/Options/BatchOption.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/Notifications/EventNotificationOption.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "CommonFramework/ControllerDevices/SerialPortGlobals.h"
 #include "CommonFramework/Tools/ProgramEnvironment.h"
 #include "CommonFramework/Tools/ConsoleHandle.h"
@@ -121,6 +122,9 @@ public:
     virtual std::string check_validity() const;
     virtual void restore_defaults();
 
+    //  Resources to load before "program()" is called.
+    const ResourceWarmupManifest& warmup_resources() const{ return m_warmup_resources; }
+
 
 protected:
     friend class SingleSwitchProgramOption;
@@ -128,6 +132,8 @@ protected:
     BatchOption m_options;
     void add_option(ConfigOption& option, std::string serialization_string);
 
+    ResourceWarmupManifest m_warmup_resources;
+
 
 public:
     EventNotificationOption NOTIFICATION_PROGRAM_FINISH;
@@ -6,10 +6,12 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
 #include "Common/Cpp/Exceptions.h"
 #include "CommonFramework/GlobalSettingsPanel.h"
 #include "NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.h"
 #include "NintendoSwitch/Commands/NintendoSwitch_Commands_ScalarButtons.h"
+#include "NintendoSwitch/Commands/NintendoSwitch_Commands_Macro.h"
 #include "NintendoSwitch_FastCodeEntry.h"
 
 //#include <iostream>
@@ -63,6 +65,11 @@ FastCodeEntrySettingsOption::FastCodeEntrySettingsOption()
         3, 15,
         "6", "6"
     )
+    , DIAGONAL_SCROLLS(
+        "<b>Diagonal Scrolls:</b><br>Allow the cursor to move diagonally with one scroll.",
+        LockWhileRunning::LOCKED,
+        false
+    )
 {
     PA_ADD_OPTION(KEYBOARD_LAYOUT);
     PA_ADD_OPTION(SKIP_PLUS);
@@ -71,6 +78,7 @@ FastCodeEntrySettingsOption::FastCodeEntrySettingsOption()
         PA_ADD_OPTION(DIGIT_REORDERING);
         PA_ADD_OPTION(SCROLL_DELAY);
         PA_ADD_OPTION(WRAP_DELAY);
+        PA_ADD_OPTION(DIAGONAL_SCROLLS);
     }
 }
 
@@ -164,72 +172,102 @@ const std::map<char, CodeboardPosition>& CODEBOARD_POSITIONS_AZERTY(){
     return map;
 }
 
+//  Cheapest way to move the cursor from "source" to "destination".
+//
+//  Rows don't wrap. Columns wrap between 0 and 11 and the scroll that wraps
+//  needs "wrap_delay" instead of "scroll_delay". With "diagonals", a diagonal
+//  scroll moves one row and one column at once.
+//
+//  This is a shortest path search over the keys. Ties go to fewer scrolls.
 DigitPath get_codeboard_digit_path(
     CodeboardPosition source, CodeboardPosition destination,
-    uint8_t scroll_delay, uint8_t wrap_delay
+    uint8_t scroll_delay, uint8_t wrap_delay, bool diagonals
 ){
 //    cout << (size_t)scroll_delay << ", " << (size_t)wrap_delay << endl;
-    DigitPath path;
-
-    //  Vertical is easy since there's no wrapping and no hazards.
-    if (source.row < destination.row){
-        size_t diff = destination.row - source.row;
-        for (size_t c = 0; c < diff; c++){
-            path.path[path.length++] = {DPAD_DOWN, scroll_delay};
-        }
-    }else{
-        size_t diff = source.row - destination.row;
-        for (size_t c = 0; c < diff; c++){
-            path.path[path.length++] = {DPAD_UP, scroll_delay};
-        }
-    }
+    const size_t ROWS = 4;
+    const size_t COLS = 12;
+    const int8_t ROW_STEP[8] = {-1, -1,  0,  1,  1,  1,  0, -1};
+    const int8_t COL_STEP[8] = { 0,  1,  1,  1,  0, -1, -1, -1};
+
+    struct Key{
+        size_t cost = (size_t)-1;
+        size_t scrolls = 0;
+        size_t previous = 0;
+        CodeboardScroll scroll = {DPAD_NONE, 0};
+        bool done = false;
+    };
+    Key keys[ROWS * COLS];
 
-    //  Horizontal is messy because we need extra delay on wrapping.
-    uint8_t col = source.col;
+    size_t target = destination.row * COLS + destination.col;
+    keys[source.row * COLS + source.col].cost = 0;
     while (true){
-        if (col == destination.col){
-//            if (path.length > 0){
-//                path.path[path.length - 1].delay = 0;
-//            }
+        size_t current = ROWS * COLS;
+        for (size_t c = 0; c < ROWS * COLS; c++){
+            const Key& key = keys[c];
+            if (key.done || key.cost == (size_t)-1){
+                continue;
+            }
+            if (current == ROWS * COLS ||
+                key.cost < keys[current].cost ||
+                (key.cost == keys[current].cost && key.scrolls < keys[current].scrolls)
+            ){
+                current = c;
+            }
+        }
+        if (current == target || current == ROWS * COLS){
             break;
         }
-
-        uint8_t direction;
-        if (destination.col > col){
-            if (destination.col - col <= 6){
-                direction = DPAD_RIGHT;
-                col++;
-            }else{
-                direction = DPAD_LEFT;
-                col--;
+        keys[current].done = true;
+
+        size_t row = current / COLS;
+        size_t col = current % COLS;
+        for (uint8_t direction = 0; direction < 8; direction++){
+            bool diagonal = ROW_STEP[direction] != 0 && COL_STEP[direction] != 0;
+            if (diagonal && !diagonals){
+                continue;
             }
-        }else{
-            if (col - destination.col <= 6){
-                direction = DPAD_LEFT;
-                col--;
-            }else{
-                direction = DPAD_RIGHT;
-                col++;
+            size_t next_row = row + ROW_STEP[direction];
+            if (next_row >= ROWS){
+                continue;
+            }
+            size_t next_col = col + COL_STEP[direction];
+            uint8_t delay = scroll_delay;
+            if (next_col >= COLS){
+                next_col = (next_col + COLS) % COLS;
+                delay = wrap_delay;
             }
-        }
 
-        uint8_t delay = scroll_delay;
-        if (col == (uint8_t)-1){
-            col = 11;
-            delay = wrap_delay;
-        }
-        if (col == 12){
-            col = 0;
-            delay = wrap_delay;
+            Key& next = keys[next_row * COLS + next_col];
+            size_t cost = keys[current].cost + delay;
+            size_t scrolls = keys[current].scrolls + 1;
+            if (next.done || cost > next.cost || (cost == next.cost && scrolls >= next.scrolls)){
+                continue;
+            }
+            next.cost = cost;
+            next.scrolls = scrolls;
+            next.previous = current;
+            next.scroll = {direction, delay};
         }
+    }
 
-//        if (direction == DPAD_RIGHT && col == 11){
-//            delay = wrap_delay;
-//        }
-
-//        cout << "col = " << (int)col << ", length = " << (int)path.length << endl;
+    DigitPath path;
+    if (keys[target].scrolls > sizeof(path.path) / sizeof(path.path[0])){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Codeboard path is too long.");
+    }
+    path.length = (uint8_t)keys[target].scrolls;
+    for (size_t c = path.length, current = target; c-- > 0; current = keys[current].previous){
+        path.path[c] = keys[current].scroll;
+    }
 
-        path.path[path.length++] = {direction, delay};
+    //  Without diagonals the scrolls can go in any order. Do the vertical ones
+    //  first like before.
+    if (!diagonals){
+        std::stable_partition(
+            path.path, path.path + path.length,
+            [](const CodeboardScroll& scroll){
+                return scroll.direction == DPAD_UP || scroll.direction == DPAD_DOWN;
+            }
+        );
     }
 
     return path;
@@ -241,70 +279,120 @@ size_t get_codeboard_path_cost(const DigitPath& path){
     }
     return total_cost;
 }
+size_t get_codeboard_digit_cost(const DigitPath& path){
+    size_t cost = get_codeboard_path_cost(path);
+    if (path.left_cursor){
+        cost++;
+    }
+    return std::max<size_t>(cost, 8);
+}
 size_t get_codeboard_path_cost(const std::vector<DigitPath>& path){
     size_t total_cost = 0;
     for (const DigitPath& digit : path){
-        size_t cost = get_codeboard_path_cost(digit);
-        if (digit.left_cursor){
-            cost++;
-        }
-        cost = std::max<size_t>(cost, 8);
-        total_cost += cost;
+        total_cost += get_codeboard_digit_cost(digit);
     }
     return total_cost;
 }
 
+
 std::vector<DigitPath> get_codeboard_path(
-    KeyboardLayout keyboard_layout,
-    const std::vector<CodeboardPosition>& positions, size_t s, size_t e,
-    CodeboardPosition start,
-    uint8_t scroll_delay, uint8_t wrap_delay, bool reordering
+    const std::vector<CodeboardPosition>& positions, CodeboardPosition start,
+    uint8_t scroll_delay, uint8_t wrap_delay, bool diagonals, bool reordering
 ){
-    if (e - s == 1){
-        return {get_codeboard_digit_path(start, positions[s], scroll_delay, wrap_delay)};
-    }
+    //  The characters that are left to enter are always a contiguous range
+    //  [s, e) of the code. Each digit either enters "s" or enters "e - 1" and
+    //  moves the text cursor left in front of it. So the cursor is always on
+    //  the key of "s - 1" or of "e". (or at "start" for the first digit)
+    //
+    //  "best[s][e][side]" is the cheapest way to enter [s, e) with the cursor
+    //  on "s - 1" (side 0) or "e" (side 1). Fill it in from short ranges to
+    //  long ones.
+
+    struct Choice{
+        size_t cost = 0;
+        bool reverse = false;
+    };
 
-    std::vector<DigitPath> forward;
-    {
-        CodeboardPosition position = positions[s];
-        forward.emplace_back(get_codeboard_digit_path(start, position, scroll_delay, wrap_delay));
-        std::vector<DigitPath> remaining = get_codeboard_path(
-            keyboard_layout,
-            positions, s + 1, e,
-            position,
-            scroll_delay, wrap_delay, reordering
-        );
-        forward.insert(forward.end(), remaining.begin(), remaining.end());
+    const size_t length = positions.size();
+    if (length == 0){
+        return {};
     }
-
-    std::vector<DigitPath> reverse;
-    {
-        CodeboardPosition position = positions[e - 1];
-        reverse.emplace_back(get_codeboard_digit_path(start, position, scroll_delay, wrap_delay));
-        reverse.back().left_cursor = true;
-        std::vector<DigitPath> remaining = get_codeboard_path(
-            keyboard_layout,
-            positions, s, e - 1, position,
-            scroll_delay, wrap_delay, reordering
+    auto index = [=](size_t s, size_t e, size_t side){
+        return (s * (length + 1) + e) * 2 + side;
+    };
+    std::vector<Choice> best((length + 1) * (length + 1) * 2);
+
+    //  Only a few pairs of keys come up. Search each one once.
+    std::map<std::pair<uint16_t, uint16_t>, DigitPath> cache;
+    auto digit = [&](CodeboardPosition from, size_t c, bool reverse){
+        CodeboardPosition to = positions[c];
+        std::pair<uint16_t, uint16_t> key(
+            (uint16_t)(from.row << 8 | from.col),
+            (uint16_t)(to.row << 8 | to.col)
         );
-        reverse.insert(reverse.end(), remaining.begin(), remaining.end());
-    }
+        auto iter = cache.find(key);
+        if (iter == cache.end()){
+            iter = cache.emplace(key, get_codeboard_digit_path(from, to, scroll_delay, wrap_delay, diagonals)).first;
+        }
+        DigitPath path = iter->second;
+        path.left_cursor = reverse;
+        return path;
+    };
+    auto choose = [&](CodeboardPosition from, size_t s, size_t e){
+        Choice ret;
+        ret.cost = get_codeboard_digit_cost(digit(from, s, false)) + best[index(s + 1, e, 0)].cost;
+        if (reordering && e - s > 1){
+            size_t cost = get_codeboard_digit_cost(digit(from, e - 1, true)) + best[index(s, e - 1, 1)].cost;
+            if (cost < ret.cost){
+                ret.cost = cost;
+                ret.reverse = true;
+            }
+        }
+        return ret;
+    };
 
-    if (!reordering){
-        return forward;
+    for (size_t range = 1; range < length; range++){
+        for (size_t s = 0; s + range <= length; s++){
+            size_t e = s + range;
+            if (s > 0){
+                best[index(s, e, 0)] = choose(positions[s - 1], s, e);
+            }
+            if (e < length){
+                best[index(s, e, 1)] = choose(positions[e], s, e);
+            }
+        }
     }
 
-    if (get_codeboard_path_cost(forward) <= get_codeboard_path_cost(reverse)){
-        return forward;
-    }else{
-        return reverse;
+    //  Walk the choices from the start.
+    std::vector<DigitPath> path;
+    CodeboardPosition from = start;
+    size_t s = 0;
+    size_t e = length;
+    Choice choice = choose(start, 0, length);
+    while (true){
+        if (choice.reverse){
+            path.emplace_back(digit(from, e - 1, true));
+            from = positions[--e];
+            if (s == e){
+                break;
+            }
+            choice = best[index(s, e, 1)];
+        }else{
+            path.emplace_back(digit(from, s, false));
+            from = positions[s++];
+            if (s == e){
+                break;
+            }
+            choice = best[index(s, e, 0)];
+        }
     }
+    return path;
 }
-std::vector<DigitPath> get_codeboard_path(
+
+
+std::vector<CodeboardPosition> get_codeboard_positions(
     Logger& logger,
-    KeyboardLayout keyboard_layout, const std::string& code,
-    uint8_t scroll_delay, uint8_t wrap_delay, bool reordering,
-    CodeboardPosition start = {0, 0}
+    KeyboardLayout keyboard_layout, const std::string& code
 ){
     auto get_keyboard_layout = [](KeyboardLayout keyboard_layout){
         switch (keyboard_layout){
@@ -325,45 +413,46 @@ std::vector<DigitPath> get_codeboard_path(
         }
         positions.emplace_back(iter->second);
     }
-    return get_codeboard_path(
-        keyboard_layout,
-        positions, 0, positions.size(),
-        start,
-        scroll_delay, wrap_delay, reordering
-    );
+    return positions;
 }
 
 
-void move_codeboard(BotBaseContext& context, const DigitPath& path){
+void move_codeboard(ControllerMacro& macro, const DigitPath& path){
     uint16_t delay = 3;
     if (path.length > 0){
         size_t last = (size_t)path.length - 1;
         for (size_t c = 0; c < last; c++){
-            ssf_issue_scroll(
-                context,
+            macro.issue_scroll(
                 path.path[c].direction,
                 path.path[c].delay,
                 6
             );
         }
-        ssf_issue_scroll(
-            context,
+        macro.issue_scroll(
             path.path[last].direction,
             0,
             6
         );
         delay = path.path[last].delay;
     }
-    ssf_press_button(context, BUTTON_A, delay);
+    macro.press_button(BUTTON_A, delay);
+}
+void move_codeboard(BotBaseContext& context, const DigitPath& path){
+    ControllerMacro macro;
+    move_codeboard(macro, path);
+    run_macro(context, macro);
 }
 
 void run_codeboard_path(BotBaseContext& context, const std::vector<DigitPath>& path){
+    //  The whole code goes to the device as one macro when it's supported.
+    ControllerMacro macro;
     for (const DigitPath& digit : path){
-        move_codeboard(context, digit);
+        move_codeboard(macro, digit);
         if (digit.left_cursor){
-            ssf_press_button(context, BUTTON_L, 1);
+            macro.press_button(BUTTON_L, 1);
         }
     }
+    run_macro(context, macro);
 }
 
 
@@ -374,6 +463,7 @@ FastCodeEntrySettings::FastCodeEntrySettings(FastCodeEntrySettingsOption& option
     , scroll_delay(option.SCROLL_DELAY)
     , wrap_delay(option.WRAP_DELAY)
     , digit_reordering(option.DIGIT_REORDERING)
+    , diagonal_scrolls(option.DIAGONAL_SCROLLS)
 {}
 
 
@@ -384,9 +474,10 @@ void enter_alphanumeric_code(
     const std::string& code
 ){
     run_codeboard_path(context, get_codeboard_path(
-        logger,
-        settings.keyboard_layout, code,
-        settings.scroll_delay, settings.wrap_delay, settings.digit_reordering
+        get_codeboard_positions(logger, settings.keyboard_layout, code),
+        {0, 0},
+        settings.scroll_delay, settings.wrap_delay,
+        settings.diagonal_scrolls, settings.digit_reordering
     ));
     if (settings.include_plus){
         pbf_press_button(context, BUTTON_PLUS, 5, 3);
@@ -20,6 +20,7 @@ namespace PokemonAutomation{
     class Logger;
     class BotBaseContext;
 namespace NintendoSwitch{
+    class ControllerMacro;
 
 
 
@@ -40,6 +41,7 @@ public:
     BooleanCheckBoxOption DIGIT_REORDERING;
     TimeExpressionOption<uint8_t> SCROLL_DELAY;
     TimeExpressionOption<uint8_t> WRAP_DELAY;
+    BooleanCheckBoxOption DIAGONAL_SCROLLS;
 };
 
 
@@ -63,8 +65,28 @@ struct DigitPath{
 };
 DigitPath get_codeboard_digit_path(
     CodeboardPosition source, CodeboardPosition destination,
-    uint8_t scroll_delay, uint8_t wrap_delay, bool reordering
+    uint8_t scroll_delay, uint8_t wrap_delay, bool diagonals
 );
+
+//  Total delay of the scrolls of one digit.
+size_t get_codeboard_path_cost(const DigitPath& path);
+
+//  Ticks to enter a whole path. Each digit takes at least 8 ticks to press A.
+size_t get_codeboard_path_cost(const std::vector<DigitPath>& path);
+
+std::vector<CodeboardPosition> get_codeboard_positions(
+    Logger& logger,
+    KeyboardLayout keyboard_layout, const std::string& code
+);
+
+//  The fastest way to enter the code at "positions" starting from "start".
+//  With "reordering", this also picks the order of the digits.
+std::vector<DigitPath> get_codeboard_path(
+    const std::vector<CodeboardPosition>& positions, CodeboardPosition start,
+    uint8_t scroll_delay, uint8_t wrap_delay, bool diagonals, bool reordering
+);
+
+void move_codeboard(ControllerMacro& macro, const DigitPath& path);
 void move_codeboard(BotBaseContext& context, const DigitPath& path);
 
 
@@ -77,6 +99,7 @@ struct FastCodeEntrySettings{
     uint8_t scroll_delay = 4;
     uint8_t wrap_delay = 6;
     bool digit_reordering = true;
+    bool diagonal_scrolls = false;
 
     FastCodeEntrySettings(FastCodeEntrySettingsOption& option);
 };
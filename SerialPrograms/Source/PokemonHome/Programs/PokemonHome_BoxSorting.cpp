@@ -25,6 +25,7 @@ language
 */
 
 #include <map>
+#include <tuple>
 #include <optional>
 #include <sstream>
 #include "Common/Cpp/Exceptions.h"
@@ -47,6 +48,7 @@ language
 #include "PokemonHome/Inference/PokemonHome_BallReader.h"
 #include "PokemonSwSh/Commands/PokemonSwSh_Commands_GameEntry.h"
 #include "PokemonSwSh/Programs/ReleaseHelpers.h"
+#include "PokemonHome_BoxSortingPlanner.h"
 #include "PokemonHome_BoxSorting.h"
 
 namespace PokemonAutomation{
@@ -56,8 +58,6 @@ using namespace Pokemon;
 
 
 const size_t MAX_BOXES = 200;
-const size_t MAX_COLUMNS = 6;
-const size_t MAX_ROWS = 5;
 
 BoxSorting_Descriptor::BoxSorting_Descriptor()
     : SingleSwitchProgramDescriptor(
@@ -136,36 +136,6 @@ BoxSorting::BoxSorting()
 
 
 
-struct Cursor{
-  size_t box;
-  size_t row;
-  size_t column;
-};
-
-std::ostream& operator<<(std::ostream& os, const Cursor& cursor){
-    os << "(" << cursor.box << "/" << cursor.row << "/" << cursor.column << ")";
-    return os;
-}
-
-Cursor get_cursor(size_t index){
-    Cursor ret;
-
-    ret.column = index % MAX_COLUMNS;
-    index = index / MAX_COLUMNS;
-
-    ret.row = index % MAX_ROWS;
-    index = index / MAX_ROWS;
-
-    ret.box = index;
-    return ret;
-}
-
-size_t get_index(size_t box, size_t row, size_t column){
-    return box * MAX_ROWS * MAX_COLUMNS + row * MAX_COLUMNS + column;
-}
-
-
-
 struct Pokemon{
     const std::vector<BoxSortingSelection>* preferences;
 
@@ -187,6 +157,20 @@ bool operator==(const Pokemon& lhs, const Pokemon& rhs){
         lhs.gender == rhs.gender;
 }
 
+//  Everything that operator== compares. Equal keys are interchangeable when sorting.
+using PokemonKey = std::tuple<uint16_t, bool, bool, std::string, EggHatchGenderFilter>;
+
+PokemonKey get_key(const Pokemon& pokemon){
+    // NOTE edit when adding new struct members
+    return PokemonKey(
+        pokemon.national_dex_number,
+        pokemon.shiny,
+        pokemon.gmax,
+        pokemon.ball_slug,
+        pokemon.gender
+    );
+}
+
 bool operator<(const std::optional<Pokemon>& lhs, const std::optional<Pokemon>& rhs){
     if (!lhs.has_value()){
         return false;
@@ -311,54 +295,25 @@ bool go_to_first_slot(SingleSwitchProgramEnvironment& env, BotBaseContext& conte
     ss << "Moving cursor from " << cur_cursor << " to " << dest_cursor;
     env.console.log(ss.str());
 
-    // TODO: shortest path movement though pages, boxes
-    for (size_t i = cur_cursor.box; i < dest_cursor.box; ++i){
+    // shortest path, wrapping around rows and columns when it is faster
+    CursorMoves moves = get_cursor_moves(cur_cursor, dest_cursor);
+    for (int64_t i = 0; i < moves.boxes; ++i){
         pbf_press_button(context, BUTTON_R, 10, GAME_DELAY+30);
     }
-    for (size_t i = dest_cursor.box; i < cur_cursor.box; ++i){
+    for (int64_t i = moves.boxes; i < 0; ++i){
         pbf_press_button(context, BUTTON_L, 10, GAME_DELAY+30);
     }
-
-
-    // direct nav up or down through rows
-    if (!(cur_cursor.row == 0 && dest_cursor.row == 4) && !(dest_cursor.row == 0 && cur_cursor.row == 4)) {
-        for (size_t i = cur_cursor.row; i < dest_cursor.row; ++i){
-            pbf_press_dpad(context, DPAD_DOWN, 1, GAME_DELAY);
-        }
-        for (size_t i = dest_cursor.row; i < cur_cursor.row; ++i){
-            pbf_press_dpad(context, DPAD_UP, 1, GAME_DELAY);
-        }
-    } else { // wrap around is faster to move between first or last row
-        if (cur_cursor.row == 0 && dest_cursor.row == 4) {
-            for (size_t i = 0; i <= 2; ++i){
-                pbf_press_dpad(context, DPAD_UP, 1, GAME_DELAY);
-            }
-        } else {
-            for (size_t i = 0; i <= 2; ++i){
-                pbf_press_dpad(context, DPAD_DOWN, 1, GAME_DELAY);
-            }
-        }
+    for (int64_t i = 0; i < moves.rows; ++i){
+        pbf_press_dpad(context, DPAD_DOWN, 1, GAME_DELAY);
     }
-
-    // direct nav forward or backward through columns
-    if ((dest_cursor.column > cur_cursor.column && dest_cursor.column - cur_cursor.column <= 3) || (cur_cursor.column > dest_cursor.column && cur_cursor.column - dest_cursor.column <= 3)) {
-        for (size_t i = cur_cursor.column; i < dest_cursor.column; ++i){
-            pbf_press_dpad(context, DPAD_RIGHT, 1, GAME_DELAY);
-        }
-        for (size_t i = dest_cursor.column; i < cur_cursor.column; ++i){
-            pbf_press_dpad(context, DPAD_LEFT, 1, GAME_DELAY);
-        }
-    } else { // wrap around is faster if direct movement is more than 3 away
-        if (dest_cursor.column > cur_cursor.column) {
-            for (size_t i = 0; i < MAX_COLUMNS - (dest_cursor.column - cur_cursor.column); ++i){
-                pbf_press_dpad(context, DPAD_LEFT, 1, GAME_DELAY);
-            }
-        }
-        if (cur_cursor.column > dest_cursor.column) {
-            for (size_t i = 0; i < MAX_COLUMNS - (cur_cursor.column - dest_cursor.column); ++i){
-                pbf_press_dpad(context, DPAD_RIGHT, 1, GAME_DELAY);
-            }
-        }
+    for (int64_t i = moves.rows; i < 0; ++i){
+        pbf_press_dpad(context, DPAD_UP, 1, GAME_DELAY);
+    }
+    for (int64_t i = 0; i < moves.columns; ++i){
+        pbf_press_dpad(context, DPAD_RIGHT, 1, GAME_DELAY);
+    }
+    for (int64_t i = moves.columns; i < 0; ++i){
+        pbf_press_dpad(context, DPAD_LEFT, 1, GAME_DELAY);
     }
 
     context.wait_for_all_requests();
@@ -396,59 +351,55 @@ void output_boxes_data_json(const std::vector<std::optional<Pokemon>>& boxes_dat
     pokemon_data.dump(json_path + ".json");
 }
 
+//  Give each distinct Pokemon an id for the planner. Empty slots are 0.
+std::vector<size_t> get_slot_ids(
+    const std::vector<std::optional<Pokemon>>& boxes_data,
+    std::map<PokemonKey, size_t>& ids
+){
+    std::vector<size_t> ret;
+    for (const std::optional<Pokemon>& pokemon : boxes_data){
+        if (!pokemon.has_value()){
+            ret.emplace_back(0);
+            continue;
+        }
+        auto iter = ids.emplace(get_key(*pokemon), ids.size() + 1).first;
+        ret.emplace_back(iter->second);
+    }
+    return ret;
+}
+
 void do_sort(
         SingleSwitchProgramEnvironment& env,
         BotBaseContext& context,
         std::vector<std::optional<Pokemon>> boxes_data,
-        std::vector<std::optional<Pokemon>> boxes_sorted,
+        const BoxSortingPlan& plan,
         BoxSorting_Descriptor::Stats& stats,
         Cursor& cur_cursor,
         uint16_t GAME_DELAY
         ) {
     std::ostringstream ss;
-    // this need to be separated into functions when I will redo the whole thing but I just wanted it to work
 
-    // going thru the sorted list one by one and for each one go through the current pokemon layout to find the closest possible match to fill the slot
-    for (size_t poke_nb_s = 0; poke_nb_s < boxes_sorted.size(); poke_nb_s++){
-        if (boxes_sorted[poke_nb_s] == std::nullopt){ // we've hit the end of the sorted list.
-            break;
-        }
-        for (size_t poke_nb = poke_nb_s; poke_nb < boxes_data.size(); poke_nb++){
-            Cursor cursor_s = get_cursor(poke_nb_s);
-            Cursor cursor = get_cursor(poke_nb);
-
-            // ss << "Comparing " << boxes_data[poke_nb] << " at " << cursor << " to " << boxes_sorted[poke_nb_s] << " at " << cursor_s;
-            // env.console.log(ss.str());
-            // ss.str("");
-
-            //check for a match and also check if the pokemon is not already in the slot
-            stats.compare++;
-            env.update_stats();
-            if(boxes_sorted[poke_nb_s] == boxes_data[poke_nb] && poke_nb_s == poke_nb){ // Same spot no need to move.
-                break;
-            }
-            if(boxes_sorted[poke_nb_s] == boxes_data[poke_nb]){
-                ss << "Swapping " << boxes_data[poke_nb] << " at " << cursor << " and " << boxes_sorted[poke_nb_s] << " at " << cursor_s;
-                env.console.log(ss.str());
-                ss.str("");
+    for (const BoxSortingSwap& swap : plan.swaps){
+        Cursor pickup = get_cursor(swap.pickup);
+        Cursor drop = get_cursor(swap.drop);
 
-                //moving cursor to the pokemon to pick it up
-                cur_cursor = move_cursor_to(env, context, cur_cursor, cursor, GAME_DELAY);
-                pbf_press_button(context, BUTTON_Y, 10, GAME_DELAY+30);
+        ss << "Swapping " << boxes_data[swap.pickup] << " at " << pickup << " and " << boxes_data[swap.drop] << " at " << drop;
+        env.console.log(ss.str());
+        ss.str("");
 
-                //moving to destination to place it or swap it
-                cur_cursor = move_cursor_to(env, context, cur_cursor, cursor_s, GAME_DELAY);
-                pbf_press_button(context, BUTTON_Y, 10, GAME_DELAY+30);
+        //moving cursor to the pokemon to pick it up
+        cur_cursor = move_cursor_to(env, context, cur_cursor, pickup, GAME_DELAY);
+        pbf_press_button(context, BUTTON_Y, 10, GAME_DELAY+30);
 
-                context.wait_for_all_requests();
+        //moving to destination to place it or swap it
+        cur_cursor = move_cursor_to(env, context, cur_cursor, drop, GAME_DELAY);
+        pbf_press_button(context, BUTTON_Y, 10, GAME_DELAY+30);
 
-                std::swap(boxes_data[poke_nb_s], boxes_data[poke_nb]);
-                stats.swaps++;
-                env.update_stats();
+        context.wait_for_all_requests();
 
-                break;
-            }
-        }
+        std::swap(boxes_data[swap.pickup], boxes_data[swap.drop]);
+        stats.swaps++;
+        env.update_stats();
     }
 }
 
@@ -710,8 +661,28 @@ void BoxSorting::program(SingleSwitchProgramEnvironment& env, BotBaseContext& co
     const std::string sorted_path = json_path + "-sorted";
     output_boxes_data_json(boxes_sorted, sorted_path);
 
+    // plan the swaps, equal pokemon are interchangeable
+    std::map<PokemonKey, size_t> ids;
+    std::vector<size_t> current_ids = get_slot_ids(boxes_data, ids);
+    std::vector<size_t> sorted_ids = get_slot_ids(boxes_sorted, ids);
+
+    BoxSortingTimings timings{GAME_DELAY};
+    BoxSortingPlan plan = plan_box_sort(current_ids, sorted_ids, 0, cur_cursor, timings);
+    BoxSortingPlan in_order = plan_box_sort_in_order(current_ids, sorted_ids, 0, cur_cursor, timings);
+    ss << "Sort plan: " << plan.swaps.size() << " swaps, " << plan.presses << " presses, " << plan.ticks << " ticks. ";
+    ss << "(in order: " << in_order.swaps.size() << " swaps, " << in_order.presses << " presses, " << in_order.ticks << " ticks)";
+    env.console.log(ss.str());
+    ss.str("");
+    if (in_order.ticks < plan.ticks){
+        plan = std::move(in_order);
+    }
+
+    JsonObject plan_json = plan.to_json(timings);
+    env.console.log("Estimated time to sort: " + *plan_json.get_string("estimated_time"));
+    plan_json.dump(json_path + ".sortplan");
+
     if (!DRY_RUN) {
-        do_sort(env, context, boxes_data, boxes_sorted, stats, cur_cursor, GAME_DELAY);
+        do_sort(env, context, boxes_data, plan, stats, cur_cursor, GAME_DELAY);
     }
 
     send_program_finished_notification(env, NOTIFICATION_PROGRAM_FINISH);
@@ -0,0 +1,348 @@
+/*  Home Box Sorting Planner
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <map>
+#include <set>
+#include <algorithm>
+#include <chrono>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/PrettyPrint.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "Common/NintendoSwitch/NintendoSwitch_ControllerDefs.h"
+#include "PokemonHome_BoxSortingPlanner.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+namespace PokemonHome{
+
+
+
+std::ostream& operator<<(std::ostream& os, const Cursor& cursor){
+    os << "(" << cursor.box << "/" << cursor.row << "/" << cursor.column << ")";
+    return os;
+}
+
+Cursor get_cursor(size_t index){
+    Cursor ret;
+
+    ret.column = index % MAX_COLUMNS;
+    index = index / MAX_COLUMNS;
+
+    ret.row = index % MAX_ROWS;
+    index = index / MAX_ROWS;
+
+    ret.box = index;
+    return ret;
+}
+
+size_t get_index(size_t box, size_t row, size_t column){
+    return box * MAX_ROWS * MAX_COLUMNS + row * MAX_COLUMNS + column;
+}
+
+
+
+namespace{
+
+//  Signed shortest distance from "from" to "to" on a ring of "size".
+//  Ties go the direct way.
+int64_t ring_distance(size_t from, size_t to, size_t size){
+    int64_t direct = (int64_t)to - (int64_t)from;
+    int64_t wrap = direct > 0 ? direct - (int64_t)size : direct + (int64_t)size;
+    return std::abs(wrap) < std::abs(direct) ? wrap : direct;
+}
+
+}
+
+size_t CursorMoves::presses() const{
+    return (size_t)(std::abs(boxes) + std::abs(rows) + std::abs(columns));
+}
+CursorMoves get_cursor_moves(const Cursor& from, const Cursor& to){
+    CursorMoves ret;
+    ret.boxes = (int64_t)to.box - (int64_t)from.box;
+    ret.rows = ring_distance(from.row, to.row, ROW_CYCLE);
+    ret.columns = ring_distance(from.column, to.column, MAX_COLUMNS);
+    return ret;
+}
+uint64_t BoxSortingTimings::cost(const CursorMoves& moves) const{
+    return
+        std::abs(moves.boxes) * box_change() +
+        (std::abs(moves.rows) + std::abs(moves.columns)) * dpad();
+}
+
+
+
+JsonObject BoxSortingPlan::to_json(const BoxSortingTimings& timings) const{
+    auto slot_to_json = [](size_t index){
+        Cursor cursor = get_cursor(index);
+        JsonObject obj;
+        obj["index"] = index;
+        obj["box"] = cursor.box;
+        obj["row"] = cursor.row;
+        obj["column"] = cursor.column;
+        return obj;
+    };
+
+    JsonArray plan;
+    for (const BoxSortingSwap& swap : swaps){
+        JsonObject obj;
+        obj["pickup"] = slot_to_json(swap.pickup);
+        obj["drop"] = slot_to_json(swap.drop);
+        plan.push_back(std::move(obj));
+    }
+
+    JsonObject ret;
+    ret["swaps"] = swaps.size();
+    ret["presses"] = presses;
+    ret["ticks"] = ticks;
+    ret["game_delay"] = timings.game_delay;
+    ret["estimated_time"] = duration_to_string(
+        std::chrono::milliseconds(ticks * 1000 / TICKS_PER_SECOND)
+    );
+    ret["plan"] = std::move(plan);
+    return ret;
+}
+
+
+
+namespace{
+
+void check_layouts(
+    const std::vector<size_t>& current,
+    const std::vector<size_t>& target
+){
+    if (current.size() != target.size()){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Current and target layouts have different sizes.");
+    }
+    std::vector<size_t> x = current;
+    std::vector<size_t> y = target;
+    std::sort(x.begin(), x.end());
+    std::sort(y.begin(), y.end());
+    if (x != y){
+        throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Target layout is not a rearrangement of the current layout.");
+    }
+}
+
+BoxSortingPlan finish_plan(
+    std::vector<BoxSortingSwap> swaps,
+    const std::vector<size_t>& current,
+    size_t empty,
+    const Cursor& start,
+    const BoxSortingTimings& timings
+){
+    BoxSortingSimulation simulation = simulate_box_sort(current, empty, start, swaps, timings);
+    BoxSortingPlan plan;
+    plan.swaps = std::move(swaps);
+    plan.presses = simulation.presses;
+    plan.ticks = simulation.ticks;
+    return plan;
+}
+
+}
+
+
+
+BoxSortingPlan plan_box_sort(
+    const std::vector<size_t>& current,
+    const std::vector<size_t>& target,
+    size_t empty,
+    const Cursor& start,
+    const BoxSortingTimings& timings
+){
+    check_layouts(current, target);
+
+    const size_t slots = current.size();
+    std::vector<size_t> layout = current;
+
+    //  Slots that don't have the right Pokemon yet.
+    std::set<size_t> misplaced;
+
+    //  Misplaced slots by the id they hold. These are the places to take
+    //  each id from. Never take from a slot that is already correct.
+    std::map<size_t, std::set<size_t>> holding;
+
+    auto add = [&](size_t index){
+        if (layout[index] != target[index]){
+            misplaced.insert(index);
+            holding[layout[index]].insert(index);
+        }
+    };
+    auto remove = [&](size_t index){
+        misplaced.erase(index);
+        holding[layout[index]].erase(index);
+    };
+    for (size_t c = 0; c < slots; c++){
+        add(c);
+    }
+
+    std::vector<BoxSortingSwap> swaps;
+    Cursor cursor = start;
+
+    auto do_swap = [&](size_t pickup, size_t drop){
+        remove(pickup);
+        remove(drop);
+        swaps.emplace_back(BoxSortingSwap{pickup, drop});
+        std::swap(layout[pickup], layout[drop]);
+        add(pickup);
+        add(drop);
+        cursor = get_cursor(drop);
+    };
+
+    //  Cost of moving the cursor to "first" and then to "second".
+    auto travel_cost = [&](size_t first, size_t second){
+        Cursor first_cursor = get_cursor(first);
+        return
+            timings.cost(get_cursor_moves(cursor, first_cursor)) +
+            timings.cost(get_cursor_moves(first_cursor, get_cursor(second)));
+    };
+
+    //  If we take from "index" to fill a slot holding "have", can the cycle
+    //  close on the step after?
+    auto closes_next = [&](size_t index, size_t have){
+        auto iter = holding.find(target[index]);
+        if (iter == holding.end()){
+            return false;
+        }
+        for (size_t next : iter->second){
+            if (next != index && target[next] == have){
+                return true;
+            }
+        }
+        return false;
+    };
+
+    while (!misplaced.empty()){
+        //  Start the next cycle at the closest misplaced slot.
+        size_t slot = 0;
+        uint64_t best_cost = ~(uint64_t)0;
+        for (size_t index : misplaced){
+            uint64_t cost = timings.cost(get_cursor_moves(cursor, get_cursor(index)));
+            if (cost < best_cost){
+                best_cost = cost;
+                slot = index;
+            }
+        }
+
+        while (layout[slot] != target[slot]){
+            size_t have = layout[slot];
+            size_t want = target[slot];
+            size_t other = slots;
+            int best_rank = 3;
+            best_cost = ~(uint64_t)0;
+
+            //  Bring the right Pokemon here. The one that was here goes to the
+            //  source which becomes the next slot of the cycle. Prefer a source
+            //  that wants what is here since that closes the cycle. Next prefer
+            //  one that lets the cycle close on the following step.
+            //
+            //  If this slot should be empty, this parks the Pokemon in the
+            //  cheapest empty slot. Sending it straight to its destination
+            //  saves a swap but costs more in cursor travel coming back.
+            for (size_t index : holding[want]){
+                int rank = 2;
+                if (target[index] == have){
+                    rank = 0;
+                }else if (closes_next(index, have)){
+                    rank = 1;
+                }
+                uint64_t cost = have == empty
+                    ? travel_cost(index, slot)
+                    : travel_cost(slot, index);
+                if (rank < best_rank || (rank == best_rank && cost < best_cost)){
+                    other = index;
+                    best_rank = rank;
+                    best_cost = cost;
+                }
+            }
+            if (other == slots){
+                throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "No source for misplaced slot.");
+            }
+
+            //  Can't pick up from an empty slot. So bring the Pokemon over instead.
+            if (have == empty){
+                do_swap(other, slot);
+            }else{
+                do_swap(slot, other);
+            }
+            slot = other;
+        }
+    }
+
+    return finish_plan(std::move(swaps), current, empty, start, timings);
+}
+
+BoxSortingPlan plan_box_sort_in_order(
+    const std::vector<size_t>& current,
+    const std::vector<size_t>& target,
+    size_t empty,
+    const Cursor& start,
+    const BoxSortingTimings& timings
+){
+    check_layouts(current, target);
+
+    std::vector<size_t> layout = current;
+    std::vector<BoxSortingSwap> swaps;
+    for (size_t slot = 0; slot < target.size(); slot++){
+        if (target[slot] == empty){
+            break;
+        }
+        for (size_t index = slot; index < layout.size(); index++){
+            if (layout[index] != target[slot]){
+                continue;
+            }
+            if (index != slot){
+                swaps.emplace_back(BoxSortingSwap{index, slot});
+                std::swap(layout[slot], layout[index]);
+            }
+            break;
+        }
+    }
+
+    return finish_plan(std::move(swaps), current, empty, start, timings);
+}
+
+
+
+BoxSortingSimulation simulate_box_sort(
+    std::vector<size_t> layout,
+    size_t empty,
+    const Cursor& start,
+    const std::vector<BoxSortingSwap>& swaps,
+    const BoxSortingTimings& timings
+){
+    BoxSortingSimulation ret;
+    ret.cursor = start;
+    for (const BoxSortingSwap& swap : swaps){
+        if (swap.pickup >= layout.size() || swap.drop >= layout.size()){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Swap is out of range.");
+        }
+        if (layout[swap.pickup] == empty){
+            throw InternalProgramError(nullptr, PA_CURRENT_FUNCTION, "Attempted to pick up from an empty slot.");
+        }
+
+        Cursor pickup = get_cursor(swap.pickup);
+        Cursor drop = get_cursor(swap.drop);
+
+        CursorMoves moves = get_cursor_moves(ret.cursor, pickup);
+        ret.presses += moves.presses() + 1;
+        ret.ticks += timings.cost(moves) + timings.pickup();
+
+        moves = get_cursor_moves(pickup, drop);
+        ret.presses += moves.presses() + 1;
+        ret.ticks += timings.cost(moves) + timings.pickup();
+
+        std::swap(layout[swap.pickup], layout[swap.drop]);
+        ret.cursor = drop;
+    }
+    ret.layout = std::move(layout);
+    return ret;
+}
+
+
+
+}
+}
+}
@@ -0,0 +1,137 @@
+/*  Home Box Sorting Planner
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Plan the swaps to turn the current box layout into the sorted one.
+ *
+ *  Each slot holds an id. Equal ids are interchangeable Pokemon so any of
+ *  them can fill any matching slot. The planner follows the cycles of the
+ *  permutation so each cycle of length k takes k-1 swaps, prefers swaps that
+ *  close a cycle when there are duplicates, and picks the next cycle and the
+ *  next source by the cost of the cursor movement.
+ *
+ *  Nothing in here touches the console. This is so that the plan can be
+ *  written out in dry-run mode and tested without a Switch.
+ *
+ */
+
+#ifndef PokemonAutomation_PokemonHome_BoxSortingPlanner_H
+#define PokemonAutomation_PokemonHome_BoxSortingPlanner_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace PokemonAutomation{
+    class JsonObject;
+namespace NintendoSwitch{
+namespace PokemonHome{
+
+
+const size_t MAX_COLUMNS = 6;
+const size_t MAX_ROWS = 5;
+
+//  Pressing up from the first row goes through the box name and the top
+//  menu before wrapping to the last row.
+const size_t ROW_CYCLE = MAX_ROWS + 2;
+
+
+struct Cursor{
+  size_t box;
+  size_t row;
+  size_t column;
+};
+
+std::ostream& operator<<(std::ostream& os, const Cursor& cursor);
+
+Cursor get_cursor(size_t index);
+size_t get_index(size_t box, size_t row, size_t column);
+
+
+
+//  Shortest way to move the cursor between two slots.
+struct CursorMoves{
+    int64_t boxes = 0;      //  Positive is R, negative is L.
+    int64_t rows = 0;       //  Positive is down, negative is up.
+    int64_t columns = 0;    //  Positive is right, negative is left.
+
+    size_t presses() const;
+};
+CursorMoves get_cursor_moves(const Cursor& from, const Cursor& to);
+
+
+//  How long each kind of press takes. (in ticks) This mirrors what the
+//  program actually sends.
+struct BoxSortingTimings{
+    uint16_t game_delay;
+
+    uint64_t box_change() const{ return 10 + game_delay + 30; }
+    uint64_t dpad() const{ return 1 + game_delay; }
+    uint64_t pickup() const{ return 10 + game_delay + 30; }
+
+    uint64_t cost(const CursorMoves& moves) const;
+};
+
+
+
+//  Press Y on "pickup" and then on "drop". The Pokemon in "drop" (if any)
+//  ends up in "pickup". The cursor ends on "drop".
+struct BoxSortingSwap{
+    size_t pickup;
+    size_t drop;
+};
+
+struct BoxSortingPlan{
+    std::vector<BoxSortingSwap> swaps;
+    size_t presses = 0;
+    uint64_t ticks = 0;
+
+    JsonObject to_json(const BoxSortingTimings& timings) const;
+};
+
+//  "target" must have the same ids as "current" in some order.
+//  "empty" is the id of an empty slot.
+BoxSortingPlan plan_box_sort(
+    const std::vector<size_t>& current,
+    const std::vector<size_t>& target,
+    size_t empty,
+    const Cursor& start,
+    const BoxSortingTimings& timings
+);
+
+//  The original strategy: fill each slot in order with the first match
+//  after it. Kept to compare against.
+BoxSortingPlan plan_box_sort_in_order(
+    const std::vector<size_t>& current,
+    const std::vector<size_t>& target,
+    size_t empty,
+    const Cursor& start,
+    const BoxSortingTimings& timings
+);
+
+
+
+struct BoxSortingSimulation{
+    std::vector<size_t> layout;
+    Cursor cursor;
+    size_t presses = 0;
+    uint64_t ticks = 0;
+};
+
+//  Run the swaps on "layout" the way the console would and count the presses.
+//  Throws if a swap picks up from an empty slot.
+BoxSortingSimulation simulate_box_sort(
+    std::vector<size_t> layout,
+    size_t empty,
+    const Cursor& start,
+    const std::vector<BoxSortingSwap>& swaps,
+    const BoxSortingTimings& timings
+);
+
+
+
+}
+}
+}
+#endif
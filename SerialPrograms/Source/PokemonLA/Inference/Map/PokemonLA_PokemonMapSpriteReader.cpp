@@ -11,6 +11,7 @@
 
 #include "Common/Compiler.h"
 #include "Common/Cpp/Exceptions.h"
+#include "Kernels/ImageGradient/Kernels_ImageGradient.h"
 #include "CommonFramework/Globals.h"
 #include "CommonFramework/ImageMatch/ImageCropper.h"
 #include "CommonFramework/ImageMatch/ImageDiff.h"
@@ -20,6 +21,7 @@
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
 #include "CommonFramework/ImageTypes/ImageHSV32.h"
 #include "CommonFramework/Logging/Logger.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "CommonFramework/Resources/SpriteDatabase.h"
 #include "CommonFramework/Tools/DebugDumper.h"
 #include "PokemonLA_PokemonMapSpriteReader.h"
@@ -103,62 +105,31 @@ std::string feature_to_str(const FeatureVector& a){
     return os.str();
 }
 
-void run_Sobel_gradient_filter(const ImageViewRGB32& image, std::function<void(size_t x, size_t y, int sum_x[3], int sum_y[3])> process_gradient){
-    const size_t width = image.width();
-    const size_t height = image.height();
-    // Kernel for computing gradient along x axis
-    const int kx[3][3] = {
-        {-1, 0, 1},
-        {-2, 0, 2},
-        {-1, 0, 1},
-    };
-    // kernel for gradient along y axis
-    const int ky[3][3] = {
-        { 1,  2,  1},
-        { 0,  0,  0},
-        {-1, -2, -1},
-    };
-    const int ksz = 3; // kernel size
-    if (width <= ksz || height <= ksz){
-        return;
-    }
-    const size_t x_end = width - ksz + 1;
-    const size_t y_end = height - ksz + 1;
-
-    for(size_t y = 0; y < y_end; y++){
-        for(size_t x = 0; x < x_end; x++){
-            int sum_x[3] = {0, 0, 0};
-            int sum_y[3] = {0, 0, 0};
-            bool has_alpha_pixel = false;
-            for(size_t sy = 0; sy < 3; sy++){
-                for(size_t sx = 0; sx < 3; sx++){
-                    uint32_t p = image.pixel(x + sx, y + sy);
-                    int alpha = p >> 24;
-                    if (alpha < 128){
-                        // We don't compute gradient when there is a pixel in the kernel
-                        // scope that is transparent
-                        has_alpha_pixel = true;
-                        break;
-                    }
-                    for(int ch = 0; ch < 3; ch++){ // rgb channel
-                        int shift = ch * 8;
-                        int c = (uint32_t(0xff) & p >> shift);
-
-                        sum_x[ch] += c * kx[sy][sx];
-                        sum_y[ch] += c * ky[sy][sx];
-                    }
-                }
-                if (has_alpha_pixel){
-                    break;
-                }
-            } // end of kernel operation
-            if (has_alpha_pixel){
-                continue;
-            }
-
-            process_gradient(x+1, y+1, sum_x, sum_y);
-        }
-    }
+//  Sobel gradients of the channel sums of the pixels [1, width - 1) x [1, height - 1).
+//  Gradients are not computed where a pixel in the 3x3 kernel is transparent.
+struct SobelGradients{
+    size_t width = 0;
+    size_t height = 0;
+    std::vector<int16_t> gx;
+    std::vector<int16_t> gy;
+    std::vector<uint8_t> valid;
+};
+SobelGradients run_Sobel_gradient_filter(const ImageViewRGB32& image){
+    SobelGradients ret;
+    const size_t ksz = 3; // kernel size
+    if (image.width() <= ksz || image.height() <= ksz){
+        return ret;
+    }
+    ret.width = image.width() - ksz + 1;
+    ret.height = image.height() - ksz + 1;
+    ret.gx.resize(ret.width * ret.height);
+    ret.gy.resize(ret.width * ret.height);
+    ret.valid.resize(ret.width * ret.height);
+    Kernels::sobel_gradient_rgb32(
+        image.width(), image.height(), image.data(), image.bytes_per_row(),
+        ret.gx.data(), ret.gy.data(), ret.valid.data(), ret.width
+    );
+    return ret;
 }
 
 ImageRGB32 smooth_image(const ImageViewRGB32& image){
@@ -167,89 +138,23 @@ ImageRGB32 smooth_image(const ImageViewRGB32& image){
     //     image.save("./test_smooth_before_" + std::to_string(count) + ".png");
     // }
 
-    ImageRGB32 result(image.width(), image.height());
-    result.fill(0);
-
     const float filter[5] = {0.062f, 0.244f, 0.388f, 0.244f, 0.062f};
 
-    size_t image_width = image.width();
-    size_t image_height = image.height();
-    for(size_t y = 0; y < image_height; y++){
-        for(size_t x = 0; x < image_width; x++){
-            float sum[3] = {0,0,0};
-            float weights = 0.0;
-            for(size_t i = 0; i < 5; i++){
-                if (x + i < 2 || x + i >= image_width + 2){
-                    continue;
-                }
-                size_t sx = x + i - 2;
-            
-                uint32_t p = image.pixel(sx, y);
-                if (is_transparent(p)){
-                    continue;
-                }
-
-                weights += filter[i];
-
-                for(int ch = 0; ch < 3; ch++){
-                    int shift = 16 - ch * 8;
-                    int c = (uint32_t(0xff) & p >> shift);
-                    sum[ch] += filter[i] * c;
-                }
-            }
-            if (weights == 0){
-                continue;
-            }
-
-            char c[3];
-            for(int ch = 0; ch < 3; ch++){
-                sum[ch] /= weights;
-                int v = std::min(std::max(int(sum[ch] + 0.5f), 0), 255);
-                c[ch] = (char)v;
-            }
-            result.pixel(x, y) = combine_rgb(c[0], c[1], c[2]);
-        }
-    }
+    ImageRGB32 result(image.width(), image.height());
+    Kernels::smooth5_rgb32_rows(
+        image.width(), image.height(),
+        image.data(), image.bytes_per_row(),
+        result.data(), result.bytes_per_row(),
+        filter
+    );
 
     ImageRGB32 result2(image.width(), image.height());
-    result2.fill(0);
-
-    for(size_t y = 0; y < image_height; y++){
-        for(size_t x = 0; x < image_width; x++){
-            float sum[3] = {0,0,0};
-            float weights = 0.0;
-            for(size_t i = 0; i < 5; i++){
-                if (y + i < 2 || y + i - 2 >= image_height){
-                    continue;
-                }
-                size_t sy = y + i - 2;
-
-                uint32_t p = result.pixel(x, sy);
-                if (is_transparent(p)){
-                    continue;
-                }
-
-                weights += filter[i];
-
-                for(int ch = 0; ch < 3; ch++){
-                    int shift = 16 - ch * 8;
-                    int c = (uint32_t(0xff) & (p >> shift));
-                    sum[ch] += filter[i] * c;
-                }
-            }
-            if (weights == 0){
-                continue;
-            }
-
-            char c[3];
-            for(int ch = 0; ch < 3; ch++){
-                sum[ch] /= weights;
-                int v = std::min(std::max(int(sum[ch] + 0.5f), 0), 255);
-                c[ch] = (char)v;
-            }
-            result2.pixel(x, y) = combine_rgb(c[0], c[1], c[2]);
-        }
-    }
+    Kernels::smooth5_rgb32_columns(
+        image.width(), image.height(),
+        result.data(), result.bytes_per_row(),
+        result2.data(), result2.bytes_per_row(),
+        filter
+    );
 
     // {
     //     result_ref.save("./test_smooth_middle_" + std::to_string(count) + ".png");
@@ -266,15 +171,22 @@ ImageRGB32 compute_image_gradient(const ImageViewRGB32& image){
     ImageRGB32 result(image.width(), image.height());
     result.fill(0);
 
-    run_Sobel_gradient_filter(image, [&](size_t x, size_t y, int sum_x[3], int sum_y[3]){
-        int gx = (sum_x[0] + sum_x[1] + sum_x[2] + 1) / 3;
-        int gy = (sum_y[0] + sum_y[1] + sum_y[2] + 1) / 3;
+    SobelGradients gradients = run_Sobel_gradient_filter(image);
+    for (size_t y = 0; y < gradients.height; y++){
+        for (size_t x = 0; x < gradients.width; x++){
+            size_t i = y * gradients.width + x;
+            if (gradients.valid[i] == 0){
+                continue;
+            }
+            int gx = (gradients.gx[i] + 1) / 3;
+            int gy = (gradients.gy[i] + 1) / 3;
 
-        uint8_t gxc = (uint8_t)std::min(std::abs(gx), 255);
-        uint8_t gyc = (uint8_t)std::min(std::abs(gy), 255);
+            uint8_t gxc = (uint8_t)std::min(std::abs(gx), 255);
+            uint8_t gyc = (uint8_t)std::min(std::abs(gy), 255);
 
-        result.pixel(x, y) = combine_rgb(gxc, gyc, 0);
-    });
+            result.pixel(x + 1, y + 1) = combine_rgb(gxc, gyc, 0);
+        }
+    }
 
     return result;
 }
@@ -288,11 +200,15 @@ FeatureVector compute_gradient_histogram(const ImageViewRGB32& image){
 
     int num_grad = 0;
 
-    run_Sobel_gradient_filter(image, [&](size_t x, size_t y, int sum_x[3], int sum_y[3]){
-        int gx = sum_x[0] + sum_x[1] + sum_x[2];
-        int gy = sum_y[0] + sum_y[1] + sum_y[2];
+    SobelGradients gradients = run_Sobel_gradient_filter(image);
+    for (size_t i = 0; i < gradients.valid.size(); i++){
+        if (gradients.valid[i] == 0){
+            continue;
+        }
+        int gx = gradients.gx[i];
+        int gy = gradients.gy[i];
         if (gx*gx + gy*gy <= 2000){
-            return;
+            continue;
         }
         num_grad++;
 
@@ -310,7 +226,7 @@ FeatureVector compute_gradient_histogram(const ImageViewRGB32& image){
         // clamp bin to [0, 11]
         bin_idx = std::min(std::max(bin_idx, 0), num_angle_divisions-1);
         bin[bin_idx]++;
-    });
+    }
 
     FeatureVector result(num_angle_divisions);
     for(size_t i = 0; i < num_angle_divisions; i++){
@@ -405,6 +321,11 @@ const MMOSpriteMatchingMap& MMO_SPRITE_MATCHING_DATA(){
     return sprite_matching_data;
 }
 
+const ResourceWarmupRegistration MMO_SPRITE_MATCHING_DATA_WARMUP(
+    "PokemonLA:MMOSpriteMatchingData",
+    []{ MMO_SPRITE_MATCHING_DATA(); }
+);
+
 
 std::multimap<double, std::string> match_pokemon_map_sprite_feature(const ImageViewRGB32& image, MapRegion region){
     const FeatureVector& image_feature = compute_feature(image);
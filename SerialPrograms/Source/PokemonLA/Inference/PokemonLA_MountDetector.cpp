@@ -16,6 +16,7 @@
 #include "CommonFramework/ImageMatch/WaterfillTemplateMatcher.h"
 #include "CommonFramework/ImageMatch/SubObjectTemplateMatcher.h"
 #include "CommonFramework/Notifications/ProgramInfo.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "PokemonLA/Inference/Objects/PokemonLA_ButtonDetector.h"
 #include "PokemonLA_MountDetector.h"
 
@@ -301,6 +302,32 @@ public:
 };
 
 
+const ResourceWarmupRegistration MOUNT_MATCHERS_WARMUP(
+    "PokemonLA:MountMatchers",
+    []{
+        MountWyrdeerMatcher::on();
+        MountWyrdeerMatcher::off();
+        MountUrsalunaMatcher::on();
+        MountUrsalunaMatcher::off();
+        MountBasculegionMatcher::on();
+        MountBasculegionMatcher::off();
+        MountSneaslerMatcher::on();
+        MountSneaslerMatcher::off();
+        MountBraviaryMatcher::on();
+        MountBraviaryMatcher::off();
+        MountWyrdeerMatcherButtons::on();
+        MountWyrdeerMatcherButtons::off();
+        MountUrsalunaMatcherButtons::on();
+        MountUrsalunaMatcherButtons::off();
+        MountBasculegionMatcherButtons::on();
+        MountSneaslerMatcherButtons::on();
+        MountSneaslerMatcherButtons::off();
+        MountBraviaryMatcherButtons::on();
+        MountBraviaryMatcherButtons::off();
+    }
+);
+
+
 
 
 const char* MOUNT_STATE_STRINGS[] = {
@@ -360,6 +387,18 @@ struct MountDetectorFilteredImage{
     PackedBinaryMatrix matrix;
 };
 
+//  These come from the kernel's constant sets so that run_filters() runs the
+//  versions of filter_rgb32_range() that are specialized for them.
+template <typename RangeSet>
+std::vector<std::pair<uint32_t, uint32_t>> make_mount_ranges(){
+    static_assert(RangeSet::REPLACEMENT == (uint32_t)COLOR_BLACK && !RangeSet::INVERT);
+    std::vector<std::pair<uint32_t, uint32_t>> ranges;
+    for (const Kernels::Rgb32Range& range : RangeSet::RANGES){
+        ranges.emplace_back(range.mins, range.maxs);
+    }
+    return ranges;
+}
+
 std::vector<MountDetectorFilteredImage> run_filters(const ImageViewRGB32& image, const std::vector<std::pair<uint32_t, uint32_t>>& range){
     std::vector<FilterRgb32Range> filters;
     for (size_t c = 0; c < range.size(); c++){
@@ -392,17 +431,7 @@ MountState MountDetector::detect(const ImageViewRGB32& screen) const{
     auto session = make_WaterfillSession();
     {
         std::vector<MountDetectorFilteredImage> filtered_images = run_filters(
-            image,
-            {
-                {0xff808060, 0xffffffff},
-                {0xff909070, 0xffffffff},
-                {0xffa0a080, 0xffffffff},
-                {0xffb0b090, 0xffffffff},
-                {0xffc0c0a0, 0xffffffff},
-                {0xffd0d0b0, 0xffffffff},
-                {0xffe0e0c0, 0xffffffff},
-                {0xfff0f0d0, 0xffffffff},
-            }
+            image, make_mount_ranges<Kernels::MountBrightRanges>()
         );
 //        static int c = 0;
         for (MountDetectorFilteredImage& filtered : filtered_images){
@@ -511,17 +540,13 @@ MountState MountDetector::detect(const ImageViewRGB32& screen) const{
     //  Now run all the direct-waterfill to detect all the yellow mounts.
     {
         std::vector<MountDetectorFilteredImage> filtered_images = run_filters(
-            image,
-            {
-                {0xff606000, 0xffffff7f},
-                {0xff808000, 0xffffff6f},
-                {0xffa0a000, 0xffffff5f},
-                {0xffc0c000, 0xffffff4f},
+            image, make_mount_ranges<Kernels::MountYellowRanges>()
+//            {
 //                {0xff606000, 0xffffffff},
 //                {0xff808000, 0xffffffff},
 //                {0xffa0a000, 0xffffffff},
 //                {0xffc0c000, 0xffffffff},
-            }
+//            }
         );
 //        int i = 0;
         for (MountDetectorFilteredImage& filtered : filtered_images){
@@ -85,6 +85,7 @@ NuggetFarmerHighlands::NuggetFarmerHighlands()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_STATIC(SHINY_REQUIRES_AUDIO);
     PA_ADD_OPTION(SHINY_DETECTED);
     PA_ADD_OPTION(NOTIFICATIONS);
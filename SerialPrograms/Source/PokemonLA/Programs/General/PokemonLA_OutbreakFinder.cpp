@@ -235,6 +235,7 @@ OutbreakFinder::OutbreakFinder()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MMOSpriteMatchingData");
     PA_ADD_OPTION(GO_HOME_WHEN_DONE);
     PA_ADD_OPTION(LANGUAGE);
     PA_ADD_OPTION(DESIRED_MO_SLUGS);
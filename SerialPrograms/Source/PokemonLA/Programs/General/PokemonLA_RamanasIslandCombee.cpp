@@ -100,6 +100,7 @@ RamanasCombeeFinder:: RamanasCombeeFinder()
         false
     )
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_OPTION(LANGUAGE);
     PA_ADD_OPTION(SHINY_DETECTED_ENROUTE);
     PA_ADD_OPTION(NOTIFICATIONS);
@@ -232,6 +232,7 @@ AutoMultiSpawn::AutoMultiSpawn()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_OPTION(LANGUAGE);
     PA_ADD_OPTION(SPAWN);
     PA_ADD_OPTION(PATH);
@@ -113,6 +113,7 @@ BurmyFinder::BurmyFinder()
         false
     )
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_OPTION(LANGUAGE);
     PA_ADD_OPTION(STOP_ON);
     PA_ADD_OPTION(EXIT_METHOD);
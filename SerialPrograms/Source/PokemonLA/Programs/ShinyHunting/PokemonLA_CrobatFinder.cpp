@@ -83,6 +83,7 @@ CrobatFinder::CrobatFinder()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_STATIC(SHINY_REQUIRES_AUDIO);
     PA_ADD_OPTION(SHINY_DETECTED_ENROUTE);
     PA_ADD_OPTION(SHINY_DETECTED_DESTINATION);
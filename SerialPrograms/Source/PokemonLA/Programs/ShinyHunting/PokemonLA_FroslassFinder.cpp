@@ -96,6 +96,7 @@ FroslassFinder::FroslassFinder()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
     PA_ADD_STATIC(SHINY_REQUIRES_AUDIO);
     PA_ADD_OPTION(DASH_DURATION);
     PA_ADD_OPTION(SHINY_DETECTED_ENROUTE);
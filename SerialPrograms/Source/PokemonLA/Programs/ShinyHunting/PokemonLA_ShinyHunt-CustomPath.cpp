@@ -97,6 +97,7 @@ ShinyHuntCustomPath::ShinyHuntCustomPath()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonLA:MountMatchers");
 
     PA_ADD_STATIC(SHINY_REQUIRES_AUDIO);
 //    PA_ADD_OPTION(TRAVEL_LOCATION);
@@ -25,8 +25,12 @@ public:
     DialogArrowDetector(Color color, const ImageFloatBox& box);
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
     virtual bool detect(const ImageViewRGB32& screen) const override;
 
+    //  Two waterfills per frame. Far more than checking the box for changes.
+    virtual bool skip_unchanged_frames() const override{ return true; }
+
     std::vector<ImageFloatBox> detect_all(const ImageViewRGB32& screen) const;
 
 protected:
@@ -42,6 +46,8 @@ public:
     DialogArrowWatcher(Color color, VideoOverlay& overlay, const ImageFloatBox& box);
 
     virtual void make_overlays(VideoOverlaySet& items) const override;
+    virtual bool reads_only_overlay_boxes() const override{ return true; }
+    virtual bool skip_unchanged_frames() const override{ return true; }
     virtual bool process_frame(const ImageViewRGB32& frame, WallClock timestamp) override;
 
 
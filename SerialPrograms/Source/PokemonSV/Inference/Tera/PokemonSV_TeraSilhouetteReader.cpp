@@ -8,6 +8,7 @@
 
 #include "CommonFramework/ImageMatch/ImageCropper.h"
 #include "CommonFramework/ImageTools/ImageFilter.h"
+#include "CommonFramework/Resources/ResourceWarmup.h"
 #include "PokemonSV/Resources/PokemonSV_PokemonSprites.h"
 
 #include "PokemonSV_TeraSilhouetteReader.h"
@@ -35,6 +36,11 @@ const ImageMatch::SilhouetteDictionaryMatcher& TERA_RAID_SILHOUETTE_MATCHER(){
     return matcher;
 }
 
+const ResourceWarmupRegistration TERA_RAID_SILHOUETTE_MATCHER_WARMUP(
+    "PokemonSV:TeraRaidSilhouetteMatcher",
+    []{ TERA_RAID_SILHOUETTE_MATCHER(); }
+);
+
 TeraSilhouetteReader::TeraSilhouetteReader(Color color)
     : m_color(color)
     , m_box(0.536, 0.122, 0.252, 0.430)
@@ -156,6 +156,7 @@ TeraSelfFarmer::TeraSelfFarmer()
         &NOTIFICATION_ERROR_FATAL,
     })
 {
+    m_warmup_resources.add("PokemonSV:TeraRaidSilhouetteMatcher");
     PA_ADD_OPTION(LANGUAGE);
     PA_ADD_OPTION(MODE);
     PA_ADD_OPTION(MIN_STARS);
@@ -8,6 +8,7 @@
 #include "Common/Cpp/PrettyPrint.h"
 #include "NintendoSwitch/Commands/NintendoSwitch_Commands_PushButtons.h"
 #include "PokemonSwSh/Inference/RNG/PokemonSwSh_OrbeetleAttackAnimationDetector.h"
+#include "PokemonSwSh/Programs/RNG/PokemonSwSh_LastBitSearch.h"
 #include "PokemonSwSh/Programs/RNG/PokemonSwSh_BasicRNG.h"
 
 namespace PokemonAutomation {
@@ -74,14 +75,10 @@ Xoroshiro128PlusState refind_rng_state(
     bool log_image_values)
 {
     Xoroshiro128Plus rng(last_known_state.s0, last_known_state.s1);
-    for (size_t i = 0; i < min_advances; i++) {
-        rng.next();
-    }
+    rng.jump(min_advances);
     OrbeetleAttackAnimationDetector detector(console, context);
     size_t possible_indices = SIZE_MAX;
-    std::vector<bool> sequence = {};
-    std::vector<bool> last_bit_sequence = rng.generate_last_bit_sequence(max_advances - min_advances);
-    size_t distance = 0;
+    LastBitSearch search(rng.get_state(), max_advances - min_advances);
 
     size_t i = 0;
     while (possible_indices > 1) {
@@ -95,37 +92,25 @@ Xoroshiro128PlusState refind_rng_state(
             break;
         case OrbeetleAttackAnimationDetector::SPECIAL:
             text += " : Special";
-            sequence.emplace_back(true);
+            possible_indices = search.push(true);
             break;
         case OrbeetleAttackAnimationDetector::PHYSICAL:
             text += " : Physical";
-            sequence.emplace_back(false);
+            possible_indices = search.push(false);
             break;
         }
         console.overlay().add_log(text, COLOR_BLUE);
+        console.log("RNG: " + std::to_string(possible_indices) + " possible states remaining.");
         pbf_wait(context, 180);
-
-        std::vector<bool>::iterator last_bit_start = std::search(last_bit_sequence.begin(), last_bit_sequence.end(), sequence.begin(), sequence.end());
-        possible_indices = 0;
-        distance = 0;
-        while (last_bit_start != last_bit_sequence.end()) {
-            possible_indices++;
-            distance = std::distance(last_bit_sequence.begin(), last_bit_start);
-
-            last_bit_start++;
-            last_bit_start = std::search(last_bit_start, last_bit_sequence.end(), sequence.begin(), sequence.end());
-        }
     }
     if (possible_indices == 0) {
         throw OperationFailedException(console, "Detected sequence of attack motions does not exist in expected range.");
     }
 
-    distance += sequence.size();
-    console.log("RNG: needed " + std::to_string(sequence.size()) + " animations.");
+    size_t distance = search.last_candidate() + search.observed();
+    console.log("RNG: needed " + std::to_string(search.observed()) + " animations.");
     console.log("RNG: new state is " + std::to_string(distance + min_advances) + " advances from last known state.");
-    for (size_t advance = 0; advance < distance; advance++) {
-        rng.next();
-    }
+    rng.jump(distance);
     console.log("RNG: state[0] = " + tostr_hex(rng.get_state().s0));
     console.log("RNG: state[1] = " + tostr_hex(rng.get_state().s1));
 
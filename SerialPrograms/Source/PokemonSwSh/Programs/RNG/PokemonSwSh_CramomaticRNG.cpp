@@ -39,6 +39,73 @@ namespace NintendoSwitch {
 namespace PokemonSwSh {
 using namespace Pokemon;
 
+
+namespace {
+
+// The outputs read for one candidate advance are almost the same as those
+// read for the next candidate, shifted by one. Generate every output once and
+// let each candidate read from the shared window.
+class CramomaticOutputWindow {
+public:
+    CramomaticOutputWindow(Xoroshiro128PlusState state)
+        : m_rng(state)
+    {}
+
+    uint64_t at(size_t index) {
+        while (m_base + m_outputs.size() <= index) {
+            m_outputs.emplace_back(m_rng.next());
+        }
+        return m_outputs[index - m_base];
+    }
+
+    // Outputs before "index" will not be read again.
+    void release_before(size_t index) {
+        if (index - m_base >= 4096) {
+            m_outputs.erase(m_outputs.begin(), m_outputs.begin() + (index - m_base));
+            m_base = index;
+        }
+    }
+
+private:
+    Xoroshiro128Plus m_rng;
+    size_t m_base = 0;
+    std::vector<uint64_t> m_outputs;
+};
+
+// Reads the window like Xoroshiro128Plus would, starting at "start".
+class CramomaticOutputReader {
+public:
+    CramomaticOutputReader(CramomaticOutputWindow& window, size_t start)
+        : m_window(window)
+        , m_index(start)
+    {}
+
+    uint64_t next() {
+        return m_window.at(m_index++);
+    }
+    uint64_t nextInt(uint64_t bound) {
+        uint64_t mask = bound - 1;
+        mask |= mask >> 1;
+        mask |= mask >> 2;
+        mask |= mask >> 4;
+        mask |= mask >> 8;
+        mask |= mask >> 16;
+        mask |= mask >> 32;
+        uint64_t result = next() & mask;
+        while (result >= bound) {
+            result = next() & mask;
+        }
+        return result;
+    }
+
+private:
+    CramomaticOutputWindow& m_window;
+    size_t m_index;
+};
+
+}
+
+
 CramomaticRNG_Descriptor::CramomaticRNG_Descriptor()
     : SingleSwitchProgramDescriptor(
         "PokemonSwSh:CramomaticRNG",
@@ -178,18 +245,20 @@ void CramomaticRNG::navigate_to_party(SingleSwitchProgramEnvironment& env, BotBa
 }
 
 CramomaticTarget CramomaticRNG::calculate_target(SingleSwitchProgramEnvironment& env, Xoroshiro128PlusState state, std::vector<CramomaticSelection> selected_balls){
-    Xoroshiro128Plus rng(state);
+    CramomaticOutputWindow window(state);
     size_t advances = 0;
-    uint16_t priority_advances = 0;
+    size_t priority_advances = 0;
+    const size_t max_priority_advances = MAX_PRIORITY_ADVANCES;
+    const uint32_t num_npcs = NUM_NPCS;
     std::vector<CramomaticTarget> possible_targets;
 
     std::sort(selected_balls.begin(), selected_balls.end(), [](CramomaticSelection sel1, CramomaticSelection sel2) { return sel1.priority > sel2.priority; });
     // priority_advances only starts counting up after the first good result is found
-    while (priority_advances <= MAX_PRIORITY_ADVANCES) {
+    while (priority_advances <= max_priority_advances) {
         // calculate the result for the current temp_rng state
-        Xoroshiro128Plus temp_rng(rng.get_state());
+        CramomaticOutputReader temp_rng(window, advances);
 
-        for (size_t i = 0; i < NUM_NPCS; i++) {
+        for (size_t i = 0; i < num_npcs; i++) {
             temp_rng.nextInt(91);
         }
         temp_rng.next();
@@ -265,8 +334,8 @@ CramomaticTarget CramomaticRNG::calculate_target(SingleSwitchProgramEnvironment&
             priority_advances++;
         }
 
-        rng.next();
         advances++;
+        window.release_before(advances);
     }
 
     // Choose the first result which doesn't overshadow a higher priority choice.
@@ -275,7 +344,7 @@ CramomaticTarget CramomaticRNG::calculate_target(SingleSwitchProgramEnvironment&
         auto last_target = possible_targets.end() - 1;
         auto second_to_last_target = possible_targets.end() - 2;
 
-        if ((*last_target).needed_advances - (*second_to_last_target).needed_advances > MAX_PRIORITY_ADVANCES) {
+        if ((*last_target).needed_advances - (*second_to_last_target).needed_advances > max_priority_advances) {
             possible_targets.erase(last_target);
         }
         else {
@@ -0,0 +1,125 @@
+/*  Last Bit Search
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <bitset>
+#include "Kernels/Kernels_BitScan.h"
+#include "PokemonSwSh/Programs/RNG/PokemonSwSh_LastBitSearch.h"
+
+namespace PokemonAutomation {
+
+
+LastBitSearch::LastBitSearch(Xoroshiro128PlusState state, size_t advances)
+    : m_advances(advances)
+    , m_count(advances)
+    , m_sequence(Xoroshiro128Plus(state).generate_last_bit_words(advances))
+    , m_dense((advances + 63) / 64, ~(uint64_t)0)
+{
+    m_sequence.emplace_back(0);
+    if (advances % 64 != 0) {
+        m_dense.back() = ((uint64_t)1 << (advances % 64)) - 1;
+    }
+}
+
+bool LastBitSearch::bit_at(size_t index) const
+{
+    return (m_sequence[index / 64] >> (index % 64)) & 1;
+}
+
+size_t LastBitSearch::push(bool bit)
+{
+    if (m_is_sparse) {
+        push_sparse(bit);
+    }
+    else {
+        push_dense(bit);
+    }
+    m_observed++;
+
+    // Walking the list is cheaper than the bitset once most words are empty.
+    if (!m_is_sparse && m_count < m_dense.size() / 8) {
+        m_sparse.reserve(m_count);
+        for (size_t w = 0; w < m_dense.size(); w++) {
+            uint64_t word = m_dense[w];
+            size_t bit_index;
+            while (Kernels::trailing_zeros(bit_index, word)) {
+                m_sparse.emplace_back(w * 64 + bit_index);
+                word &= word - 1;
+            }
+        }
+        m_dense.clear();
+        m_is_sparse = true;
+    }
+
+    return m_count;
+}
+
+void LastBitSearch::push_dense(bool bit)
+{
+    // Position p survives if the sequence has "bit" at p + m_observed.
+    // That is the sequence shifted down by m_observed and compared 64 positions at a time.
+    size_t offset_words = m_observed / 64;
+    size_t shift = m_observed % 64;
+    uint64_t invert = bit ? 0 : ~(uint64_t)0;
+
+    size_t count = 0;
+    for (size_t w = 0; w < m_dense.size(); w++) {
+        uint64_t candidates = m_dense[w];
+        if (candidates == 0) {
+            continue;
+        }
+        size_t lo = w + offset_words;
+        uint64_t shifted = 0;
+        if (lo < m_sequence.size()) {
+            shifted = m_sequence[lo] >> shift;
+            if (shift != 0 && lo + 1 < m_sequence.size()) {
+                shifted |= m_sequence[lo + 1] << (64 - shift);
+            }
+        }
+        candidates &= shifted ^ invert;
+        m_dense[w] = candidates;
+        count += std::bitset<64>(candidates).count();
+    }
+
+    // The position whose match now runs past the end of the window.
+    if (m_observed > 0 && m_observed <= m_advances) {
+        size_t last = m_advances - m_observed;
+        if (m_dense[last / 64] & ((uint64_t)1 << (last % 64))) {
+            m_dense[last / 64] &= ~((uint64_t)1 << (last % 64));
+            count--;
+        }
+    }
+
+    m_count = count;
+}
+
+void LastBitSearch::push_sparse(bool bit)
+{
+    size_t kept = 0;
+    for (size_t position : m_sparse) {
+        size_t index = position + m_observed;
+        if (index < m_advances && bit_at(index) == bit) {
+            m_sparse[kept++] = position;
+        }
+    }
+    m_sparse.resize(kept);
+    m_count = kept;
+}
+
+size_t LastBitSearch::last_candidate() const
+{
+    if (m_is_sparse) {
+        return m_sparse.back();
+    }
+    for (size_t w = m_dense.size(); w > 0; w--) {
+        if (m_dense[w - 1] != 0) {
+            return (w - 1) * 64 + Kernels::bitlength(m_dense[w - 1]) - 1;
+        }
+    }
+    return 0;
+}
+
+
+}
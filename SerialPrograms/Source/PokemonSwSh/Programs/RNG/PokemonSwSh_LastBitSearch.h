@@ -0,0 +1,67 @@
+/*  Last Bit Search
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Find where a sequence of observed last bits (attack animations) occurs
+ *  within a window of Xoroshiro128+ advances.
+ *
+ *  The window is generated once. Every observed bit then narrows down the set
+ *  of starting positions that are still consistent. While there are many
+ *  candidates they are kept as a bitset and 64 positions are tested at once.
+ *  Once only a few are left they are kept as a list. Nothing is rescanned.
+ *
+ */
+
+#ifndef PokemonAutomation_PokemonSwSh_LastBitSearch_H
+#define PokemonAutomation_PokemonSwSh_LastBitSearch_H
+
+#include <stdint.h>
+#include <vector>
+#include "PokemonSwSh/Programs/RNG/PokemonSwSh_Xoroshiro128Plus.h"
+
+namespace PokemonAutomation {
+
+
+class LastBitSearch {
+public:
+    // Search the "advances" outputs that follow "state".
+    LastBitSearch(Xoroshiro128PlusState state, size_t advances);
+
+    size_t advances() const { return m_advances; }
+    size_t observed() const { return m_observed; }
+
+    // Number of starting positions that match everything observed so far.
+    size_t candidates() const { return m_count; }
+
+    // Add the next observed bit. Returns the number of remaining candidates.
+    size_t push(bool bit);
+
+    // The largest remaining starting position. Only valid if candidates() > 0.
+    size_t last_candidate() const;
+
+
+private:
+    bool bit_at(size_t index) const;
+    void push_dense(bool bit);
+    void push_sparse(bool bit);
+
+
+private:
+    size_t m_advances;
+    size_t m_observed = 0;
+    size_t m_count;
+
+    // Packed last bits of the window with one extra zero word at the end.
+    std::vector<uint64_t> m_sequence;
+
+    // Bit p is set if position p is still a candidate.
+    std::vector<uint64_t> m_dense;
+
+    // Used instead of "m_dense" once there are few enough candidates.
+    bool m_is_sparse = false;
+    std::vector<size_t> m_sparse;
+};
+
+
+}
+#endif
@@ -4,10 +4,70 @@
  *
  */
 
+#include <array>
 #include "PokemonSwSh/Programs/RNG/PokemonSwSh_Xoroshiro128Plus.h"
 
 namespace PokemonAutomation {
 
+namespace {
+
+void step(uint64_t& s0, uint64_t& s1)
+{
+    uint64_t x = s0 ^ s1;
+    s0 = ((s0 << 24) | (s0 >> 40)) ^ x ^ (x << 16);
+    s1 = (x << 37) | (x >> 27);
+}
+
+// A 128x128 matrix over GF(2) acting on (s0, s1).
+// Column i is stored at [2 * i] (s0 half) and [2 * i + 1] (s1 half).
+using TransitionMatrix = std::array<uint64_t, 256>;
+
+void apply(const TransitionMatrix& matrix, uint64_t& s0, uint64_t& s1)
+{
+    uint64_t r0 = 0;
+    uint64_t r1 = 0;
+    for (size_t i = 0; i < 64; i++) {
+        uint64_t mask = 0 - ((s0 >> i) & 1);
+        r0 ^= matrix[2 * i + 0] & mask;
+        r1 ^= matrix[2 * i + 1] & mask;
+    }
+    for (size_t i = 0; i < 64; i++) {
+        uint64_t mask = 0 - ((s1 >> i) & 1);
+        r0 ^= matrix[2 * (i + 64) + 0] & mask;
+        r1 ^= matrix[2 * (i + 64) + 1] & mask;
+    }
+    s0 = r0;
+    s1 = r1;
+}
+
+// Element k advances the state by 2^k.
+const std::vector<TransitionMatrix>& transition_powers()
+{
+    static const std::vector<TransitionMatrix> powers = [] {
+        std::vector<TransitionMatrix> ret(64);
+        for (size_t i = 0; i < 128; i++) {
+            uint64_t s0 = i < 64 ? (uint64_t)1 << i : 0;
+            uint64_t s1 = i < 64 ? 0 : (uint64_t)1 << (i - 64);
+            step(s0, s1);
+            ret[0][2 * i + 0] = s0;
+            ret[0][2 * i + 1] = s1;
+        }
+        for (size_t k = 1; k < 64; k++) {
+            for (size_t i = 0; i < 128; i++) {
+                uint64_t s0 = ret[k - 1][2 * i + 0];
+                uint64_t s1 = ret[k - 1][2 * i + 1];
+                apply(ret[k - 1], s0, s1);
+                ret[k][2 * i + 0] = s0;
+                ret[k][2 * i + 1] = s1;
+            }
+        }
+        return ret;
+    }();
+    return powers;
+}
+
+}
+
 Xoroshiro128PlusState::Xoroshiro128PlusState(uint64_t s0, uint64_t s1)
     : s0(s0)
     , s1(s1)
@@ -77,6 +137,72 @@ std::vector<bool> Xoroshiro128Plus::generate_last_bit_sequence(size_t max_advanc
     return sequence;
 }
 
+void Xoroshiro128Plus::jump(uint64_t advances)
+{
+    // Stepping is cheaper than a matrix multiply for short distances.
+    if (advances < 256) {
+        for (uint64_t i = 0; i < advances; i++) {
+            next();
+        }
+        return;
+    }
+    const std::vector<TransitionMatrix>& powers = transition_powers();
+    for (size_t k = 0; advances != 0; k++, advances >>= 1) {
+        if (advances & 1) {
+            apply(powers[k], state.s0, state.s1);
+        }
+    }
+}
+
+std::vector<uint64_t> Xoroshiro128Plus::generate_last_bit_words(size_t max_advances) const
+{
+    // The last bit of s0 + s1 is the last bit of s0 ^ s1, so no add is needed.
+    const size_t LANES = 8;
+    const size_t MIN_WORDS_PER_LANE = 16;
+
+    std::vector<uint64_t> sequence((max_advances + 63) / 64);
+    size_t words_per_lane = max_advances / 64 / LANES;
+    if (words_per_lane < MIN_WORDS_PER_LANE) {
+        words_per_lane = 0;
+    }
+
+    uint64_t tail_s0 = state.s0;
+    uint64_t tail_s1 = state.s1;
+    if (words_per_lane > 0) {
+        // Each lane starts where the previous one ends and they are stepped
+        // in lockstep. The lanes are independent so this vectorizes.
+        uint64_t s0[LANES];
+        uint64_t s1[LANES];
+        Xoroshiro128Plus lane(state);
+        for (size_t l = 0; l < LANES; l++) {
+            s0[l] = lane.state.s0;
+            s1[l] = lane.state.s1;
+            lane.jump(words_per_lane * 64);
+        }
+        for (size_t w = 0; w < words_per_lane; w++) {
+            uint64_t bits[LANES] = {};
+            for (size_t b = 0; b < 64; b++) {
+                for (size_t l = 0; l < LANES; l++) {
+                    bits[l] |= ((s0[l] ^ s1[l]) & 1) << b;
+                    step(s0[l], s1[l]);
+                }
+            }
+            for (size_t l = 0; l < LANES; l++) {
+                sequence[l * words_per_lane + w] = bits[l];
+            }
+        }
+        tail_s0 = s0[LANES - 1];
+        tail_s1 = s1[LANES - 1];
+    }
+
+    for (size_t i = words_per_lane * LANES * 64; i < max_advances; i++) {
+        sequence[i / 64] |= ((tail_s0 ^ tail_s1) & 1) << (i % 64);
+        step(tail_s0, tail_s1);
+    }
+
+    return sequence;
+}
+
 // The generic solution to the system of equations to calculate the initial state from the last bits of 128 consecutive Xoroshiro128+ results.
 uint64_t Xoroshiro128Plus::last_bits_reverse_matrix[128][2] = {
     /*s0 bit 0*/ {0b0101001100100001111011111110111001010011111110101011100011001101, 0b0111010111110111000101010100001111101001111001011111001011010111} ,
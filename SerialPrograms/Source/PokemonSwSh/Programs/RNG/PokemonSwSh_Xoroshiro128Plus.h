@@ -8,6 +8,7 @@
 #define PokemonAutomation_PokemonSwSh_Xoroshiro128Plus_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <utility>
 #include <vector>
 
@@ -28,8 +29,18 @@ public:
     uint64_t next();
     uint64_t nextInt(uint64_t);
     Xoroshiro128PlusState get_state();
+
+    // Advance the state as if next() was called "advances" times.
+    // Uses the GF(2) transition matrix so the cost is logarithmic in "advances".
+    void jump(uint64_t advances);
+
     std::vector<bool> generate_last_bit_sequence(size_t max_advances);
 
+    // Same as generate_last_bit_sequence() but packed 64 bits per word.
+    // Bit i of the sequence is bit (i % 64) of word (i / 64). Unused bits are zero.
+    // Long sequences are split into several lanes that are generated together.
+    std::vector<uint64_t> generate_last_bit_words(size_t max_advances) const;
+
     static Xoroshiro128Plus xoroshiro128plus_from_last_bits(std::pair<uint64_t, uint64_t> last_bits);
 
 
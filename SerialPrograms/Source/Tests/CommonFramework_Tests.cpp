@@ -5,10 +5,24 @@
  */
 
 
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <condition_variable>
 #include "Common/Compiler.h"
+#include "Common/CRC32.h"
 #include "Common/Cpp/Time.h"
+#include "Common/Microcontroller/MessageProtocol.h"
+#include "ClientSource/Connection/BotBaseMessage.h"
+#include "ClientSource/Connection/PABotBaseConnection.h"
+#ifndef _WIN32
+#include "ClientSource/Connection/SerialConnection.h"
+#include "ClientSource/Connection/PtyLoopbackPOSIX.h"
+#endif
+#include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/RegionSignature.h"
 #include "CommonFramework/Inference/BlackBorderDetector.h"
 #include "CommonFramework_Tests.h"
 #include "TestUtils.h"
@@ -32,4 +46,150 @@ int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool t
 }
 
 
+#ifndef _WIN32
+namespace{
+
+class LoopbackReceiver : public PABotBaseConnection{
+public:
+    using PABotBaseConnection::PABotBaseConnection;
+    ~LoopbackReceiver(){
+        safely_stop();
+    }
+
+    std::vector<BotBaseMessage> wait_for(size_t count, std::chrono::milliseconds timeout){
+        std::unique_lock<std::mutex> lg(m_lock);
+        m_cv.wait_for(lg, timeout, [&]{ return m_messages.size() >= count; });
+        return std::move(m_messages);
+    }
+
+private:
+    virtual void on_recv_message(BotBaseMessage message) override{
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_messages.emplace_back(std::move(message));
+        m_cv.notify_all();
+    }
+
+private:
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::vector<BotBaseMessage> m_messages;
+};
+
+void append_frame(std::string& stream, uint8_t type, const std::string& body){
+    size_t start = stream.size();
+    stream += (char)~(uint8_t)(PABB_PROTOCOL_OVERHEAD + body.size());
+    stream += (char)type;
+    stream += body;
+    stream += std::string(sizeof(uint32_t), 0);
+    pabb_crc32_write_to_message(&stream[start], stream.size() - start);
+}
+
+}
+#endif
+
+
+// Test file can be anything. It is cut into messages, framed, and written to
+// the device end of a pseudo-terminal with some garbage in between. The
+// messages must come out of SerialConnection + PABotBaseConnection intact.
+int test_CommonFramework_SerialLoopback(const std::string& filepath){
+#ifdef _WIN32
+    cout << "Skip " << filepath << ". Pseudo-terminals are not available on Windows." << endl;
+    return -1;
+#else
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file){
+        cerr << "Error: cannot read " << filepath << endl;
+        return 1;
+    }
+    std::string payload((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<std::string> bodies;
+    std::string stream;
+    for (size_t c = 0; c < payload.size(); c += PABB_MAX_MESSAGE_SIZE){
+        bodies.emplace_back(payload.substr(c, PABB_MAX_MESSAGE_SIZE));
+        append_frame(stream, PABB_MSG_INFO_I32, bodies.back());
+
+        //  Things the framing must skip over.
+        if (bodies.size() % 7 == 0){
+            stream += '\0';
+            std::string bad;
+            append_frame(bad, PABB_MSG_INFO_I32, bodies.back());
+            bad.back() ^= 1;
+            stream += bad;
+        }
+    }
+
+    PtyLoopback device;
+    LoopbackReceiver receiver(
+        global_logger_command_line(),
+        std::unique_ptr<StreamConnection>(new SerialConnection(device.device_name(), PABB_BAUD_RATE))
+    );
+
+    WallClock start = current_time();
+    device.send(stream.data(), stream.size());
+    std::vector<BotBaseMessage> received = receiver.wait_for(bodies.size(), std::chrono::seconds(10));
+    WallClock end = current_time();
+
+    TEST_RESULT_EQUAL(received.size(), bodies.size());
+    for (size_t c = 0; c < bodies.size(); c++){
+        if (received[c].type != PABB_MSG_INFO_I32 || received[c].body != bodies[c]){
+            cerr << "Error: message " << c << " does not match." << endl;
+            return 1;
+        }
+    }
+
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000000.;
+    cout << bodies.size() << " messages, " << stream.size() << " bytes in " << seconds * 1000 << " ms";
+    if (seconds > 0){
+        cout << " (" << stream.size() / seconds / 1000000 << " MB/s)";
+    }
+    cout << endl;
+
+    return 0;
+#endif
+}
+
+
+// Test file is any screenshot. Changes that are too small to see or that are
+// outside the boxes must not change the signature of the boxes. A small mark
+// inside a box must.
+int test_CommonFramework_RegionSignature(const std::string& filepath){
+    ImageRGB32 image(filepath);
+    const std::vector<ImageFloatBox> boxes{
+        {0.10, 0.10, 0.30, 0.20},
+        {0.60, 0.70, 0.20, 0.10},
+    };
+    RegionSignature reference(image, boxes);
+
+    //  Flip the lowest bit of every channel like capture card noise.
+    ImageRGB32 noisy = image.copy();
+    for (size_t r = 0; r < noisy.height(); r++){
+        for (size_t c = 0; c < noisy.width(); c++){
+            noisy.pixel(c, r) ^= (r + c) % 2 == 0 ? 0x00010101 : 0;
+        }
+    }
+    TEST_RESULT_EQUAL(RegionSignature(noisy, boxes).matches(reference, 2), true);
+
+    //  Draw a 4x4 mark in the middle of the screen. No box covers it.
+    auto draw_mark = [](ImageRGB32& target, size_t x, size_t y){
+        for (size_t r = y; r < y + 4; r++){
+            for (size_t c = x; c < x + 4; c++){
+                uint32_t& pixel = target.pixel(c, r);
+                pixel = (pixel & 0x00ff0000) > 0x00800000 ? 0xff000000 : 0xffffffff;
+            }
+        }
+    };
+    ImageRGB32 outside = image.copy();
+    draw_mark(outside, outside.width() / 2, outside.height() / 2);
+    TEST_RESULT_EQUAL(RegionSignature(outside, boxes).matches(reference, 2), true);
+
+    //  Same mark in the middle of the second box.
+    ImageRGB32 inside = image.copy();
+    draw_mark(inside, (size_t)(inside.width() * 0.70), (size_t)(inside.height() * 0.75));
+    TEST_RESULT_EQUAL(RegionSignature(inside, boxes).matches(reference, 2), false);
+
+    return 0;
+}
+
+
 }
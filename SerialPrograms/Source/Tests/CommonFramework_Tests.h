@@ -9,12 +9,18 @@
 #ifndef PokemonAutomation_Tests_CommonFramework_Tests_H
 #define PokemonAutomation_Tests_CommonFramework_Tests_H
 
+#include <string>
+
 namespace PokemonAutomation{
 
 class ImageViewRGB32;
 
 int test_CommonFramework_BlackBorderDetector(const ImageViewRGB32& image, bool target);
 
+int test_CommonFramework_SerialLoopback(const std::string& filepath);
+
+int test_CommonFramework_RegionSignature(const std::string& filepath);
+
 }
 
 #endif
@@ -0,0 +1,850 @@
+/*  Kernels Benchmark
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <string.h>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+#include <iostream>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/CpuId/CpuId.h"
+#include "Common/Cpp/Containers/AlignedVector.tpp"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqr.h"
+#include "Kernels/ImageStats/Kernels_ImagePixelSumSqrDev.h"
+#include "Kernels/ImageFilters/Kernels_ImageFilter_Basic.h"
+#include "Kernels/ImageGradient/Kernels_ImageGradient.h"
+#include "Kernels/BinaryMatrix/Kernels_BinaryMatrix.h"
+#include "Kernels/BinaryImageFilters/Kernels_BinaryImage_BasicFilters.h"
+#include "Kernels/Waterfill/Kernels_Waterfill.h"
+#include "Kernels/Waterfill/Kernels_Waterfill_Session.h"
+#include "Kernels/ScaleInvariantMatrixMatch/Kernels_ScaleInvariantMatrixMatch.h"
+#include "Kernels/SpikeConvolution/Kernels_SpikeConvolution.h"
+#include "Kernels/AbsFFT/Kernels_AbsFFT.h"
+#include "Kernels/AudioStreamConversion/AudioStreamConversion.h"
+#include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/ImageStats.h"
+#include "CommonFramework/ImageTools/RegionSignature.h"
+#include "Kernels_Benchmark.h"
+
+#if _MSC_VER && PA_ARCH_x86
+#include <intrin.h>
+#elif PA_ARCH_x86
+#include <x86intrin.h>
+#endif
+
+using std::cout;
+using std::endl;
+
+namespace PokemonAutomation{
+
+using namespace Kernels;
+
+
+namespace{
+
+
+struct BenchmarkCase{
+    std::string name;
+
+    //  Bytes of input processed by one call.
+    size_t bytes;
+
+    //  Runs before every call without being timed. Calls are not batched if
+    //  this is set.
+    std::function<void()> setup;
+
+    std::function<void()> run;
+};
+
+struct BenchmarkResult{
+    std::string name;
+    std::string isa;
+    size_t bytes;
+    size_t batch;
+    double median_ns;
+    double p95_ns;
+    double median_cycles;   //  Zero if there is no cycle counter.
+};
+
+
+//  Keeps results alive so the calls aren't optimized out.
+volatile float SINK_FLOAT;
+volatile size_t SINK_SIZE;
+
+
+uint64_t read_cycles(){
+#if PA_ARCH_x86
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+struct RandomImage{
+    size_t width;
+    size_t height;
+    std::vector<uint32_t> pixels;
+
+    RandomImage(size_t p_width, size_t p_height, uint32_t seed)
+        : width(p_width)
+        , height(p_height)
+        , pixels(p_width * p_height)
+    {
+        std::mt19937 rng(seed);
+        for (uint32_t& pixel : pixels){
+            pixel = rng() | 0xff000000;
+        }
+    }
+    size_t bytes_per_row() const{ return width * sizeof(uint32_t); }
+    size_t bytes() const{ return pixels.size() * sizeof(uint32_t); }
+};
+
+std::string size_str(size_t width, size_t height){
+    return std::to_string(width) + "x" + std::to_string(height);
+}
+
+const std::vector<std::pair<size_t, size_t>> IMAGE_SIZES{
+    {64, 64},
+    {1920, 1080},
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Families that dispatch on CPU_CAPABILITY_CURRENT.
+
+void add_ImageStats(std::vector<BenchmarkCase>& cases){
+    for (const auto& size : IMAGE_SIZES){
+        auto image = std::make_shared<RandomImage>(size.first, size.second, 1);
+        auto other = std::make_shared<RandomImage>(size.first, size.second, 2);
+        std::string suffix = "/" + size_str(size.first, size.second);
+
+        cases.emplace_back(BenchmarkCase{
+            "ImageStats/pixel_sum_sqr" + suffix, image->bytes(), nullptr,
+            [=]{
+                PixelSums sums;
+                pixel_sum_sqr(
+                    sums, image->width, image->height,
+                    image->pixels.data(), image->bytes_per_row(),
+                    image->pixels.data(), image->bytes_per_row()
+                );
+                SINK_SIZE = sums.count;
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "ImageStats/sum_sqr_deviation" + suffix, 2 * image->bytes(), nullptr,
+            [=]{
+                uint64_t count = 0;
+                uint64_t sumsqrs = 0;
+                sum_sqr_deviation(
+                    count, sumsqrs, image->width, image->height,
+                    image->pixels.data(), image->bytes_per_row(),
+                    other->pixels.data(), other->bytes_per_row()
+                );
+                SINK_SIZE = (size_t)sumsqrs;
+            }
+        });
+    }
+}
+
+void add_ImageFilter(std::vector<BenchmarkCase>& cases){
+    //  The OCR filter sets run the specialized kernels. The same filters in
+    //  reverse order don't match a set and run the generic kernel.
+    struct FilterSet{
+        const char* name;
+        std::vector<Rgb32Range> ranges;
+    };
+    std::vector<FilterSet> sets;
+    sets.emplace_back(FilterSet{
+        "BlackText",
+        std::vector<Rgb32Range>(std::begin(BlackTextRanges::RANGES), std::end(BlackTextRanges::RANGES))
+    });
+    sets.emplace_back(FilterSet{
+        "WhiteText",
+        std::vector<Rgb32Range>(std::begin(WhiteTextRanges::RANGES), std::end(WhiteTextRanges::RANGES))
+    });
+    sets.emplace_back(FilterSet{
+        "BlackOrWhiteText",
+        std::vector<Rgb32Range>(std::begin(BlackOrWhiteTextRanges::RANGES), std::end(BlackOrWhiteTextRanges::RANGES))
+    });
+    for (size_t c = 0, stop = sets.size(); c < stop; c++){
+        FilterSet reversed{sets[c].name, sets[c].ranges};
+        std::reverse(reversed.ranges.begin(), reversed.ranges.end());
+        sets.emplace_back(std::move(reversed));
+    }
+
+    for (const auto& size : IMAGE_SIZES){
+        auto image = std::make_shared<RandomImage>(size.first, size.second, 11);
+        std::string suffix = "/" + size_str(size.first, size.second);
+
+        for (size_t c = 0; c < sets.size(); c++){
+            std::vector<Rgb32Range> ranges = sets[c].ranges;
+            auto outputs = std::make_shared<std::vector<std::vector<uint32_t>>>(
+                ranges.size(), std::vector<uint32_t>(image->pixels.size())
+            );
+            std::string name = "ImageFilter/to_blackwhite_rgb32_range/";
+            name += sets[c].name;
+            name += c < sets.size() / 2 ? "" : "_Generic";
+            cases.emplace_back(BenchmarkCase{
+                name + suffix, image->bytes(), nullptr,
+                [=]{
+                    std::vector<ToBlackWhiteRgb32RangeFilter> filters;
+                    for (size_t i = 0; i < ranges.size(); i++){
+                        filters.emplace_back(
+                            (*outputs)[i].data(), image->bytes_per_row(),
+                            ranges[i].mins, ranges[i].maxs, true
+                        );
+                    }
+                    to_blackwhite_rgb32_range(
+                        image->pixels.data(), image->bytes_per_row(), image->width, image->height,
+                        filters.data(), filters.size()
+                    );
+                    SINK_SIZE = filters[0].pixels_in_range;
+                }
+            });
+        }
+    }
+
+    //  Same for the mount detector sets of "filter_rgb32_range()".
+    std::vector<FilterSet> replace_sets;
+    replace_sets.emplace_back(FilterSet{
+        "MountBright",
+        std::vector<Rgb32Range>(std::begin(MountBrightRanges::RANGES), std::end(MountBrightRanges::RANGES))
+    });
+    replace_sets.emplace_back(FilterSet{
+        "MountYellow",
+        std::vector<Rgb32Range>(std::begin(MountYellowRanges::RANGES), std::end(MountYellowRanges::RANGES))
+    });
+    for (size_t c = 0, stop = replace_sets.size(); c < stop; c++){
+        FilterSet reversed{replace_sets[c].name, replace_sets[c].ranges};
+        std::reverse(reversed.ranges.begin(), reversed.ranges.end());
+        replace_sets.emplace_back(std::move(reversed));
+    }
+
+    for (const auto& size : IMAGE_SIZES){
+        auto image = std::make_shared<RandomImage>(size.first, size.second, 12);
+        std::string suffix = "/" + size_str(size.first, size.second);
+
+        for (size_t c = 0; c < replace_sets.size(); c++){
+            std::vector<Rgb32Range> ranges = replace_sets[c].ranges;
+            auto outputs = std::make_shared<std::vector<std::vector<uint32_t>>>(
+                ranges.size(), std::vector<uint32_t>(image->pixels.size())
+            );
+            std::string name = "ImageFilter/filter_rgb32_range/";
+            name += replace_sets[c].name;
+            name += c < replace_sets.size() / 2 ? "" : "_Generic";
+            cases.emplace_back(BenchmarkCase{
+                name + suffix, image->bytes(), nullptr,
+                [=]{
+                    std::vector<FilterRgb32RangeFilter> filters;
+                    for (size_t i = 0; i < ranges.size(); i++){
+                        filters.emplace_back(
+                            (*outputs)[i].data(), image->bytes_per_row(),
+                            ranges[i].mins, ranges[i].maxs, 0xff000000, false
+                        );
+                    }
+                    filter_rgb32_range(
+                        image->pixels.data(), image->bytes_per_row(), image->width, image->height,
+                        filters.data(), filters.size()
+                    );
+                    SINK_SIZE = filters[0].pixels_in_range;
+                }
+            });
+        }
+    }
+}
+
+void add_ImageGradient(std::vector<BenchmarkCase>& cases){
+    const float filter[5] = {0.062f, 0.244f, 0.388f, 0.244f, 0.062f};
+    for (const auto& size : IMAGE_SIZES){
+        auto image = std::make_shared<RandomImage>(size.first, size.second, 10);
+        std::string suffix = "/" + size_str(size.first, size.second);
+
+        auto smoothed = std::make_shared<std::vector<uint32_t>>(image->pixels.size());
+        cases.emplace_back(BenchmarkCase{
+            "ImageGradient/smooth5_rgb32_rows" + suffix, image->bytes(), nullptr,
+            [=]{
+                smooth5_rgb32_rows(
+                    image->width, image->height,
+                    image->pixels.data(), image->bytes_per_row(),
+                    smoothed->data(), image->bytes_per_row(),
+                    filter
+                );
+                SINK_SIZE = (*smoothed)[0];
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "ImageGradient/smooth5_rgb32_columns" + suffix, image->bytes(), nullptr,
+            [=]{
+                smooth5_rgb32_columns(
+                    image->width, image->height,
+                    image->pixels.data(), image->bytes_per_row(),
+                    smoothed->data(), image->bytes_per_row(),
+                    filter
+                );
+                SINK_SIZE = (*smoothed)[0];
+            }
+        });
+
+        struct Gradients{
+            std::vector<int16_t> gx;
+            std::vector<int16_t> gy;
+            std::vector<uint8_t> valid;
+        };
+        size_t out_width = image->width - 2;
+        size_t out_size = out_width * (image->height - 2);
+        auto gradients = std::make_shared<Gradients>();
+        gradients->gx.resize(out_size);
+        gradients->gy.resize(out_size);
+        gradients->valid.resize(out_size);
+        cases.emplace_back(BenchmarkCase{
+            "ImageGradient/sobel_gradient_rgb32" + suffix, image->bytes(), nullptr,
+            [=]{
+                sobel_gradient_rgb32(
+                    image->width, image->height,
+                    image->pixels.data(), image->bytes_per_row(),
+                    gradients->gx.data(), gradients->gy.data(), gradients->valid.data(), out_width
+                );
+                SINK_SIZE = gradients->valid[0];
+            }
+        });
+    }
+}
+
+void add_ScaleInvariantMatrixMatch(std::vector<BenchmarkCase>& cases){
+    for (size_t dim : {16, 64}){
+        struct Matrices{
+            AlignedVector<float> A;
+            AlignedVector<float> T;
+            AlignedVector<float> W;
+            std::vector<const float*> rowsA;
+            std::vector<const float*> rowsT;
+            std::vector<const float*> rowsW;
+        };
+        auto data = std::make_shared<Matrices>();
+        data->A = AlignedVector<float>(dim * dim);
+        data->T = AlignedVector<float>(dim * dim);
+        data->W = AlignedVector<float>(dim * dim);
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<float> dist(0, 1);
+        for (size_t c = 0; c < dim * dim; c++){
+            data->A[c] = dist(rng);
+            data->T[c] = dist(rng);
+            data->W[c] = dist(rng);
+        }
+        for (size_t r = 0; r < dim; r++){
+            data->rowsA.emplace_back(data->A.data() + r * dim);
+            data->rowsT.emplace_back(data->T.data() + r * dim);
+            data->rowsW.emplace_back(data->W.data() + r * dim);
+        }
+        std::string suffix = "/" + size_str(dim, dim);
+        size_t bytes = dim * dim * sizeof(float);
+
+        cases.emplace_back(BenchmarkCase{
+            "ScaleInvariantMatrixMatch/compute_scale" + suffix, 2 * bytes, nullptr,
+            [=]{
+                SINK_FLOAT = ScaleInvariantMatrixMatch::compute_scale(
+                    dim, dim, data->rowsA.data(), data->rowsT.data()
+                );
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "ScaleInvariantMatrixMatch/compute_error" + suffix, 2 * bytes, nullptr,
+            [=]{
+                SINK_FLOAT = ScaleInvariantMatrixMatch::compute_error(
+                    dim, dim, 1.1f, data->rowsA.data(), data->rowsT.data()
+                );
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "ScaleInvariantMatrixMatch/compute_error_weighted" + suffix, 3 * bytes, nullptr,
+            [=]{
+                SINK_FLOAT = ScaleInvariantMatrixMatch::compute_error(
+                    dim, dim, 1.1f, data->rowsA.data(), data->rowsT.data(), data->rowsW.data()
+                );
+            }
+        });
+    }
+}
+
+void add_SpikeConvolution(std::vector<BenchmarkCase>& cases){
+    const size_t LENGTH_I = 4096;
+    for (size_t length_k : {64, 512}){
+        struct Buffers{
+            AlignedVector<float> in;
+            AlignedVector<float> kernel;
+            AlignedVector<float> out;
+        };
+        auto data = std::make_shared<Buffers>();
+        data->in = AlignedVector<float>(LENGTH_I);
+        data->kernel = AlignedVector<float>(length_k);
+        data->out = AlignedVector<float>(LENGTH_I + 64);
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<float> dist(-1, 1);
+        for (float& x : data->in){
+            x = dist(rng);
+        }
+        for (float& x : data->kernel){
+            x = dist(rng);
+        }
+
+        cases.emplace_back(BenchmarkCase{
+            "SpikeConvolution/compute_spike_kernel/" + std::to_string(LENGTH_I) + "x" + std::to_string(length_k),
+            LENGTH_I * sizeof(float), nullptr,
+            [=]{
+                SpikeConvolution::compute_spike_kernel(
+                    data->out.data(), data->in.data(), LENGTH_I,
+                    data->kernel.data(), length_k
+                );
+                SINK_FLOAT = data->out[0];
+            }
+        });
+    }
+}
+
+void add_AbsFFT(std::vector<BenchmarkCase>& cases){
+    for (int k : {9, 12}){
+        size_t length = (size_t)1 << k;
+        struct Buffers{
+            AlignedVector<float> input;
+            AlignedVector<float> real;
+            AlignedVector<float> abs;
+        };
+        auto data = std::make_shared<Buffers>();
+        data->input = AlignedVector<float>(length);
+        data->real = AlignedVector<float>(length);
+        data->abs = AlignedVector<float>(length / 2);
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> dist(-1, 1);
+        for (float& x : data->input){
+            x = dist(rng);
+        }
+
+        //  The transform is destructive on its input.
+        cases.emplace_back(BenchmarkCase{
+            "AbsFFT/fft_abs/" + std::to_string(length), length * sizeof(float),
+            [=]{
+                memcpy(data->real.data(), data->input.data(), length * sizeof(float));
+            },
+            [=]{
+                AbsFFT::fft_abs(k, data->abs.data(), data->real.data());
+                SINK_FLOAT = data->abs[1];
+            }
+        });
+    }
+}
+
+void add_AudioStreamConversion(std::vector<BenchmarkCase>& cases){
+    for (size_t length : {1024, 96000}){
+        struct Buffers{
+            std::vector<int16_t> sint16;
+            std::vector<float> f;
+        };
+        auto data = std::make_shared<Buffers>();
+        data->sint16.resize(length);
+        data->f.resize(length);
+        std::mt19937 rng(6);
+        for (int16_t& x : data->sint16){
+            x = (int16_t)rng();
+        }
+        std::string suffix = "/" + std::to_string(length);
+
+        cases.emplace_back(BenchmarkCase{
+            "AudioStreamConversion/sint16_to_float" + suffix, length * sizeof(int16_t), nullptr,
+            [=]{
+                AudioStreamConversion::convert_audio_sint16_to_float(
+                    data->f.data(), data->sint16.data(), length, 1.f / 32768
+                );
+                SINK_FLOAT = data->f[0];
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "AudioStreamConversion/float_to_sint16" + suffix, length * sizeof(float), nullptr,
+            [=]{
+                AudioStreamConversion::convert_audio_float_to_sint16(
+                    data->sint16.data(), data->f.data(), length
+                );
+                SINK_SIZE = data->sint16[0];
+            }
+        });
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Families that dispatch on the binary matrix type.
+
+const char* matrix_type_name(BinaryMatrixType type){
+    switch (type){
+    case BinaryMatrixType::i64x4_Default:       return "64x4-default";
+    case BinaryMatrixType::i64x8_Default:       return "64x8-default";
+    case BinaryMatrixType::i64x8_x64_SSE42:     return "64x8-sse4.2";
+    case BinaryMatrixType::i64x16_x64_AVX2:     return "64x16-avx2";
+    case BinaryMatrixType::i64x32_x64_AVX512:   return "64x32-avx512";
+    case BinaryMatrixType::i64x64_x64_AVX512:   return "64x64-avx512";
+    }
+    return "unknown";
+}
+
+void add_BinaryImageFilters(std::vector<BenchmarkCase>& cases, BinaryMatrixType type){
+    for (const auto& size : IMAGE_SIZES){
+        auto image = std::make_shared<RandomImage>(size.first, size.second, 7);
+        std::shared_ptr<PackedBinaryMatrix_IB> matrix =
+            make_PackedBinaryMatrix(type, size.first, size.second);
+        std::string suffix = "/" + size_str(size.first, size.second);
+
+        cases.emplace_back(BenchmarkCase{
+            "BinaryImageFilters/compress_rgb32_to_binary_range" + suffix, image->bytes(), nullptr,
+            [=]{
+                compress_rgb32_to_binary_range(
+                    image->pixels.data(), image->bytes_per_row(),
+                    *matrix, 0xff000000, 0xff7f7f7f
+                );
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "BinaryImageFilters/compress_rgb32_to_binary_euclidean" + suffix, image->bytes(), nullptr,
+            [=]{
+                compress_rgb32_to_binary_euclidean(
+                    image->pixels.data(), image->bytes_per_row(),
+                    *matrix, 0xff808080, 100
+                );
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "BinaryImageFilters/filter_by_mask" + suffix, image->bytes(), nullptr,
+            [=]{
+                filter_by_mask(
+                    *matrix, image->pixels.data(), image->bytes_per_row(),
+                    0xff000000, true
+                );
+            }
+        });
+    }
+}
+
+void add_Waterfill(std::vector<BenchmarkCase>& cases, BinaryMatrixType type){
+    for (const auto& size : IMAGE_SIZES){
+        //  Random 8x8 blocks so that there are objects of many shapes.
+        RandomImage image(size.first, size.second, 8);
+        std::mt19937 rng(9);
+        std::vector<bool> blocks((size.first / 8 + 1) * (size.second / 8 + 1));
+        for (size_t c = 0; c < blocks.size(); c++){
+            blocks[c] = rng() % 5 < 2;
+        }
+        for (size_t r = 0; r < size.second; r++){
+            for (size_t c = 0; c < size.first; c++){
+                if (blocks[(r / 8) * (size.first / 8 + 1) + c / 8]){
+                    image.pixels[r * size.first + c] = 0xffffffff;
+                }
+            }
+        }
+
+        std::shared_ptr<PackedBinaryMatrix_IB> matrix =
+            make_PackedBinaryMatrix(type, size.first, size.second);
+        compress_rgb32_to_binary_range(
+            image.pixels.data(), image.bytes_per_row(),
+            *matrix, 0xffffffff, 0xffffffff
+        );
+        auto work = std::make_shared<std::unique_ptr<PackedBinaryMatrix_IB>>();
+
+        cases.emplace_back(BenchmarkCase{
+            "Waterfill/find_objects_inplace/" + size_str(size.first, size.second),
+            size.first * size.second / 8,
+            [=]{
+                *work = matrix->clone();
+            },
+            [=]{
+                SINK_SIZE = Waterfill::find_objects_inplace(**work, 10).size();
+            }
+        });
+    }
+}
+
+
+//  What "skip_unchanged_frames()" costs against what it saves. The pivot
+//  computes a region signature of the callback's boxes on every frame. That
+//  is only a win if it is much cheaper than the callback itself.
+//    - "black_screen" is the default box of the black/white screen watchers.
+//      Their whole check is one "image_stats()".
+//    - "dialog_arrow" is the box of the SV dialog arrow. Its check is two
+//      binary filters and a waterfill of each, not counting the template
+//      matching of the objects found.
+void add_SkipUnchanged(std::vector<BenchmarkCase>& cases, BinaryMatrixType type){
+    struct Frame{
+        RandomImage image;
+        ImageViewRGB32 frame;
+        ImageViewRGB32 region;
+        std::vector<ImageFloatBox> boxes;
+
+        Frame(const ImageFloatBox& box)
+            : image(1920, 1080, 11)
+            , frame(image.pixels.data(), image.bytes_per_row(), image.width, image.height)
+            , region(extract_box_reference(frame, box))
+            , boxes{box}
+        {}
+    };
+
+    const std::vector<std::pair<std::string, ImageFloatBox>> BOXES{
+        {"black_screen", {0.1, 0.1, 0.8, 0.8}},
+        {"dialog_arrow", {0.710, 0.850, 0.030, 0.042}},
+    };
+    for (const auto& item : BOXES){
+        auto data = std::make_shared<Frame>(item.second);
+        size_t bytes = data->region.width() * data->region.height() * sizeof(uint32_t);
+
+        cases.emplace_back(BenchmarkCase{
+            "SkipUnchanged/region_signature/" + item.first, bytes, nullptr,
+            [=]{
+                RegionSignature signature(data->frame, data->boxes);
+                SINK_SIZE = (bool)signature;
+            }
+        });
+        cases.emplace_back(BenchmarkCase{
+            "SkipUnchanged/image_stats/" + item.first, bytes, nullptr,
+            [=]{
+                SINK_SIZE = image_stats(data->region).count;
+            }
+        });
+
+        std::shared_ptr<PackedBinaryMatrix_IB> matrix =
+            make_PackedBinaryMatrix(type, data->region.width(), data->region.height());
+        cases.emplace_back(BenchmarkCase{
+            "SkipUnchanged/waterfill_two_ranges/" + item.first, bytes, nullptr,
+            [=]{
+                const ImageViewRGB32& region = data->region;
+                size_t objects = 0;
+                for (auto range : {std::make_pair(0xff000000, 0xff7f7fbf), std::make_pair(0xff808080, 0xffffffff)}){
+                    compress_rgb32_to_binary_range(
+                        region.data(), region.bytes_per_row(),
+                        *matrix, range.first, range.second
+                    );
+                    std::unique_ptr<Waterfill::WaterfillSession> session = Waterfill::make_WaterfillSession(*matrix);
+                    auto finder = session->make_iterator(20);
+                    Waterfill::WaterfillObject object;
+                    while (finder->find_next(object, false)){
+                        objects++;
+                    }
+                }
+                SINK_SIZE = objects;
+            }
+        });
+    }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//  Runner
+
+BenchmarkResult run_case(
+    const KernelBenchmarkOptions& options,
+    const BenchmarkCase& item, const std::string& isa
+){
+    using Clock = std::chrono::steady_clock;
+
+    //  Warm up and find how many calls make a long enough sample.
+    size_t batch = 1;
+    if (!item.setup){
+        while (true){
+            auto start = Clock::now();
+            for (size_t c = 0; c < batch; c++){
+                item.run();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (seconds >= options.min_sample_seconds || batch >= ((size_t)1 << 24)){
+                break;
+            }
+            batch *= 2;
+        }
+    }else{
+        for (size_t c = 0; c < 3; c++){
+            item.setup();
+            item.run();
+        }
+    }
+
+    size_t samples = std::max<size_t>(options.samples, 1);
+    std::vector<double> ns;
+    std::vector<double> cycles;
+    for (size_t s = 0; s < samples; s++){
+        if (item.setup){
+            item.setup();
+        }
+        auto start = Clock::now();
+        uint64_t start_cycles = read_cycles();
+        for (size_t c = 0; c < batch; c++){
+            item.run();
+        }
+        uint64_t end_cycles = read_cycles();
+        auto end = Clock::now();
+        ns.emplace_back(std::chrono::duration<double, std::nano>(end - start).count() / batch);
+        cycles.emplace_back((double)(end_cycles - start_cycles) / batch);
+    }
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+
+    size_t p95 = (size_t)std::ceil(0.95 * samples) - 1;
+    return BenchmarkResult{
+        item.name, isa, item.bytes, batch,
+        ns[samples / 2], ns[p95], cycles[samples / 2],
+    };
+}
+
+std::string result_key(const std::string& name, const std::string& isa){
+    return name + " [" + isa + "]";
+}
+
+void print_result(const BenchmarkResult& result){
+    cout << result_key(result.name, result.isa) << ": median = " << result.median_ns
+         << " ns, p95 = " << result.p95_ns << " ns, " << result.bytes / result.median_ns << " bytes/ns";
+    if (result.median_cycles > 0){
+        cout << ", " << result.bytes / result.median_cycles << " bytes/cycle";
+    }
+    cout << endl;
+}
+
+JsonObject to_json(const std::vector<BenchmarkResult>& results){
+    JsonArray array;
+    for (const BenchmarkResult& result : results){
+        JsonObject obj;
+        obj["name"] = result.name;
+        obj["isa"] = result.isa;
+        obj["bytes"] = (int64_t)result.bytes;
+        obj["batch"] = (int64_t)result.batch;
+        obj["median_ns"] = result.median_ns;
+        obj["p95_ns"] = result.p95_ns;
+        obj["bytes_per_ns"] = result.bytes / result.median_ns;
+        if (result.median_cycles > 0){
+            obj["median_cycles"] = result.median_cycles;
+            obj["bytes_per_cycle"] = result.bytes / result.median_cycles;
+        }
+        array.push_back(std::move(obj));
+    }
+    JsonObject root;
+    root["arch"] = PA_ARCH_STRING;
+    root["results"] = std::move(array);
+    return root;
+}
+
+//  Returns the number of regressions.
+size_t compare_to_baseline(
+    const KernelBenchmarkOptions& options,
+    const std::vector<BenchmarkResult>& results
+){
+    JsonValue json = load_json_file(options.baseline_file);
+    const JsonArray& array = json.get_object_throw(options.baseline_file).get_array_throw("results", options.baseline_file);
+
+    std::map<std::string, double> baseline;
+    for (const JsonValue& item : array){
+        const JsonObject& obj = item.get_object_throw(options.baseline_file);
+        baseline[result_key(
+            obj.get_string_throw("name", options.baseline_file),
+            obj.get_string_throw("isa", options.baseline_file)
+        )] = obj.get_double_throw("median_ns", options.baseline_file);
+    }
+
+    size_t regressions = 0;
+    size_t compared = 0;
+    for (const BenchmarkResult& result : results){
+        std::string key = result_key(result.name, result.isa);
+        auto iter = baseline.find(key);
+        if (iter == baseline.end()){
+            continue;
+        }
+        compared++;
+        double ratio = result.median_ns / iter->second;
+        if (ratio > 1 + options.tolerance){
+            regressions++;
+            cout << "REGRESSION: " << key << ": " << result.median_ns << " ns vs. "
+                 << iter->second << " ns in baseline (+" << (ratio - 1) * 100 << "%)" << endl;
+        }
+    }
+    cout << "Compared " << compared << " of " << results.size() << " cases against the baseline." << endl;
+    return regressions;
+}
+
+
+}
+
+
+
+int run_kernel_benchmarks(const KernelBenchmarkOptions& options){
+    std::vector<BenchmarkResult> results;
+    auto run_all = [&](const std::vector<BenchmarkCase>& cases, const std::string& isa){
+        for (const BenchmarkCase& item : cases){
+            if (item.name.find(options.filter) == std::string::npos){
+                continue;
+            }
+            results.emplace_back(run_case(options, item, isa));
+            print_result(results.back());
+        }
+    };
+
+    //  Run the CPU-dispatched families under each instruction set.
+    const CPU_Features original = CPU_CAPABILITY_CURRENT;
+    for (const CpuCapabilityOption& option : AVAILABLE_CAPABILITIES()){
+        if (!option.available){
+            continue;
+        }
+        CPU_CAPABILITY_CURRENT = option.features;
+        std::vector<BenchmarkCase> cases;
+        add_ImageStats(cases);
+        add_ImageFilter(cases);
+        add_ImageGradient(cases);
+        add_ScaleInvariantMatrixMatch(cases);
+        add_SpikeConvolution(cases);
+        add_AbsFFT(cases);
+        add_AudioStreamConversion(cases);
+        run_all(cases, option.slug);
+    }
+    CPU_CAPABILITY_CURRENT = original;
+
+    //  Run the binary matrix families for each matrix type.
+    for (BinaryMatrixType type : {
+        BinaryMatrixType::i64x4_Default,
+        BinaryMatrixType::i64x8_x64_SSE42,
+        BinaryMatrixType::i64x16_x64_AVX2,
+        BinaryMatrixType::i64x32_x64_AVX512,
+        BinaryMatrixType::i64x64_x64_AVX512,
+    }){
+        if (!BinaryMatrixType_available(type)){
+            continue;
+        }
+        std::vector<BenchmarkCase> cases;
+        add_BinaryImageFilters(cases, type);
+        add_Waterfill(cases, type);
+        add_SkipUnchanged(cases, type);
+        run_all(cases, matrix_type_name(type));
+    }
+
+    if (!options.output_file.empty()){
+        to_json(results).dump(options.output_file);
+        cout << "Results written to: " << options.output_file << endl;
+    }
+
+    if (options.baseline_file.empty()){
+        return 0;
+    }
+    size_t regressions = compare_to_baseline(options, results);
+    if (regressions != 0){
+        cout << regressions << " case(s) regressed by more than " << options.tolerance * 100 << "%." << endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+
+}
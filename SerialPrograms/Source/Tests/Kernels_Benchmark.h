@@ -0,0 +1,52 @@
+/*  Kernels Benchmark
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Micro-benchmarks of the kernels in "Kernels/". Every family is run
+ *  under every instruction set that was compiled in and that this CPU
+ *  supports, at a small and a full-frame size.
+ *
+ *  Each case is warmed up, then timed over a number of samples. The results
+ *  (median, p95 and throughput) are printed and can be written as JSON.
+ *  Passing the JSON of an earlier run as the baseline fails the run if any
+ *  case got slower than the tolerance allows.
+ *
+ *  Baselines are only meaningful on the machine they were recorded on.
+ *
+ */
+
+#ifndef PokemonAutomation_Tests_Kernels_Benchmark_H
+#define PokemonAutomation_Tests_Kernels_Benchmark_H
+
+#include <string>
+
+namespace PokemonAutomation{
+
+
+struct KernelBenchmarkOptions{
+    //  Only run cases whose name contains this.
+    std::string filter;
+
+    size_t samples = 31;
+
+    //  Calls are batched until each sample takes at least this long.
+    double min_sample_seconds = 0.0002;
+
+    //  Write the results here as JSON. Empty to skip.
+    std::string output_file;
+
+    //  Compare the medians against the results in this file. Empty to skip.
+    std::string baseline_file;
+
+    //  How much slower than the baseline a case may get before it fails.
+    double tolerance = 0.15;
+};
+
+
+//  Returns 0 if there are no regressions against the baseline.
+int run_kernel_benchmarks(const KernelBenchmarkOptions& options);
+
+
+
+}
+#endif
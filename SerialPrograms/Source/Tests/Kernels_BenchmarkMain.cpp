@@ -0,0 +1,66 @@
+/*  Kernels Benchmark
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      Entry point of the "SerialProgramsKernelBenchmark" executable.
+ *
+ *  Usage:
+ *      SerialProgramsKernelBenchmark
+ *          [--filter <substring>]      Only run cases whose name contains this.
+ *          [--samples <count>]         Timed samples per case. (default 31)
+ *          [--output <file>]           Write the results as JSON.
+ *          [--baseline <file>]         Fail if slower than these results.
+ *          [--tolerance <fraction>]    Allowed slowdown. (default 0.15)
+ *
+ */
+
+#include <stdlib.h>
+#include <string>
+#include <iostream>
+#include "Common/Cpp/Exceptions.h"
+#include "Kernels_Benchmark.h"
+
+using std::cout;
+using std::cerr;
+using std::endl;
+
+using namespace PokemonAutomation;
+
+
+int main(int argc, char* argv[]){
+    KernelBenchmarkOptions options;
+    for (int c = 1; c < argc; c++){
+        std::string arg = argv[c];
+        if (arg == "--help" || arg == "-h"){
+            cout << "Usage: " << argv[0] << " [--filter <substring>] [--samples <count>]"
+                 << " [--output <file>] [--baseline <file>] [--tolerance <fraction>]" << endl;
+            return 0;
+        }
+        if (c + 1 >= argc){
+            cerr << "Missing value for: " << arg << endl;
+            return 2;
+        }
+        std::string value = argv[++c];
+        if (arg == "--filter"){
+            options.filter = value;
+        }else if (arg == "--samples"){
+            options.samples = (size_t)atoll(value.c_str());
+        }else if (arg == "--output"){
+            options.output_file = value;
+        }else if (arg == "--baseline"){
+            options.baseline_file = value;
+        }else if (arg == "--tolerance"){
+            options.tolerance = atof(value.c_str());
+        }else{
+            cerr << "Unknown argument: " << arg << endl;
+            return 2;
+        }
+    }
+
+    try{
+        return run_kernel_benchmarks(options);
+    }catch (Exception& e){
+        cerr << e.to_str() << endl;
+        return 2;
+    }
+}
@@ -5,11 +5,24 @@
  */
 
 
+#include <cmath>
+#include <algorithm>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Time.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "CommonFramework/ImageTools/ImageBoxes.h"
+#include "CommonFramework/ImageTools/ImageFilter.h"
+#include "CommonFramework/ImageTools/ImageStats.h"
+#include "CommonFramework/ImageMatch/ImageDiff.h"
+#include "CommonFramework/ImageMatch/ExactImageMatcher.h"
+#include "CommonFramework/ImageMatch/SilhouetteDictionaryMatcher.h"
 #include "Kernels/ImageScaleBrightness/Kernels_ImageScaleBrightness.h"
+#include "Kernels/ImageFilters/Kernels_ImageFilter_Basic.h"
+#include "Kernels/ImageGradient/Kernels_ImageGradient.h"
+#include "PokemonSwSh/Inference/PokemonSwSh_PokemonSpriteReader.h"
+#include "PokemonSV/Resources/PokemonSV_PokemonSprites.h"
+#include "TestUtils.h"
 #include "Kernels_Tests.h"
 
 #include <iostream>
@@ -40,4 +53,349 @@ int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image){
     return 0;
 }
 
+
+
+namespace{
+//  Sub-images of "image" of different sizes for comparing kernels against a
+//  reference. They start at an odd column so the rows are not aligned.
+std::vector<ImageViewRGB32> make_test_sub_images(const ImageViewRGB32& image){
+    std::vector<ImageViewRGB32> ret;
+    for (size_t width : {(size_t)1, (size_t)3, (size_t)5, (size_t)13, (size_t)15, (size_t)17, (size_t)37, image.width()}){
+        for (size_t height : {(size_t)1, (size_t)4, (size_t)19, image.height()}){
+            if (width > image.width() || height > image.height()){
+                continue;
+            }
+            size_t x = width < image.width() ? 1 : 0;
+            ret.emplace_back(image.sub_image(x, 0, width, height));
+        }
+    }
+    return ret;
+}
+}
+
+
+
+//  The smoothing and gradients as the sprite reader computed them one pixel at
+//  a time before they became kernels.
+namespace{
+uint32_t reference_smooth5_pixel(const ImageViewRGB32& image, size_t x, size_t y, bool vertical){
+    const float filter[5] = {0.062f, 0.244f, 0.388f, 0.244f, 0.062f};
+    size_t pos = vertical ? y : x;
+    size_t length = vertical ? image.height() : image.width();
+    float sum[3] = {0, 0, 0};
+    float weights = 0;
+    for (size_t i = 0; i < 5; i++){
+        if (pos + i < 2 || pos + i >= length + 2){
+            continue;
+        }
+        uint32_t p = vertical ? image.pixel(x, y + i - 2) : image.pixel(x + i - 2, y);
+        if ((p >> 24) < 128){
+            continue;
+        }
+        weights += filter[i];
+        for (int ch = 0; ch < 3; ch++){
+            sum[ch] += filter[i] * ((p >> (16 - ch * 8)) & 0xff);
+        }
+    }
+    if (weights == 0){
+        return 0;
+    }
+    uint8_t c[3];
+    for (int ch = 0; ch < 3; ch++){
+        c[ch] = (uint8_t)std::min(std::max(int(sum[ch] / weights + 0.5f), 0), 255);
+    }
+    return combine_rgb(c[0], c[1], c[2]);
+}
+bool reference_sobel_pixel(const ImageViewRGB32& image, size_t x, size_t y, int& gx, int& gy){
+    const int kx[3][3] = {{-1, 0, 1}, {-2, 0, 2}, {-1, 0, 1}};
+    const int ky[3][3] = {{1, 2, 1}, {0, 0, 0}, {-1, -2, -1}};
+    gx = 0;
+    gy = 0;
+    for (size_t sy = 0; sy < 3; sy++){
+        for (size_t sx = 0; sx < 3; sx++){
+            uint32_t p = image.pixel(x + sx, y + sy);
+            if ((p >> 24) < 128){
+                return false;
+            }
+            int c = (p & 0xff) + ((p >> 8) & 0xff) + ((p >> 16) & 0xff);
+            gx += c * kx[sy][sx];
+            gy += c * ky[sy][sx];
+        }
+    }
+    return true;
+}
+}
+
+int test_kernels_ImageGradient(const ImageViewRGB32& source){
+    //  Punch transparent holes into the image so both the smoothing and the
+    //  gradients have pixels to skip.
+    ImageRGB32 image = source.copy();
+    for (size_t r = 0; r < image.height(); r++){
+        for (size_t c = 0; c < image.width(); c++){
+            if ((r / 7 + c / 5) % 4 == 0 || (r * 31 + c * 17) % 53 == 0){
+                image.pixel(c, r) &= 0x7fffffff;
+            }
+        }
+    }
+
+    const float filter[5] = {0.062f, 0.244f, 0.388f, 0.244f, 0.062f};
+    for (const ImageViewRGB32& sub : make_test_sub_images(image)){
+        size_t width = sub.width();
+        size_t height = sub.height();
+
+        ImageRGB32 rows(width, height);
+        smooth5_rgb32_rows(
+            width, height, sub.data(), sub.bytes_per_row(),
+            rows.data(), rows.bytes_per_row(), filter
+        );
+        ImageRGB32 columns(width, height);
+        smooth5_rgb32_columns(
+            width, height, rows.data(), rows.bytes_per_row(),
+            columns.data(), columns.bytes_per_row(), filter
+        );
+        for (size_t r = 0; r < height; r++){
+            for (size_t c = 0; c < width; c++){
+                TEST_RESULT_EQUAL(rows.pixel(c, r), reference_smooth5_pixel(sub, c, r, false));
+                TEST_RESULT_EQUAL(columns.pixel(c, r), reference_smooth5_pixel(rows, c, r, true));
+            }
+        }
+
+        if (width < 3 || height < 3){
+            continue;
+        }
+        size_t out_width = width - 2;
+        size_t out_height = height - 2;
+        std::vector<int16_t> gx(out_width * out_height);
+        std::vector<int16_t> gy(out_width * out_height);
+        std::vector<uint8_t> valid(out_width * out_height);
+        sobel_gradient_rgb32(
+            width, height, sub.data(), sub.bytes_per_row(),
+            gx.data(), gy.data(), valid.data(), out_width
+        );
+        for (size_t r = 0; r < out_height; r++){
+            for (size_t c = 0; c < out_width; c++){
+                size_t index = r * out_width + c;
+                int expected_gx;
+                int expected_gy;
+                bool expected_valid = reference_sobel_pixel(sub, c, r, expected_gx, expected_gy);
+                TEST_RESULT_EQUAL((int)valid[index], expected_valid ? 1 : 0);
+                TEST_RESULT_EQUAL(gx[index], expected_valid ? expected_gx : 0);
+                TEST_RESULT_EQUAL(gy[index], expected_valid ? expected_gy : 0);
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+//  ExactImageMatcher before the closed form: brightness-scale a copy of the
+//  template, then run the deviation kernel on the copy.
+namespace{
+ImageRGB32 reference_scale_template_brightness(const ImageViewRGB32& sprite, const ImageViewRGB32& image){
+    FloatPixel image_brightness = ImageMatch::pixel_average(image, sprite);
+    FloatPixel scale = image_brightness / image_stats(sprite).average;
+
+    if (std::isnan(scale.r)) scale.r = 1.0;
+    if (std::isnan(scale.g)) scale.g = 1.0;
+    if (std::isnan(scale.b)) scale.b = 1.0;
+    scale.bound(0.8, 1.2);
+
+    ImageRGB32 ret = sprite.copy();
+    ImageMatch::scale_brightness(ret, scale);
+    return ret;
+}
+}
+
+int test_kernels_ImageScaledDeviation(const ImageViewRGB32& image){
+    //  The old path rounds the scaled template to integers. That moves each
+    //  channel by at most 0.5, so each pixel by at most sqrt(3) / 2.
+    const double TOLERANCE = 0.87;
+
+    size_t width = std::min<size_t>(image.width(), 64);
+    size_t height = std::min<size_t>(image.height(), 48);
+
+    //  Template with transparent holes, like a trimmed sprite.
+    ImageRGB32 sprite = image.sub_image(0, 0, width, height).copy();
+    for (size_t r = 0; r < height; r++){
+        for (size_t c = 0; c < width; c++){
+            if ((r / 5 + c / 3) % 4 == 0 || (r * 31 + c * 17) % 41 == 0){
+                sprite.pixel(c, r) &= 0x00ffffff;
+            }else{
+                sprite.pixel(c, r) |= 0xff000000;
+            }
+        }
+    }
+    ImageMatch::ExactImageMatcher matcher(sprite.copy());
+
+    //  Inputs: the template region at brightness scales inside and outside
+    //  the allowed range, the template region with its own holes for the
+    //  masked mode, and a differently sized input that has to be scaled.
+    std::vector<ImageRGB32> inputs;
+    for (double scale : {1.0, 0.7, 0.9, 1.1, 1.4}){
+        ImageRGB32 input = image.sub_image(0, 0, width, height).copy();
+        for (size_t r = 0; r < height; r++){
+            for (size_t c = 0; c < width; c++){
+                input.pixel(c, r) |= 0xff000000;
+            }
+        }
+        ImageMatch::scale_brightness(input, FloatPixel(scale, scale, scale));
+        inputs.emplace_back(std::move(input));
+    }
+    {
+        ImageRGB32 input = inputs[0].copy();
+        for (size_t r = 0; r < height; r++){
+            for (size_t c = 0; c < width; c++){
+                if ((r / 3 + c / 7) % 5 == 0){
+                    input.pixel(c, r) &= 0x00ffffff;
+                }
+            }
+        }
+        inputs.emplace_back(std::move(input));
+    }
+    inputs.emplace_back(image.copy());
+
+    const Color background(0xff406080);
+    for (const ImageRGB32& input : inputs){
+        ImageRGB32 scaled = input.scale_to(width, height);
+        ImageRGB32 reference = reference_scale_template_brightness(sprite, scaled);
+
+        TEST_RESULT_APPROXIMATE(matcher.rmsd(input), ImageMatch::pixel_RMSD(reference, scaled), TOLERANCE);
+        TEST_RESULT_APPROXIMATE(matcher.rmsd(input, background), ImageMatch::pixel_RMSD(reference, scaled, background), TOLERANCE);
+        TEST_RESULT_APPROXIMATE(matcher.rmsd_masked(input), ImageMatch::pixel_RMSD_masked(reference, scaled), TOLERANCE);
+    }
+
+    return 0;
+}
+
+
+//  The dictionary matchers skip templates whose lower bound is already out of
+//  the results. Check that this never changes the results by scoring every
+//  template of the real sprite sets.
+namespace{
+int compare_match_results(const ImageMatch::ImageMatchResult& result, const ImageMatch::ImageMatchResult& target){
+    TEST_RESULT_EQUAL(result.results.size(), target.results.size());
+    auto iter = target.results.begin();
+    for (const auto& item : result.results){
+        TEST_RESULT_EQUAL(item.first, iter->first);
+        TEST_RESULT_EQUAL(item.second, iter->second);
+        ++iter;
+    }
+    return 0;
+}
+ImageMatch::SilhouetteDictionaryMatcher make_tera_silhouette_matcher(){
+    //  Same as the Tera raid silhouette reader.
+    ImageMatch::SilhouetteDictionaryMatcher matcher;
+    for (const auto& item : NintendoSwitch::PokemonSV::ALL_POKEMON_SILHOUETTES()){
+        if (item.first == "pm1084_00_00_00_big" ||
+            item.first == "pm1091_00_00_00_big" ||
+            item.first == "error") {
+            continue;
+        }
+        matcher.add(item.first, to_blackwhite_rgb32_range(item.second.icon, 0xff000000, 0xff5f5f5f, true));
+    }
+    return matcher;
+}
+}
+
+int test_kernels_ImageMatch(const ImageViewRGB32& image){
+    static const ImageMatch::SilhouetteDictionaryMatcher silhouettes = make_tera_silhouette_matcher();
+    static const NintendoSwitch::PokemonSwSh::PokemonSpriteMatcherCropped sprites(nullptr);
+
+    ImageRGB32 silhouette = to_blackwhite_rgb32_range(image, 0xff000000, 0xff5f5f5f, true);
+
+    for (double spread : {0., 20., 100.}){
+        auto time0 = current_time();
+        ImageMatch::ImageMatchResult silhouette_result = silhouettes.match(silhouette, spread);
+        auto time1 = current_time();
+        ImageMatch::ImageMatchResult silhouette_target = silhouettes.match_exhaustive(silhouette, spread);
+        auto time2 = current_time();
+        ImageMatch::ImageMatchResult sprite_result = sprites.match(image, spread);
+        auto time3 = current_time();
+        ImageMatch::ImageMatchResult sprite_target = sprites.match_exhaustive(image, spread);
+        auto time4 = current_time();
+
+        cout << "Spread " << spread << ": silhouettes "
+             << std::chrono::duration_cast<Milliseconds>(time1 - time0).count() << " ms vs. "
+             << std::chrono::duration_cast<Milliseconds>(time2 - time1).count() << " ms exhaustive, sprites "
+             << std::chrono::duration_cast<Milliseconds>(time3 - time2).count() << " ms vs. "
+             << std::chrono::duration_cast<Milliseconds>(time4 - time3).count() << " ms exhaustive" << endl;
+
+        if (compare_match_results(silhouette_result, silhouette_target) != 0){
+            return 1;
+        }
+        if (compare_match_results(sprite_result, sprite_target) != 0){
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+int test_kernels_ImageFilterSets(const ImageViewRGB32& image){
+    std::vector<std::vector<Rgb32Range>> sets{
+        {std::begin(BlackTextRanges::RANGES), std::end(BlackTextRanges::RANGES)},
+        {std::begin(WhiteTextRanges::RANGES), std::end(WhiteTextRanges::RANGES)},
+        {std::begin(BlackOrWhiteTextRanges::RANGES), std::end(BlackOrWhiteTextRanges::RANGES)},
+    };
+    std::vector<std::vector<Rgb32Range>> replace_sets{
+        {std::begin(MountBrightRanges::RANGES), std::end(MountBrightRanges::RANGES)},
+        {std::begin(MountYellowRanges::RANGES), std::end(MountYellowRanges::RANGES)},
+    };
+    //  The same filters in reverse order run the generic kernel.
+    for (size_t c = 0, stop = sets.size(); c < stop; c++){
+        sets.emplace_back(sets[c].rbegin(), sets[c].rend());
+    }
+    for (size_t c = 0, stop = replace_sets.size(); c < stop; c++){
+        replace_sets.emplace_back(replace_sets[c].rbegin(), replace_sets[c].rend());
+    }
+
+    for (const ImageViewRGB32& sub : make_test_sub_images(image)){
+        for (const std::vector<Rgb32Range>& ranges : sets){
+            std::vector<BlackWhiteRgb32Range> filters;
+            for (const Rgb32Range& range : ranges){
+                filters.emplace_back(BlackWhiteRgb32Range{range.mins, range.maxs, true});
+            }
+            std::vector<std::pair<ImageRGB32, size_t>> results = to_blackwhite_rgb32_range(sub, filters);
+            TEST_RESULT_EQUAL(results.size(), ranges.size());
+            for (size_t i = 0; i < ranges.size(); i++){
+                size_t expected_count;
+                ImageRGB32 expected = to_blackwhite_rgb32_range(
+                    expected_count, sub, ranges[i].mins, ranges[i].maxs, true
+                );
+                TEST_RESULT_EQUAL(results[i].second, expected_count);
+                for (size_t r = 0; r < sub.height(); r++){
+                    for (size_t c = 0; c < sub.width(); c++){
+                        TEST_RESULT_EQUAL(results[i].first.pixel(c, r), expected.pixel(c, r));
+                    }
+                }
+            }
+        }
+
+        for (const std::vector<Rgb32Range>& ranges : replace_sets){
+            std::vector<FilterRgb32Range> filters;
+            for (const Rgb32Range& range : ranges){
+                filters.emplace_back(FilterRgb32Range{range.mins, range.maxs, COLOR_BLACK, false});
+            }
+            std::vector<std::pair<ImageRGB32, size_t>> results = filter_rgb32_range(sub, filters);
+            TEST_RESULT_EQUAL(results.size(), ranges.size());
+            for (size_t i = 0; i < ranges.size(); i++){
+                size_t expected_count;
+                ImageRGB32 expected = filter_rgb32_range(
+                    expected_count, sub, ranges[i].mins, ranges[i].maxs, COLOR_BLACK, false
+                );
+                TEST_RESULT_EQUAL(results[i].second, expected_count);
+                for (size_t r = 0; r < sub.height(); r++){
+                    for (size_t c = 0; c < sub.width(); c++){
+                        TEST_RESULT_EQUAL(results[i].first.pixel(c, r), expected.pixel(c, r));
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
 }
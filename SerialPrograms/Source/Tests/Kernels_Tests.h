@@ -9,12 +9,22 @@
 #ifndef PokemonAutomation_Tests_Kernels_Tests_H
 #define PokemonAutomation_Tests_Kernels_Tests_H
 
+#include <string>
+
 namespace PokemonAutomation{
 
 class ImageViewRGB32;
 
 int test_kernels_ImageScaleBrightness(const ImageViewRGB32& image);
 
+int test_kernels_ImageGradient(const ImageViewRGB32& image);
+
+int test_kernels_ImageScaledDeviation(const ImageViewRGB32& image);
+
+int test_kernels_ImageMatch(const ImageViewRGB32& image);
+
+int test_kernels_ImageFilterSets(const ImageViewRGB32& image);
+
 }
 
 #endif
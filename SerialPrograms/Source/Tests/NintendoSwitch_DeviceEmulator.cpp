@@ -0,0 +1,558 @@
+/*  Device Emulator
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+#include <string.h>
+#include <set>
+#include <algorithm>
+#include <sstream>
+#include "Common/CRC32.h"
+#include "Common/Cpp/PanicDump.h"
+#include "Common/PokemonSwSh/PokemonProgramIDs.h"
+#include "Common/NintendoSwitch/NintendoSwitch_Protocol_PushButtons.h"
+#include "Common/NintendoSwitch/NintendoSwitch_Protocol_ScalarButtons.h"
+#include "NintendoSwitch_DeviceEmulator.h"
+
+//#include <iostream>
+//using std::cout;
+//using std::endl;
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+
+bool EmulatedControllerState::same_input(const EmulatedControllerState& x) const{
+    return
+        buttons == x.buttons &&
+        dpad == x.dpad &&
+        left_x == x.left_x && left_y == x.left_y &&
+        right_x == x.right_x && right_y == x.right_y;
+}
+std::string EmulatedControllerState::to_str() const{
+    std::ostringstream ss;
+    ss << "tick = " << tick;
+    ss << ", buttons = " << buttons;
+    ss << ", dpad = " << (int)dpad;
+    ss << ", left = (" << (int)left_x << ", " << (int)left_y << ")";
+    ss << ", right = (" << (int)right_x << ", " << (int)right_y << ")";
+    return ss.str();
+}
+
+
+
+DeviceEmulator::DeviceEmulator(uint32_t protocol_version)
+    : m_protocol_version(protocol_version)
+    , m_thread(run_with_catch, "DeviceEmulator::thread_loop()", [this]{ thread_loop(); })
+{}
+DeviceEmulator::~DeviceEmulator(){
+    stop();
+}
+void DeviceEmulator::stop(){
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stopping = true;
+        m_cv.notify_all();
+    }
+    if (m_thread.joinable()){
+        m_thread.join();
+    }
+}
+void DeviceEmulator::send(const void* data, size_t bytes){
+    //  The host may call this with its own locks held. So only queue it here.
+    //  Everything else happens on the emulator thread.
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_inbox.append((const char*)data, bytes);
+    m_cv.notify_all();
+}
+
+DeviceEmulatorStats DeviceEmulator::stats() const{
+    std::lock_guard<std::mutex> lg(m_state_lock);
+    return m_stats;
+}
+uint64_t DeviceEmulator::current_tick() const{
+    std::lock_guard<std::mutex> lg(m_state_lock);
+    return m_now;
+}
+
+
+void DeviceEmulator::thread_loop(){
+    while (true){
+        std::string input;
+        {
+            std::unique_lock<std::mutex> lg(m_lock);
+            m_cv.wait(lg, [this]{ return m_stopping || !m_inbox.empty(); });
+            if (m_stopping){
+                return;
+            }
+            input.swap(m_inbox);
+        }
+        {
+            std::lock_guard<std::mutex> lg(m_state_lock);
+            m_stats.bytes_received += input.size();
+        }
+        m_recv_buffer += input;
+
+        std::string outbox;
+        process_frames(outbox);
+
+        //  No locks may be held here. The host sends acks from inside this.
+        if (!outbox.empty()){
+            on_recv(outbox.data(), outbox.size());
+        }
+    }
+}
+void DeviceEmulator::process_frames(std::string& outbox){
+    size_t head = 0;
+    while (head < m_recv_buffer.size()){
+        const char* message = m_recv_buffer.data() + head;
+        size_t available = m_recv_buffer.size() - head;
+        uint8_t length = ~message[0];
+
+        if (message[0] == 0 || length < PABB_PROTOCOL_OVERHEAD || length > PABB_MAX_PACKET_SIZE){
+            head++;
+            continue;
+        }
+        if (length > available){
+            break;
+        }
+
+        uint32_t checksumA = pabb_crc32(0xffffffff, message, length - sizeof(uint32_t));
+        uint32_t checksumE;
+        memcpy(&checksumE, message + length - sizeof(uint32_t), sizeof(uint32_t));
+        if (checksumA != checksumE){
+            head++;
+            continue;
+        }
+
+        process_message(message[1], std::string(message + 2, length - PABB_PROTOCOL_OVERHEAD), outbox);
+        head += length;
+    }
+    m_recv_buffer.erase(0, head);
+}
+
+
+void DeviceEmulator::append_message(std::string& outbox, uint8_t type, const std::string& body){
+    std::string buffer;
+    buffer += ~(uint8_t)(PABB_PROTOCOL_OVERHEAD + body.size());
+    buffer += type;
+    buffer += body;
+    buffer += std::string(sizeof(uint32_t), 0);
+    pabb_crc32_write_to_message(&buffer[0], buffer.size());
+    outbox += buffer;
+}
+
+void DeviceEmulator::process_message(uint8_t type, const std::string& body, std::string& outbox){
+    //  Acks for our own finish messages. There are no retransmits to cancel.
+    if (!PABB_MSG_IS_REQUEST_OR_COMMAND(type)){
+        return;
+    }
+    if (body.size() < sizeof(seqnum_t)){
+        return;
+    }
+    seqnum_t seqnum;
+    memcpy(&seqnum, body.data(), sizeof(seqnum_t));
+
+    {
+        std::lock_guard<std::mutex> lg(m_state_lock);
+        m_stats.messages++;
+    }
+
+    if (type == PABB_MSG_SEQNUM_RESET){
+        m_expected_seqnum = seqnum + 1;
+        pabb_MsgAckRequest ack{seqnum};
+        append_message(outbox, PABB_MSG_ACK_REQUEST, ack);
+        return;
+    }
+
+    int32_t ahead = (int32_t)(seqnum - m_expected_seqnum);
+    if (ahead > 0){
+        pabb_MsgInfoMissedRequest error{seqnum};
+        append_message(outbox, PABB_MSG_ERROR_MISSED_REQUEST, error);
+        return;
+    }
+    bool retransmit = ahead < 0;
+    if (!retransmit){
+        m_expected_seqnum++;
+    }
+
+    if (PABB_MSG_IS_REQUEST(type)){
+        {
+            std::lock_guard<std::mutex> lg(m_state_lock);
+            m_stats.requests++;
+            m_stats.retransmits += retransmit;
+        }
+        //  All the requests are safe to repeat.
+        if (!process_request(type, body, outbox)){
+            pabb_MsgInfoInvalidType error{type};
+            append_message(outbox, PABB_MSG_ERROR_INVALID_TYPE, error);
+        }
+        return;
+    }
+
+    pabb_MsgAckCommand ack{seqnum};
+    append_message(outbox, PABB_MSG_ACK_COMMAND, ack);
+    {
+        std::lock_guard<std::mutex> lg(m_state_lock);
+        m_stats.commands++;
+        m_stats.retransmits += retransmit;
+    }
+    if (retransmit){
+        return;
+    }
+
+    run_command(type, body);
+
+    pabb_MsgRequestCommandFinished finished;
+    finished.seqnum = m_send_seqnum++;
+    finished.seq_of_original_command = seqnum;
+    finished.finish_time = (uint32_t)current_tick();
+    append_message(outbox, PABB_MSG_REQUEST_COMMAND_FINISHED, finished);
+}
+bool DeviceEmulator::process_request(uint8_t type, const std::string& body, std::string& outbox){
+    seqnum_t seqnum;
+    memcpy(&seqnum, body.data(), sizeof(seqnum_t));
+
+    switch (type){
+    case PABB_MSG_REQUEST_PROTOCOL_VERSION:{
+        pabb_MsgAckRequestI32 ack{seqnum, m_protocol_version};
+        append_message(outbox, PABB_MSG_ACK_REQUEST_I32, ack);
+        return true;
+    }
+    case PABB_MSG_REQUEST_PROGRAM_VERSION:{
+        pabb_MsgAckRequestI32 ack{seqnum, PABB_PROGRAM_VERSION};
+        append_message(outbox, PABB_MSG_ACK_REQUEST_I32, ack);
+        return true;
+    }
+    case PABB_MSG_REQUEST_PROGRAM_ID:{
+        pabb_MsgAckRequestI8 ack{seqnum, PABB_PID_PABOTBASE_31KB};
+        append_message(outbox, PABB_MSG_ACK_REQUEST_I8, ack);
+        return true;
+    }
+    case PABB_MSG_REQUEST_CLOCK:{
+        pabb_MsgAckRequestI32 ack{seqnum, (uint32_t)current_tick()};
+        append_message(outbox, PABB_MSG_ACK_REQUEST_I32, ack);
+        return true;
+    }
+    case PABB_MSG_REQUEST_STOP:
+    case PABB_MSG_REQUEST_NEXT_CMD_INTERRUPT:{
+        //  Commands finish as soon as they arrive. There is nothing to stop.
+        pabb_MsgAckRequest ack{seqnum};
+        append_message(outbox, PABB_MSG_ACK_REQUEST, ack);
+        return true;
+    }
+    case PABB_MSG_REQUEST_MACRO_LOAD:{
+        if (m_protocol_version < PABB_MACRO_PROTOCOL_VERSION || body.size() != sizeof(pabb_macro_load)){
+            return false;
+        }
+        const pabb_macro_load* params = (const pabb_macro_load*)body.data();
+        for (size_t c = 0; c < PABB_MACRO_LOAD_BYTES; c++){
+            size_t index = (size_t)params->offset + c;
+            if (index < PABB_MACRO_BUFFER_SIZE){
+                m_macro_buffer[index] = params->data[c];
+            }
+        }
+        pabb_MsgAckRequest ack{seqnum};
+        append_message(outbox, PABB_MSG_ACK_REQUEST, ack);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+
+
+void DeviceEmulator::press(
+    uint8_t resource, uint8_t x, uint8_t y,
+    uint16_t delay, uint16_t hold, uint8_t cool
+){
+    //  A held or cooling input can't be pressed again. Stall until it's ready.
+    uint64_t start = std::max(m_now, m_free_at[resource]);
+    if (hold > 0){
+        m_inputs.emplace_back(HeldInput{start, start + hold, resource, x, y});
+    }
+    m_release_at[resource] = std::max(m_release_at[resource], start + hold);
+    m_free_at[resource] = start + hold + cool;
+    m_now = start + delay;
+}
+void DeviceEmulator::press_buttons(Button buttons, uint16_t delay, uint16_t hold, uint8_t cool){
+    if (buttons == 0){
+        m_now += delay;
+        return;
+    }
+
+    //  Buttons are independent. All but the last start together.
+    for (uint8_t bit = 0; bit < 16; bit++){
+        Button mask = (Button)1 << bit;
+        if ((buttons & mask) == 0){
+            continue;
+        }
+        buttons &= ~mask;
+        press(bit, 0, 0, buttons == 0 ? delay : 0, hold, cool);
+    }
+}
+void DeviceEmulator::scroll(uint8_t direction, uint16_t delay, uint16_t hold, uint8_t cool){
+    //  Scrolls alternate between the dpad and the left joystick so that
+    //  back-to-back scrolls don't wait for each other's cooldown.
+    static const uint8_t JOYSTICK[8][2] = {
+        {128,   0}, {255,   0}, {255, 128}, {255, 255},
+        {128, 255}, {  0, 255}, {  0, 128}, {  0,   0},
+    };
+    direction &= 7;
+    if (m_free_at[RESOURCE_JOYSTICK_L] < m_free_at[RESOURCE_DPAD]){
+        press(RESOURCE_JOYSTICK_L, JOYSTICK[direction][0], JOYSTICK[direction][1], delay, hold, cool);
+    }else{
+        press(RESOURCE_DPAD, direction, 0, delay, hold, cool);
+    }
+}
+void DeviceEmulator::flush(){
+    for (uint64_t release : m_release_at){
+        m_now = std::max(m_now, release);
+    }
+}
+
+
+void DeviceEmulator::run_command(uint8_t type, const std::string& body){
+    if (type == PABB_MSG_COMMAND_MACRO_RUN){
+        run_macro(body);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lg(m_state_lock);
+    auto params_of = [&](auto* params) -> bool{
+        if (body.size() != sizeof(*params)){
+            return false;
+        }
+        memcpy(params, body.data(), sizeof(*params));
+        return true;
+    };
+
+    switch (type){
+    case PABB_MSG_COMMAND_SSF_FLUSH_PIPELINE:
+        flush();
+        return;
+    case PABB_MSG_COMMAND_SSF_DO_NOTHING:{
+        pabb_ssf_do_nothing params;
+        if (params_of(&params)){
+            m_now += params.ticks;
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_SSF_PRESS_BUTTON:{
+        pabb_ssf_press_button params;
+        if (params_of(&params)){
+            press_buttons(params.button, params.delay, params.hold, params.cool);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_SSF_PRESS_DPAD:{
+        pabb_ssf_press_dpad params;
+        if (params_of(&params)){
+            press(RESOURCE_DPAD, params.position, 0, params.delay, params.hold, params.cool);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_SSF_PRESS_JOYSTICK_L:
+    case PABB_MSG_COMMAND_SSF_PRESS_JOYSTICK_R:{
+        pabb_ssf_press_joystick params;
+        if (params_of(&params)){
+            uint8_t resource = type == PABB_MSG_COMMAND_SSF_PRESS_JOYSTICK_L ? RESOURCE_JOYSTICK_L : RESOURCE_JOYSTICK_R;
+            press(resource, params.x, params.y, params.delay, params.hold, params.cool);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_SSF_SCROLL:{
+        pabb_ssf_issue_scroll params;
+        if (params_of(&params)){
+            scroll((uint8_t)params.direction, params.delay, params.hold, params.cool);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_PBF_WAIT:{
+        pabb_pbf_wait params;
+        if (params_of(&params)){
+            flush();
+            m_now += params.ticks;
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_PBF_PRESS_BUTTON:{
+        pabb_pbf_press_button params;
+        if (params_of(&params)){
+            flush();
+            uint64_t start = m_now;
+            press_buttons(params.button, 0, params.hold_ticks, (uint8_t)std::min<uint16_t>(params.release_ticks, 255));
+            m_now = std::max(m_now, start + params.hold_ticks + params.release_ticks);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_PBF_PRESS_DPAD:{
+        pabb_pbf_press_dpad params;
+        if (params_of(&params)){
+            flush();
+            uint64_t start = m_now;
+            press(RESOURCE_DPAD, params.dpad, 0, 0, params.hold_ticks, (uint8_t)std::min<uint16_t>(params.release_ticks, 255));
+            m_now = std::max(m_now, start + params.hold_ticks + params.release_ticks);
+            return;
+        }
+        break;
+    }
+    case PABB_MSG_COMMAND_PBF_MOVE_JOYSTICK_L:
+    case PABB_MSG_COMMAND_PBF_MOVE_JOYSTICK_R:{
+        pabb_pbf_move_joystick params;
+        if (params_of(&params)){
+            flush();
+            uint64_t start = m_now;
+            uint8_t resource = type == PABB_MSG_COMMAND_PBF_MOVE_JOYSTICK_L ? RESOURCE_JOYSTICK_L : RESOURCE_JOYSTICK_R;
+            press(resource, params.x, params.y, 0, params.hold_ticks, (uint8_t)std::min<uint16_t>(params.release_ticks, 255));
+            m_now = std::max(m_now, start + params.hold_ticks + params.release_ticks);
+            return;
+        }
+        break;
+    }
+    }
+    m_stats.unsupported++;
+}
+void DeviceEmulator::run_macro(const std::string& body){
+    std::lock_guard<std::mutex> lg(m_state_lock);
+    m_stats.macros++;
+
+    pabb_macro_run params;
+    if (m_protocol_version < PABB_MACRO_PROTOCOL_VERSION || body.size() != sizeof(params)){
+        m_stats.macro_errors++;
+        return;
+    }
+    memcpy(&params, body.data(), sizeof(params));
+    if (params.length > PABB_MACRO_BUFFER_SIZE ||
+        pabb_crc32(0xffffffff, m_macro_buffer, params.length) != params.crc32
+    ){
+        m_stats.macro_errors++;
+        return;
+    }
+
+    const uint8_t* ptr = m_macro_buffer;
+    const uint8_t* end = m_macro_buffer + params.length;
+    uint8_t delay = PABB_MACRO_DEFAULT_DELAY;
+    uint8_t hold = PABB_MACRO_DEFAULT_HOLD;
+    uint8_t cool = PABB_MACRO_DEFAULT_COOL;
+    while (ptr < end){
+        uint8_t opcode = *ptr++;
+        size_t operands = 0;
+        switch (opcode){
+        case PABB_MACRO_OP_SET_TIMING:
+            operands = 3;
+            break;
+        case PABB_MACRO_OP_SET_DELAY:
+            operands = 1;
+            break;
+        case PABB_MACRO_OP_WAIT:
+        case PABB_MACRO_OP_PRESS_JOYSTICK_L:
+        case PABB_MACRO_OP_PRESS_JOYSTICK_R:
+            operands = 2;
+            break;
+        }
+        if ((size_t)(end - ptr) < operands){
+            m_stats.macro_errors++;
+            return;
+        }
+
+        switch (opcode & 0xf0){
+        case PABB_MACRO_OP_SCROLL:
+            if (opcode < 0x08){
+                scroll(opcode & 0x07, delay, hold, cool);
+                continue;
+            }
+            break;
+        case PABB_MACRO_OP_PRESS_DPAD:
+            if (opcode < 0x18){
+                press(RESOURCE_DPAD, opcode & 0x07, 0, delay, hold, cool);
+                continue;
+            }
+            break;
+        case PABB_MACRO_OP_PRESS_BUTTON:
+            press(opcode & 0x0f, 0, 0, delay, hold, cool);
+            continue;
+        }
+
+        switch (opcode){
+        case PABB_MACRO_OP_SET_TIMING:
+            delay = ptr[0];
+            hold = ptr[1];
+            cool = ptr[2];
+            break;
+        case PABB_MACRO_OP_SET_DELAY:
+            delay = ptr[0];
+            break;
+        case PABB_MACRO_OP_WAIT:
+            m_now += (uint16_t)(ptr[0] | ptr[1] << 8);
+            break;
+        case PABB_MACRO_OP_PRESS_JOYSTICK_L:
+            press(RESOURCE_JOYSTICK_L, ptr[0], ptr[1], delay, hold, cool);
+            break;
+        case PABB_MACRO_OP_PRESS_JOYSTICK_R:
+            press(RESOURCE_JOYSTICK_R, ptr[0], ptr[1], delay, hold, cool);
+            break;
+        default:
+            m_stats.macro_errors++;
+            return;
+        }
+        ptr += operands;
+    }
+}
+
+
+
+std::vector<EmulatedControllerState> DeviceEmulator::timeline() const{
+    std::lock_guard<std::mutex> lg(m_state_lock);
+
+    std::set<uint64_t> ticks{0};
+    for (const HeldInput& input : m_inputs){
+        ticks.insert(input.start);
+        ticks.insert(input.end);
+    }
+
+    std::vector<EmulatedControllerState> ret;
+    for (uint64_t tick : ticks){
+        EmulatedControllerState state;
+        state.tick = tick;
+        for (const HeldInput& input : m_inputs){
+            if (tick < input.start || tick >= input.end){
+                continue;
+            }
+            switch (input.resource){
+            case RESOURCE_DPAD:
+                state.dpad = input.x;
+                break;
+            case RESOURCE_JOYSTICK_L:
+                state.left_x = input.x;
+                state.left_y = input.y;
+                break;
+            case RESOURCE_JOYSTICK_R:
+                state.right_x = input.x;
+                state.right_y = input.y;
+                break;
+            default:
+                state.buttons |= (Button)1 << input.resource;
+            }
+        }
+        if (ret.empty() || !ret.back().same_input(state)){
+            ret.emplace_back(state);
+        }
+    }
+    return ret;
+}
+
+
+
+}
+}
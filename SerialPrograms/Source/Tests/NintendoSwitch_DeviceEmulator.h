@@ -0,0 +1,146 @@
+/*  Device Emulator
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ *      A reference implementation of the device side of the protocol. It goes
+ *  under PABotBase in place of a serial port so that command sequences can be
+ *  tested without hardware.
+ *
+ *  Commands run instantly in virtual time. Nothing is sent to a Switch. The
+ *  emulator only records what the controller would be doing at each tick.
+ *  This is enough to check that two ways of issuing the same presses give the
+ *  same controller input.
+ *
+ *  Supported are the framework requests, the ssf and pbf button commands and
+ *  macros. Any other command is acked and finished without doing anything.
+ *
+ */
+
+#ifndef PokemonAutomation_Tests_NintendoSwitch_DeviceEmulator_H
+#define PokemonAutomation_Tests_NintendoSwitch_DeviceEmulator_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Common/Microcontroller/MessageProtocol.h"
+#include "Common/NintendoSwitch/NintendoSwitch_ControllerDefs.h"
+#include "Common/NintendoSwitch/NintendoSwitch_Protocol_Macro.h"
+#include "ClientSource/Connection/StreamInterface.h"
+
+namespace PokemonAutomation{
+namespace NintendoSwitch{
+
+
+struct EmulatedControllerState{
+    uint64_t tick = 0;
+    Button buttons = 0;
+    DpadPosition dpad = DPAD_NONE;
+    uint8_t left_x = 128;
+    uint8_t left_y = 128;
+    uint8_t right_x = 128;
+    uint8_t right_y = 128;
+
+    //  Same input. Ignores the tick.
+    bool same_input(const EmulatedControllerState& x) const;
+    std::string to_str() const;
+};
+
+struct DeviceEmulatorStats{
+    size_t bytes_received = 0;
+    size_t messages = 0;        //  Valid messages received.
+    size_t requests = 0;
+    size_t commands = 0;
+    size_t retransmits = 0;
+    size_t unsupported = 0;     //  Commands that were acked but not emulated.
+    size_t macros = 0;
+    size_t macro_errors = 0;
+};
+
+
+class DeviceEmulator final : public StreamConnection{
+public:
+    DeviceEmulator(uint32_t protocol_version = PABB_MACRO_PROTOCOL_VERSION);
+    virtual ~DeviceEmulator();
+
+    virtual void stop() override;
+    virtual void send(const void* data, size_t bytes) override;
+
+    DeviceEmulatorStats stats() const;
+
+    //  Tick at which the next command would start.
+    uint64_t current_tick() const;
+
+    //  Every change of the controller input in tick order starting from the
+    //  neutral state at tick zero.
+    std::vector<EmulatedControllerState> timeline() const;
+
+
+private:
+    //  Every button bit, the dpad and each joystick are held and cooled
+    //  down independently.
+    enum Resource : uint8_t{
+        RESOURCE_DPAD = 16,
+        RESOURCE_JOYSTICK_L,
+        RESOURCE_JOYSTICK_R,
+        RESOURCE_COUNT,
+    };
+    struct HeldInput{
+        uint64_t start;
+        uint64_t end;
+        uint8_t resource;
+        uint8_t x;          //  Dpad position or joystick x.
+        uint8_t y;
+    };
+
+    void thread_loop();
+    void process_frames(std::string& outbox);
+    void process_message(uint8_t type, const std::string& body, std::string& outbox);
+    bool process_request(uint8_t type, const std::string& body, std::string& outbox);
+    void run_command(uint8_t type, const std::string& body);
+    void run_macro(const std::string& body);
+
+    //  These must be called under "m_state_lock".
+    void press(uint8_t resource, uint8_t x, uint8_t y, uint16_t delay, uint16_t hold, uint8_t cool);
+    void press_buttons(Button buttons, uint16_t delay, uint16_t hold, uint8_t cool);
+    void scroll(uint8_t direction, uint16_t delay, uint16_t hold, uint8_t cool);
+    void flush();
+
+    static void append_message(std::string& outbox, uint8_t type, const std::string& body);
+    template <typename Params>
+    static void append_message(std::string& outbox, uint8_t type, const Params& params){
+        append_message(outbox, type, std::string((const char*)&params, sizeof(params)));
+    }
+
+
+private:
+    const uint32_t m_protocol_version;
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+    std::string m_inbox;
+
+    //  Only touched by the emulator thread.
+    std::string m_recv_buffer;
+    seqnum_t m_expected_seqnum = 1;
+    seqnum_t m_send_seqnum = 1;
+    uint8_t m_macro_buffer[PABB_MACRO_BUFFER_SIZE] = {};
+
+    mutable std::mutex m_state_lock;
+    uint64_t m_now = 0;
+    uint64_t m_free_at[RESOURCE_COUNT] = {};
+    uint64_t m_release_at[RESOURCE_COUNT] = {};
+    std::vector<HeldInput> m_inputs;
+    DeviceEmulatorStats m_stats;
+
+    std::thread m_thread;
+};
+
+
+
+}
+}
+#endif
@@ -5,11 +5,19 @@
  */
 
 
+#include <fstream>
+#include <chrono>
 #include "Common/Compiler.h"
 #include "Common/Cpp/Time.h"
+#include "Common/Microcontroller/DeviceRoutines.h"
+#include "ClientSource/Connection/PABotBase.h"
+#include "CommonFramework/Logging/Logger.h"
 #include "CommonFramework/ImageTypes/ImageRGB32.h"
 #include "CommonFramework/ImageTypes/ImageViewRGB32.h"
+#include "NintendoSwitch/Commands/NintendoSwitch_Commands_Macro.h"
 #include "NintendoSwitch/Inference/NintendoSwitch_DetectHome.h"
+#include "NintendoSwitch/Programs/NintendoSwitch_FastCodeEntry.h"
+#include "NintendoSwitch_DeviceEmulator.h"
 #include "NintendoSwitch_Tests.h"
 #include "TestUtils.h"
 
@@ -31,5 +39,260 @@ int test_NintendoSwitch_UpdateMenuDetector(const ImageViewRGB32& image, bool tar
 }
 
 
+namespace{
+
+struct EmulatedCodeEntry{
+    std::vector<EmulatedControllerState> timeline;
+    DeviceEmulatorStats stats;
+};
+EmulatedCodeEntry emulate_code_entry(uint32_t protocol_version, const FastCodeEntrySettings& settings, const std::string& code){
+    Logger& logger = global_logger_command_line();
+    DeviceEmulator* device = new DeviceEmulator(protocol_version);
+    PABotBase botbase(logger, std::unique_ptr<StreamConnection>(device));
+    botbase.connect();
+    Microcontroller::protocol_version(botbase);
+
+    BotBaseContext context(botbase);
+    enter_alphanumeric_code(logger, context, settings, code);
+    context.wait_for_all_requests();
+
+    EmulatedCodeEntry ret{device->timeline(), device->stats()};
+    botbase.stop();
+    return ret;
+}
+EmulatedCodeEntry emulate_macro(uint32_t protocol_version, const ControllerMacro& macro){
+    Logger& logger = global_logger_command_line();
+    DeviceEmulator* device = new DeviceEmulator(protocol_version);
+    PABotBase botbase(logger, std::unique_ptr<StreamConnection>(device));
+    botbase.connect();
+    Microcontroller::protocol_version(botbase);
+
+    BotBaseContext context(botbase);
+    run_macro(context, macro);
+    context.wait_for_all_requests();
+
+    EmulatedCodeEntry ret{device->timeline(), device->stats()};
+    botbase.stop();
+    return ret;
+}
+
+std::string to_hex(const std::vector<std::string>& programs){
+    const char DIGITS[] = "0123456789abcdef";
+    std::string ret;
+    for (const std::string& program : programs){
+        if (!ret.empty()){
+            ret += " | ";
+        }
+        for (size_t c = 0; c < program.size(); c++){
+            uint8_t byte = (uint8_t)program[c];
+            if (c != 0){
+                ret += ' ';
+            }
+            ret += DIGITS[byte >> 4];
+            ret += DIGITS[byte & 15];
+        }
+    }
+    return ret;
+}
+
+//  Check the encoder and the emulator against programs and timelines worked
+//  out by hand.
+int test_macro_encoding(){
+    ControllerMacro macro;
+    macro.press_button(BUTTON_A, 10);
+    macro.press_button(0, 20);
+    macro.issue_scroll(SSF_SCROLL_DOWN, 10);
+    macro.press_dpad(DPAD_UP, 300);
+    macro.press_button(BUTTON_A | BUTTON_B, 3, 8, 0);
+    macro.do_nothing(500);
+    macro.press_joystick(true, 0, 255, 5, 5);
+
+    TEST_RESULT_EQUAL(
+        to_hex(macro.compile()),
+        "31 0a 22 "                 //  Set delay 10. Press A.
+        "32 14 00 "                 //  No buttons. Wait 20.
+        "04 "                       //  Scroll down.
+        "31 00 10 32 2c 01 "        //  Set delay 0. Press up. Wait 300.
+        "30 00 08 00 21 31 03 22 "  //  Set timing 0/8/0. Press B. Set delay 3. Press A.
+        "32 f4 01 "                 //  Wait 500.
+        "30 05 05 00 33 00 ff"      //  Set timing 5/5/0. Left joystick.
+    );
+
+    //  Every program starts over with the default registers.
+    TEST_RESULT_EQUAL(
+        to_hex(macro.compile(8)),
+        "31 0a 22 32 14 00 04 | "
+        "10 32 2c 01 | "
+        "30 00 08 00 21 31 03 22 | "
+        "32 f4 01 | "
+        "30 05 05 00 33 00 ff"
+    );
+
+    //  A press with no buttons delays the next press.
+    ControllerMacro gap;
+    gap.press_button(BUTTON_A, 10);
+    gap.press_button(0, 20);
+    gap.press_button(BUTTON_B, 0);
+    for (uint32_t version : {PABB_MACRO_PROTOCOL_VERSION, PABB_PROTOCOL_VERSION}){
+        std::vector<EmulatedControllerState> timeline = emulate_macro(version, gap).timeline;
+        TEST_RESULT_EQUAL(timeline.size(), 4);
+        TEST_RESULT_EQUAL(timeline[0].tick, 0);
+        TEST_RESULT_EQUAL(timeline[0].buttons, BUTTON_A);
+        TEST_RESULT_EQUAL(timeline[1].tick, 5);
+        TEST_RESULT_EQUAL(timeline[1].buttons, 0);
+        TEST_RESULT_EQUAL(timeline[2].tick, 30);
+        TEST_RESULT_EQUAL(timeline[2].buttons, BUTTON_B);
+        TEST_RESULT_EQUAL(timeline[3].tick, 35);
+        TEST_RESULT_EQUAL(timeline[3].buttons, 0);
+    }
+
+    return 0;
+}
+
+}
+
+// Test file has one code per line. Each code is entered through the device
+// emulator twice. Once as a macro and once as individual ssf commands for a
+// device that doesn't support macros. The controller input must be the same.
+// Also checks a few fixed macros against hand-written programs and timelines.
+int test_NintendoSwitch_DeviceMacro(const std::string& filepath){
+    std::ifstream file(filepath);
+    if (!file){
+        cerr << "Error: cannot read " << filepath << endl;
+        return 1;
+    }
+
+    if (test_macro_encoding() != 0){
+        return 1;
+    }
+
+    FastCodeEntrySettingsOption option;
+    FastCodeEntrySettings settings(option);
+
+    std::string code;
+    while (std::getline(file, code)){
+        while (!code.empty() && (code.back() == '\r' || code.back() == ' ')){
+            code.pop_back();
+        }
+        if (code.empty()){
+            continue;
+        }
+
+        EmulatedCodeEntry macro = emulate_code_entry(PABB_MACRO_PROTOCOL_VERSION, settings, code);
+        EmulatedCodeEntry ssf = emulate_code_entry(PABB_PROTOCOL_VERSION, settings, code);
+
+        TEST_RESULT_EQUAL(ssf.stats.macros, 0);
+        TEST_RESULT_EQUAL(macro.stats.macros > 0, true);
+        TEST_RESULT_EQUAL(macro.stats.macro_errors, 0);
+        TEST_RESULT_EQUAL(macro.stats.unsupported, 0);
+        TEST_RESULT_EQUAL(ssf.stats.unsupported, 0);
+        TEST_RESULT_EQUAL(macro.timeline.size(), ssf.timeline.size());
+        for (size_t c = 0; c < macro.timeline.size(); c++){
+            const EmulatedControllerState& x = macro.timeline[c];
+            const EmulatedControllerState& y = ssf.timeline[c];
+            if (x.tick != y.tick || !x.same_input(y)){
+                cerr << "Error: " << code << " differs at change " << c << "." << endl;
+                cerr << "    macro: " << x.to_str() << endl;
+                cerr << "    ssf:   " << y.to_str() << endl;
+                return 1;
+            }
+        }
+
+        cout << code << ": " << macro.timeline.back().tick << " ticks, "
+             << macro.stats.messages << " messages (" << macro.stats.bytes_received << " bytes) as a macro vs. "
+             << ssf.stats.messages << " messages (" << ssf.stats.bytes_received << " bytes) as ssf commands" << endl;
+    }
+    return 0;
+}
+
+
+
+namespace{
+
+//  The old planner. It tries both ends of the code for every digit so it is
+//  exponential in the code length. Kept to check and time the new one.
+std::vector<DigitPath> get_codeboard_path_exhaustive(
+    const std::vector<CodeboardPosition>& positions, size_t s, size_t e,
+    CodeboardPosition start,
+    uint8_t scroll_delay, uint8_t wrap_delay, bool diagonals
+){
+    if (e - s == 1){
+        return {get_codeboard_digit_path(start, positions[s], scroll_delay, wrap_delay, diagonals)};
+    }
+
+    std::vector<DigitPath> forward;
+    forward.emplace_back(get_codeboard_digit_path(start, positions[s], scroll_delay, wrap_delay, diagonals));
+    std::vector<DigitPath> remaining = get_codeboard_path_exhaustive(
+        positions, s + 1, e, positions[s],
+        scroll_delay, wrap_delay, diagonals
+    );
+    forward.insert(forward.end(), remaining.begin(), remaining.end());
+
+    std::vector<DigitPath> reverse;
+    reverse.emplace_back(get_codeboard_digit_path(start, positions[e - 1], scroll_delay, wrap_delay, diagonals));
+    reverse.back().left_cursor = true;
+    remaining = get_codeboard_path_exhaustive(
+        positions, s, e - 1, positions[e - 1],
+        scroll_delay, wrap_delay, diagonals
+    );
+    reverse.insert(reverse.end(), remaining.begin(), remaining.end());
+
+    return get_codeboard_path_cost(forward) <= get_codeboard_path_cost(reverse) ? forward : reverse;
+}
+
+}
+
+// Test file has one code per line. For both keyboard layouts, with and without
+// diagonal scrolls, the planner must find a path as fast as trying every
+// order of the digits. Prints the time taken by both.
+int test_NintendoSwitch_CodeboardPlanner(const std::string& filepath){
+    std::ifstream file(filepath);
+    if (!file){
+        cerr << "Error: cannot read " << filepath << endl;
+        return 1;
+    }
+
+    Logger& logger = global_logger_command_line();
+    const uint8_t scroll_delay = 4;
+    const uint8_t wrap_delay = 6;
+
+    std::string code;
+    while (std::getline(file, code)){
+        while (!code.empty() && (code.back() == '\r' || code.back() == ' ')){
+            code.pop_back();
+        }
+        if (code.empty()){
+            continue;
+        }
+
+        for (KeyboardLayout layout : {KeyboardLayout::QWERTY, KeyboardLayout::AZERTY}){
+            std::vector<CodeboardPosition> positions = get_codeboard_positions(logger, layout, code);
+            for (bool diagonals : {false, true}){
+                auto time0 = std::chrono::steady_clock::now();
+                std::vector<DigitPath> planned = get_codeboard_path(
+                    positions, {0, 0}, scroll_delay, wrap_delay, diagonals, true
+                );
+                auto time1 = std::chrono::steady_clock::now();
+                std::vector<DigitPath> exhaustive = get_codeboard_path_exhaustive(
+                    positions, 0, positions.size(), {0, 0}, scroll_delay, wrap_delay, diagonals
+                );
+                auto time2 = std::chrono::steady_clock::now();
+
+                TEST_RESULT_EQUAL(planned.size(), positions.size());
+                TEST_RESULT_EQUAL(get_codeboard_path_cost(planned), get_codeboard_path_cost(exhaustive));
+
+                cout << code
+                     << (layout == KeyboardLayout::QWERTY ? " (QWERTY" : " (AZERTY")
+                     << (diagonals ? ", diagonals): " : "): ")
+                     << get_codeboard_path_cost(planned) << " ticks, planned in "
+                     << std::chrono::duration_cast<std::chrono::microseconds>(time1 - time0).count() << " us vs. "
+                     << std::chrono::duration_cast<std::chrono::microseconds>(time2 - time1).count() << " us exhaustive" << endl;
+            }
+        }
+    }
+    return 0;
+}
+
+
 
 }
@@ -9,12 +9,18 @@
 #ifndef PokemonAutomation_Tests_NintendoSwitch_Tests_H
 #define PokemonAutomation_Tests_NintendoSwitch_Tests_H
 
+#include <string>
+
 namespace PokemonAutomation{
 
 class ImageViewRGB32;
 
 int test_NintendoSwitch_UpdateMenuDetector(const ImageViewRGB32& image, bool target);
 
+int test_NintendoSwitch_DeviceMacro(const std::string& filepath);
+
+int test_NintendoSwitch_CodeboardPlanner(const std::string& filepath);
+
 }
 
 #endif
@@ -0,0 +1,119 @@
+/*  PokemonHome Tests
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include "Common/Cpp/Exceptions.h"
+#include "Common/Cpp/Json/JsonValue.h"
+#include "Common/Cpp/Json/JsonArray.h"
+#include "Common/Cpp/Json/JsonObject.h"
+#include "PokemonHome/Programs/PokemonHome_BoxSortingPlanner.h"
+#include "PokemonHome_Tests.h"
+
+#include <iostream>
+using std::cout;
+using std::cerr;
+using std::endl;
+
+namespace PokemonAutomation{
+
+using namespace NintendoSwitch::PokemonHome;
+
+
+// Test file is the "<OUTPUT_FILE>.json" box dump written by the box sorter.
+// Sort it by national dex number, plan the swaps, then run them on a simulated
+// box and count the button presses.
+int test_pokemonHome_BoxSortingPlanner(const std::string& filepath){
+    if (filepath.size() < 5 || filepath.substr(filepath.size() - 5) != ".json"){
+        cout << "Skip " << filepath << " as it is not a json file" << endl;
+        return -1;
+    }
+
+    JsonValue json;
+    try{
+        json = load_json_file(filepath);
+    }catch (Exception& e){
+        cerr << "Error: cannot read " << filepath << ": " << e.message() << endl;
+        return 1;
+    }
+    const JsonArray* slots = json.get_array();
+    if (slots == nullptr){
+        cerr << "Error: " << filepath << " is not a box dump." << endl;
+        return 1;
+    }
+
+    //  Same fields as the box sorter compares.
+    using Key = std::tuple<int64_t, bool, bool, std::string, std::string>;
+    std::map<Key, size_t> ids;
+    std::vector<Key> keys;
+    std::vector<size_t> current;
+    for (const JsonValue& value : *slots){
+        const JsonObject* slot = value.get_object();
+        int64_t dex;
+        if (slot == nullptr || !slot->read_integer(dex, "national_dex_number")){
+            current.emplace_back(0);
+            continue;
+        }
+        Key key(dex, false, false, "", "");
+        slot->read_boolean(std::get<1>(key), "shiny");
+        slot->read_boolean(std::get<2>(key), "gmax");
+        slot->read_string(std::get<3>(key), "ball_slug");
+        slot->read_string(std::get<4>(key), "gender");
+        auto iter = ids.emplace(key, ids.size() + 1).first;
+        if (iter->second > keys.size()){
+            keys.emplace_back(key);
+        }
+        current.emplace_back(iter->second);
+    }
+
+    std::vector<size_t> target = current;
+    std::sort(
+        target.begin(), target.end(),
+        [&](size_t x, size_t y){
+            if (x == 0 || y == 0){
+                return y == 0 && x != 0;
+            }
+            return keys[x - 1] < keys[y - 1];
+        }
+    );
+
+    BoxSortingTimings timings{10};
+    size_t boxes = (current.size() + MAX_ROWS * MAX_COLUMNS - 1) / (MAX_ROWS * MAX_COLUMNS);
+    Cursor start{boxes == 0 ? 0 : boxes - 1, 0, 0};
+
+    BoxSortingPlan plan = plan_box_sort(current, target, 0, start, timings);
+    BoxSortingPlan in_order = plan_box_sort_in_order(current, target, 0, start, timings);
+
+    BoxSortingSimulation simulation = simulate_box_sort(current, 0, start, plan.swaps, timings);
+    BoxSortingSimulation in_order_simulation = simulate_box_sort(current, 0, start, in_order.swaps, timings);
+
+    cout << "Slots: " << current.size() << ", distinct: " << ids.size() << endl;
+    cout << "Planner: " << plan.swaps.size() << " swaps, " << simulation.presses << " presses, " << simulation.ticks << " ticks" << endl;
+    cout << "In Order: " << in_order.swaps.size() << " swaps, " << in_order_simulation.presses << " presses, " << in_order_simulation.ticks << " ticks" << endl;
+
+    if (simulation.layout != target){
+        cerr << "Error: planner did not sort the boxes." << endl;
+        return 1;
+    }
+    if (in_order_simulation.layout != target){
+        cerr << "Error: in-order plan did not sort the boxes." << endl;
+        return 1;
+    }
+    if (simulation.presses != plan.presses || simulation.ticks != plan.ticks){
+        cerr << "Error: plan estimate does not match the simulation." << endl;
+        return 1;
+    }
+    if (simulation.ticks > in_order_simulation.ticks){
+        cerr << "Error: planner is slower than sorting in order." << endl;
+        return 1;
+    }
+    return 0;
+}
+
+
+}
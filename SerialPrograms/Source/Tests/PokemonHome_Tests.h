@@ -0,0 +1,21 @@
+/*  PokemonHome Tests
+ *
+ *  From: https://github.com/PokemonAutomation/Arduino-Source
+ *
+ */
+
+
+#ifndef PokemonAutomation_Tests_PokemonHome_Tests_H
+#define PokemonAutomation_Tests_PokemonHome_Tests_H
+
+#include <string>
+
+namespace PokemonAutomation{
+
+
+int test_pokemonHome_BoxSortingPlanner(const std::string& filepath);
+
+
+}
+
+#endif
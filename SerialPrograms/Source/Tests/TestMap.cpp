@@ -9,6 +9,7 @@
 #include "CommonFramework_Tests.h"
 #include "Kernels_Tests.h"
 #include "NintendoSwitch_Tests.h"
+#include "PokemonHome_Tests.h"
 #include "PokemonLA_Tests.h"
 #include "PokemonSwSh_Tests.h"
 #include "PokemonSV_Tests.h"
@@ -46,6 +47,8 @@ using ImageWordsDetectorFunction = std::function<int(const ImageViewRGB32& image
 
 using ImageVoidDetectorFunction = std::function<void(const ImageViewRGB32& image)>;
 
+using ImageTestFunction = std::function<int(const ImageViewRGB32& image)>;
+
 using SoundBoolDetectorFunction = std::function<int(const std::vector<AudioSpectrum>& spectrums, bool target)>;
 
 // Basic check on whether an image can be loaded.
@@ -166,6 +169,17 @@ int image_void_detector_helper(ImageVoidDetectorFunction test_func, const std::s
     return image_filename_detector_helper(run_test, test_path);
 }
 
+// Helper for testing code that reads an image and checks the results itself,
+// for example the kernels against their reference versions.
+// test_func: reads an image and returns 0 if the test succeeds, > 0 if it fails.
+int image_test_helper(ImageTestFunction test_func, const std::string& test_path){
+    auto run_test = [&](const ImageViewRGB32& image, const std::string&) -> int{
+        return test_func(image);
+    };
+
+    return image_filename_detector_helper(run_test, test_path);
+}
+
 
 // Basic check on whether an image can be loaded.
 // Also strip the image format suffix (.png and so on)
@@ -221,8 +235,16 @@ int sound_bool_detector_helper(SoundBoolDetectorFunction test_func, const std::s
 
 const std::map<std::string, TestFunction> TEST_MAP = {
     {"Kernels_ImageScaleBrightness", std::bind(image_void_detector_helper, test_kernels_ImageScaleBrightness, _1)},
+    {"Kernels_ImageGradient", std::bind(image_test_helper, test_kernels_ImageGradient, _1)},
+    {"Kernels_ImageScaledDeviation", std::bind(image_test_helper, test_kernels_ImageScaledDeviation, _1)},
+    {"Kernels_ImageMatch", std::bind(image_test_helper, test_kernels_ImageMatch, _1)},
+    {"Kernels_ImageFilterSets", std::bind(image_test_helper, test_kernels_ImageFilterSets, _1)},
     {"CommonFramework_BlackBorderDetector", std::bind(image_bool_detector_helper, test_CommonFramework_BlackBorderDetector, _1)},
+    {"CommonFramework_SerialLoopback", test_CommonFramework_SerialLoopback},
+    {"CommonFramework_RegionSignature", test_CommonFramework_RegionSignature},
     {"NintendoSwitch_UpdateMenuDetector", std::bind(image_bool_detector_helper, test_NintendoSwitch_UpdateMenuDetector, _1)},
+    {"NintendoSwitch_DeviceMacro", test_NintendoSwitch_DeviceMacro},
+    {"NintendoSwitch_CodeboardPlanner", test_NintendoSwitch_CodeboardPlanner},
     {"PokemonSwSh_YCommMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_YCommMenuDetector, _1)},
     {"PokemonSwSh_MaxLair_BattleMenuDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_MaxLair_BattleMenuDetector, _1)},
     {"PokemonSwSh_DialogTriangleDetector", std::bind(image_bool_detector_helper, test_pokemonSwSh_DialogTriangleDetector, _1)},
@@ -269,6 +291,7 @@ const std::map<std::string, TestFunction> TEST_MAP = {
     {"PokemonSV_BoxPartyEggDetector", std::bind(image_int_detector_helper, test_pokemonSV_BoxPartyEggDetector, _1)},
     {"PokemonSV_OverworldDetector", std::bind(image_bool_detector_helper, test_pokemonSV_OverworldDetector, _1)},
     {"PokemonSV_BoxBottomButtonDetector", std::bind(image_words_detector_helper, test_pokemonSV_BoxBottomButtonDetector, _1)},
+    {"PokemonHome_BoxSortingPlanner", test_pokemonHome_BoxSortingPlanner},
 };
 
 TestFunction find_test_function(const std::string& test_space, const std::string& test_name){